@@ -24,6 +24,7 @@
 #include <cassert>
 #include <cstddef>
 #include <algorithm>
+#include <utility>
 
 // user include files
 #include "DataFormats/Common/interface/RefProd.h"
@@ -37,6 +38,7 @@ namespace edm {
   public:
     ContainerMask() {}
     ContainerMask(const edm::RefProd<T>& iProd, const std::vector<bool>& iMask);
+    ContainerMask(const edm::RefProd<T>& iProd, std::vector<bool>&& iMask);
     //virtual ~ContainerMask();
 
     // ---------- const member functions ---------------------
@@ -52,6 +54,9 @@ namespace edm {
 
     size_t size() const { return m_mask.size(); }
 
+    /// read-only access to the full mask, to share it without copying
+    const std::vector<bool>& maskVector() const { return m_mask; }
+
     const edm::RefProd<T>& refProd() const { return m_prod; }
     // ---------- static member functions --------------------
 
@@ -77,6 +82,12 @@ namespace edm {
     assert(iMask.size() <= ContainerMaskTraits<T>::size(m_prod.product()));
   }
 
+  template <typename T>
+  ContainerMask<T>::ContainerMask(const edm::RefProd<T>& iProd, std::vector<bool>&& iMask)
+      : m_prod(iProd), m_mask(std::move(iMask)) {
+    assert(m_mask.size() <= ContainerMaskTraits<T>::size(m_prod.product()));
+  }
+
   template <typename T>
   bool ContainerMask<T>::mask(const typename ContainerMaskTraits<T>::value_type* iElement) {
     unsigned int index = ContainerMaskTraits<T>::indexFor(iElement, m_prod.product());
@@ -85,7 +96,8 @@ namespace edm {
 
   template <typename T>
   void ContainerMask<T>::copyMaskTo(std::vector<bool>& iTo) const {
-    iTo.assign(m_mask.begin(), m_mask.end());
+    // copy-assignment works on whole words, assign from iterators would go bit by bit
+    iTo = m_mask;
   }
 
   template <typename T>
@@ -68,6 +68,14 @@ void testContainerMask::testVector() {
     CPPUNIT_ASSERT(alternate[2]);
     CPPUNIT_ASSERT(!alternate[3]);
   }
+
+  {
+    std::vector<bool> moved(mask);
+    edm::ContainerMask<ContainerType> cMoved(rp, std::move(moved));
+    CPPUNIT_ASSERT(cMoved.size() == mask.size());
+    CPPUNIT_ASSERT(cMoved.maskVector() == mask);
+    CPPUNIT_ASSERT(&cMoved.maskVector() != &cMask.maskVector());
+  }
 }
 
 void testContainerMask::testDetSetVector() {
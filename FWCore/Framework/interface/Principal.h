@@ -184,6 +184,8 @@ namespace edm {
     CacheIdentifier_t cacheIdentifier() const { return cacheIdentifier_; }
 
     DelayedReader* reader() const { return reader_; }
+    // Replaces the reader of the products not read yet, e.g. when the source has moved on to other events
+    void setReader(DelayedReader* reader) { reader_ = reader; }
 
     ConstProductResolverPtr getProductResolver(BranchID const& oid) const;
 
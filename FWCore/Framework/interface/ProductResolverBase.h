@@ -79,6 +79,10 @@ namespace edm {
                           MergeableRunProductMetadata const* mergeableRunProductMetadata) const {
       retrieveAndMerge_(principal, mergeableRunProductMetadata);
     }
+    // Sets a product owned together with other principals, e.g. a pileup event
+    // cached for several streams. Only products read from the input take it.
+    void putSharedProduct(std::shared_ptr<WrapperBase const> edp) const { putSharedProduct_(std::move(edp)); }
+
     void resetProductData() { resetProductData_(false); }
 
     void unsafe_deleteProduct() const { const_cast<ProductResolverBase*>(this)->resetProductData_(true); }
@@ -187,6 +191,7 @@ namespace edm {
 
     virtual void retrieveAndMerge_(Principal const& principal,
                                    MergeableRunProductMetadata const* mergeableRunProductMetadata) const;
+    virtual void putSharedProduct_(std::shared_ptr<WrapperBase const> edp) const;
 
     virtual bool unscheduledWasNotRun_() const = 0;
     virtual bool productUnavailable_() const = 0;
@@ -32,6 +32,8 @@ namespace edm {
 
   void ProductResolverBase::retrieveAndMerge_(Principal const&, MergeableRunProductMetadata const*) const {}
 
+  void ProductResolverBase::putSharedProduct_(std::shared_ptr<WrapperBase const>) const {}
+
   void ProductResolverBase::setMergeableRunProductMetadata_(MergeableRunProductMetadata const*) {}
 
   void ProductResolverBase::write(std::ostream& os) const {
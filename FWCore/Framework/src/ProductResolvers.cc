@@ -469,6 +469,12 @@ namespace edm {
     }
   }
 
+  void InputProductResolver::putSharedProduct_(std::shared_ptr<WrapperBase const> edp) const {
+    if (not productResolved()) {
+      setProduct(std::move(edp));
+    }
+  }
+
   bool ProducedProductResolver::isFromCurrentProcess() const { return true; }
 
   void DataManagingProductResolver::connectTo(ProductResolverBase const& iOther, Principal const*) { assert(false); }
@@ -507,6 +513,16 @@ namespace edm {
       setFailedStatus();
     }
   }
+
+  void DataManagingProductResolver::setProduct(std::shared_ptr<WrapperBase const> edp) const {
+    if (edp) {
+      checkType(*edp);
+      productData_.unsafe_setWrapper(std::move(edp));
+      theStatus_ = ProductStatus::ProductSet;
+    } else {
+      setFailedStatus();
+    }
+  }
   // This routine returns true if it is known that currently there is no real product.
   // If there is a real product, it returns false.
   // If it is not known if there is a real product, it returns false.
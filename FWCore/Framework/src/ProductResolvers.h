@@ -59,6 +59,7 @@ namespace edm {
 
   protected:
     void setProduct(std::unique_ptr<WrapperBase> edp) const;
+    void setProduct(std::shared_ptr<WrapperBase const> edp) const;
     ProductStatus status() const { return theStatus_; }
     ProductStatus defaultStatus() const { return defaultStatus_; }
     void setFailedStatus() const { theStatus_ = ProductStatus::ResolveFailed; }
@@ -122,6 +123,7 @@ namespace edm {
                         SharedResourcesAcquirer* sra,
                         ModuleCallingContext const* mcc) const override;
     void putProduct_(std::unique_ptr<WrapperBase> edp) const override;
+    void putSharedProduct_(std::shared_ptr<WrapperBase const> edp) const override;
 
     void retrieveAndMerge_(Principal const& principal,
                            MergeableRunProductMetadata const* mergeableRunProductMetadata) const override;
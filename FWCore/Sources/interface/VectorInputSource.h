@@ -29,6 +29,13 @@ namespace edm {
     explicit VectorInputSource(ParameterSet const& pset, VectorInputSourceDescription const& desc);
     virtual ~VectorInputSource();
 
+    /// Position of an event in the input: the entry in a file of the sequence.
+    /// Both are taken modulo the number of files and the number of entries in the file.
+    struct EntryPosition {
+      unsigned int file;
+      unsigned long long entry;
+    };
+
     template <typename T>
     size_t loopOverEvents(EventPrincipal& cache,
                           size_t& fileNameHash,
@@ -42,7 +49,15 @@ namespace edm {
     size_t loopSpecified(
         EventPrincipal& cache, size_t& fileNameHash, Iterator const& begin, Iterator const& end, T eventOperator);
 
+    /// Reads events at the positions returned by nextPosition until number of them are used
+    template <typename T, typename P>
+    size_t loopOverEntries(
+        EventPrincipal& cache, size_t& fileNameHash, size_t number, T eventOperator, P nextPosition);
+
     void dropUnwantedBranches(std::vector<std::string> const& wantedBranches);
+
+    /// True if reading the next event may draw random numbers from the engine given to loopOverEvents
+    bool nextEventNeedsRandomEngine() const { return nextEventNeedsRandomEngine_(); }
     //
     /// Called at beginning of job
     void doBeginJob();
@@ -69,8 +84,10 @@ namespace edm {
       SecondaryEventIDAndFileInfo info(event, fileNameHash);
       readOneSpecified(cache, fileNameHash, info);
     }
+    virtual void readOneEntry(EventPrincipal& cache, size_t& fileNameHash, EntryPosition const& position);
 
     virtual void dropUnwantedBranches_(std::vector<std::string> const& wantedBranches) = 0;
+    virtual bool nextEventNeedsRandomEngine_() const { return true; }
     virtual void beginJob() = 0;
     virtual void endJob() = 0;
 
@@ -120,5 +137,25 @@ namespace edm {
     }
     return i;
   }
+
+  template <typename T, typename P>
+  size_t VectorInputSource::loopOverEntries(
+      EventPrincipal& cache, size_t& fileNameHash, size_t number, T eventOperator, P nextPosition) {
+    size_t i = 0U;
+    unsigned int consecutiveRejections = 0U;
+    while (i < number) {
+      clearEventPrincipal(cache);
+      readOneEntry(cache, fileNameHash, nextPosition());
+      bool used = eventOperator(cache, fileNameHash);
+      if (used) {
+        ++i;
+        consecutiveRejections = 0U;
+      } else if (consecutiveRejectionsLimit_ > 0) {
+        ++consecutiveRejections;
+        throwIfOverLimit(consecutiveRejections);
+      }
+    }
+    return i;
+  }
 }  // namespace edm
 #endif
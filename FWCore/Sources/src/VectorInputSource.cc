@@ -22,6 +22,10 @@ namespace edm {
 
   void VectorInputSource::clearEventPrincipal(EventPrincipal& cache) { cache.clearEventPrincipal(); }
 
+  void VectorInputSource::readOneEntry(EventPrincipal&, size_t&, EntryPosition const&) {
+    throw cms::Exception("LogicError") << "VectorInputSource::readOneEntry(): this source cannot read events by entry.";
+  }
+
   void VectorInputSource::doBeginJob() { this->beginJob(); }
 
   void VectorInputSource::doEndJob() { this->endJob(); }
@@ -160,6 +160,12 @@ public:
   /// particle did not decay before more detectors (useful for newProducer)
   inline void setGlobal() { isGlobal_ = true; }
 
+  /// Set the index in FBaseSimEvent and other vectors (and the SimTrack id)
+  inline void setId(int id) {
+    id_ = id;
+    setTrackId(id);
+  }
+
   /// Set origin vertex
   inline void setOriginVertex(const SimVertex& v) { vertex_ = v; }
 
@@ -54,6 +54,27 @@ namespace fastsim {
     //! In case interaction produces and stores content in the event (e.g. TrackerSimHits).
     virtual void storeProducts(edm::Event& iEvent) { ; }
 
+    //! Prepares this instance for the parallel propagation (see FastSimProducer).
+    /*!
+            Every propagator then has its own instance of each model and propagates the families of the primary particles
+            (a primary particle and all its secondaries) one after the other. The outcome of interact() must only depend
+            on the particle, the layer and the random engine, not on the particles propagated before by this instance.
+            \return False if the model does not support it.
+        */
+    virtual bool enableParallelPropagation() { return false; }
+
+    //! Parallel propagation: the products made from now on belong to the family with the given index.
+    virtual void beginFamily(unsigned family) { ; }
+
+    //! Parallel propagation: moves the products of a family from another instance of this model to this one.
+    /*!
+            Called for every family in order, on the instance that stores the products in the event.
+            \param other The instance of this model that propagated the family.
+            \param family Index of the family.
+            \param simTrackIndexOffset Index of the first SimTrack of the family in the event.
+        */
+    virtual void mergeFamily(InteractionModel& other, unsigned family, int simTrackIndexOffset) { ; }
+
     //! Return (unique) name of this interaction.
     const std::string getName() { return name_; }
 
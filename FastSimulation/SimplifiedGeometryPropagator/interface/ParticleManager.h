@@ -53,6 +53,21 @@ namespace fastsim {
                     std::vector<SimTrack>& simTracks,
                     std::vector<SimVertex>& simVertices);
 
+    //! Constructor for the family of a primary particle (parallel propagation).
+    /*!
+            Propagates the primary particle and all its secondaries, with its own SimTracks and SimVertices: the
+            SimTrack indices start from 0, the SimVertex indices after those of the event (the origin vertices of the
+            GenParticles, which are shared by all the families).
+            \param eventManager The ParticleManager of the event, after takeGenParticles().
+            \param primary The primary particle of the family.
+            \param simTracks The SimTracks of the family.
+            \param simVertices The SimVertices of the family.
+        */
+    ParticleManager(const ParticleManager& eventManager,
+                    std::unique_ptr<Particle> primary,
+                    std::vector<SimTrack>& simTracks,
+                    std::vector<SimVertex>& simVertices);
+
     //! Default destructor.
     ~ParticleManager();
 
@@ -66,6 +81,13 @@ namespace fastsim {
         */
     std::unique_ptr<Particle> nextParticle(const RandomEngineAndDistribution& random);
 
+    //! Returns the GenParticles to propagate, in order (the primary particles of the parallel propagation).
+    /*!
+            Their origin vertices are added to the SimVertices. The (kinetic) cuts of the ParticleFilter are applied
+            later, by nextParticle() of the ParticleManager of their family.
+        */
+    std::vector<std::unique_ptr<Particle> > takeGenParticles();
+
     //! Adds secondaries that are produced by any of the interactions (or particle decay) to the buffer.
     /*!
             Also checks which charged daughter is closest to a charged mother (in deltaR) and assigns the same SimTrack ID.
@@ -79,7 +101,9 @@ namespace fastsim {
                         const SimplifiedGeometry* layer = nullptr);
 
     //! Returns the position of a given SimVertex. Needed for interfacing the code with the old calorimetry.
-    const SimVertex getSimVertex(unsigned i) { return simVertices_->at(i); }
+    const SimVertex getSimVertex(unsigned i) {
+      return i < firstSimVertexIndex_ ? eventSimVertices_->at(i) : simVertices_->at(i - firstSimVertexIndex_);
+    }
 
     //! Returns a given SimTrack. Needed for interfacing the code with the old calorimetry.
     const SimTrack getSimTrack(unsigned i) { return simTracks_->at(i); }
@@ -137,6 +161,8 @@ namespace fastsim {
     double timeUnitConversionFactor_;             //!< Convert pythia unis to ns (FastSim standard)
     std::vector<std::unique_ptr<Particle> >
         particleBuffer_;  //!< The vector of all secondaries that are not yet propagated in the event.
+    const std::vector<SimVertex>* eventSimVertices_;  //!< SimVertices of the event (of the GenParticles for a family)
+    unsigned firstSimVertexIndex_;                    //!< Index of the first SimVertex in simVertices_
   };
 }  // namespace fastsim
 
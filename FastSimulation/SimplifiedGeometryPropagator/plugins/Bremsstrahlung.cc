@@ -50,6 +50,9 @@ namespace fastsim {
                   std::vector<std::unique_ptr<Particle> >& secondaries,
                   const RandomEngineAndDistribution& random) override;
 
+    //! Supports the parallel propagation.
+    bool enableParallelPropagation() override { return true; }
+
   private:
     //! Compute Brem photon energy and angles, if any.
     /*!
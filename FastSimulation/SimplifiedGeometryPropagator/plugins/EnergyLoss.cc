@@ -49,6 +49,9 @@ namespace fastsim {
                   std::vector<std::unique_ptr<fastsim::Particle> >& secondaries,
                   const RandomEngineAndDistribution& random) override;
 
+    //! The Landau generator only holds its tabulated function: supports the parallel propagation.
+    bool enableParallelPropagation() override { return true; }
+
   private:
     LandauFluctuationGenerator theGenerator;  //!< Generator to do Landau fluctuation
     double minMomentum_;                      //!< Minimum momentum of incoming (charged) particle
@@ -1,6 +1,7 @@
 // system include files
 #include <memory>
 #include <string>
+#include <vector>
 
 // framework
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -45,6 +46,11 @@
 #include "Geometry/CaloEventSetup/interface/CaloTopologyRecord.h"
 #include "FastSimulation/ShowerDevelopment/interface/FastHFShowerLibrary.h"
 
+#include "CLHEP/Random/MixMaxRng.h"
+
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+
 ///////////////////////////////////////////////
 // Author: L. Vanelderen, S. Kurz
 // Date: 29 May 2017
@@ -60,6 +66,12 @@
     5) If particle is about to decay: do decay and add secondaries to the event
     6) Restart from 1) with the next particle
     7) If last particle was propagated add SimTracks, SimVertices, SimHits,... to the event
+
+    With parallelPropagators > 0, the families of the primary particles (a GenParticle and all its secondaries) are
+    propagated at the same time by that many propagators, each with its own tracker geometry, interaction models and
+    decayer. Each family uses a random engine seeded from the engine of the stream and its index, and the SimTracks,
+    SimVertices and SimHits of the families are added to the event in the order of the GenParticles: the result does
+    not depend on the number of threads (but is not the one of the sequential propagation).
 */
 class FastSimProducer : public edm::stream::EDProducer<> {
 public:
@@ -70,9 +82,43 @@ private:
   void beginStream(edm::StreamID id) override;
   void produce(edm::Event&, const edm::EventSetup&) override;
   void endStream() override;
+  void propagate(fastsim::Particle& particle,
+                 fastsim::ParticleManager& particleManager,
+                 const fastsim::Geometry& geometry,
+                 const fastsim::Decayer& decayer,
+                 const RandomEngineAndDistribution& random,
+                 HepPDT::ParticleDataTable const& particleTable,
+                 std::vector<FSimTrack>& fSimTracks);
+  void propagateFamilies(fastsim::ParticleManager& particleManager,
+                         HepPDT::ParticleDataTable const& particleTable,
+                         edm::SimTrackContainer& simTracks,
+                         edm::SimVertexContainer& simVertices,
+                         std::vector<FSimTrack>& fSimTracks);
   virtual FSimTrack createFSimTrack(fastsim::Particle* particle,
                                     fastsim::ParticleManager* particleManager,
-                                    HepPDT::ParticleDataTable const& particleTable);
+                                    HepPDT::ParticleDataTable const& particleTable,
+                                    const fastsim::Decayer& decayer,
+                                    const RandomEngineAndDistribution& random);
+  static void createInteractionModels(const edm::ParameterSet& modelCfgs,
+                                      std::vector<std::unique_ptr<fastsim::InteractionModel> >& interactionModels,
+                                      std::map<std::string, fastsim::InteractionModel*>& interactionModelMap);
+
+  //! A propagator of the parallel propagation, used by one family at a time.
+  struct Propagator {
+    Propagator(const edm::ParameterSet& trackerDefinition) : geometry(trackerDefinition) {}
+    fastsim::Geometry geometry;
+    fastsim::Decayer decayer;
+    std::vector<std::unique_ptr<fastsim::InteractionModel> > interactionModels;
+    std::map<std::string, fastsim::InteractionModel*> interactionModelMap;
+  };
+
+  //! What the propagation of a family adds to the event, with the indices of the family (see ParticleManager).
+  struct Family {
+    edm::SimTrackContainer simTracks;
+    edm::SimVertexContainer simVertices;
+    std::vector<FSimTrack> fSimTracks;
+    Propagator* propagator = nullptr;  //!< Holds the products of the interaction models
+  };
 
   edm::EDGetTokenT<edm::HepMCProduct> genParticlesToken_;  //!< Token to get the genParticles
   fastsim::Geometry geometry_;                             //!< The definition of the tracker according to python config
@@ -91,6 +137,8 @@ private:
   fastsim::Decayer decayer_;  //!< Handles decays of non-stable particles using pythia
   std::vector<std::unique_ptr<fastsim::InteractionModel> > interactionModels_;  //!< All defined interaction models
   std::map<std::string, fastsim::InteractionModel*> interactionModelMap_;  //!< Each interaction model has a unique name
+  std::vector<std::unique_ptr<Propagator> > propagators_;  //!< Parallel propagation (if not empty)
+  std::unique_ptr<tbb::task_arena> arena_;                  //!< Runs at most one family per propagator
   static const std::string MESSAGECATEGORY;  //!< Category of debugging messages ("FastSimulation")
 };
 
@@ -111,19 +159,32 @@ FastSimProducer::FastSimProducer(const edm::ParameterSet& iConfig)
   //---------------
 
   const edm::ParameterSet& modelCfgs = iConfig.getParameter<edm::ParameterSet>("interactionModels");
-  for (const std::string& modelName : modelCfgs.getParameterNames()) {
-    const edm::ParameterSet& modelCfg = modelCfgs.getParameter<edm::ParameterSet>(modelName);
-    std::string modelClassName(modelCfg.getParameter<std::string>("className"));
-    // Use plugin-factory to create model
-    std::unique_ptr<fastsim::InteractionModel> interactionModel(
-        fastsim::InteractionModelFactory::get()->create(modelClassName, modelName, modelCfg));
-    if (!interactionModel.get()) {
-      throw cms::Exception("FastSimProducer") << "InteractionModel " << modelName << " could not be created";
+  createInteractionModels(modelCfgs, interactionModels_, interactionModelMap_);
+
+  //----------------
+  // parallel propagation
+  //---------------
+
+  const unsigned parallelPropagators = iConfig.getParameter<unsigned>("parallelPropagators");
+  bool parallelPropagation = parallelPropagators > 0;
+  for (unsigned i = 0; i < parallelPropagators && parallelPropagation; ++i) {
+    auto propagator = std::make_unique<Propagator>(iConfig.getParameter<edm::ParameterSet>("trackerDefinition"));
+    createInteractionModels(modelCfgs, propagator->interactionModels, propagator->interactionModelMap);
+    for (auto& interactionModel : propagator->interactionModels) {
+      if (!interactionModel->enableParallelPropagation()) {
+        edm::LogWarning(MESSAGECATEGORY) << "The " << *interactionModel
+                                         << " does not support the parallel propagation: the particles are propagated"
+                                            " one after the other";
+        parallelPropagation = false;
+        break;
+      }
     }
-    // Add model to list
-    interactionModels_.push_back(std::move(interactionModel));
-    // and create the map
-    interactionModelMap_[modelName] = interactionModels_.back().get();
+    propagators_.push_back(std::move(propagator));
+  }
+  if (parallelPropagation) {
+    arena_ = std::make_unique<tbb::task_arena>(parallelPropagators);
+  } else {
+    propagators_.clear();
   }
 
   //----------------
@@ -165,6 +226,9 @@ void FastSimProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 
   geometry_.update(iSetup, interactionModelMap_);
   caloGeometry_.update(iSetup, interactionModelMap_);
+  for (auto& propagator : propagators_) {
+    propagator->geometry.update(iSetup, propagator->interactionModelMap);
+  }
 
   // Define containers for SimTracks, SimVertices
   std::unique_ptr<edm::SimTrackContainer> simTracks_(new edm::SimTrackContainer);
@@ -213,114 +277,15 @@ void FastSimProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
   LogDebug(MESSAGECATEGORY) << "################################"
                             << "\n###############################";
 
-  // loop over particles
-  for (std::unique_ptr<fastsim::Particle> particle = particleManager.nextParticle(*_randomEngine); particle != nullptr;
-       particle = particleManager.nextParticle(*_randomEngine)) {
-    LogDebug(MESSAGECATEGORY) << "\n   moving NEXT particle: " << *particle;
-
-    // -----------------------------
-    // This condition is necessary because of hack for calorimetry
-    // -> The CalorimetryManager should also be implemented based on this new FastSim classes (Particle.h) in a future project.
-    // A second loop (below) loops over all parts of the calorimetry in order to create a track of the old FastSim class FSimTrack.
-    // The condition below (R<128, z<302) makes sure that the particle geometrically is outside the tracker boundaries
-    // -----------------------------
-
-    if (particle->position().Perp2() < 128. * 128. && std::abs(particle->position().Z()) < 302.) {
-      // move the particle through the layers
-      fastsim::LayerNavigator layerNavigator(geometry_);
-      const fastsim::SimplifiedGeometry* layer = nullptr;
-
-      // moveParticleToNextLayer(..) returns 0 in case that particle decays
-      // in this case particle is propagated up to its decay vertex
-      while (layerNavigator.moveParticleToNextLayer(*particle, layer)) {
-        LogDebug(MESSAGECATEGORY) << "   moved to next layer: " << *layer;
-        LogDebug(MESSAGECATEGORY) << "   new state: " << *particle;
-
-        // Hack to interface "old" calo to "new" tracking
-        // Particle reached calorimetry so stop further propagation
-        if (layer->getCaloType() == fastsim::SimplifiedGeometry::TRACKERBOUNDARY) {
-          layer = nullptr;
-          // particle no longer is on a layer
-          particle->resetOnLayer();
-          break;
-        }
-
-        // break after 25 ns: only happens for particles stuck in loops
-        if (particle->position().T() > 25) {
-          layer = nullptr;
-          // particle no longer is on a layer
-          particle->resetOnLayer();
-          break;
-        }
-
-        // perform interaction between layer and particle
-        // do only if there is actual material
-        if (layer->getThickness(particle->position(), particle->momentum()) > 1E-10) {
-          int nSecondaries = 0;
-          // loop on interaction models
-          for (fastsim::InteractionModel* interactionModel : layer->getInteractionModels()) {
-            LogDebug(MESSAGECATEGORY) << "   interact with " << *interactionModel;
-            std::vector<std::unique_ptr<fastsim::Particle> > secondaries;
-            interactionModel->interact(*particle, *layer, secondaries, *_randomEngine);
-            nSecondaries += secondaries.size();
-            particleManager.addSecondaries(particle->position(), particle->simTrackIndex(), secondaries, layer);
-          }
-
-          // kinematic cuts: particle might e.g. lost all its energy
-          if (!particleFilter_.acceptsEn(*particle)) {
-            // Add endvertex if particle did not create any secondaries
-            if (nSecondaries == 0)
-              particleManager.addEndVertex(particle.get());
-            layer = nullptr;
-            break;
-          }
-        }
-
-        LogDebug(MESSAGECATEGORY) << "--------------------------------"
-                                  << "\n-------------------------------";
-      }
-
-      // do decays
-      if (!particle->isStable() && particle->remainingProperLifeTimeC() < 1E-10) {
-        LogDebug(MESSAGECATEGORY) << "Decaying particle...";
-        std::vector<std::unique_ptr<fastsim::Particle> > secondaries;
-        decayer_.decay(*particle, secondaries, _randomEngine->theEngine());
-        LogDebug(MESSAGECATEGORY) << "   decay has " << secondaries.size() << " products";
-        particleManager.addSecondaries(particle->position(), particle->simTrackIndex(), secondaries);
-        continue;
-      }
-
-      LogDebug(MESSAGECATEGORY) << "################################"
-                                << "\n###############################";
+  if (propagators_.empty()) {
+    // loop over particles
+    for (std::unique_ptr<fastsim::Particle> particle = particleManager.nextParticle(*_randomEngine);
+         particle != nullptr;
+         particle = particleManager.nextParticle(*_randomEngine)) {
+      propagate(*particle, particleManager, geometry_, decayer_, *_randomEngine, *pdt, myFSimTracks);
     }
-
-    // -----------------------------
-    // Hack to interface "old" calorimetry with "new" propagation in tracker
-    // The CalorimetryManager has to know which particle could in principle hit which parts of the calorimeter
-    // I think it's a bit strange to propagate the particle even further (and even decay it) if it already hits
-    // some part of the calorimetry but this is how the code works...
-    // -----------------------------
-
-    if (particle->position().Perp2() >= 128. * 128. || std::abs(particle->position().Z()) >= 302.) {
-      LogDebug(MESSAGECATEGORY) << "\n   moving particle to calorimetry: " << *particle;
-
-      // create FSimTrack (this is the object the old propagation uses)
-      myFSimTracks.push_back(createFSimTrack(particle.get(), &particleManager, *pdt));
-      // particle was decayed
-      if (!particle->isStable() && particle->remainingProperLifeTimeC() < 1E-10) {
-        continue;
-      }
-
-      LogDebug(MESSAGECATEGORY) << "################################"
-                                << "\n###############################";
-    }
-
-    // -----------------------------
-    // End Hack
-    // -----------------------------
-
-    LogDebug(MESSAGECATEGORY) << "################################"
-                              << "\n###############################";
+  } else {
+    propagateFamilies(particleManager, *pdt, *simTracks_, *simVertices_, myFSimTracks);
   }
 
   // store simTracks and simVertices
@@ -368,9 +333,200 @@ void FastSimProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 
 void FastSimProducer::endStream() { _randomEngine.reset(); }
 
+void FastSimProducer::propagate(fastsim::Particle& particle,
+                                fastsim::ParticleManager& particleManager,
+                                const fastsim::Geometry& geometry,
+                                const fastsim::Decayer& decayer,
+                                const RandomEngineAndDistribution& random,
+                                HepPDT::ParticleDataTable const& particleTable,
+                                std::vector<FSimTrack>& fSimTracks) {
+  LogDebug(MESSAGECATEGORY) << "\n   moving NEXT particle: " << particle;
+
+  // -----------------------------
+  // This condition is necessary because of hack for calorimetry
+  // -> The CalorimetryManager should also be implemented based on this new FastSim classes (Particle.h) in a future project.
+  // A second loop (below) loops over all parts of the calorimetry in order to create a track of the old FastSim class FSimTrack.
+  // The condition below (R<128, z<302) makes sure that the particle geometrically is outside the tracker boundaries
+  // -----------------------------
+
+  if (particle.position().Perp2() < 128. * 128. && std::abs(particle.position().Z()) < 302.) {
+    // move the particle through the layers
+    fastsim::LayerNavigator layerNavigator(geometry);
+    const fastsim::SimplifiedGeometry* layer = nullptr;
+
+    // moveParticleToNextLayer(..) returns 0 in case that particle decays
+    // in this case particle is propagated up to its decay vertex
+    while (layerNavigator.moveParticleToNextLayer(particle, layer)) {
+      LogDebug(MESSAGECATEGORY) << "   moved to next layer: " << *layer;
+      LogDebug(MESSAGECATEGORY) << "   new state: " << particle;
+
+      // Hack to interface "old" calo to "new" tracking
+      // Particle reached calorimetry so stop further propagation
+      if (layer->getCaloType() == fastsim::SimplifiedGeometry::TRACKERBOUNDARY) {
+        layer = nullptr;
+        // particle no longer is on a layer
+        particle.resetOnLayer();
+        break;
+      }
+
+      // break after 25 ns: only happens for particles stuck in loops
+      if (particle.position().T() > 25) {
+        layer = nullptr;
+        // particle no longer is on a layer
+        particle.resetOnLayer();
+        break;
+      }
+
+      // perform interaction between layer and particle
+      // do only if there is actual material
+      if (layer->getThickness(particle.position(), particle.momentum()) > 1E-10) {
+        int nSecondaries = 0;
+        // loop on interaction models
+        for (fastsim::InteractionModel* interactionModel : layer->getInteractionModels()) {
+          LogDebug(MESSAGECATEGORY) << "   interact with " << *interactionModel;
+          std::vector<std::unique_ptr<fastsim::Particle> > secondaries;
+          interactionModel->interact(particle, *layer, secondaries, random);
+          nSecondaries += secondaries.size();
+          particleManager.addSecondaries(particle.position(), particle.simTrackIndex(), secondaries, layer);
+        }
+
+        // kinematic cuts: particle might e.g. lost all its energy
+        if (!particleFilter_.acceptsEn(particle)) {
+          // Add endvertex if particle did not create any secondaries
+          if (nSecondaries == 0)
+            particleManager.addEndVertex(&particle);
+          layer = nullptr;
+          break;
+        }
+      }
+
+      LogDebug(MESSAGECATEGORY) << "--------------------------------"
+                                << "\n-------------------------------";
+    }
+
+    // do decays
+    if (!particle.isStable() && particle.remainingProperLifeTimeC() < 1E-10) {
+      LogDebug(MESSAGECATEGORY) << "Decaying particle...";
+      std::vector<std::unique_ptr<fastsim::Particle> > secondaries;
+      decayer.decay(particle, secondaries, random.theEngine());
+      LogDebug(MESSAGECATEGORY) << "   decay has " << secondaries.size() << " products";
+      particleManager.addSecondaries(particle.position(), particle.simTrackIndex(), secondaries);
+      return;
+    }
+
+    LogDebug(MESSAGECATEGORY) << "################################"
+                              << "\n###############################";
+  }
+
+  // -----------------------------
+  // Hack to interface "old" calorimetry with "new" propagation in tracker
+  // The CalorimetryManager has to know which particle could in principle hit which parts of the calorimeter
+  // I think it's a bit strange to propagate the particle even further (and even decay it) if it already hits
+  // some part of the calorimetry but this is how the code works...
+  // -----------------------------
+
+  if (particle.position().Perp2() >= 128. * 128. || std::abs(particle.position().Z()) >= 302.) {
+    LogDebug(MESSAGECATEGORY) << "\n   moving particle to calorimetry: " << particle;
+
+    // create FSimTrack (this is the object the old propagation uses)
+    fSimTracks.push_back(createFSimTrack(&particle, &particleManager, particleTable, decayer, random));
+    // particle was decayed
+    if (!particle.isStable() && particle.remainingProperLifeTimeC() < 1E-10) {
+      return;
+    }
+
+    LogDebug(MESSAGECATEGORY) << "################################"
+                              << "\n###############################";
+  }
+
+  // -----------------------------
+  // End Hack
+  // -----------------------------
+
+  LogDebug(MESSAGECATEGORY) << "################################"
+                            << "\n###############################";
+}
+
+void FastSimProducer::propagateFamilies(fastsim::ParticleManager& particleManager,
+                                        HepPDT::ParticleDataTable const& particleTable,
+                                        edm::SimTrackContainer& simTracks,
+                                        edm::SimVertexContainer& simVertices,
+                                        std::vector<FSimTrack>& fSimTracks) {
+  // the primary particles, their origin vertices are shared by all the families
+  std::vector<std::unique_ptr<fastsim::Particle> > primaries = particleManager.takeGenParticles();
+  const int nGenVertices = simVertices.size();
+
+  // the engine of a family is seeded from the engine of the stream and the index of the family
+  const long eventSeed = static_cast<long>(static_cast<unsigned int>(_randomEngine->theEngine()));
+
+  std::vector<Family> families(primaries.size());
+  arena_->execute([&] {
+    tbb::parallel_for(0u, static_cast<unsigned>(primaries.size()), [&](unsigned iFamily) {
+      // a propagator must not start another family while this one waits for nested tasks
+      tbb::this_task_arena::isolate([&] {
+        Family& family = families[iFamily];
+        family.propagator = propagators_[tbb::this_task_arena::current_thread_index()].get();
+
+        CLHEP::MixMaxRng engine;
+        long seeds[2] = {eventSeed, static_cast<long>(iFamily)};
+        engine.setSeeds(seeds, 2);
+        RandomEngineAndDistribution random(engine);
+
+        for (auto& interactionModel : family.propagator->interactionModels) {
+          interactionModel->beginFamily(iFamily);
+        }
+        fastsim::ParticleManager familyManager(
+            particleManager, std::move(primaries[iFamily]), family.simTracks, family.simVertices);
+        for (std::unique_ptr<fastsim::Particle> particle = familyManager.nextParticle(random); particle != nullptr;
+             particle = familyManager.nextParticle(random)) {
+          propagate(*particle,
+                    familyManager,
+                    family.propagator->geometry,
+                    family.propagator->decayer,
+                    random,
+                    particleTable,
+                    family.fSimTracks);
+        }
+      });
+    });
+  });
+
+  // add the families to the event in order: shift their SimTrack indices and their SimVertex indices
+  // (except the origin vertices of the GenParticles)
+  for (unsigned iFamily = 0; iFamily < families.size(); ++iFamily) {
+    Family& family = families[iFamily];
+    const int simTrackOffset = simTracks.size();
+    const int simVertexOffset = simVertices.size() - nGenVertices;
+    auto simVertexIndex = [&](int index) { return index < nGenVertices ? index : index + simVertexOffset; };
+
+    for (SimTrack& simTrack : family.simTracks) {
+      simTrack.setTrackId(simTrack.trackId() + simTrackOffset);
+      simTrack.setVertexIndex(simVertexIndex(simTrack.vertIndex()));
+      simTracks.push_back(simTrack);
+    }
+    for (const SimVertex& simVertex : family.simVertices) {
+      simVertices.emplace_back(simVertex.position().Vect(),
+                               simVertex.position().T(),
+                               simVertex.noParent() ? -1 : simVertex.parentIndex() + simTrackOffset,
+                               simVertexIndex(simVertex.vertexId()));
+    }
+    for (FSimTrack& fSimTrack : family.fSimTracks) {
+      fSimTrack.setId(fSimTrack.id() + simTrackOffset);
+      fSimTrack.setVertexIndex(simVertexIndex(fSimTrack.vertIndex()));
+      fSimTrack.setOriginVertex(simVertices[fSimTrack.vertIndex()]);
+      fSimTracks.push_back(fSimTrack);
+    }
+    for (unsigned i = 0; i < interactionModels_.size(); ++i) {
+      interactionModels_[i]->mergeFamily(*family.propagator->interactionModels[i], iFamily, simTrackOffset);
+    }
+  }
+}
+
 FSimTrack FastSimProducer::createFSimTrack(fastsim::Particle* particle,
                                            fastsim::ParticleManager* particleManager,
-                                           HepPDT::ParticleDataTable const& particleTable) {
+                                           HepPDT::ParticleDataTable const& particleTable,
+                                           const fastsim::Decayer& decayer,
+                                           const RandomEngineAndDistribution& random) {
   FSimTrack myFSimTrack(particle->pdgId(),
                         particleManager->getSimTrack(particle->simTrackIndex()).momentum(),
                         particle->simVertexIndex(),
@@ -496,7 +652,7 @@ FSimTrack FastSimProducer::createFSimTrack(fastsim::Particle* particle,
   if (!particle->isStable() && particle->remainingProperLifeTimeC() < 1E-10) {
     LogDebug(MESSAGECATEGORY) << "Decaying particle...";
     std::vector<std::unique_ptr<fastsim::Particle> > secondaries;
-    decayer_.decay(*particle, secondaries, _randomEngine->theEngine());
+    decayer.decay(*particle, secondaries, random.theEngine());
     LogDebug(MESSAGECATEGORY) << "   decay has " << secondaries.size() << " products";
     particleManager->addSecondaries(particle->position(), particle->simTrackIndex(), secondaries);
   }
@@ -504,4 +660,24 @@ FSimTrack FastSimProducer::createFSimTrack(fastsim::Particle* particle,
   return myFSimTrack;
 }
 
+void FastSimProducer::createInteractionModels(
+    const edm::ParameterSet& modelCfgs,
+    std::vector<std::unique_ptr<fastsim::InteractionModel> >& interactionModels,
+    std::map<std::string, fastsim::InteractionModel*>& interactionModelMap) {
+  for (const std::string& modelName : modelCfgs.getParameterNames()) {
+    const edm::ParameterSet& modelCfg = modelCfgs.getParameter<edm::ParameterSet>(modelName);
+    std::string modelClassName(modelCfg.getParameter<std::string>("className"));
+    // Use plugin-factory to create model
+    std::unique_ptr<fastsim::InteractionModel> interactionModel(
+        fastsim::InteractionModelFactory::get()->create(modelClassName, modelName, modelCfg));
+    if (!interactionModel.get()) {
+      throw cms::Exception("FastSimProducer") << "InteractionModel " << modelName << " could not be created";
+    }
+    // Add model to list
+    interactionModels.push_back(std::move(interactionModel));
+    // and create the map
+    interactionModelMap[modelName] = interactionModels.back().get();
+  }
+}
+
 DEFINE_FWK_MODULE(FastSimProducer);
@@ -51,6 +51,9 @@ namespace fastsim {
                   std::vector<std::unique_ptr<Particle> >& secondaries,
                   const RandomEngineAndDistribution& random) override;
 
+    //! Keeps no state between two particles: supports the parallel propagation.
+    bool enableParallelPropagation() override { return true; }
+
   private:
     //! Return an orthogonal vector.
     XYZVector orthogonal(const XYZVector& aVector) const;
@@ -75,10 +75,16 @@ namespace fastsim {
                   std::vector<std::unique_ptr<fastsim::Particle> >& secondaries,
                   const RandomEngineAndDistribution& random) override;
 
+    //! Draw the FullSim interactions with the engine of the particle instead of reading them in sequence.
+    bool enableParallelPropagation() override;
+
   private:
     //! Return a hashed index for a given particle ID
     unsigned index(int thePid);
 
+    //! Parallel propagation: draw an entry of a file and an interaction in it, return false if it has none.
+    bool drawInteraction(unsigned thePidIndex, unsigned ene, const RandomEngineAndDistribution& random);
+
     //! Return an orthogonal vector.
     XYZVector orthogonal(const XYZVector& aVector) const;
 
@@ -113,6 +119,7 @@ namespace fastsim {
     unsigned myOutputBuffer;     //!< Needed to save interactions to file
 
     bool currentValuesWereSet;  //!< Read data from file that was created in a previous run
+    bool randomEntries;         //!< Parallel propagation: the interactions are drawn at random
 
     //////////
     // Properties of the Hadrons
@@ -346,7 +353,7 @@ namespace fastsim {
 }  // namespace fastsim
 
 fastsim::NuclearInteraction::NuclearInteraction(const std::string& name, const edm::ParameterSet& cfg)
-    : fastsim::InteractionModel(name), currentValuesWereSet(false) {
+    : fastsim::InteractionModel(name), currentValuesWereSet(false), randomEntries(false) {
   // Full path to FullSim root file
   std::string fullPath;
 
@@ -535,7 +542,7 @@ void fastsim::NuclearInteraction::interact(fastsim::Particle& particle,
   }
 
   // In case the events are not read from (old) saved file, then pick a random event from FullSim file
-  if (!currentValuesWereSet) {
+  if (!currentValuesWereSet && !randomEntries) {
     currentValuesWereSet = true;
     for (unsigned iname = 0; iname < theHadronNA.size(); ++iname) {
       for (unsigned iene = 0; iene < theHadronEN.size(); ++iene) {
@@ -693,7 +700,17 @@ void fastsim::NuclearInteraction::interact(fastsim::Particle& particle,
       // and protection against low momentum proton and neutron that never interacts
       // (i.e., empty files)
       unsigned ene;
-      if (random.flatShoot() < slope || aNumberOfInteractions[ene1] == 0) {
+      if (randomEntries) {
+        // aNumberOfInteractions depends on the entries drawn before by this instance: check the drawn entry
+        // instead, and fall back to the other energy if it has no interaction
+        ene = random.flatShoot() < slope ? ene2 : ene1;
+        if (!drawInteraction(thePidIndex, ene, random)) {
+          if (ene == ene2 || !drawInteraction(thePidIndex, ene2, random)) {
+            return;
+          }
+          ene = ene2;
+        }
+      } else if (random.flatShoot() < slope || aNumberOfInteractions[ene1] == 0) {
         ene = ene2;
       } else {
         ene = ene1;
@@ -705,7 +722,7 @@ void fastsim::NuclearInteraction::interact(fastsim::Particle& particle,
 
       // Check we are not either at the end of an interaction bunch
       // or at the end of a file
-      if (aCurrentInteraction[ene] == aNumberOfInteractions[ene]) {
+      if (!randomEntries && aCurrentInteraction[ene] == aNumberOfInteractions[ene]) {
         std::vector<unsigned>& aCurrentEntry = theCurrentEntry[thePidIndex];
         std::vector<unsigned>& aNumberOfEntries = theNumberOfEntries[thePidIndex];
         std::vector<TTree*>& aTrees = theTrees[thePidIndex];
@@ -794,6 +811,45 @@ void fastsim::NuclearInteraction::interact(fastsim::Particle& particle,
   }
 }
 
+bool fastsim::NuclearInteraction::enableParallelPropagation() {
+  // The interactions saved by an earlier run are positions in the sequential reading of the files
+  if (currentValuesWereSet) {
+    return false;
+  }
+  randomEntries = true;
+  // No entry read yet
+  for (unsigned iname = 0; iname < theHadronNA.size(); ++iname) {
+    for (unsigned iene = 0; iene < theHadronEN.size(); ++iene) {
+      theCurrentEntry[iname][iene] = theNumberOfEntries[iname][iene];
+    }
+  }
+  return true;
+}
+
+bool fastsim::NuclearInteraction::drawInteraction(unsigned thePidIndex,
+                                                  unsigned ene,
+                                                  const RandomEngineAndDistribution& random) {
+  unsigned aNumberOfEntries = theNumberOfEntries[thePidIndex][ene];
+  if (aNumberOfEntries == 0) {
+    return false;
+  }
+
+  // Read the entry unless it is the last one read by this instance
+  unsigned myEntry = (unsigned)(aNumberOfEntries * random.flatShoot());
+  if (myEntry != theCurrentEntry[thePidIndex][ene]) {
+    theCurrentEntry[thePidIndex][ene] = myEntry;
+    theTrees[thePidIndex][ene]->GetEntry(myEntry);
+    theNumberOfInteractions[thePidIndex][ene] = theNUEvents[thePidIndex][ene]->nInteractions();
+  }
+
+  unsigned aNumberOfInteractions = theNumberOfInteractions[thePidIndex][ene];
+  if (aNumberOfInteractions == 0) {
+    return false;
+  }
+  theCurrentInteraction[thePidIndex][ene] = (unsigned)(aNumberOfInteractions * random.flatShoot());
+  return true;
+}
+
 void fastsim::NuclearInteraction::save() {
   // Size of buffer
   ++myOutputBuffer;
@@ -48,6 +48,9 @@ namespace fastsim {
                   std::vector<std::unique_ptr<fastsim::Particle> >& secondaries,
                   const RandomEngineAndDistribution& random) override;
 
+    //! Only depends on the photon and the random engine: supports the parallel propagation.
+    bool enableParallelPropagation() override { return true; }
+
   private:
     //! A universal angular distribution.
     /*!
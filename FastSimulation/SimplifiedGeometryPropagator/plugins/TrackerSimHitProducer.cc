@@ -1,5 +1,6 @@
 #include <vector>
 #include <memory>
+#include <map>
 
 // framework
 #include "FWCore/Framework/interface/Event.h"
@@ -75,6 +76,15 @@ namespace fastsim {
     //! Store the SimHit collection.
     void storeProducts(edm::Event& iEvent) override;
 
+    //! The SimHits are kept per family in the parallel propagation.
+    bool enableParallelPropagation() override { return true; }
+
+    //! The SimHits made from now on belong to the given family.
+    void beginFamily(unsigned family) override;
+
+    //! Append the SimHits of a family made by another instance, with the SimTrack indices of the event.
+    void mergeFamily(InteractionModel& other, unsigned family, int simTrackIndexOffset) override;
+
     //! Helper funtion to create the actual SimHit on a detector (sub-) module.
     /*!
             \param particle Representation of the particle's trajectory
@@ -97,14 +107,19 @@ namespace fastsim {
   private:
     const double
         onSurfaceTolerance_;  //!< Max distance between particle and active (sub-) module. Otherwise particle has to be propagated.
-    std::unique_ptr<edm::PSimHitContainer> simHitContainer_;  //!< The SimHit.
-    double minMomentum_;                                      //!< Set the minimal momentum of incoming particle
+    std::unique_ptr<edm::PSimHitContainer> simHitContainer_;   //!< The SimHit.
+    edm::PSimHitContainer* currentSimHits_;                    //!< simHitContainer_ or the SimHits of a family
+    std::map<unsigned, edm::PSimHitContainer> familySimHits_;  //!< The SimHits of each family (parallel propagation)
+    double minMomentum_;                                       //!< Set the minimal momentum of incoming particle
     bool doHitsFromInboundParticles_;  //!< If not set, incoming particles (negative speed relative to center of detector) don't create a SimHits since reconstruction anyways not possible
   };
 }  // namespace fastsim
 
 fastsim::TrackerSimHitProducer::TrackerSimHitProducer(const std::string& name, const edm::ParameterSet& cfg)
-    : fastsim::InteractionModel(name), onSurfaceTolerance_(0.01), simHitContainer_(new edm::PSimHitContainer) {
+    : fastsim::InteractionModel(name),
+      onSurfaceTolerance_(0.01),
+      simHitContainer_(new edm::PSimHitContainer),
+      currentSimHits_(simHitContainer_.get()) {
   // Set the minimal momentum
   minMomentum_ = cfg.getParameter<double>("minMomentumCut");
   // - if not set, particles from outside the beampipe with a negative speed in R direction are propagated but no SimHits
@@ -120,6 +135,23 @@ void fastsim::TrackerSimHitProducer::registerProducts(edm::ProducerBase& produce
 void fastsim::TrackerSimHitProducer::storeProducts(edm::Event& iEvent) {
   iEvent.put(std::move(simHitContainer_), "TrackerHits");
   simHitContainer_.reset(new edm::PSimHitContainer);
+  currentSimHits_ = simHitContainer_.get();
+}
+
+void fastsim::TrackerSimHitProducer::beginFamily(unsigned family) { currentSimHits_ = &familySimHits_[family]; }
+
+void fastsim::TrackerSimHitProducer::mergeFamily(InteractionModel& other, unsigned family, int simTrackIndexOffset) {
+  std::map<unsigned, edm::PSimHitContainer>& otherFamilySimHits =
+      static_cast<TrackerSimHitProducer&>(other).familySimHits_;
+  auto familySimHits = otherFamilySimHits.find(family);
+  if (familySimHits == otherFamilySimHits.end()) {
+    return;
+  }
+  for (PSimHit& simHit : familySimHits->second) {
+    simHit.setTrackId(simHit.trackId() + simTrackIndexOffset);
+    simHitContainer_->push_back(simHit);
+  }
+  otherFamilySimHits.erase(familySimHits);
 }
 
 void fastsim::TrackerSimHitProducer::interact(Particle& particle,
@@ -246,7 +278,7 @@ void fastsim::TrackerSimHitProducer::interact(Particle& particle,
   // Fill simHitContainer
   for (std::map<double, std::unique_ptr<PSimHit>>::const_iterator it = distAndHits.begin(); it != distAndHits.end();
        it++) {
-    simHitContainer_->push_back(*(it->second));
+    currentSimHits_->push_back(*(it->second));
   }
 }
 
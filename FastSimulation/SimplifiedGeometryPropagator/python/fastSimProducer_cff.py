@@ -16,6 +16,7 @@ fastSimProducer = cms.EDProducer(
     caloDefinition = CaloMaterialBlock.CaloMaterial, #  Hack to interface "old" calorimetry with "new" propagation in tracker
     beamPipeRadius = cms.double(3.),
     deltaRchargedMother = cms.double(0.02), # Maximum angle to associate a charged daughter to a charged mother (mostly done to associate muons to decaying pions)
+    parallelPropagators = cms.uint32(0), # >0: number of families of primary particles (a GenParticle and its secondaries) propagated at the same time, each with its own random engine (reproducible, but not the random sequence of the sequential propagation)
     interactionModels = cms.PSet(
             pairProduction = cms.PSet(
                 className = cms.string("fastsim::PairProduction"),
@@ -43,7 +43,9 @@ fastsim::ParticleManager::ParticleManager(const HepMC::GenEvent& genEvent,
       momentumUnitConversionFactor_(conversion_factor(genEvent_->momentum_unit(), HepMC::Units::GEV)),
       lengthUnitConversionFactor_(conversion_factor(genEvent_->length_unit(), HepMC::Units::LengthUnit::CM)),
       lengthUnitConversionFactor2_(lengthUnitConversionFactor_ * lengthUnitConversionFactor_),
-      timeUnitConversionFactor_(lengthUnitConversionFactor_ / fastsim::Constants::speedOfLight)
+      timeUnitConversionFactor_(lengthUnitConversionFactor_ / fastsim::Constants::speedOfLight),
+      eventSimVertices_(&simVertices),
+      firstSimVertexIndex_(0)
 
 {
   // add the main vertex from the signal event to the simvertex collection
@@ -57,6 +59,30 @@ fastsim::ParticleManager::ParticleManager(const HepMC::GenEvent& genEvent,
   }
 }
 
+fastsim::ParticleManager::ParticleManager(const ParticleManager& eventManager,
+                                          std::unique_ptr<Particle> primary,
+                                          std::vector<SimTrack>& simTracks,
+                                          std::vector<SimVertex>& simVertices)
+    : genEvent_(eventManager.genEvent_),
+      genParticleIterator_(eventManager.genParticleEnd_),
+      genParticleEnd_(eventManager.genParticleEnd_),
+      genParticleIndex_(eventManager.genParticleIndex_),
+      particleDataTable_(eventManager.particleDataTable_),
+      beamPipeRadius2_(eventManager.beamPipeRadius2_),
+      deltaRchargedMother_(eventManager.deltaRchargedMother_),
+      particleFilter_(eventManager.particleFilter_),
+      simTracks_(&simTracks),
+      simVertices_(&simVertices),
+      momentumUnitConversionFactor_(eventManager.momentumUnitConversionFactor_),
+      lengthUnitConversionFactor_(eventManager.lengthUnitConversionFactor_),
+      lengthUnitConversionFactor2_(eventManager.lengthUnitConversionFactor2_),
+      timeUnitConversionFactor_(eventManager.timeUnitConversionFactor_),
+      eventSimVertices_(eventManager.simVertices_),
+      firstSimVertexIndex_(eventManager.simVertices_->size()) {
+  // the GenParticles are all taken by the ParticleManager of the event: only the primary and its secondaries
+  particleBuffer_.push_back(std::move(primary));
+}
+
 fastsim::ParticleManager::~ParticleManager() {}
 
 std::unique_ptr<fastsim::Particle> fastsim::ParticleManager::nextParticle(const RandomEngineAndDistribution& random) {
@@ -116,6 +142,14 @@ std::unique_ptr<fastsim::Particle> fastsim::ParticleManager::nextParticle(const
   return particle;
 }
 
+std::vector<std::unique_ptr<fastsim::Particle> > fastsim::ParticleManager::takeGenParticles() {
+  std::vector<std::unique_ptr<Particle> > genParticles;
+  for (std::unique_ptr<Particle> particle = nextGenParticle(); particle != nullptr; particle = nextGenParticle()) {
+    genParticles.push_back(std::move(particle));
+  }
+  return genParticles;
+}
+
 void fastsim::ParticleManager::addSecondaries(const math::XYZTLorentzVector& vertexPosition,
                                               int parentSimTrackIndex,
                                               std::vector<std::unique_ptr<Particle> >& secondaries,
@@ -180,7 +214,7 @@ unsigned fastsim::ParticleManager::addEndVertex(const fastsim::Particle* particl
 }
 
 unsigned fastsim::ParticleManager::addSimVertex(const math::XYZTLorentzVector& position, int parentSimTrackIndex) {
-  int simVertexIndex = simVertices_->size();
+  int simVertexIndex = firstSimVertexIndex_ + simVertices_->size();
   simVertices_->emplace_back(position.Vect(), position.T(), parentSimTrackIndex, simVertexIndex);
   return simVertexIndex;
 }
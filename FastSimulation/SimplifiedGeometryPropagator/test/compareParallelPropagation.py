@@ -0,0 +1,48 @@
+#!/usr/bin/env python
+###############################################################################
+# Compares two runs of runParallelPropagation_cfg.py event by event: the
+# SimTracks, SimVertices and tracker SimHits of two parallel runs (with
+# different numbers of threads) must be identical; for a sequential and a
+# parallel run only the mean multiplicities are meaningful
+#
+#   python compareParallelPropagation.py fastSim4.root fastSim4t1.root
+###############################################################################
+from __future__ import print_function
+import sys
+from DataFormats.FWLite import Events, Handle
+
+if len(sys.argv) != 3:
+    print("usage: compareParallelPropagation.py reference.root parallel.root")
+    sys.exit(1)
+
+track = lambda t: (t.trackId(), t.type(), t.vertIndex(), t.genpartIndex(), t.momentum().e())
+vertex = lambda v: (v.vertexId(), v.parentIndex(), v.position().x(), v.position().y(), v.position().z())
+hit = lambda h: (h.detUnitId(), h.trackId(), h.particleType(), h.tof(), h.energyLoss())
+products = [("SimTracks", "std::vector<SimTrack>", "fastSimProducer", track),
+            ("SimVertices", "std::vector<SimVertex>", "fastSimProducer", vertex),
+            ("TrackerHits", "std::vector<PSimHit>", ("fastSimProducer", "TrackerHits"), hit)]
+handles = [[Handle(cppType) for f in sys.argv[1:]] for name, cppType, label, convert in products]
+
+events = [Events(name) for name in sys.argv[1:]]
+nEvents = 0
+bad = 0
+sizes = [[0, 0] for p in products]
+for ev0, ev1 in zip(events[0], events[1]):
+    nEvents += 1
+    for iProduct, (name, cppType, label, convert) in enumerate(products):
+        content = []
+        for ev, h in zip([ev0, ev1], handles[iProduct]):
+            ev.getByLabel(label, h)
+            content.append([convert(x) for x in h.product()] if h.isValid() else None)
+        for i in range(2):
+            sizes[iProduct][i] += len(content[i] or [])
+        if content[0] != content[1]:
+            bad += 1
+            aux = ev0.eventAuxiliary()
+            print("run %d event %d: %s differ (%d, %d)" % (aux.run(), aux.event(), name,
+                                                         len(content[0] or []), len(content[1] or [])))
+
+for (name, cppType, label, convert), size in zip(products, sizes):
+    print("%-12s per event: %10.2f %10.2f" % (name, size[0] / max(nEvents, 1.), size[1] / max(nEvents, 1.)))
+print("%d events compared, %d products differ" % (nEvents, bad))
+sys.exit(1 if bad else 0)
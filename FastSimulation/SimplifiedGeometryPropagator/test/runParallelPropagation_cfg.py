@@ -0,0 +1,67 @@
+###############################################################################
+# Latency of the FastSim propagation: the same GEN sample is propagated one
+# particle after the other (propagators=0) or with the families of the
+# primary particles in parallel, the SimTracks, SimVertices and SimHits are
+# written out
+#
+#   cmsRun runParallelPropagation_cfg.py inputFiles=file:gen.root propagators=0
+#   cmsRun runParallelPropagation_cfg.py inputFiles=file:gen.root propagators=4 threads=4
+#   cmsRun runParallelPropagation_cfg.py inputFiles=file:gen.root propagators=4 threads=1 tag=t1
+#   python compareParallelPropagation.py fastSim4.root fastSim4t1.root
+#
+# Two parallel runs must give the same products whatever the number of
+# threads; the sequential run only agrees statistically. The CPU and real
+# time per event of fastSimProducer are in the Timing summary
+###############################################################################
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+from Configuration.Eras.Era_Run2_2018_FastSim_cff import Run2_2018_FastSim
+
+options = VarParsing('analysis')
+options.register ("propagators", 4, VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.register ("threads", 4, VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.register ("tag", "", VarParsing.multiplicity.singleton, VarParsing.varType.string)
+options.parseArguments()
+
+process = cms.Process("ParallelPropagation", Run2_2018_FastSim)
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('SimGeneral.HepPDTESSource.pythiapdt_cfi')
+process.load('FastSimulation.Configuration.Geometries_MC_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('FastSimulation.SimplifiedGeometryPropagator.fastSimProducer_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2018_realistic', '')
+
+process.MessageLogger.cerr.FwkReport.reportEvery = 100
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(1)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.Timing = cms.Service("Timing",
+    summaryOnly = cms.untracked.bool(True)
+)
+
+process.fastSimProducer.parallelPropagators = options.propagators
+
+process.out = cms.OutputModule("PoolOutputModule",
+    fileName = cms.untracked.string('fastSim%d%s.root' % (options.propagators, options.tag)),
+    outputCommands = cms.untracked.vstring(
+        'drop *',
+        'keep *_fastSimProducer_*_*'
+    )
+)
+
+process.p = cms.Path(process.fastSimProducer)
+process.e = cms.EndPath(process.out)
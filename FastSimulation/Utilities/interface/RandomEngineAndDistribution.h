@@ -19,6 +19,8 @@ class RandomEngineAndDistribution {
 public:
   RandomEngineAndDistribution(edm::StreamID const&);
   RandomEngineAndDistribution(edm::LuminosityBlockIndex const&);
+  // an engine owned by the caller, e.g. one per particle family in the parallel FastSim propagation
+  explicit RandomEngineAndDistribution(CLHEP::HepRandomEngine& engine) : engine_(&engine) {}
 
   ~RandomEngineAndDistribution();
 
@@ -61,6 +61,12 @@ namespace edm {
     fileSequence_->readOneSpecified(cache, fileNameHash, id);
   }
 
+  void EmbeddedRootSource::readOneEntry(EventPrincipal& cache, size_t& fileNameHash, EntryPosition const& position) {
+    fileSequence_->readOneEntry(cache, fileNameHash, position.file, position.entry);
+  }
+
+  bool EmbeddedRootSource::nextEventNeedsRandomEngine_() const { return fileSequence_->nextEventNeedsRandomEngine(); }
+
   void EmbeddedRootSource::dropUnwantedBranches_(std::vector<std::string> const& wantedBranches) {
     std::vector<std::string> rules;
     rules.reserve(wantedBranches.size() + 1);
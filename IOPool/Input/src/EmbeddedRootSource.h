@@ -58,7 +58,9 @@ namespace edm {
                       EventID const* id,
                       bool recycleFiles) override;
     void readOneSpecified(EventPrincipal& cache, size_t& fileNameHash, SecondaryEventIDAndFileInfo const& id) override;
+    void readOneEntry(EventPrincipal& cache, size_t& fileNameHash, EntryPosition const& position) override;
     void dropUnwantedBranches_(std::vector<std::string> const& wantedBranches) override;
+    bool nextEventNeedsRandomEngine_() const override;
 
     RootServiceChecker rootServiceChecker_;
 
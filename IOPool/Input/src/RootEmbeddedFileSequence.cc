@@ -238,6 +238,30 @@ namespace edm {
     }
   }
 
+  void RootEmbeddedFileSequence::readOneEntry(EventPrincipal& cache,
+                                              size_t& fileNameHash,
+                                              unsigned int file,
+                                              unsigned long long entry) {
+    unsigned int newSeqNumber = file % fileCatalogItems().size();
+    if (!rootFile() || newSeqNumber != sequenceNumberOfFile()) {
+      setAtFileSequenceNumber(newSeqNumber);
+      initFile(false);
+    }
+    assert(rootFile());
+    long long entries = rootFile()->eventTree().entries();
+    if (entries == 0) {
+      throw Exception(errors::NotFound) << "RootEmbeddedFileSequence::readOneEntry(): Secondary Input file "
+                                        << fileName() << " contains no events.\n";
+    }
+    rootFile()->setAtEventEntry(static_cast<long long>(entry % entries) - 1);
+    rootFile()->nextEventEntry();
+    bool found = rootFile()->readCurrentEvent(cache);
+    assert(found);
+    fileNameHash = lfnHash();
+    // a random reading afterwards draws a new file and entry
+    eventsRemainingInFile_ = 0;
+  }
+
   bool RootEmbeddedFileSequence::readOneRandom(
       EventPrincipal& cache, size_t& fileNameHash, CLHEP::HepRandomEngine* engine, EventID const*, bool) {
     assert(rootFile());
@@ -52,6 +52,10 @@ namespace edm {
     bool readOneSequentialWithID(
         EventPrincipal& cache, size_t& fileNameHash, CLHEP::HepRandomEngine*, EventID const* id, bool);
     void readOneSpecified(EventPrincipal& cache, size_t& fileNameHash, SecondaryEventIDAndFileInfo const& id);
+    void readOneEntry(EventPrincipal& cache, size_t& fileNameHash, unsigned int file, unsigned long long entry);
+    // the random reading draws a new file and entry when the current file is exhausted,
+    // and an event of the lumi block for each event when restricted to the same lumi block
+    bool nextEventNeedsRandomEngine() const { return !sequential_ && (sameLumiBlock_ || eventsRemainingInFile_ == 0); }
 
     static void fillDescription(ParameterSetDescription& desc);
 
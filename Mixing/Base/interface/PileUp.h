@@ -1,14 +1,19 @@
 #ifndef Mixing_Base_PileUp_h
 #define Mixing_Base_PileUp_h
 
+#include <algorithm>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "FWCore/Sources/interface/VectorInputSource.h"
+#include "DataFormats/Provenance/interface/BranchID.h"
 #include "DataFormats/Provenance/interface/EventID.h"
+#include "FWCore/Utilities/interface/InputTag.h"
 #include "FWCore/Framework/interface/EventPrincipal.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "Mixing/Base/interface/PileUpEventCache.h"
 
 #include "TRandom.h"
 #include "TFile.h"
@@ -21,9 +26,11 @@ namespace CLHEP {
   class RandPoissonQ;
   class RandPoisson;
   class HepRandomEngine;
+  class MixMaxRng;
 }  // namespace CLHEP
 
 namespace edm {
+  class DelayedReader;
   class SecondaryEventProvider;
   class StreamID;
   class ProcessContext;
@@ -35,6 +42,8 @@ namespace edm {
     double averageNumber_;
     std::shared_ptr<TH1F> histo_;
     const bool playback_;
+    // products of the events shared by the streams, if configured
+    std::shared_ptr<PileUpEventCache> eventCache_;
   };
 
   class PileUp {
@@ -63,6 +72,12 @@ namespace edm {
 
     double averageNumber() const { return averageNumber_; }
     bool poisson() const { return poisson_; }
+    // true if readPileUp reads the events ahead of their use in a parallel task
+    bool prefetch() const { return !prefetchPrincipals_.empty(); }
+    // true if the products of the events are shared with the other streams
+    bool sharedEventCache() const { return eventCache_.get() != nullptr; }
+    // true if the events are drawn from pools shared by nearby signal events
+    bool poolSampling() const { return poolEngine_.get() != nullptr; }
     bool doPileUp(int BX) {
       if (Source_type_ != "cosmics") {
         return none_ ? false : averageNumber_ > 0.;
@@ -73,6 +88,15 @@ namespace edm {
     void dropUnwantedBranches(std::vector<std::string> const& wantedBranches) {
       input_->dropUnwantedBranches(wantedBranches);
     }
+    // products read with the events read ahead: those of the tags, or all of
+    // them if one of the tags has no label
+    void setPrefetchedProducts(std::vector<edm::InputTag> const& tags) {
+      prefetchTags_ = tags;
+      prefetchAllProducts_ =
+          std::any_of(tags.begin(), tags.end(), [](edm::InputTag const& tag) { return tag.label().empty(); });
+      prefetchBranchIDs_.clear();
+      prefetchRegistrySize_ = 0;
+    }
     void beginStream(edm::StreamID);
     void endStream();
 
@@ -100,6 +124,15 @@ namespace edm {
     void input(unsigned int s) { inputType_ = s; }
 
   private:
+    int readPileUpPrefetched(edm::EventID const& signal,
+                             std::function<bool(EventPrincipal const&, size_t)> const& eventOperator,
+                             int const pileEventCnt,
+                             CLHEP::HepRandomEngine* engine);
+    void readPrefetchedProducts(EventPrincipal& cache);
+
+    void startPoolSampling(edm::EventID const& signal);
+    VectorInputSource::EntryPosition nextPoolPosition();
+
     std::unique_ptr<CLHEP::RandPoissonQ> const& poissonDistribution(StreamID const& streamID);
     std::unique_ptr<CLHEP::RandPoisson> const& poissonDistr_OOT(StreamID const& streamID);
     CLHEP::HepRandomEngine* randomEngine(StreamID const& streamID);
@@ -151,6 +184,36 @@ namespace edm {
 
     // sequential reading
     bool sequential_;
+
+    // read-ahead of the pileup events: the events are read and their wanted
+    // products deserialized into a ring of principals while the previous ones
+    // are mixed
+    std::vector<std::unique_ptr<EventPrincipal>> prefetchPrincipals_;
+    std::vector<size_t> prefetchFileNameHashes_;
+    std::vector<edm::InputTag> prefetchTags_;
+    std::vector<BranchID> prefetchBranchIDs_;
+    size_t prefetchRegistrySize_;
+    bool prefetchAllProducts_;
+    // throws when a product that was not read ahead is requested
+    std::unique_ptr<DelayedReader> notPrefetchedReader_;
+
+    // products of the events, shared by the PileUp objects of all the streams
+    std::shared_ptr<PileUpEventCache> eventCache_;
+
+    // With the shared cache, the events of a signal event are drawn from a pool
+    // of poolSize_ consecutive entries, the same for poolSignalEvents_ signal
+    // events in a row, so that the streams working on them read the same events.
+    // The pools and the events are drawn with engines seeded from the seed of the
+    // module and the signal event, whatever the stream reading them.
+    unsigned int poolSize_;
+    unsigned int poolSignalEvents_;
+    unsigned int poolsPerFile_;
+    std::unique_ptr<CLHEP::MixMaxRng> poolEngine_;
+    long poolSeed_;
+    EventID poolSignal_;
+    long poolCalls_;
+    unsigned int poolFile_;
+    unsigned long long poolStart_;
   };
 
   template <typename T>
@@ -194,8 +257,32 @@ namespace edm {
     ids.reserve(pileEventCnt);
     RecordEventID<T> recorder(ids, eventOperator);
     int read = 0;
-    CLHEP::HepRandomEngine* engine = (sequential_ ? nullptr : randomEngine(streamID));
-    read = input_->loopOverEvents(*eventPrincipal_, fileNameHash_, pileEventCnt, recorder, engine, &signal);
+    CLHEP::HepRandomEngine* engine = (sequential_ || poolSampling() ? nullptr : randomEngine(streamID));
+    if (poolSampling()) {
+      startPoolSampling(signal);
+    }
+    if (prefetch()) {
+      read = readPileUpPrefetched(
+          signal,
+          [&recorder](EventPrincipal const& eventPrincipal, size_t fileNameHash) {
+            return recorder(eventPrincipal, fileNameHash);
+          },
+          pileEventCnt,
+          engine);
+    } else if (eventCache_) {
+      auto cached = [this, &recorder](EventPrincipal& eventPrincipal, size_t fileNameHash) {
+        eventCache_->fill(eventPrincipal, fileNameHash);
+        return recorder(eventPrincipal, fileNameHash);
+      };
+      if (poolSampling()) {
+        read = input_->loopOverEntries(
+            *eventPrincipal_, fileNameHash_, pileEventCnt, cached, [this]() { return nextPoolPosition(); });
+      } else {
+        read = input_->loopOverEvents(*eventPrincipal_, fileNameHash_, pileEventCnt, cached, engine, &signal);
+      }
+    } else {
+      read = input_->loopOverEvents(*eventPrincipal_, fileNameHash_, pileEventCnt, recorder, engine, &signal);
+    }
     if (read != pileEventCnt)
       edm::LogWarning("PileUp") << "Could not read enough pileup events: only " << read << " out of " << pileEventCnt
                                 << " requested.";
@@ -208,7 +295,15 @@ namespace edm {
                           T eventOperator) {
     //TrueNumInteractions.push_back( end - begin ) ;
     RecordEventID<T> recorder(ids, eventOperator);
-    input_->loopSpecified(*eventPrincipal_, fileNameHash_, begin, end, recorder);
+    if (eventCache_) {
+      auto cached = [this, &recorder](EventPrincipal& eventPrincipal, size_t fileNameHash) {
+        eventCache_->fill(eventPrincipal, fileNameHash);
+        return recorder(eventPrincipal, fileNameHash);
+      };
+      input_->loopSpecified(*eventPrincipal_, fileNameHash_, begin, end, cached);
+    } else {
+      input_->loopSpecified(*eventPrincipal_, fileNameHash_, begin, end, recorder);
+    }
   }
 
   template <typename T>
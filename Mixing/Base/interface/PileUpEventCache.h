@@ -0,0 +1,100 @@
+#ifndef Mixing_Base_PileUpEventCache_h
+#define Mixing_Base_PileUpEventCache_h
+
+/** \class PileUpEventCache
+ *
+ * Deserialized products of the pileup events of one source, shared by
+ * the PileUp objects of all the streams of a mixing module. The streams
+ * draw the events of nearby signal events from the same pool of entries
+ * (see PileUp), and each still reads the entries of its events through
+ * its own input; only the products of an event already decompressed by
+ * a stream are handed over to the others.
+ *
+ * The cache keeps the last maxEvents events used. An event dropped from
+ * it stays alive as long as a principal holds one of its products.
+ *
+ ************************************************************/
+
+#include "DataFormats/Common/interface/EDProductGetter.h"
+#include "DataFormats/Common/interface/WrapperBase.h"
+#include "DataFormats/Provenance/interface/BranchID.h"
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "DataFormats/Provenance/interface/ProductID.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace edm {
+  class EventPrincipal;
+
+  class PileUpEventCache {
+  public:
+    explicit PileUpEventCache(unsigned int maxEvents);
+    ~PileUpEventCache();
+
+    PileUpEventCache(PileUpEventCache const&) = delete;
+    PileUpEventCache& operator=(PileUpEventCache const&) = delete;
+
+    /// puts into the event just read the products from the cache, reading them first if the event is not there
+    void fill(EventPrincipal& eventPrincipal, size_t fileNameHash);
+
+  private:
+    // products of one event; Refs inside them are resolved against the entry
+    // itself, since the principal which read them moves on to other events
+    class Entry : public EDProductGetter {
+    public:
+      struct Product {
+        ProductID productID;
+        BranchID branchID;
+        std::unique_ptr<WrapperBase> wrapper;
+      };
+
+      explicit Entry(unsigned int transitionIndex) : transition_(transitionIndex) {}
+
+      void insert(ProductID const& pid, BranchID const& bid, std::unique_ptr<WrapperBase> wrapper);
+      std::vector<Product> const& products() const { return products_; }
+
+      WrapperBase const* getIt(ProductID const&) const override;
+      WrapperBase const* getThinnedProduct(ProductID const&, unsigned int&) const override { return nullptr; }
+      void getThinnedProducts(ProductID const&,
+                              std::vector<WrapperBase const*>&,
+                              std::vector<unsigned int>&) const override {}
+
+    private:
+      unsigned int transitionIndex_() const override { return transition_; }
+
+      unsigned int transition_;
+      std::vector<Product> products_;
+    };
+
+    struct Key {
+      size_t fileNameHash;
+      EventID id;
+      bool operator==(Key const& other) const { return fileNameHash == other.fileNameHash && id == other.id; }
+    };
+
+    struct KeyHash {
+      size_t operator()(Key const& key) const;
+    };
+
+    typedef std::list<std::pair<Key, std::shared_ptr<Entry const>>> LRUList;
+
+    std::shared_ptr<Entry const> find(Key const& key);
+    std::shared_ptr<Entry const> insert(Key const& key, std::shared_ptr<Entry const> entry);
+
+    unsigned int const maxEvents_;
+    std::mutex mutex_;
+    LRUList lru_;
+    std::unordered_map<Key, LRUList::iterator, KeyHash> index_;
+
+    std::atomic<unsigned long> hits_;
+    std::atomic<unsigned long> misses_;
+  };
+}  // namespace edm
+
+#endif
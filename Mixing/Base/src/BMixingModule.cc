@@ -167,6 +167,16 @@ namespace {
         }
       }
     }
+    if (pileupconfig) {
+      const edm::ParameterSet& psin = ps.getParameter<edm::ParameterSet>(sourceName);
+      unsigned int cacheEvents = psin.getUntrackedParameter<unsigned int>("sharedCacheEvents", 0);
+      if (cacheEvents > 0) {
+        // the streams at the end of a pool and those at the start of the next one both find their events
+        pileupconfig->eventCache_ = std::make_shared<edm::PileUpEventCache>(2 * cacheEvents);
+        edm::LogInfo("MixingModule") << " Events of source " << sourceName << " are drawn from pools of " << cacheEvents
+                                     << " events whose products are shared by the streams.";
+      }
+    }
     return pileupconfig;
   }
 }  // namespace
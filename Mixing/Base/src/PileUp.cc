@@ -2,7 +2,9 @@
 #include "DataFormats/Provenance/interface/BranchIDListHelper.h"
 #include "DataFormats/Provenance/interface/ModuleDescription.h"
 #include "DataFormats/Provenance/interface/ThinnedAssociationsHelper.h"
+#include "FWCore/Framework/interface/DelayedReader.h"
 #include "FWCore/Framework/interface/EventPrincipal.h"
+#include "FWCore/Framework/interface/ProductResolverBase.h"
 #include "FWCore/Framework/interface/LuminosityBlock.h"
 #include "FWCore/Framework/interface/Run.h"
 #include "FWCore/Framework/src/SignallingProductRegistry.h"
@@ -27,9 +29,16 @@
 #include "CondFormats/DataRecord/interface/MixingRcd.h"
 #include "CondFormats/RunInfo/interface/MixingModuleConfig.h"
 
+#include "CLHEP/Random/MixMaxRng.h"
+#include "CLHEP/Random/RandFlat.h"
 #include "CLHEP/Random/RandPoissonQ.h"
 #include "CLHEP/Random/RandPoisson.h"
 
+#include <boost/functional/hash.hpp>
+
+#include "tbb/pipeline.h"
+#include "tbb/task_arena.h"
+
 #include <algorithm>
 #include <memory>
 #include "TMath.h"
@@ -64,6 +73,40 @@ static Double_t GetRandom(TH1* th1, CLHEP::HepRandomEngine* rng) {
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace edm {
+  namespace {
+    // Reader of a pileup event read ahead, once its wanted products are read:
+    // the input has moved on to the next events and cannot read the others.
+    class NotPrefetchedReader : public DelayedReader {
+    public:
+      explicit NotPrefetchedReader(std::string const& source) : source_(source) {}
+
+      signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* preEventReadFromSourceSignal()
+          const override {
+        return nullptr;
+      }
+      signalslot::Signal<void(StreamContext const&, ModuleCallingContext const&)> const* postEventReadFromSourceSignal()
+          const override {
+        return nullptr;
+      }
+
+    private:
+      std::unique_ptr<WrapperBase> getProduct_(BranchID const& k, EDProductGetter const* ep) override {
+        cms::Exception ex("LogicError");
+        ex << "A product of a pileup event of source " << source_ << " was requested but not read ahead with the event";
+        if (auto const principal = dynamic_cast<EventPrincipal const*>(ep)) {
+          ex << ":\n" << principal->getProductResolver(k)->branchDescription().branchName() << " of event "
+             << principal->id();
+        }
+        ex << ".\nThe digitizers reading it must consume it through the ConsumesCollector they are given.";
+        throw ex;
+      }
+      void mergeReaders_(DelayedReader*) override {}
+      void reset_() override {}
+
+      std::string const source_;
+    };
+  }  // namespace
+
   PileUp::PileUp(ParameterSet const& pset, const std::shared_ptr<PileUpConfig>& config)
       : type_(pset.getParameter<std::string>("type")),
         Source_type_(config->sourcename_),
@@ -91,7 +134,20 @@ namespace edm {
         PoissonDistr_OOT_(),
         randomEngine_(),
         playback_(config->playback_),
-        sequential_(pset.getUntrackedParameter<bool>("sequential", false)) {
+        sequential_(pset.getUntrackedParameter<bool>("sequential", false)),
+        prefetchRegistrySize_(0),
+        prefetchAllProducts_(true),
+        notPrefetchedReader_(std::make_unique<NotPrefetchedReader>(config->sourcename_)),
+        eventCache_(config->eventCache_),
+        poolSize_(pset.getUntrackedParameter<unsigned int>("sharedCacheEvents", 0)),
+        poolSignalEvents_(pset.getUntrackedParameter<unsigned int>("sharedCacheSignalEvents", 10)),
+        poolsPerFile_(pset.getUntrackedParameter<unsigned int>("sharedCachePoolsPerFile", 100)),
+        poolEngine_(),
+        poolSeed_(-1),
+        poolSignal_(),
+        poolCalls_(0),
+        poolFile_(0),
+        poolStart_(0) {
     // Use the empty parameter set for the parameter set ID of our "@MIXING" process.
     processConfiguration_->setParameterSetID(ParameterSet::emptyParameterSetID());
     processContext_->setProcessConfiguration(processConfiguration_.get());
@@ -110,6 +166,40 @@ namespace edm {
                                              *processConfiguration_,
                                              nullptr));
 
+    if (eventCache_ && !playback_) {
+      // each stream reading on from its own position would hardly ever read an event of the others
+      if (sequential_ || pset.getUntrackedParameter<bool>("sameLumiBlock", false)) {
+        throw cms::Exception("Configuration") << "The products of the pileup events of source " << Source_type_
+                                              << " can only be shared by the streams with random reading: please "
+                                                 "remove sharedCacheEvents, sequential or sameLumiBlock.";
+      }
+      if (poolSignalEvents_ == 0 || poolsPerFile_ == 0) {
+        throw cms::Exception("Configuration") << "sharedCacheSignalEvents and sharedCachePoolsPerFile of source "
+                                              << Source_type_ << " must be positive.";
+      }
+      poolEngine_ = std::make_unique<CLHEP::MixMaxRng>();
+    }
+
+    unsigned int prefetchEvents = pset.getUntrackedParameter<unsigned int>("prefetchEvents", 0);
+    if (prefetchEvents > 0 && provider_.get() != nullptr) {
+      edm::LogWarning("MixingModule") << "Pileup events of source " << Source_type_
+                                      << " are not prefetched since producers are run on them";
+      prefetchEvents = 0;
+    }
+    if (prefetchEvents > 0) {
+      // one principal is being mixed while the others are read ahead
+      for (unsigned int i = 0; i <= prefetchEvents; ++i) {
+        prefetchPrincipals_.emplace_back(new EventPrincipal(input_->productRegistry(),
+                                                            std::make_shared<BranchIDListHelper>(),
+                                                            std::make_shared<ThinnedAssociationsHelper>(),
+                                                            *processConfiguration_,
+                                                            nullptr));
+      }
+      prefetchFileNameHashes_.resize(prefetchPrincipals_.size(), 0U);
+      edm::LogInfo("MixingModule") << " Pileup events of source " << Source_type_ << " are read up to "
+                                   << prefetchEvents << " events ahead.";
+    }
+
     bool DB = type_ == "readDB";
 
     if (pset.exists("nbPileupEvents")) {
@@ -325,6 +415,139 @@ namespace edm {
   }
   PileUp::~PileUp() {}
 
+  int PileUp::readPileUpPrefetched(edm::EventID const& signal,
+                                   std::function<bool(EventPrincipal const&, size_t)> const& eventOperator,
+                                   int const pileEventCnt,
+                                   CLHEP::HepRandomEngine* engine) {
+    unsigned int const nSlots = prefetchPrincipals_.size();
+    auto const readAny = [](EventPrincipal const&, size_t) { return true; };
+    int used = 0;
+    bool endOfInput = false;
+    while (used < pileEventCnt && !endOfInput) {
+      int const toRead = pileEventCnt - used;
+      int nRead = 0;
+      int nUsed = 0;
+      // The first filter reads the events in turn into the slots and deserializes
+      // their wanted products, since the delayed reader of the file only knows the
+      // last event read; the second one hands them over in the same order. At
+      // most nSlots events are in flight, so a slot is free when it is reused.
+      //
+      // The digitizers draw from the same engine as the reading when they get
+      // the events: an event whose reading draws random numbers is only read
+      // first in a pipeline, once the previous events have been handed over, so
+      // that the sequence of random numbers, and with it the choice of the
+      // events, is the same as without reading ahead.
+      tbb::this_task_arena::isolate([&] {
+        tbb::parallel_pipeline(
+            nSlots,
+            tbb::make_filter<void, unsigned int>(
+                tbb::filter::serial_in_order,
+                [&](tbb::flow_control& fc) -> unsigned int {
+                  unsigned int const slot = nRead % nSlots;
+                  if (nRead == toRead || (nRead > 0 && engine != nullptr && input_->nextEventNeedsRandomEngine())) {
+                    fc.stop();
+                    return slot;
+                  }
+                  EventPrincipal& cache = *prefetchPrincipals_[slot];
+                  size_t& fileNameHash = prefetchFileNameHashes_[slot];
+                  auto const nextPosition = [this]() { return nextPoolPosition(); };
+                  size_t const nEvents = poolSampling()
+                                             ? input_->loopOverEntries(cache, fileNameHash, 1, readAny, nextPosition)
+                                             : input_->loopOverEvents(cache, fileNameHash, 1, readAny, engine, &signal);
+                  if (nEvents == 0) {
+                    endOfInput = true;
+                    fc.stop();
+                    return slot;
+                  }
+                  if (eventCache_) {
+                    eventCache_->fill(cache, fileNameHash);
+                  } else {
+                    readPrefetchedProducts(cache);
+                  }
+                  ++nRead;
+                  return slot;
+                }) &
+                tbb::make_filter<unsigned int, void>(tbb::filter::serial_in_order, [&](unsigned int slot) {
+                  if (eventOperator(*prefetchPrincipals_[slot], prefetchFileNameHashes_[slot]))
+                    ++nUsed;
+                }));
+      });
+      if (nRead == 0)
+        break;
+      used += nUsed;
+    }
+    return used;
+  }
+
+  void PileUp::readPrefetchedProducts(EventPrincipal& cache) {
+    if (prefetchAllProducts_) {
+      cache.readAllFromSourceAndMergeImmediately();
+      return;
+    }
+    // the branches of the tags, looked up again when a new file adds branches
+    ProductRegistry const& registry = *input_->productRegistry();
+    if (registry.size() != prefetchRegistrySize_) {
+      prefetchRegistrySize_ = registry.size();
+      prefetchBranchIDs_.clear();
+      for (auto const& product : registry.productList()) {
+        BranchDescription const& desc = product.second;
+        if (desc.branchType() != InEvent)
+          continue;
+        for (auto const& tag : prefetchTags_) {
+          if (desc.moduleLabel() == tag.label() && desc.productInstanceName() == tag.instance() &&
+              (tag.process().empty() || desc.processName() == tag.process())) {
+            prefetchBranchIDs_.push_back(desc.branchID());
+            break;
+          }
+        }
+      }
+    }
+    for (auto const& branchID : prefetchBranchIDs_) {
+      auto const resolver = cache.getProductResolver(branchID);
+      if (resolver != nullptr)
+        resolver->retrieveAndMerge(cache, nullptr);
+    }
+    // the reader of the input would read the other products from the event read last
+    cache.setReader(notPrefetchedReader_.get());
+  }
+
+  void PileUp::startPoolSampling(edm::EventID const& signal) {
+    if (poolSeed_ < 0) {
+      // the seed of the module, the same for all the streams
+      Service<RandomNumberGenerator> rng;
+      poolSeed_ = rng->mySeed();
+    }
+    // the bunch crossings of a signal event read their events in turn
+    if (signal != poolSignal_) {
+      poolSignal_ = signal;
+      poolCalls_ = 0;
+    }
+    size_t sourceSeed = std::hash<std::string>()(Source_type_);
+
+    // the pool of the signal event, the pools of a file following each other
+    unsigned long long const pool = signal.event() / poolSignalEvents_;
+    size_t fileSeed = sourceSeed;
+    boost::hash_combine(fileSeed, pool / poolsPerFile_);
+    long fileSeeds[2] = {poolSeed_, static_cast<long>(fileSeed)};
+    poolEngine_->setSeeds(fileSeeds, 2);
+    poolFile_ = static_cast<unsigned int>(*poolEngine_);
+    unsigned long long fileStart = static_cast<unsigned int>(*poolEngine_);
+    fileStart = (fileStart << 32) | static_cast<unsigned int>(*poolEngine_);
+    poolStart_ = fileStart + (pool % poolsPerFile_) * poolSize_;
+
+    // the events of the signal event within the pool
+    size_t eventSeed = sourceSeed;
+    boost::hash_combine(eventSeed, signal.run());
+    boost::hash_combine(eventSeed, signal.luminosityBlock());
+    long eventSeeds[4] = {poolSeed_, static_cast<long>(eventSeed), static_cast<long>(signal.event()), poolCalls_++};
+    poolEngine_->setSeeds(eventSeeds, 4);
+  }
+
+  VectorInputSource::EntryPosition PileUp::nextPoolPosition() {
+    unsigned long long const entry = poolStart_ + CLHEP::RandFlat::shootInt(poolEngine_.get(), poolSize_);
+    return VectorInputSource::EntryPosition{poolFile_, entry};
+  }
+
   std::unique_ptr<CLHEP::RandPoissonQ> const& PileUp::poissonDistribution(StreamID const& streamID) {
     if (!PoissonDistribution_) {
       CLHEP::HepRandomEngine& engine = *randomEngine(streamID);
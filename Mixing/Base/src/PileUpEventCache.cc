@@ -0,0 +1,101 @@
+#include "Mixing/Base/interface/PileUpEventCache.h"
+#include "DataFormats/Provenance/interface/BranchDescription.h"
+#include "DataFormats/Provenance/interface/ProductRegistry.h"
+#include "FWCore/Framework/interface/DelayedReader.h"
+#include "FWCore/Framework/interface/EventPrincipal.h"
+#include "FWCore/Framework/interface/ProductResolverBase.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <boost/functional/hash.hpp>
+
+namespace edm {
+
+  PileUpEventCache::PileUpEventCache(unsigned int maxEvents) : maxEvents_(maxEvents), hits_(0), misses_(0) {}
+
+  PileUpEventCache::~PileUpEventCache() {
+    edm::LogInfo("MixingModule") << "Shared pileup event cache: " << hits_ << " events taken from the cache, "
+                                 << misses_ << " events read.";
+  }
+
+  void PileUpEventCache::Entry::insert(ProductID const& pid,
+                                       BranchID const& bid,
+                                       std::unique_ptr<WrapperBase> wrapper) {
+    products_.push_back(Product{pid, bid, std::move(wrapper)});
+  }
+
+  WrapperBase const* PileUpEventCache::Entry::getIt(ProductID const& pid) const {
+    for (auto const& product : products_) {
+      if (product.productID == pid)
+        return product.wrapper.get();
+    }
+    return nullptr;
+  }
+
+  size_t PileUpEventCache::KeyHash::operator()(Key const& key) const {
+    size_t seed = key.fileNameHash;
+    boost::hash_combine(seed, key.id.run());
+    boost::hash_combine(seed, key.id.luminosityBlock());
+    boost::hash_combine(seed, key.id.event());
+    return seed;
+  }
+
+  void PileUpEventCache::fill(EventPrincipal& eventPrincipal, size_t fileNameHash) {
+    Key const key{fileNameHash, eventPrincipal.id()};
+    std::shared_ptr<Entry const> entry = find(key);
+    if (!entry) {
+      // The products are read with the entry as product getter: the streams
+      // sharing them may dereference their Refs after this principal is cleared.
+      auto newEntry = std::make_shared<Entry>(eventPrincipal.transitionIndex());
+      DelayedReader* reader = eventPrincipal.reader();
+      if (reader != nullptr) {
+        for (auto const& item : eventPrincipal.productRegistry().productList()) {
+          BranchDescription const& desc = item.second;
+          if (desc.branchType() != InEvent || desc.produced() || !desc.present())
+            continue;
+          std::unique_ptr<WrapperBase> edp = reader->getProduct(desc.branchID(), newEntry.get());
+          if (edp.get() != nullptr) {
+            newEntry->insert(eventPrincipal.branchIDToProductID(desc.branchID()), desc.branchID(), std::move(edp));
+          }
+        }
+      }
+      entry = insert(key, std::move(newEntry));
+    }
+    // Each product keeps the whole entry alive, so that it survives the eviction
+    for (auto const& product : entry->products()) {
+      ProductResolverBase* resolver = eventPrincipal.getModifiableProductResolver(product.branchID);
+      if (resolver != nullptr) {
+        resolver->putSharedProduct(std::shared_ptr<WrapperBase const>(entry, product.wrapper.get()));
+      }
+    }
+  }
+
+  std::shared_ptr<PileUpEventCache::Entry const> PileUpEventCache::find(Key const& key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      ++misses_;
+      return std::shared_ptr<Entry const>();
+    }
+    ++hits_;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return lru_.front().second;
+  }
+
+  std::shared_ptr<PileUpEventCache::Entry const> PileUpEventCache::insert(Key const& key,
+                                                                          std::shared_ptr<Entry const> entry) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    // another stream may have read the same event in the meantime
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return lru_.front().second;
+    }
+    lru_.emplace_front(key, std::move(entry));
+    index_.emplace(key, lru_.begin());
+    if (lru_.size() > maxEvents_) {
+      index_.erase(lru_.back().first);
+      lru_.pop_back();
+    }
+    return lru_.front().second;
+  }
+}  // namespace edm
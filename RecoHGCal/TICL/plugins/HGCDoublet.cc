@@ -1,72 +1,24 @@
 #include "HGCDoublet.h"
 
-bool HGCDoublet::checkCompatibilityAndTag(std::vector<HGCDoublet> &allDoublets,
-                                          const std::vector<int> &innerDoublets,
-                                          float minCosTheta,
-                                          float minCosPointing,
-                                          bool debug) {
-  int nDoublets = innerDoublets.size();
-  int constexpr VSIZE = 4;
-  int ok[VSIZE];
-  double xi[VSIZE];
-  double yi[VSIZE];
-  double zi[VSIZE];
-  auto xo = outerX();
-  auto yo = outerY();
-  auto zo = outerZ();
-  unsigned int doubletId = theDoubletId_;
-
-  auto loop = [&](int i, int vs) {
-    for (int j = 0; j < vs; ++j) {
-      auto otherDoubletId = innerDoublets[i + j];
-      auto &otherDoublet = allDoublets[otherDoubletId];
-      xi[j] = otherDoublet.innerX();
-      yi[j] = otherDoublet.innerY();
-      zi[j] = otherDoublet.innerZ();
-    }
-    for (int j = 0; j < vs; ++j) {
-      ok[j] = areAligned(xi[j], yi[j], zi[j], xo, yo, zo, minCosTheta, minCosPointing, debug);
-      if (debug) {
-        LogDebug("HGCDoublet") << "Are aligned for InnerDoubletId: " << i + j << " is " << ok[j] << std::endl;
-      }
-    }
-    for (int j = 0; j < vs; ++j) {
-      auto otherDoubletId = innerDoublets[i + j];
-      auto &otherDoublet = allDoublets[otherDoubletId];
-      if (ok[j]) {
-        otherDoublet.tagAsOuterNeighbor(doubletId);
-        allDoublets[doubletId].tagAsInnerNeighbor(otherDoubletId);
-      }
-    }
-  };
-  auto lim = VSIZE * (nDoublets / VSIZE);
-  for (int i = 0; i < lim; i += VSIZE)
-    loop(i, VSIZE);
-  loop(lim, nDoublets - lim);
-
-  if (debug) {
-    LogDebug("HGCDoublet") << "Found " << innerNeighbors_.size() << " compatible doublets out of " << nDoublets
-                           << " considered" << std::endl;
-  }
-  return innerNeighbors_.empty();
-}
-
-int HGCDoublet::areAligned(double xi,
-                           double yi,
-                           double zi,
-                           double xo,
-                           double yo,
-                           double zo,
-                           float minCosTheta,
-                           float minCosPointing,
-                           bool debug) const {
+bool HGCDoublets::areAligned(double xi,
+                             double yi,
+                             double zi,
+                             double xm,
+                             double ym,
+                             double zm,
+                             double xo,
+                             double yo,
+                             double zo,
+                             float minCosTheta,
+                             float minCosPointing,
+                             bool debug) {
   auto dx1 = xo - xi;
   auto dy1 = yo - yi;
   auto dz1 = zo - zi;
 
-  auto dx2 = innerX() - xi;
-  auto dy2 = innerY() - yi;
-  auto dz2 = innerZ() - zi;
+  auto dx2 = xm - xi;
+  auto dy2 = ym - yi;
+  auto dz2 = zm - zi;
 
   // inner product
   auto dot = dx1 * dx2 + dy1 * dy2 + dz1 * dz2;
@@ -96,14 +48,3 @@ int HGCDoublet::areAligned(double xi,
 
   return (cosTheta > minCosTheta) && (cosTheta_pointing > minCosPointing);
 }
-
-void HGCDoublet::findNtuplets(std::vector<HGCDoublet> &allDoublets, HGCntuplet &tmpNtuplet) {
-  if (!alreadyVisited_) {
-    alreadyVisited_ = true;
-    tmpNtuplet.push_back(theDoubletId_);
-    unsigned int numberOfOuterNeighbors = outerNeighbors_.size();
-    for (unsigned int i = 0; i < numberOfOuterNeighbors; ++i) {
-      allDoublets[outerNeighbors_[i]].findNtuplets(allDoublets, tmpNtuplet);
-    }
-  }
-}
@@ -8,87 +8,70 @@
 #include <vector>
 
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
-#include "DataFormats/CaloRecHit/interface/CaloCluster.h"
 
-class HGCDoublet {
+// The doublets of layer clusters of the HGCGraph, as a structure of arrays.
+// The inner neighbors of a doublet are the aligned doublets whose outer
+// cluster is its inner cluster, and its outer neighbors are the doublets of
+// which it is an inner neighbor. Both are stored as ranges of flat arrays,
+// in increasing order of the doublet ids.
+class HGCDoublets {
 public:
   using HGCntuplet = std::vector<unsigned int>;
 
-  HGCDoublet(const int innerClusterId,
-             const int outerClusterId,
-             const int doubletId,
-             const std::vector<reco::CaloCluster> *layerClusters)
-      : layerClusters_(layerClusters),
-        theDoubletId_(doubletId),
-        innerClusterId_(innerClusterId),
-        outerClusterId_(outerClusterId),
-        innerR_((*layerClusters)[innerClusterId].position().r()),
-        outerR_((*layerClusters)[outerClusterId].position().r()),
-        innerX_((*layerClusters)[innerClusterId].x()),
-        outerX_((*layerClusters)[outerClusterId].x()),
-        innerY_((*layerClusters)[innerClusterId].y()),
-        outerY_((*layerClusters)[outerClusterId].y()),
-        innerZ_((*layerClusters)[innerClusterId].z()),
-        outerZ_((*layerClusters)[outerClusterId].z()),
-        alreadyVisited_(false) {}
-
-  double innerX() const { return innerX_; }
-
-  double outerX() const { return outerX_; }
-
-  double innerY() const { return innerY_; }
-
-  double outerY() const { return outerY_; }
-
-  double innerZ() const { return innerZ_; }
-
-  double outerZ() const { return outerZ_; }
-
-  double innerR() const { return innerR_; }
-
-  double outerR() const { return outerZ_; }
-
-  int innerClusterId() const { return innerClusterId_; }
-
-  int outerClusterId() const { return outerClusterId_; }
-
-  void tagAsOuterNeighbor(unsigned int otherDoublet) { outerNeighbors_.push_back(otherDoublet); }
-
-  void tagAsInnerNeighbor(unsigned int otherDoublet) { innerNeighbors_.push_back(otherDoublet); }
-
-  bool checkCompatibilityAndTag(
-      std::vector<HGCDoublet> &, const std::vector<int> &, float, float minCosPointing = 1., bool debug = false);
-
-  int areAligned(double xi,
-                 double yi,
-                 double zi,
-                 double xo,
-                 double yo,
-                 double zo,
-                 float minCosTheta,
-                 float minCosPointing,
-                 bool debug = false) const;
-
-  void findNtuplets(std::vector<HGCDoublet> &, HGCntuplet &);
+  unsigned int size() const { return innerClusterId_.size(); }
+
+  int innerClusterId(unsigned int doubletId) const { return innerClusterId_[doubletId]; }
+
+  int outerClusterId(unsigned int doubletId) const { return outerClusterId_[doubletId]; }
+
+  const unsigned int *innerNeighborsBegin(unsigned int doubletId) const {
+    return innerNeighbors_.data() + innerNeighborsOffset_[doubletId];
+  }
+  const unsigned int *innerNeighborsEnd(unsigned int doubletId) const {
+    return innerNeighbors_.data() + innerNeighborsOffset_[doubletId + 1];
+  }
+
+  const unsigned int *outerNeighborsBegin(unsigned int doubletId) const {
+    return outerNeighbors_.data() + outerNeighborsOffset_[doubletId];
+  }
+  const unsigned int *outerNeighborsEnd(unsigned int doubletId) const {
+    return outerNeighbors_.data() + outerNeighborsOffset_[doubletId + 1];
+  }
+
+  void clear() {
+    innerClusterId_.clear();
+    outerClusterId_.clear();
+    innerNeighborsOffset_.clear();
+    innerNeighbors_.clear();
+    outerNeighborsOffset_.clear();
+    outerNeighbors_.clear();
+  }
+
+  // Alignment of the doublet (xm, ym, zm)->(xo, yo, zo) with the inner
+  // doublet (xi, yi, zi)->(xm, ym, zm), and pointing of the inner doublet
+  // to the origin
+  static bool areAligned(double xi,
+                         double yi,
+                         double zi,
+                         double xm,
+                         double ym,
+                         double zm,
+                         double xo,
+                         double yo,
+                         double zo,
+                         float minCosTheta,
+                         float minCosPointing,
+                         bool debug = false);
 
 private:
-  const std::vector<reco::CaloCluster> *layerClusters_;
-  std::vector<int> outerNeighbors_;
-  std::vector<int> innerNeighbors_;
-
-  const int theDoubletId_;
-  const int innerClusterId_;
-  const int outerClusterId_;
-
-  const double innerR_;
-  const double outerR_;
-  const double innerX_;
-  const double outerX_;
-  const double innerY_;
-  const double outerY_;
-  const double innerZ_;
-  const double outerZ_;
-  bool alreadyVisited_;
+  friend class HGCGraph;
+
+  std::vector<int> innerClusterId_;
+  std::vector<int> outerClusterId_;
+  std::vector<unsigned int> innerNeighborsOffset_;
+  std::vector<unsigned int> innerNeighbors_;
+  std::vector<unsigned int> outerNeighborsOffset_;
+  std::vector<unsigned int> outerNeighbors_;
 };
 
 #endif /*HGCDoublet_H_ */
@@ -1,5 +1,11 @@
 // Author: Felice Pantaleo - felice.pantaleo@cern.ch
 // Date: 11/2018
+#include <algorithm>
+#include <limits>
+
+#include "tbb/task_arena.h"
+#include "tbb/tbb.h"
+
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "DataFormats/HGCalReco/interface/Common.h"
 #include "PatternRecognitionbyCA.h"
@@ -20,78 +26,213 @@ void HGCGraph::makeAndConnectDoublets(const TICLLayerTiles &histo,
                                       int missing_layers,
                                       int maxNumberOfLayers,
                                       float maxDeltaTime) {
-  isOuterClusterOfDoublets_.clear();
-  isOuterClusterOfDoublets_.resize(layerClusters.size());
   allDoublets_.clear();
   theRootDoublets_.clear();
-  for (int zSide = 0; zSide < 2; ++zSide) {
-    for (int il = 0; il < maxNumberOfLayers - 1; ++il) {
-      for (int outer_layer = 0; outer_layer < std::min(1 + missing_layers, maxNumberOfLayers - 1 - il); ++outer_layer) {
-        int currentInnerLayerId = il + maxNumberOfLayers * zSide;
-        int currentOuterLayerId = currentInnerLayerId + 1 + outer_layer;
-        auto const &outerLayerHisto = histo[currentOuterLayerId];
-        auto const &innerLayerHisto = histo[currentInnerLayerId];
-
-        for (int oeta = 0; oeta < nEtaBins; ++oeta) {
-          auto offset = oeta * nPhiBins;
-          for (int ophi = 0; ophi < nPhiBins; ++ophi) {
-            for (auto outerClusterId : outerLayerHisto[offset + ophi]) {
-              // Skip masked clusters
-              if (mask[outerClusterId] == 0.)
-                continue;
-              const auto etaRangeMin = std::max(0, oeta - deltaIEta);
-              const auto etaRangeMax = std::min(oeta + deltaIEta, nEtaBins);
-
-              for (int ieta = etaRangeMin; ieta < etaRangeMax; ++ieta) {
-                // wrap phi bin
-                for (int phiRange = 0; phiRange < 2 * deltaIPhi + 1; ++phiRange) {
-                  // The first wrapping is to take into account the
-                  // cases in which we would have to seach in
-                  // negative bins. The second wrap is mandatory to
-                  // account for all other cases, since we add in
-                  // between a full nPhiBins slot.
-                  auto iphi = ((ophi + phiRange - deltaIPhi) % nPhiBins + nPhiBins) % nPhiBins;
-                  for (auto innerClusterId : innerLayerHisto[ieta * nPhiBins + iphi]) {
-                    // Skip masked clusters
-                    if (mask[innerClusterId] == 0.)
-                      continue;
-                    auto doubletId = allDoublets_.size();
-                    if (maxDeltaTime != -1 &&
-                        !areTimeCompatible(innerClusterId, outerClusterId, layerClustersTime, maxDeltaTime))
-                      continue;
-                    allDoublets_.emplace_back(innerClusterId, outerClusterId, doubletId, &layerClusters);
-                    if (verbosity_ > Advanced) {
-                      LogDebug("HGCGraph")
-                          << "Creating doubletsId: " << doubletId << " layerLink in-out: [" << currentInnerLayerId
-                          << ", " << currentOuterLayerId << "] clusterLink in-out: [" << innerClusterId << ", "
-                          << outerClusterId << "]" << std::endl;
-                    }
-                    isOuterClusterOfDoublets_[outerClusterId].push_back(doubletId);
-                    auto &neigDoublets = isOuterClusterOfDoublets_[innerClusterId];
-                    auto &thisDoublet = allDoublets_[doubletId];
-                    if (verbosity_ > Expert) {
-                      LogDebug("HGCGraph")
-                          << "Checking compatibility of doubletId: " << doubletId
-                          << " with all possible inners doublets link by the innerClusterId: " << innerClusterId
-                          << std::endl;
-                    }
-                    bool isRootDoublet = thisDoublet.checkCompatibilityAndTag(
-                        allDoublets_, neigDoublets, minCosTheta, minCosPointing, verbosity_ > Advanced);
-                    if (isRootDoublet)
-                      theRootDoublets_.push_back(doubletId);
-                  }
-                }
+
+  const unsigned int nClusters = layerClusters.size();
+  clusterX_.resize(nClusters);
+  clusterY_.resize(nClusters);
+  clusterZ_.resize(nClusters);
+  for (unsigned int i = 0; i < nClusters; ++i) {
+    clusterX_[i] = layerClusters[i].x();
+    clusterY_[i] = layerClusters[i].y();
+    clusterZ_[i] = layerClusters[i].z();
+  }
+
+  // units of work: for each endcap and inner layer, each outer layer and eta
+  // row of the outer tiles, in the order in which the doublets are numbered
+  nLayerPairsPerSide_ = std::max(0, maxNumberOfLayers - 1);
+  const int nOuterLayers = 1 + missing_layers;
+  const unsigned int nUnitsPerLayerPair = nOuterLayers * nEtaBins;
+  const unsigned int nUnits = 2 * nLayerPairsPerSide_ * nUnitsPerLayerPair;
+  units_.resize(nUnits);
+
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(0u, nUnits, [&](unsigned int iUnit) {
+      auto &unit = units_[iUnit];
+      unit.innerClusterId.clear();
+      unit.outerClusterId.clear();
+
+      const int oeta = iUnit % nEtaBins;
+      const int outer_layer = (iUnit / nEtaBins) % nOuterLayers;
+      const int layerPair = iUnit / nUnitsPerLayerPair;
+      const int zSide = layerPair / nLayerPairsPerSide_;
+      const int il = layerPair % nLayerPairsPerSide_;
+      if (outer_layer >= std::min(1 + missing_layers, maxNumberOfLayers - 1 - il))
+        return;
+
+      int currentInnerLayerId = il + maxNumberOfLayers * zSide;
+      int currentOuterLayerId = currentInnerLayerId + 1 + outer_layer;
+      auto const &outerLayerHisto = histo[currentOuterLayerId];
+      auto const &innerLayerHisto = histo[currentInnerLayerId];
+
+      auto offset = oeta * nPhiBins;
+      for (int ophi = 0; ophi < nPhiBins; ++ophi) {
+        for (auto outerClusterId : outerLayerHisto[offset + ophi]) {
+          // Skip masked clusters
+          if (mask[outerClusterId] == 0.)
+            continue;
+          const auto etaRangeMin = std::max(0, oeta - deltaIEta);
+          const auto etaRangeMax = std::min(oeta + deltaIEta, nEtaBins);
+
+          for (int ieta = etaRangeMin; ieta < etaRangeMax; ++ieta) {
+            // wrap phi bin
+            for (int phiRange = 0; phiRange < 2 * deltaIPhi + 1; ++phiRange) {
+              // The first wrapping is to take into account the
+              // cases in which we would have to seach in
+              // negative bins. The second wrap is mandatory to
+              // account for all other cases, since we add in
+              // between a full nPhiBins slot.
+              auto iphi = ((ophi + phiRange - deltaIPhi) % nPhiBins + nPhiBins) % nPhiBins;
+              for (auto innerClusterId : innerLayerHisto[ieta * nPhiBins + iphi]) {
+                // Skip masked clusters
+                if (mask[innerClusterId] == 0.)
+                  continue;
+                if (maxDeltaTime != -1 &&
+                    !areTimeCompatible(innerClusterId, outerClusterId, layerClustersTime, maxDeltaTime))
+                  continue;
+                unit.innerClusterId.push_back(innerClusterId);
+                unit.outerClusterId.push_back(outerClusterId);
               }
             }
           }
         }
       }
+    });
+  });
+
+  // number the doublets
+  unitOffsets_.resize(nUnits + 1);
+  unitOffsets_[0] = 0;
+  for (unsigned int iUnit = 0; iUnit < nUnits; ++iUnit)
+    unitOffsets_[iUnit + 1] = unitOffsets_[iUnit] + units_[iUnit].innerClusterId.size();
+  const unsigned int nDoublets = unitOffsets_[nUnits];
+
+  layerPairOffsets_.resize(2 * nLayerPairsPerSide_ + 1);
+  for (int layerPair = 0; layerPair <= 2 * nLayerPairsPerSide_; ++layerPair)
+    layerPairOffsets_[layerPair] = unitOffsets_[layerPair * nUnitsPerLayerPair];
+
+  allDoublets_.innerClusterId_.resize(nDoublets);
+  allDoublets_.outerClusterId_.resize(nDoublets);
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(0u, nUnits, [&](unsigned int iUnit) {
+      const auto &unit = units_[iUnit];
+      std::copy(unit.innerClusterId.begin(),
+                unit.innerClusterId.end(),
+                allDoublets_.innerClusterId_.begin() + unitOffsets_[iUnit]);
+      std::copy(unit.outerClusterId.begin(),
+                unit.outerClusterId.end(),
+                allDoublets_.outerClusterId_.begin() + unitOffsets_[iUnit]);
+    });
+  });
+
+  if (verbosity_ > Advanced) {
+    for (unsigned int doubletId = 0; doubletId < nDoublets; ++doubletId) {
+      LogDebug("HGCGraph") << "Creating doubletsId: " << doubletId << " clusterLink in-out: ["
+                           << allDoublets_.innerClusterId_[doubletId] << ", " << allDoublets_.outerClusterId_[doubletId]
+                           << "]" << std::endl;
+    }
+  }
+
+  // doublets ending on each cluster: the doublets ending on the inner cluster
+  // of a doublet all come from previous layers, and have smaller ids
+  outerClusterOffsets_.assign(nClusters + 1, 0);
+  for (unsigned int doubletId = 0; doubletId < nDoublets; ++doubletId)
+    ++outerClusterOffsets_[allDoublets_.outerClusterId_[doubletId] + 1];
+  for (unsigned int i = 0; i < nClusters; ++i)
+    outerClusterOffsets_[i + 1] += outerClusterOffsets_[i];
+  doubletsByOuterCluster_.resize(nDoublets);
+  {
+    std::vector<unsigned int> fillPosition(outerClusterOffsets_.begin(), outerClusterOffsets_.end() - 1);
+    for (unsigned int doubletId = 0; doubletId < nDoublets; ++doubletId)
+      doubletsByOuterCluster_[fillPosition[allDoublets_.outerClusterId_[doubletId]]++] = doubletId;
+  }
+
+  // alignment of each doublet with the doublets ending on its inner cluster
+  candidatesOffset_.resize(nDoublets + 1);
+  candidatesOffset_[0] = 0;
+  for (unsigned int doubletId = 0; doubletId < nDoublets; ++doubletId) {
+    const int innerClusterId = allDoublets_.innerClusterId_[doubletId];
+    candidatesOffset_[doubletId + 1] = candidatesOffset_[doubletId] + outerClusterOffsets_[innerClusterId + 1] -
+                                       outerClusterOffsets_[innerClusterId];
+  }
+  aligned_.resize(candidatesOffset_[nDoublets]);
+
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nDoublets), [&](const tbb::blocked_range<unsigned int> &r) {
+      for (unsigned int doubletId = r.begin(); doubletId < r.end(); ++doubletId) {
+        const int innerClusterId = allDoublets_.innerClusterId_[doubletId];
+        const int outerClusterId = allDoublets_.outerClusterId_[doubletId];
+        const double xm = clusterX_[innerClusterId];
+        const double ym = clusterY_[innerClusterId];
+        const double zm = clusterZ_[innerClusterId];
+        const double xo = clusterX_[outerClusterId];
+        const double yo = clusterY_[outerClusterId];
+        const double zo = clusterZ_[outerClusterId];
+        if (verbosity_ > Expert) {
+          LogDebug("HGCGraph") << "Checking compatibility of doubletId: " << doubletId
+                               << " with all possible inners doublets link by the innerClusterId: " << innerClusterId
+                               << std::endl;
+        }
+        const unsigned int *candidates = doubletsByOuterCluster_.data() + outerClusterOffsets_[innerClusterId];
+        uint8_t *ok = aligned_.data() + candidatesOffset_[doubletId];
+        const unsigned int nCandidates = candidatesOffset_[doubletId + 1] - candidatesOffset_[doubletId];
+        for (unsigned int j = 0; j < nCandidates; ++j) {
+          const int otherInnerClusterId = allDoublets_.innerClusterId_[candidates[j]];
+          ok[j] = HGCDoublets::areAligned(clusterX_[otherInnerClusterId],
+                                          clusterY_[otherInnerClusterId],
+                                          clusterZ_[otherInnerClusterId],
+                                          xm,
+                                          ym,
+                                          zm,
+                                          xo,
+                                          yo,
+                                          zo,
+                                          minCosTheta,
+                                          minCosPointing,
+                                          verbosity_ > Advanced);
+        }
+      }
+    });
+  });
+
+  // inner and outer neighbors, and root doublets
+  auto &innerOffset = allDoublets_.innerNeighborsOffset_;
+  auto &outerOffset = allDoublets_.outerNeighborsOffset_;
+  innerOffset.resize(nDoublets + 1);
+  innerOffset[0] = 0;
+  outerOffset.assign(nDoublets + 1, 0);
+  allDoublets_.innerNeighbors_.clear();
+  for (unsigned int doubletId = 0; doubletId < nDoublets; ++doubletId) {
+    const unsigned int *candidates =
+        doubletsByOuterCluster_.data() + outerClusterOffsets_[allDoublets_.innerClusterId_[doubletId]];
+    for (unsigned int c = candidatesOffset_[doubletId]; c < candidatesOffset_[doubletId + 1]; ++c) {
+      if (aligned_[c]) {
+        const unsigned int otherDoubletId = candidates[c - candidatesOffset_[doubletId]];
+        allDoublets_.innerNeighbors_.push_back(otherDoubletId);
+        ++outerOffset[otherDoubletId + 1];
+      }
     }
+    innerOffset[doubletId + 1] = allDoublets_.innerNeighbors_.size();
+    if (innerOffset[doubletId + 1] == innerOffset[doubletId])
+      theRootDoublets_.push_back(doubletId);
   }
+  for (unsigned int doubletId = 0; doubletId < nDoublets; ++doubletId)
+    outerOffset[doubletId + 1] += outerOffset[doubletId];
+  allDoublets_.outerNeighbors_.resize(outerOffset[nDoublets]);
+  {
+    std::vector<unsigned int> fillPosition(outerOffset.begin(), outerOffset.end() - 1);
+    for (unsigned int doubletId = 0; doubletId < nDoublets; ++doubletId) {
+      for (auto it = allDoublets_.innerNeighborsBegin(doubletId); it != allDoublets_.innerNeighborsEnd(doubletId);
+           ++it)
+        allDoublets_.outerNeighbors_[fillPosition[*it]++] = doubletId;
+    }
+  }
+
   // #ifdef FP_DEBUG
   if (verbosity_ > None) {
     LogDebug("HGCGraph") << "number of Root doublets " << theRootDoublets_.size() << " over a total number of doublets "
-                         << allDoublets_.size() << std::endl;
+                         << nDoublets << std::endl;
   }
   // #endif
 }
@@ -99,22 +240,63 @@ void HGCGraph::makeAndConnectDoublets(const TICLLayerTiles &histo,
 bool HGCGraph::areTimeCompatible(int innerIdx,
                                  int outerIdx,
                                  const edm::ValueMap<float> &layerClustersTime,
-                                 float maxDeltaTime) {
+                                 float maxDeltaTime) const {
   float timeIn = layerClustersTime.get(innerIdx);
   float timeOut = layerClustersTime.get(outerIdx);
 
   return (timeIn == -99 || timeOut == -99 || std::abs(timeIn - timeOut) < maxDeltaTime);
 }
 
-void HGCGraph::findNtuplets(std::vector<HGCDoublet::HGCntuplet> &foundNtuplets,
+void HGCGraph::findNtuplets(std::vector<HGCDoublets::HGCntuplet> &foundNtuplets,
                             const unsigned int minClustersPerNtuplet) {
-  HGCDoublet::HGCntuplet tmpNtuplet;
-  tmpNtuplet.reserve(minClustersPerNtuplet);
-  for (auto rootDoublet : theRootDoublets_) {
-    tmpNtuplet.clear();
-    allDoublets_[rootDoublet].findNtuplets(allDoublets_, tmpNtuplet);
-    if (tmpNtuplet.size() > minClustersPerNtuplet) {
-      foundNtuplets.push_back(tmpNtuplet);
+  // A doublet belongs to the ntuplet of the first root doublet from which it
+  // can be reached through outer neighbors, i.e. the root of smallest index
+  // among the roots of its inner neighbors. The inner neighbors of a doublet
+  // start on a previous layer, so the roots are propagated one layer at a
+  // time, in parallel within each layer.
+  const unsigned int nDoublets = allDoublets_.size();
+  const unsigned int nRoots = theRootDoublets_.size();
+  rootOfDoublet_.resize(nDoublets);
+  for (unsigned int iRoot = 0; iRoot < nRoots; ++iRoot)
+    rootOfDoublet_[theRootDoublets_[iRoot]] = iRoot;
+
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(0, 2, [&](int zSide) {
+      for (int il = 0; il < nLayerPairsPerSide_; ++il) {
+        const int layerPair = il + nLayerPairsPerSide_ * zSide;
+        tbb::parallel_for(
+            tbb::blocked_range<unsigned int>(layerPairOffsets_[layerPair], layerPairOffsets_[layerPair + 1]),
+            [&](const tbb::blocked_range<unsigned int> &r) {
+              for (unsigned int doubletId = r.begin(); doubletId < r.end(); ++doubletId) {
+                auto it = allDoublets_.innerNeighborsBegin(doubletId);
+                auto end = allDoublets_.innerNeighborsEnd(doubletId);
+                if (it == end)
+                  continue;
+                unsigned int root = std::numeric_limits<unsigned int>::max();
+                for (; it != end; ++it)
+                  root = std::min(root, rootOfDoublet_[*it]);
+                rootOfDoublet_[doubletId] = root;
+              }
+            });
+      }
+    });
+  });
+
+  // group the doublets by root, in increasing order
+  std::vector<unsigned int> rootOffsets(nRoots + 1, 0);
+  for (unsigned int doubletId = 0; doubletId < nDoublets; ++doubletId)
+    ++rootOffsets[rootOfDoublet_[doubletId] + 1];
+  for (unsigned int iRoot = 0; iRoot < nRoots; ++iRoot)
+    rootOffsets[iRoot + 1] += rootOffsets[iRoot];
+  std::vector<unsigned int> doubletsByRoot(nDoublets);
+  std::vector<unsigned int> fillPosition(rootOffsets.begin(), rootOffsets.end() - 1);
+  for (unsigned int doubletId = 0; doubletId < nDoublets; ++doubletId)
+    doubletsByRoot[fillPosition[rootOfDoublet_[doubletId]]++] = doubletId;
+
+  for (unsigned int iRoot = 0; iRoot < nRoots; ++iRoot) {
+    if (rootOffsets[iRoot + 1] - rootOffsets[iRoot] > minClustersPerNtuplet) {
+      foundNtuplets.emplace_back(doubletsByRoot.begin() + rootOffsets[iRoot],
+                                 doubletsByRoot.begin() + rootOffsets[iRoot + 1]);
     }
   }
 }
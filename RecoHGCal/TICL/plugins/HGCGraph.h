@@ -4,11 +4,20 @@
 #ifndef __RecoHGCal_TICL_HGCGraph_H__
 #define __RecoHGCal_TICL_HGCGraph_H__
 
+#include <cstdint>
 #include <vector>
+#include "DataFormats/CaloRecHit/interface/CaloCluster.h"
+#include "DataFormats/Common/interface/ValueMap.h"
 #include "DataFormats/HGCalReco/interface/Common.h"
 #include "DataFormats/HGCalReco/interface/TICLLayerTile.h"
 #include "HGCDoublet.h"
 
+// The doublets are made in parallel, for each endcap, pair of layers and eta
+// row of the tiles of the outer layer, and numbered in that order. Their
+// alignment with the doublets that end on their inner cluster is also
+// checked in parallel. The ntuplets are the sets of doublets that are first
+// reached from the same root doublet, which are found by propagating the
+// root doublets outwards, one layer at a time.
 class HGCGraph {
 public:
   void makeAndConnectDoublets(const TICLLayerTiles &h,
@@ -25,25 +34,52 @@ public:
                               int maxNumberOfLayers,
                               float maxDeltaTime);
 
-  bool areTimeCompatible(int innerIdx, int outerIdx, const edm::ValueMap<float> &layerClustersTime, float maxDeltaTime);
+  bool areTimeCompatible(int innerIdx,
+                         int outerIdx,
+                         const edm::ValueMap<float> &layerClustersTime,
+                         float maxDeltaTime) const;
 
-  std::vector<HGCDoublet> &getAllDoublets() { return allDoublets_; }
-  void findNtuplets(std::vector<HGCDoublet::HGCntuplet> &foundNtuplets, const unsigned int minClustersPerNtuplet);
+  const HGCDoublets &getAllDoublets() const { return allDoublets_; }
+  void findNtuplets(std::vector<HGCDoublets::HGCntuplet> &foundNtuplets, const unsigned int minClustersPerNtuplet);
   void clear() {
     allDoublets_.clear();
     theRootDoublets_.clear();
-    theNtuplets_.clear();
-    isOuterClusterOfDoublets_.clear();
+    layerPairOffsets_.clear();
   }
   void setVerbosity(int level) { verbosity_ = level; }
   enum VerbosityLevel { None = 0, Basic, Advanced, Expert, Guru };
 
 private:
-  std::vector<HGCDoublet> allDoublets_;
+  HGCDoublets allDoublets_;
   std::vector<unsigned int> theRootDoublets_;
-  std::vector<std::vector<HGCDoublet *>> theNtuplets_;
-  std::vector<std::vector<int>> isOuterClusterOfDoublets_;
   int verbosity_;
+
+  // clusters of the doublets made in one unit of work, in order
+  struct UnitDoublets {
+    std::vector<int> innerClusterId;
+    std::vector<int> outerClusterId;
+  };
+  std::vector<UnitDoublets> units_;
+  std::vector<unsigned int> unitOffsets_;
+  // first doublet of each endcap and inner layer
+  std::vector<unsigned int> layerPairOffsets_;
+  int nLayerPairsPerSide_ = 0;
+
+  // positions of the layer clusters
+  std::vector<double> clusterX_;
+  std::vector<double> clusterY_;
+  std::vector<double> clusterZ_;
+
+  // doublets ending on each cluster, in increasing order
+  std::vector<unsigned int> outerClusterOffsets_;
+  std::vector<unsigned int> doubletsByOuterCluster_;
+
+  // alignment of each doublet with the doublets ending on its inner cluster
+  std::vector<unsigned int> candidatesOffset_;
+  std::vector<uint8_t> aligned_;
+
+  // index of the root doublet that first reaches each doublet
+  std::vector<unsigned int> rootOfDoublet_;
 };
 
 #endif
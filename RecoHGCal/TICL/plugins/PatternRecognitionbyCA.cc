@@ -35,7 +35,7 @@ void PatternRecognitionbyCA::makeTracksters(const edm::Event &ev,
   if (algo_verbosity_ > None) {
     LogDebug("HGCPatterRecoByCA") << "Making Tracksters with CA" << std::endl;
   }
-  std::vector<HGCDoublet::HGCntuplet> foundNtuplets;
+  std::vector<HGCDoublets::HGCntuplet> foundNtuplets;
   std::vector<uint8_t> layer_cluster_usage(layerClusters.size(), 0);
   theGraph_->makeAndConnectDoublets(tiles,
                                     ticl::constants::nEtaBins,
@@ -57,8 +57,8 @@ void PatternRecognitionbyCA::makeTracksters(const edm::Event &ev,
   for (auto const &ntuplet : foundNtuplets) {
     std::set<unsigned int> effective_cluster_idx;
     for (auto const &doublet : ntuplet) {
-      auto innerCluster = doublets[doublet].innerClusterId();
-      auto outerCluster = doublets[doublet].outerClusterId();
+      auto innerCluster = doublets.innerClusterId(doublet);
+      auto outerCluster = doublets.outerClusterId(doublet);
       effective_cluster_idx.insert(innerCluster);
       effective_cluster_idx.insert(outerCluster);
       if (algo_verbosity_ > Advanced) {
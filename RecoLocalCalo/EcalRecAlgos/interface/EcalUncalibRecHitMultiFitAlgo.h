@@ -28,6 +28,21 @@ public:
                                     const FullSampleVector &fullpulse,
                                     const FullSampleMatrix &fullpulsecov,
                                     const BXVector &activeBX);
+  /// samples and noise covariance of the channels that can be fitted with PulseChiSqSNNLSBatch
+  /// (all samples in gain 12, static pedestals, no prefit and no uncertainty calculation),
+  /// returns false for the channels that need makeRecHit
+  bool batchedFitInputs(const EcalDataFrame &dataFrame,
+                        const EcalPedestals::Item *aped,
+                        const SampleMatrixGainArray &noisecors,
+                        SampleVector &amplitudes,
+                        SampleMatrix &noisecov) const;
+  /// rechit from the result of the batched fit, with the amplitudes in the order of activeBX
+  EcalUncalibratedRecHit makeRecHit(const EcalDataFrame &dataFrame,
+                                    const EcalPedestals::Item *aped,
+                                    const BXVector &activeBX,
+                                    const double *fitAmplitudes,
+                                    double chisq,
+                                    bool status) const;
   void disableErrorCalculation() { _computeErrors = false; }
   void setDoPrefit(bool b) { _doPrefit = b; }
   void setPrefitMaxChiSq(double x) { _prefitMaxChiSq = x; }
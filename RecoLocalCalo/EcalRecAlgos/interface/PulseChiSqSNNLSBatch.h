@@ -0,0 +1,98 @@
+#ifndef RecoLocalCalo_EcalRecAlgos_PulseChiSqSNNLSBatch_h
+#define RecoLocalCalo_EcalRecAlgos_PulseChiSqSNNLSBatch_h
+
+/** \class PulseChiSqSNNLSBatch
+  *  Multi-channel version of the PulseChiSqSNNLS fit.
+  *
+  *  The channels are fitted kLanes at a time, as fixed-size (SampleVectorSize x SampleVectorSize)
+  *  problems stored interleaved, i.e. as [row][column][lane]. The covariance update, the Cholesky
+  *  decompositions and the solutions of the NNLS active-set iterations run over all the lanes
+  *  together; the active sets are kept as per-lane masks instead of permuting the matrices, so
+  *  that every lane executes the same instructions. A lane whose fit has converged is refilled
+  *  with the next channel, so that channels needing many iterations do not stall the others.
+  *
+  *  Only the plain fit is supported: one template per active BX, without dynamic pedestals,
+  *  bad-sample step corrections or uncertainty calculation. Channels that need these go
+  *  through PulseChiSqSNNLS. With T = float the fit runs in single precision with twice
+  *  as many lanes.
+  */
+
+#include "RecoLocalCalo/EcalRecAlgos/interface/EigenMatrixTypes.h"
+
+#include <vector>
+
+template <typename T>
+class PulseChiSqSNNLSBatch {
+public:
+  static constexpr unsigned int kLanes = 64 / sizeof(T);
+  static constexpr unsigned int kSamples = SampleVectorSize;
+  // the templates cover rows and columns 7 to 18 of the full pulse (covariance)
+  static constexpr unsigned int kTemplateSamples = 12;
+
+  PulseChiSqSNNLSBatch();
+
+  /// set the active BXs (in [-5, 4]), this clears the batch
+  void setBXs(const BXVector &bxs);
+  void setMaxIters(int n) { _maxiters = n; }
+
+  /// add a channel with the same inputs as PulseChiSqSNNLS::DoFit, returns its index in the batch
+  unsigned int addChannel(const SampleVector &samples,
+                          const SampleMatrix &samplecov,
+                          const FullSampleVector &fullpulse,
+                          const FullSampleMatrix &fullpulsecov);
+  unsigned int size() const { return _chisqres.size(); }
+  void clear();
+
+  /// fit all the channels in the batch
+  void DoFit();
+
+  /// amplitude of channel ich for the ipulse-th active BX, in the order given to setBXs
+  double X(unsigned int ich, unsigned int ipulse) const { return _ampres[ich * _npulse + ipulse]; }
+  double ChiSq(unsigned int ich) const { return _chisqres[ich]; }
+  /// false if the covariance of channel ich was not positive definite or its result is not finite;
+  /// as in PulseChiSqSNNLS, a fit stopped at the maximum number of iterations keeps a good status
+  bool Status(unsigned int ich) const { return _statusres[ich]; }
+
+private:
+  // inputs of one channel, as stored by addChannel
+  static constexpr unsigned int kSampleCovOffset = kSamples;
+  static constexpr unsigned int kPulseOffset = kSampleCovOffset + kSamples * kSamples;
+  static constexpr unsigned int kPulseCovOffset = kPulseOffset + kTemplateSamples;
+  static constexpr unsigned int kInputSize = kPulseCovOffset + kTemplateSamples * kTemplateSamples;
+
+  void loadChannel(unsigned int ich, unsigned int l);
+  void loadEmpty(unsigned int l);
+  void updateCov();
+  void whiten();
+  void NNLS(const bool *running);
+  void OnePulseMinimize(const bool *running);
+  void ComputeChiSq(T *chisq) const;
+
+  unsigned int _npulse;
+  int _bxs[kSamples];
+  int _maxiters;
+
+  std::vector<T> _inputs;
+  std::vector<double> _ampres;
+  std::vector<double> _chisqres;
+  std::vector<char> _statusres;
+
+  // inputs of the channels in the lanes
+  alignas(64) T _sampvec[kSamples][kLanes];
+  alignas(64) T _samplecov[kSamples][kSamples][kLanes];
+  alignas(64) T _pulsemat[kSamples][kSamples][kLanes];
+  alignas(64) T _pulsecov[kTemplateSamples][kTemplateSamples][kLanes];
+
+  // fit state and work space
+  alignas(64) T _covL[kSamples][kSamples][kLanes];
+  alignas(64) T _covLinvdiag[kSamples][kLanes];
+  alignas(64) T _invcovp[kSamples][kSamples][kLanes];
+  alignas(64) T _invcovs[kSamples][kLanes];
+  alignas(64) T _aTamat[kSamples][kSamples][kLanes];
+  alignas(64) T _aTbvec[kSamples][kLanes];
+  alignas(64) T _ampvec[kSamples][kLanes];
+  alignas(64) T _chisq[kLanes];
+  alignas(64) T _passive[kSamples][kLanes];  // 1 for the unconstrained parameters of the NNLS, 0 otherwise
+};
+
+#endif
@@ -223,3 +223,59 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
 
   return rh;
 }
+
+bool EcalUncalibRecHitMultiFitAlgo::batchedFitInputs(const EcalDataFrame &dataFrame,
+                                                     const EcalPedestals::Item *aped,
+                                                     const SampleMatrixGainArray &noisecors,
+                                                     SampleVector &amplitudes,
+                                                     SampleMatrix &noisecov) const {
+  if (_computeErrors || _doPrefit || _dynamicPedestals)
+    return false;
+
+  // same inputs as in makeRecHit for a channel without gain switch
+  for (unsigned int iSample = 0; iSample < EcalDataFrame::MAXSAMPLES; iSample++) {
+    const EcalMGPASample &sample = dataFrame.sample(iSample);
+    if (sample.gainId() != 1)
+      return false;
+    amplitudes[iSample] = (double)(sample.adc()) - aped->mean_x12;
+  }
+
+  noisecov = aped->rms_x12 * aped->rms_x12 * noisecors[0];
+  if (_addPedestalUncertainty > 0.) {
+    //add fully correlated component to noise covariance to inflate pedestal uncertainty
+    noisecov += _addPedestalUncertainty * _addPedestalUncertainty * SampleMatrix::Ones();
+  }
+
+  return true;
+}
+
+EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataFrame &dataFrame,
+                                                                 const EcalPedestals::Item *aped,
+                                                                 const BXVector &activeBX,
+                                                                 const double *fitAmplitudes,
+                                                                 double chisq,
+                                                                 bool status) const {
+  if (!status) {
+    edm::LogWarning("EcalUncalibRecHitMultiFitAlgo::makeRecHit") << "Failed Fit" << std::endl;
+  }
+
+  unsigned int ipulseintime = 0;
+  for (unsigned int ipulse = 0; ipulse < activeBX.rows(); ++ipulse) {
+    if (activeBX.coeff(ipulse) == 0) {
+      ipulseintime = ipulse;
+      break;
+    }
+  }
+
+  EcalUncalibratedRecHit rh(
+      dataFrame.id(), status ? fitAmplitudes[ipulseintime] : 0., aped->mean_x12, 0., chisq, 0);
+  rh.setAmplitudeError(0.);
+  for (unsigned int ipulse = 0; ipulse < activeBX.rows(); ++ipulse) {
+    int bx = activeBX.coeff(ipulse);
+    if (bx != 0) {
+      rh.setOutOfTimeAmplitude(bx + 5, status ? fitAmplitudes[ipulse] : 0.);
+    }
+  }
+
+  return rh;
+}
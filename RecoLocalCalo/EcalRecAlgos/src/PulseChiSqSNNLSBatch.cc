@@ -0,0 +1,514 @@
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+  // all the helpers work on [row][column][lane] (or [row][lane]) arrays, with the lane loop innermost
+  // so that it is vectorized; n is the size of the (leading) square block that is used
+
+  // in-place Cholesky decomposition of the lower triangle of m, invdiag is set to 1/L(i,i)
+  template <typename T, unsigned int N, unsigned int L>
+  void cholesky(T (&m)[N][N][L], T (&invdiag)[N][L], unsigned int n) {
+    for (unsigned int j = 0; j < n; ++j) {
+      for (unsigned int k = 0; k < j; ++k)
+        for (unsigned int l = 0; l < L; ++l)
+          m[j][j][l] -= m[j][k][l] * m[j][k][l];
+      for (unsigned int l = 0; l < L; ++l) {
+        m[j][j][l] = std::sqrt(m[j][j][l]);
+        invdiag[j][l] = T(1) / m[j][j][l];
+      }
+      for (unsigned int i = j + 1; i < n; ++i) {
+        for (unsigned int k = 0; k < j; ++k)
+          for (unsigned int l = 0; l < L; ++l)
+            m[i][j][l] -= m[i][k][l] * m[j][k][l];
+        for (unsigned int l = 0; l < L; ++l)
+          m[i][j][l] *= invdiag[j][l];
+      }
+    }
+  }
+
+  // solve L*y = b in place
+  template <typename T, unsigned int N, unsigned int L>
+  void forwardSubstitute(const T (&m)[N][N][L], const T (&invdiag)[N][L], T (&b)[N][L], unsigned int n) {
+    for (unsigned int i = 0; i < n; ++i) {
+      for (unsigned int k = 0; k < i; ++k)
+        for (unsigned int l = 0; l < L; ++l)
+          b[i][l] -= m[i][k][l] * b[k][l];
+      for (unsigned int l = 0; l < L; ++l)
+        b[i][l] *= invdiag[i][l];
+    }
+  }
+
+  // solve L^T*x = y in place
+  template <typename T, unsigned int N, unsigned int L>
+  void backSubstitute(const T (&m)[N][N][L], const T (&invdiag)[N][L], T (&b)[N][L], unsigned int n) {
+    for (int i = n - 1; i >= 0; --i) {
+      for (unsigned int k = i + 1; k < n; ++k)
+        for (unsigned int l = 0; l < L; ++l)
+          b[i][l] -= m[k][i][l] * b[k][l];
+      for (unsigned int l = 0; l < L; ++l)
+        b[i][l] *= invdiag[i][l];
+    }
+  }
+
+}  // namespace
+
+template <typename T>
+PulseChiSqSNNLSBatch<T>::PulseChiSqSNNLSBatch() : _npulse(0), _maxiters(50) {}
+
+template <typename T>
+void PulseChiSqSNNLSBatch<T>::setBXs(const BXVector &bxs) {
+  if (bxs.rows() == 0 || bxs.rows() > int(kSamples))
+    throw cms::Exception("MultFitWeirdState") << "Batched multifit needs between 1 and " << kSamples
+                                              << " active BXs, got " << bxs.rows();
+  _npulse = bxs.rows();
+  for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse) {
+    _bxs[ipulse] = bxs.coeff(ipulse);
+    if (_bxs[ipulse] < -5 || _bxs[ipulse] > 4)
+      throw cms::Exception("MultFitWeirdState") << "Batched multifit active BX " << _bxs[ipulse] << " out of range";
+  }
+  clear();
+}
+
+template <typename T>
+void PulseChiSqSNNLSBatch<T>::clear() {
+  _inputs.clear();
+  _ampres.clear();
+  _chisqres.clear();
+  _statusres.clear();
+}
+
+template <typename T>
+unsigned int PulseChiSqSNNLSBatch<T>::addChannel(const SampleVector &samples,
+                                                 const SampleMatrix &samplecov,
+                                                 const FullSampleVector &fullpulse,
+                                                 const FullSampleMatrix &fullpulsecov) {
+  const unsigned int ich = _chisqres.size();
+  _chisqres.push_back(0.);
+  _statusres.push_back(true);
+  _ampres.resize(_ampres.size() + _npulse, 0.);
+
+  auto input = _inputs.insert(_inputs.end(), kInputSize, T(0));
+  for (unsigned int i = 0; i < kSamples; ++i) {
+    input[i] = samples.coeff(i);
+    for (unsigned int j = 0; j < kSamples; ++j)
+      input[kSampleCovOffset + i * kSamples + j] = samplecov.coeff(i, j);
+  }
+  for (unsigned int i = 0; i < kTemplateSamples; ++i) {
+    input[kPulseOffset + i] = fullpulse.coeff(i + 7);
+    for (unsigned int j = 0; j < kTemplateSamples; ++j)
+      input[kPulseCovOffset + i * kTemplateSamples + j] = fullpulsecov.coeff(i + 7, j + 7);
+  }
+
+  return ich;
+}
+
+template <typename T>
+void PulseChiSqSNNLSBatch<T>::loadChannel(unsigned int ich, unsigned int l) {
+  const T *input = &_inputs[ich * kInputSize];
+  for (unsigned int i = 0; i < kSamples; ++i) {
+    _sampvec[i][l] = input[i];
+    for (unsigned int j = 0; j < kSamples; ++j)
+      _samplecov[i][j][l] = input[kSampleCovOffset + i * kSamples + j];
+  }
+
+  //pulse template matrix, the samples before the start of the template are zero
+  for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse) {
+    const int offset = 7 - 3 - _bxs[ipulse];
+    for (unsigned int i = 0; i < kSamples; ++i) {
+      const int itemplate = int(i) + offset - 7;
+      _pulsemat[i][ipulse][l] = itemplate >= 0 ? input[kPulseOffset + itemplate] : T(0);
+    }
+  }
+
+  for (unsigned int i = 0; i < kTemplateSamples; ++i)
+    for (unsigned int j = 0; j < kTemplateSamples; ++j)
+      _pulsecov[i][j][l] = input[kPulseCovOffset + i * kTemplateSamples + j];
+
+  // initial state as in PulseChiSqSNNLS::DoFit
+  for (unsigned int ipulse = 0; ipulse < kSamples; ++ipulse) {
+    _ampvec[ipulse][l] = 0;
+    _passive[ipulse][l] = 0;
+  }
+  if (_npulse == 1)
+    _ampvec[0][l] = _sampvec[_bxs[0] + 5][l];
+  _chisq[l] = 0;
+}
+
+template <typename T>
+void PulseChiSqSNNLSBatch<T>::loadEmpty(unsigned int l) {
+  // trivial problem for the lanes left without channels, so that they stay finite
+  for (unsigned int i = 0; i < kSamples; ++i) {
+    _sampvec[i][l] = 0;
+    for (unsigned int j = 0; j < kSamples; ++j) {
+      _samplecov[i][j][l] = (i == j) ? 1 : 0;
+      _pulsemat[i][j][l] = (i == j) ? 1 : 0;
+    }
+    _ampvec[i][l] = 0;
+    _passive[i][l] = 0;
+  }
+  for (unsigned int i = 0; i < kTemplateSamples; ++i)
+    for (unsigned int j = 0; j < kTemplateSamples; ++j)
+      _pulsecov[i][j][l] = 0;
+  _chisq[l] = 0;
+}
+
+template <typename T>
+void PulseChiSqSNNLSBatch<T>::DoFit() {
+  const unsigned int nchannels = size();
+  unsigned int nextchannel = 0;
+
+  // channel fitted in each lane (-1 if none) and its state
+  int channel[kLanes];
+  bool running[kLanes];
+  bool failed[kLanes];
+  int iter[kLanes];
+  for (unsigned int l = 0; l < kLanes; ++l) {
+    channel[l] = -1;
+    running[l] = false;
+    failed[l] = false;
+    iter[l] = 0;
+    loadEmpty(l);
+  }
+
+  // a channel only fails if its covariance is not positive definite or its result is not finite
+  auto fail = [&](unsigned int l) {
+    running[l] = false;
+    failed[l] = true;
+    _statusres[channel[l]] = false;
+  };
+
+  // same iterations as PulseChiSqSNNLS::Minimize, each lane stops on its own. All the lanes go
+  // through every step, so a lane refilled alone would make the others wait for its first NNLS
+  // minimization, which takes the most active-set iterations: the idle lanes are refilled together,
+  // once they are at least half of them
+  while (true) {
+    unsigned int nidle = 0;
+    for (unsigned int l = 0; l < kLanes; ++l) {
+      if (running[l] && iter[l] >= _maxiters) {
+        // the last iteration is kept as the result, with a good status as in PulseChiSqSNNLS::Minimize
+        LogDebug("PulseChiSqSNNLSBatch::DoFit") << "Max Iterations reached at iter " << iter[l];
+        running[l] = false;
+      }
+      if (!running[l] && channel[l] >= 0) {
+        for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse)
+          _ampres[channel[l] * _npulse + ipulse] = _ampvec[ipulse][l];
+        _chisqres[channel[l]] = _chisq[l];
+        channel[l] = -1;
+      }
+      if (failed[l]) {
+        // do not carry the non finite values of the failed fit into the next steps
+        loadEmpty(l);
+        failed[l] = false;
+      }
+      nidle += !running[l];
+    }
+    if (2 * nidle >= kLanes) {
+      for (unsigned int l = 0; l < kLanes && nextchannel < nchannels; ++l) {
+        if (!running[l]) {
+          channel[l] = nextchannel++;
+          loadChannel(channel[l], l);
+          running[l] = true;
+          iter[l] = 0;
+          --nidle;
+        }
+      }
+    }
+    if (nidle == kLanes)
+      break;
+
+    updateCov();
+    for (unsigned int l = 0; l < kLanes; ++l) {
+      if (!running[l])
+        continue;
+      bool posdef = true;
+      for (unsigned int i = 0; i < kSamples; ++i)
+        posdef &= std::isfinite(_covLinvdiag[i][l]);
+      if (!posdef) {
+        LogDebug("PulseChiSqSNNLSBatch::DoFit") << "Cholesky decomposition of the covariance failed";
+        fail(l);
+      }
+    }
+    whiten();
+    if (_npulse > 1) {
+      NNLS(running);
+    } else {
+      //special case for one pulse fit
+      OnePulseMinimize(running);
+    }
+
+    T chisqnow[kLanes];
+    ComputeChiSq(chisqnow);
+    for (unsigned int l = 0; l < kLanes; ++l) {
+      if (!running[l])
+        continue;
+      bool finite = std::isfinite(chisqnow[l]);
+      for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse)
+        finite &= std::isfinite(_ampvec[ipulse][l]);
+      if (!finite) {
+        LogDebug("PulseChiSqSNNLSBatch::DoFit") << "Non finite fit result";
+        _chisq[l] = chisqnow[l];
+        fail(l);
+        continue;
+      }
+      const T deltachisq = chisqnow[l] - _chisq[l];
+      _chisq[l] = chisqnow[l];
+      //in single precision the change of a large chi2 can stay above the absolute threshold
+      if (std::abs(deltachisq) < std::max(T(1e-3), 16 * std::numeric_limits<T>::epsilon() * chisqnow[l]))
+        running[l] = false;
+      else
+        ++iter[l];
+    }
+  }
+}
+
+template <typename T>
+void PulseChiSqSNNLSBatch<T>::updateCov() {
+  for (unsigned int i = 0; i < kSamples; ++i)
+    for (unsigned int j = 0; j < kSamples; ++j)
+      for (unsigned int l = 0; l < kLanes; ++l)
+        _covL[i][j][l] = _samplecov[i][j][l];
+
+  // pulses with zero amplitude add nothing, so they do not need to be masked out
+  for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse) {
+    const int bx = _bxs[ipulse];
+    const unsigned int firstsamplet = std::max(0, bx + 3);
+    const int offset = -bx - 3;
+    T ampsq[kLanes];
+    for (unsigned int l = 0; l < kLanes; ++l)
+      ampsq[l] = _ampvec[ipulse][l] * _ampvec[ipulse][l];
+    for (unsigned int i = firstsamplet; i < kSamples; ++i)
+      for (unsigned int j = firstsamplet; j < kSamples; ++j)
+        for (unsigned int l = 0; l < kLanes; ++l)
+          _covL[i][j][l] += ampsq[l] * _pulsecov[i + offset][j + offset][l];
+  }
+
+  cholesky(_covL, _covLinvdiag, kSamples);
+}
+
+template <typename T>
+void PulseChiSqSNNLSBatch<T>::whiten() {
+  // _invcovp = L^-1 * pulsemat and _invcovs = L^-1 * samples, solved for all the columns at once
+  for (unsigned int i = 0; i < kSamples; ++i) {
+    for (unsigned int l = 0; l < kLanes; ++l)
+      _invcovs[i][l] = _sampvec[i][l];
+    for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse)
+      for (unsigned int l = 0; l < kLanes; ++l)
+        _invcovp[i][ipulse][l] = _pulsemat[i][ipulse][l];
+  }
+  for (unsigned int i = 0; i < kSamples; ++i) {
+    for (unsigned int k = 0; k < i; ++k) {
+      for (unsigned int l = 0; l < kLanes; ++l)
+        _invcovs[i][l] -= _covL[i][k][l] * _invcovs[k][l];
+      for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse)
+        for (unsigned int l = 0; l < kLanes; ++l)
+          _invcovp[i][ipulse][l] -= _covL[i][k][l] * _invcovp[k][ipulse][l];
+    }
+    for (unsigned int l = 0; l < kLanes; ++l)
+      _invcovs[i][l] *= _covLinvdiag[i][l];
+    for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse)
+      for (unsigned int l = 0; l < kLanes; ++l)
+        _invcovp[i][ipulse][l] *= _covLinvdiag[i][l];
+  }
+
+  for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse) {
+    for (unsigned int l = 0; l < kLanes; ++l)
+      _aTbvec[ipulse][l] = 0;
+    for (unsigned int jpulse = 0; jpulse <= ipulse; ++jpulse)
+      for (unsigned int l = 0; l < kLanes; ++l)
+        _aTamat[ipulse][jpulse][l] = 0;
+    for (unsigned int i = 0; i < kSamples; ++i) {
+      for (unsigned int l = 0; l < kLanes; ++l)
+        _aTbvec[ipulse][l] += _invcovp[i][ipulse][l] * _invcovs[i][l];
+      for (unsigned int jpulse = 0; jpulse <= ipulse; ++jpulse)
+        for (unsigned int l = 0; l < kLanes; ++l)
+          _aTamat[ipulse][jpulse][l] += _invcovp[i][ipulse][l] * _invcovp[i][jpulse][l];
+    }
+    for (unsigned int jpulse = 0; jpulse < ipulse; ++jpulse)
+      for (unsigned int l = 0; l < kLanes; ++l)
+        _aTamat[jpulse][ipulse][l] = _aTamat[ipulse][jpulse][l];
+  }
+}
+
+template <typename T>
+void PulseChiSqSNNLSBatch<T>::NNLS(const bool *running) {
+  //Fast NNLS (fnnls) algorithm as in PulseChiSqSNNLS::NNLS, with the passive set kept as a 0/1 mask:
+  //the masked out rows and columns of the system are replaced by the identity (with a zero right
+  //hand side), so that the same full-size solve gives the solution of each lane's passive subsystem
+
+  const unsigned int npulse = _npulse;
+  const unsigned int nPmax = std::min(npulse, kSamples);
+
+  enum class Step : char { update, solve, done };
+  Step step[kLanes];
+  unsigned int nP[kLanes];
+  int iter[kLanes];
+  int idxwmax[kLanes];
+  T wmax[kLanes];
+  T threshold[kLanes];
+  for (unsigned int l = 0; l < kLanes; ++l) {
+    nP[l] = 0;
+    for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+      nP[l] += (_passive[ipulse][l] != 0);
+    //can only start with the update step if the solution is guaranteed viable
+    step[l] = running[l] ? (nP[l] == 0 ? Step::update : Step::solve) : Step::done;
+    iter[l] = 0;
+    idxwmax[l] = 0;
+    wmax[l] = 0;
+    threshold[l] = T(1e-11);
+  }
+
+  auto nextIteration = [&](unsigned int l) {
+    step[l] = Step::update;
+    ++iter[l];
+    //adaptive convergence threshold to avoid infinite loops but still
+    //ensure best value is used
+    if (iter[l] % 16 == 0)
+      threshold[l] *= 2;
+  };
+
+  alignas(64) T updatework[kSamples][kLanes];
+  alignas(64) T mat[kSamples][kSamples][kLanes];
+  alignas(64) T matinvdiag[kSamples][kLanes];
+  alignas(64) T ampvecpermtest[kSamples][kLanes];
+
+  while (true) {
+    // gradient of all the lanes, only used for the ones in the update step
+    for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse) {
+      for (unsigned int l = 0; l < kLanes; ++l)
+        updatework[ipulse][l] = _aTbvec[ipulse][l];
+      for (unsigned int jpulse = 0; jpulse < npulse; ++jpulse)
+        for (unsigned int l = 0; l < kLanes; ++l)
+          updatework[ipulse][l] -= _aTamat[ipulse][jpulse][l] * _ampvec[jpulse][l];
+    }
+
+    // update step: add the constrained parameter with the largest gradient to the passive set
+    bool anySolve = false;
+    for (unsigned int l = 0; l < kLanes; ++l) {
+      if (step[l] == Step::update) {
+        if (nP[l] == nPmax) {
+          step[l] = Step::done;
+          continue;
+        }
+
+        const int idxwmaxprev = idxwmax[l];
+        const T wmaxprev = wmax[l];
+        wmax[l] = std::numeric_limits<T>::lowest();
+        for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse) {
+          if (_passive[ipulse][l] == 0 && updatework[ipulse][l] > wmax[l]) {
+            wmax[l] = updatework[ipulse][l];
+            idxwmax[l] = ipulse;
+          }
+        }
+
+        //convergence
+        if (wmax[l] < threshold[l] || (idxwmax[l] == idxwmaxprev && wmax[l] == wmaxprev)) {
+          step[l] = Step::done;
+          continue;
+        }
+
+        //worst case protection
+        if (iter[l] >= 500) {
+          LogDebug("PulseChiSqSNNLSBatch::NNLS()") << "Max Iterations reached at iter " << iter[l];
+          step[l] = Step::done;
+          continue;
+        }
+
+        //unconstrain parameter
+        _passive[idxwmax[l]][l] = 1;
+        ++nP[l];
+        step[l] = Step::solve;
+      }
+      anySolve |= (step[l] == Step::solve);
+    }
+    if (!anySolve)
+      break;
+
+    // solve step: unconstrained solution for the passive parameters, for all the lanes at once
+    for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse) {
+      for (unsigned int jpulse = 0; jpulse < npulse; ++jpulse)
+        for (unsigned int l = 0; l < kLanes; ++l)
+          mat[ipulse][jpulse][l] = _passive[ipulse][l] * _passive[jpulse][l] * _aTamat[ipulse][jpulse][l];
+      for (unsigned int l = 0; l < kLanes; ++l) {
+        mat[ipulse][ipulse][l] += T(1) - _passive[ipulse][l];
+        ampvecpermtest[ipulse][l] = _passive[ipulse][l] * _aTbvec[ipulse][l];
+      }
+    }
+    cholesky(mat, matinvdiag, npulse);
+    forwardSubstitute(mat, matinvdiag, ampvecpermtest, npulse);
+    backSubstitute(mat, matinvdiag, ampvecpermtest, npulse);
+
+    for (unsigned int l = 0; l < kLanes; ++l) {
+      if (step[l] != Step::solve)
+        continue;
+
+      //check solution
+      bool positive = true;
+      for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+        positive &= (_passive[ipulse][l] == 0 || ampvecpermtest[ipulse][l] > 0);
+      if (positive) {
+        for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+          if (_passive[ipulse][l] != 0)
+            _ampvec[ipulse][l] = ampvecpermtest[ipulse][l];
+        nextIteration(l);
+        continue;
+      }
+
+      //update parameter vector
+      unsigned int minratioidx = 0;
+      T minratio = std::numeric_limits<T>::max();
+      for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse) {
+        if (_passive[ipulse][l] != 0 && ampvecpermtest[ipulse][l] <= 0) {
+          const T c_ampvec = _ampvec[ipulse][l];
+          const T ratio = c_ampvec / (c_ampvec - ampvecpermtest[ipulse][l]);
+          if (ratio < minratio) {
+            minratio = ratio;
+            minratioidx = ipulse;
+          }
+        }
+      }
+      for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+        if (_passive[ipulse][l] != 0)
+          _ampvec[ipulse][l] += minratio * (ampvecpermtest[ipulse][l] - _ampvec[ipulse][l]);
+
+      //avoid numerical problems with later ==0. check
+      _ampvec[minratioidx][l] = 0;
+      _passive[minratioidx][l] = 0;
+      --nP[l];
+      if (nP[l] == 0)
+        nextIteration(l);
+    }
+  }
+}
+
+template <typename T>
+void PulseChiSqSNNLSBatch<T>::OnePulseMinimize(const bool *running) {
+  for (unsigned int l = 0; l < kLanes; ++l)
+    if (running[l])
+      _ampvec[0][l] = std::max(T(0), _aTbvec[0][l] / _aTamat[0][0][l]);
+}
+
+template <typename T>
+void PulseChiSqSNNLSBatch<T>::ComputeChiSq(T *chisq) const {
+  // |L^-1 * (pulsemat*ampvec - samples)|^2, with the whitened pulses and samples
+  for (unsigned int l = 0; l < kLanes; ++l)
+    chisq[l] = 0;
+  for (unsigned int i = 0; i < kSamples; ++i) {
+    T res[kLanes];
+    for (unsigned int l = 0; l < kLanes; ++l)
+      res[l] = -_invcovs[i][l];
+    for (unsigned int ipulse = 0; ipulse < _npulse; ++ipulse)
+      for (unsigned int l = 0; l < kLanes; ++l)
+        res[l] += _invcovp[i][ipulse][l] * _ampvec[ipulse][l];
+    for (unsigned int l = 0; l < kLanes; ++l)
+      chisq[l] += res[l] * res[l];
+  }
+}
+
+template class PulseChiSqSNNLSBatch<double>;
+template class PulseChiSqSNNLSBatch<float>;
@@ -0,0 +1,223 @@
+/* Unit test for PulseChiSqSNNLSBatch: compare the batched fit of
+   synthetic barrel pulses with the single channel PulseChiSqSNNLS fit,
+   and check the status of slow converging and failed fits
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLS.h"
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+class testPulseChiSqSNNLSBatch : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testPulseChiSqSNNLSBatch);
+  CPPUNIT_TEST(testDoublePrecision);
+  CPPUNIT_TEST(testSinglePrecision);
+  CPPUNIT_TEST(testStatus);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown() {}
+
+  void testDoublePrecision();
+  void testSinglePrecision();
+  void testStatus();
+
+private:
+  // fit nchannels with both fitters, returns the amplitudes and chi2 of each in the order of bxs
+  template <typename T>
+  void fit(const BXVector& bxs,
+           std::vector<double>& ref,
+           std::vector<double>& refchisq,
+           std::vector<double>& batched,
+           std::vector<double>& batchedchisq);
+
+  static constexpr unsigned int nchannels = 1000;
+  // small enough to refill the lanes and flush the batch several times
+  static constexpr unsigned int batchSize = 300;
+
+  FullSampleVector fullpulse_;
+  FullSampleMatrix fullpulsecov_;
+  SampleMatrix noisecov_;
+  std::vector<SampleVector> samples_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testPulseChiSqSNNLSBatch);
+
+void testPulseChiSqSNNLSBatch::setUp() {
+  // barrel pulse template, diagonal of its covariance and noise correlation
+  const double pulse[12] = {1.13979e-02,
+                            7.58151e-01,
+                            1.00000e+00,
+                            8.87744e-01,
+                            6.73548e-01,
+                            4.74332e-01,
+                            3.19561e-01,
+                            2.15144e-01,
+                            1.47464e-01,
+                            1.01087e-01,
+                            6.93181e-02,
+                            4.75044e-02};
+  const double pulsevar[12] = {3.001e-06,
+                               6.154e-05,
+                               0.,
+                               8.319e-06,
+                               9.182e-06,
+                               6.016e-06,
+                               3.602e-06,
+                               1.375e-06,
+                               9.115e-07,
+                               7.217e-07,
+                               6.509e-07,
+                               6.142e-07};
+  const double noisecor[10] = {
+      1.00000, 0.71073, 0.55721, 0.46089, 0.40449, 0.35931, 0.33924, 0.32439, 0.31581, 0.30481};
+
+  fullpulse_ = FullSampleVector::Zero();
+  fullpulsecov_ = FullSampleMatrix::Zero();
+  for (int i = 0; i < 12; ++i) {
+    fullpulse_(i + 7) = pulse[i];
+    fullpulsecov_(i + 7, i + 7) = pulsevar[i];
+  }
+  for (int i = 0; i < 10; ++i)
+    for (int j = 0; j < 10; ++j)
+      noisecov_(i, j) = 1.1 * 1.1 * noisecor[std::abs(i - j)];
+  SampleMatrix noiseL = noisecov_.llt().matrixL();
+
+  // in-time pulse with an amplitude up to 1000 ADC counts and out-of-time pileup in 30% of the BXs
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::normal_distribution<double> gauss;
+  samples_.resize(nchannels);
+  for (auto& samples : samples_) {
+    double amplitudes[10] = {0.};
+    amplitudes[5] = 1000. * uniform(rng) * uniform(rng);
+    for (int ibx = 0; ibx < 10; ++ibx)
+      if (ibx != 5 && uniform(rng) < 0.3)
+        amplitudes[ibx] = 100. * uniform(rng);
+    SampleVector noise;
+    for (int i = 0; i < 10; ++i)
+      noise(i) = gauss(rng);
+    samples = noiseL * noise;
+    for (int i = 0; i < 10; ++i)
+      for (int ibx = 0; ibx < 10; ++ibx)
+        samples(i) += amplitudes[ibx] * fullpulse_(i + 9 - ibx);
+  }
+}
+
+template <typename T>
+void testPulseChiSqSNNLSBatch::fit(const BXVector& bxs,
+                                   std::vector<double>& ref,
+                                   std::vector<double>& refchisq,
+                                   std::vector<double>& batched,
+                                   std::vector<double>& batchedchisq) {
+  const unsigned int npulse = bxs.rows();
+  ref.assign(nchannels * npulse, 0.);
+  refchisq.assign(nchannels, 0.);
+  batched.assign(nchannels * npulse, 0.);
+  batchedchisq.assign(nchannels, 0.);
+
+  PulseChiSqSNNLS scalar;
+  scalar.disableErrorCalculation();
+  for (unsigned int ich = 0; ich < nchannels; ++ich) {
+    CPPUNIT_ASSERT(scalar.DoFit(samples_[ich], noisecov_, bxs, fullpulse_, fullpulsecov_));
+    // the scalar fit permutes its BXs
+    for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse) {
+      const unsigned int jpulse = std::find(bxs.data(), bxs.data() + npulse, scalar.BXs().coeff(ipulse)) - bxs.data();
+      ref[ich * npulse + jpulse] = scalar.X().coeff(ipulse);
+    }
+    refchisq[ich] = scalar.ChiSq();
+  }
+
+  auto batch = std::make_unique<PulseChiSqSNNLSBatch<T>>();
+  batch->setBXs(bxs);
+  unsigned int first = 0;
+  auto flush = [&]() {
+    batch->DoFit();
+    for (unsigned int ich = 0; ich < batch->size(); ++ich) {
+      CPPUNIT_ASSERT(batch->Status(ich));
+      for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+        batched[(first + ich) * npulse + ipulse] = batch->X(ich, ipulse);
+      batchedchisq[first + ich] = batch->ChiSq(ich);
+    }
+    first += batch->size();
+    batch->clear();
+  };
+  for (unsigned int ich = 0; ich < nchannels; ++ich) {
+    CPPUNIT_ASSERT(batch->addChannel(samples_[ich], noisecov_, fullpulse_, fullpulsecov_) == ich - first);
+    if (batch->size() == batchSize)
+      flush();
+  }
+  flush();
+  CPPUNIT_ASSERT(first == nchannels);
+}
+
+void testPulseChiSqSNNLSBatch::testDoublePrecision() {
+  std::vector<BXVector> allbxs(3);
+  allbxs[0].resize(10);
+  allbxs[0] << -5, -4, -3, -2, -1, 0, 1, 2, 3, 4;
+  allbxs[1].resize(5);
+  allbxs[1] << -4, -2, 0, 2, 4;
+  allbxs[2].resize(1);
+  allbxs[2] << 0;
+
+  for (const auto& bxs : allbxs) {
+    std::vector<double> ref, refchisq, batched, batchedchisq;
+    fit<double>(bxs, ref, refchisq, batched, batchedchisq);
+    for (unsigned int i = 0; i < ref.size(); ++i)
+      CPPUNIT_ASSERT(std::abs(batched[i] - ref[i]) < 1e-4 * std::max(1., std::abs(ref[i])));
+    for (unsigned int ich = 0; ich < nchannels; ++ich)
+      CPPUNIT_ASSERT(std::abs(batchedchisq[ich] - refchisq[ich]) < 1e-4 * std::max(1., refchisq[ich]));
+  }
+}
+
+void testPulseChiSqSNNLSBatch::testSinglePrecision() {
+  BXVector bxs(10);
+  bxs << -5, -4, -3, -2, -1, 0, 1, 2, 3, 4;
+
+  // the out-of-time amplitudes of nearly degenerate solutions can differ, only check the in-time one
+  std::vector<double> ref, refchisq, batched, batchedchisq;
+  fit<float>(bxs, ref, refchisq, batched, batchedchisq);
+  for (unsigned int ich = 0; ich < nchannels; ++ich) {
+    const double intime = ref[ich * 10 + 5];
+    CPPUNIT_ASSERT(std::abs(batched[ich * 10 + 5] - intime) < 1e-2 * std::max(1., std::abs(intime)));
+  }
+}
+
+void testPulseChiSqSNNLSBatch::testStatus() {
+  BXVector bxs(10);
+  bxs << -5, -4, -3, -2, -1, 0, 1, 2, 3, 4;
+
+  // a fit stopped at the maximum number of iterations keeps a good status, as in PulseChiSqSNNLS
+  auto batch = std::make_unique<PulseChiSqSNNLSBatch<double>>();
+  batch->setBXs(bxs);
+  batch->setMaxIters(1);
+  for (unsigned int ich = 0; ich < batchSize; ++ich)
+    batch->addChannel(samples_[ich], noisecov_, fullpulse_, fullpulsecov_);
+  batch->DoFit();
+  for (unsigned int ich = 0; ich < batch->size(); ++ich)
+    CPPUNIT_ASSERT(batch->Status(ich));
+
+  // only the channels with a covariance that is not positive definite or a non finite result fail
+  batch->setBXs(bxs);
+  batch->setMaxIters(50);
+  SampleVector nansamples = samples_[1];
+  nansamples(3) = std::numeric_limits<double>::quiet_NaN();
+  const SampleMatrix badcov = -noisecov_;
+  batch->addChannel(samples_[0], noisecov_, fullpulse_, fullpulsecov_);
+  batch->addChannel(nansamples, noisecov_, fullpulse_, fullpulsecov_);
+  batch->addChannel(samples_[2], badcov, fullpulse_, fullpulsecov_);
+  batch->addChannel(samples_[3], noisecov_, fullpulse_, fullpulsecov_);
+  batch->DoFit();
+  CPPUNIT_ASSERT(batch->Status(0));
+  CPPUNIT_ASSERT(!batch->Status(1));
+  CPPUNIT_ASSERT(!batch->Status(2));
+  CPPUNIT_ASSERT(batch->Status(3));
+}
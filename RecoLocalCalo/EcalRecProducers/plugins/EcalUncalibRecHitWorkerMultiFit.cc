@@ -35,6 +35,17 @@ EcalUncalibRecHitWorkerMultiFit::EcalUncalibRecHitWorkerMultiFit(const edm::Para
   ampErrorCalculation_ = ps.getParameter<bool>("ampErrorCalculation");
   useLumiInfoRunHeader_ = ps.getParameter<bool>("useLumiInfoRunHeader");
 
+  // fit the channels without gain switch together with PulseChiSqSNNLSBatch (only without uncertainty calculation,
+  // prefit and dynamic pedestals), optionally in single precision
+  batchedFit_ = ps.getParameter<bool>("batchedFit");
+  batchedFitSinglePrecision_ = ps.getParameter<bool>("batchedFitSinglePrecision");
+  if (batchedFit_) {
+    if (batchedFitSinglePrecision_)
+      batchedFitterSinglePrecision_ = std::make_unique<PulseChiSqSNNLSBatch<float>>();
+    else
+      batchedFitter_ = std::make_unique<PulseChiSqSNNLSBatch<double>>();
+  }
+
   if (useLumiInfoRunHeader_) {
     bunchSpacing_ = c.consumes<unsigned int>(edm::InputTag("bunchSpacingProducer"));
     bunchSpacingManual_ = 0;
@@ -261,6 +272,10 @@ void EcalUncalibRecHitWorkerMultiFit::run(const edm::Event& evt,
     multiFitMethod_.setAddPedestalUncertainty(addPedestalUncertaintyEE_);
   }
 
+  batchedIndex_.clear();
+  if (batchedFit_)
+    runBatchedFit(digis, barrel);
+
   FullSampleVector fullpulse(FullSampleVector::Zero());
   FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
 
@@ -351,7 +366,18 @@ void EcalUncalibRecHitWorkerMultiFit::run(const edm::Event& evt,
       // multifit
       const SampleMatrixGainArray& noisecors = noisecor(barrel);
 
-      result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
+      const int ibatched = batchedIndex_.empty() ? -1 : batchedIndex_[itdg - digis.begin()];
+      if (ibatched >= 0) {
+        result.push_back(multiFitMethod_.makeRecHit(*itdg,
+                                                    aped,
+                                                    activeBX,
+                                                    &batchedAmplitudes_[ibatched * activeBX.rows()],
+                                                    batchedChiSq_[ibatched],
+                                                    batchedStatus_[ibatched]));
+      } else {
+        result.push_back(
+            multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
+      }
       auto& uncalibRecHit = result.back();
 
       // === time computation ===
@@ -488,6 +514,82 @@ void EcalUncalibRecHitWorkerMultiFit::run(const edm::Event& evt,
   }
 }
 
+void EcalUncalibRecHitWorkerMultiFit::runBatchedFit(const EcalDigiCollection& digis, bool barrel) {
+  if (batchedFitSinglePrecision_)
+    runBatchedFit(*batchedFitterSinglePrecision_, digis, barrel);
+  else
+    runBatchedFit(*batchedFitter_, digis, barrel);
+}
+
+template <typename T>
+void EcalUncalibRecHitWorkerMultiFit::runBatchedFit(PulseChiSqSNNLSBatch<T>& fitter,
+                                                    const EcalDigiCollection& digis,
+                                                    bool barrel) {
+  // the inputs of the channels are buffered, flush them regularly to keep them small
+  constexpr unsigned int maxBatchSize = 1024;
+
+  const unsigned int npulse = activeBX.rows();
+  const SampleMatrixGainArray& noisecors = noisecor(barrel);
+  fitter.setBXs(activeBX);
+
+  batchedIndex_.assign(digis.size(), -1);
+  batchedAmplitudes_.clear();
+  batchedChiSq_.clear();
+  batchedStatus_.clear();
+
+  auto flush = [&]() {
+    fitter.DoFit();
+    for (unsigned int ich = 0; ich < fitter.size(); ++ich) {
+      for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+        batchedAmplitudes_.push_back(fitter.X(ich, ipulse));
+      batchedChiSq_.push_back(fitter.ChiSq(ich));
+      batchedStatus_.push_back(fitter.Status(ich));
+    }
+    fitter.clear();
+  };
+
+  FullSampleVector fullpulse(FullSampleVector::Zero());
+  FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
+  SampleVector amplitudes;
+  SampleMatrix noisecov;
+  int nbatched = 0;
+  for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg) {
+    DetId detid(itdg->id());
+
+    const EcalPedestals::Item* aped = nullptr;
+    const EcalPulseShapes::Item* aPulse = nullptr;
+    const EcalPulseCovariances::Item* aPulseCov = nullptr;
+    if (barrel) {
+      unsigned int hashedIndex = EBDetId(detid).hashedIndex();
+      aped = &peds->barrel(hashedIndex);
+      aPulse = &pulseshapes->barrel(hashedIndex);
+      aPulseCov = &pulsecovariances->barrel(hashedIndex);
+    } else {
+      unsigned int hashedIndex = EEDetId(detid).hashedIndex();
+      aped = &peds->endcap(hashedIndex);
+      aPulse = &pulseshapes->endcap(hashedIndex);
+      aPulseCov = &pulsecovariances->endcap(hashedIndex);
+    }
+
+    if (!multiFitMethod_.batchedFitInputs(*itdg, aped, noisecors, amplitudes, noisecov))
+      continue;
+
+    for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; ++i)
+      fullpulse(i + 7) = aPulse->pdfval[i];
+
+    for (int i = 0; i < EcalPulseShape::TEMPLATESAMPLES; i++)
+      for (int j = 0; j < EcalPulseShape::TEMPLATESAMPLES; j++)
+        fullpulsecov(i + 7, j + 7) = aPulseCov->covval[i][j];
+
+    fitter.addChannel(amplitudes, noisecov, fullpulse, fullpulsecov);
+    batchedIndex_[itdg - digis.begin()] = nbatched++;
+    if (fitter.size() == maxBatchSize)
+      flush();
+  }
+  if (fitter.size() > 0)
+    flush();
+}
+
 edm::ParameterSetDescription EcalUncalibRecHitWorkerMultiFit::getAlgoDescription() {
   edm::ParameterSetDescription psd0;
   psd0.addNode((edm::ParameterDescription<std::vector<double>>("EBPulseShapeTemplate",
@@ -596,6 +698,8 @@ edm::ParameterSetDescription EcalUncalibRecHitWorkerMultiFit::getAlgoDescription
       edm::ParameterDescription<std::vector<int>>("activeBXs", {-5, -4, -3, -2, -1, 0, 1, 2, 3, 4}, true) and
       edm::ParameterDescription<bool>("ampErrorCalculation", true, true) and
       edm::ParameterDescription<bool>("useLumiInfoRunHeader", true, true) and
+      edm::ParameterDescription<bool>("batchedFit", false, true) and
+      edm::ParameterDescription<bool>("batchedFitSinglePrecision", false, true) and
       edm::ParameterDescription<int>("bunchSpacing", 0, true) and
       edm::ParameterDescription<bool>("doPrefitEB", false, true) and
       edm::ParameterDescription<bool>("doPrefitEE", false, true) and
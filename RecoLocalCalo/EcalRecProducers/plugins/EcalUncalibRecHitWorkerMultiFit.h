@@ -11,6 +11,7 @@
 
 #include "RecoLocalCalo/EcalRecProducers/interface/EcalUncalibRecHitWorkerBaseClass.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitMultiFitAlgo.h"
+#include "RecoLocalCalo/EcalRecAlgos/interface/PulseChiSqSNNLSBatch.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitTimeWeightsAlgo.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitRecChi2Algo.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitRatioMethodAlgo.h"
@@ -29,6 +30,9 @@
 #include "CondFormats/EcalObjects/interface/EcalPulseCovariances.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/EigenMatrixTypes.h"
 
+#include <memory>
+#include <vector>
+
 namespace edm {
   class Event;
   class EventSetup;
@@ -59,6 +63,11 @@ private:
 
   double timeCorrection(float ampli, const std::vector<float>& amplitudeBins, const std::vector<float>& shiftBins);
 
+  // fit the channels that allow it with the batched multifit, before the loop of run()
+  void runBatchedFit(const EcalDigiCollection& digis, bool barrel);
+  template <typename T>
+  void runBatchedFit(PulseChiSqSNNLSBatch<T>& fitter, const EcalDigiCollection& digis, bool barrel);
+
   const SampleMatrix& noisecor(bool barrel, int gain) const { return noisecors_[barrel ? 1 : 0][gain]; }
   const SampleMatrixGainArray& noisecor(bool barrel) const { return noisecors_[barrel ? 1 : 0]; }
 
@@ -69,6 +78,16 @@ private:
   bool useLumiInfoRunHeader_;
   EcalUncalibRecHitMultiFitAlgo multiFitMethod_;
 
+  // batched multifit
+  bool batchedFit_;
+  bool batchedFitSinglePrecision_;
+  std::unique_ptr<PulseChiSqSNNLSBatch<double>> batchedFitter_;
+  std::unique_ptr<PulseChiSqSNNLSBatch<float>> batchedFitterSinglePrecision_;
+  std::vector<int> batchedIndex_;  // index of the result of each digi, -1 if not fitted in the batch
+  std::vector<double> batchedAmplitudes_;
+  std::vector<double> batchedChiSq_;
+  std::vector<char> batchedStatus_;
+
   int bunchSpacingManual_;
   edm::EDGetTokenT<unsigned int> bunchSpacing_;
 
@@ -149,6 +149,13 @@ private:
     std::vector<std::vector<int>> followers;
     std::vector<bool> isSeed;
 
+    // weight, density and detid of the hits in the order of the tiles
+    std::vector<float> tileWeight;
+    std::vector<float> tileRho;
+    std::vector<DetId> tileDetid;
+    // per-hit results of the loops over the hits of a tile
+    std::vector<float> work;
+
     void clear() {
       detid.clear();
       x.clear();
@@ -161,28 +168,21 @@ private:
       sigmaNoise.clear();
       followers.clear();
       isSeed.clear();
+      tileWeight.clear();
+      tileRho.clear();
+      tileDetid.clear();
     }
   };
 
   std::vector<CellsOnLayer> cells_;
+  std::vector<HGCalLayerTiles> tiles_;
 
   std::vector<int> numberOfClustersPerLayer_;
 
-  inline float distance2(int cell1, int cell2, int layerId) const {  // distance squared
-    const float dx = cells_[layerId].x[cell1] - cells_[layerId].x[cell2];
-    const float dy = cells_[layerId].y[cell1] - cells_[layerId].y[cell2];
-    return (dx * dx + dy * dy);
-  }
-
-  inline float distance(int cell1, int cell2, int layerId) const {  // 2-d distance on the layer (x-y)
-    return std::sqrt(distance2(cell1, cell2, layerId));
-  }
-
   void prepareDataStructures(const unsigned int layerId);
-  void calculateLocalDensity(const HGCalLayerTiles& lt,
-                             const unsigned int layerId,
-                             float delta_c);  // return max density
+  void calculateLocalDensity(const HGCalLayerTiles& lt, const unsigned int layerId, float delta_c);
   void calculateDistanceToHigher(const HGCalLayerTiles& lt, const unsigned int layerId, float delta_c);
+  void buildClusters(const unsigned int layerId, const int firstClusterIdx);
   int findAndAssignClusters(const unsigned int layerId, float delta_c);
   math::XYZPoint calculatePosition(const std::vector<int>& v, const unsigned int layerId) const;
   void setDensity(const unsigned int layerId);
@@ -12,12 +12,39 @@
 #include <algorithm>
 #include <cassert>
 
+// The hits of a layer sorted by tile: the hits of a tile are contiguous,
+// in the order in which they were filled, and their positions are copied
+// in the same order so that the loops over the hits of a tile run over
+// contiguous arrays.
 class HGCalLayerTiles {
 public:
+  static constexpr int nTiles = hgcaltilesconstants::nColumns * hgcaltilesconstants::nRows;
+
   void fill(const std::vector<float>& x, const std::vector<float>& y) {
-    auto cellsSize = x.size();
+    const unsigned int cellsSize = x.size();
+
+    // counting sort of the hits by tile
+    tileOfCell_.resize(cellsSize);
+    offsets_.assign(nTiles + 1, 0);
+    for (unsigned int i = 0; i < cellsSize; ++i) {
+      tileOfCell_[i] = getGlobalBin(x[i], y[i]);
+      ++offsets_[tileOfCell_[i] + 1];
+    }
+    maxTileSize_ = 0;
+    for (int t = 0; t < nTiles; ++t) {
+      maxTileSize_ = std::max(maxTileSize_, offsets_[t + 1]);
+      offsets_[t + 1] += offsets_[t];
+    }
+
+    cells_.resize(cellsSize);
+    x_.resize(cellsSize);
+    y_.resize(cellsSize);
+    fillPosition_.assign(offsets_.begin(), offsets_.end() - 1);
     for (unsigned int i = 0; i < cellsSize; ++i) {
-      tiles_[getGlobalBin(x[i], y[i])].push_back(i);
+      const int p = fillPosition_[tileOfCell_[i]]++;
+      cells_[p] = i;
+      x_[p] = x[i];
+      y_[p] = y[i];
     }
   }
 
@@ -26,7 +53,7 @@ public:
     static_assert(xRange >= 0.);
     constexpr float r = hgcaltilesconstants::nColumns / xRange;
     int xBin = (x - hgcaltilesconstants::minX) * r;
-    xBin = std::clamp(xBin, 0, hgcaltilesconstants::nColumns);
+    xBin = std::clamp(xBin, 0, hgcaltilesconstants::nColumns - 1);
     return xBin;
   }
 
@@ -35,7 +62,7 @@ public:
     static_assert(yRange >= 0.);
     constexpr float r = hgcaltilesconstants::nRows / yRange;
     int yBin = (y - hgcaltilesconstants::minY) * r;
-    yBin = std::clamp(yBin, 0, hgcaltilesconstants::nRows);
+    yBin = std::clamp(yBin, 0, hgcaltilesconstants::nRows - 1);
     return yBin;
   }
 
@@ -52,14 +79,44 @@ public:
   }
 
   void clear() {
-    for (auto& t : tiles_)
-      t.clear();
+    offsets_.assign(nTiles + 1, 0);
+    cells_.clear();
+    x_.clear();
+    y_.clear();
+    tileOfCell_.clear();
+    maxTileSize_ = 0;
   }
 
-  const std::vector<int>& operator[](int globalBinId) const { return tiles_[globalBinId]; }
+  // the hits of a tile are those at the positions [begin, end)
+  int begin(int globalBinId) const { return offsets_[globalBinId]; }
+  int end(int globalBinId) const { return offsets_[globalBinId + 1]; }
+  int maxTileSize() const { return maxTileSize_; }
+
+  // number of hits, and index in the filled vectors of the hit at position p
+  unsigned int size() const { return cells_.size(); }
+  int cell(int p) const { return cells_[p]; }
+
+  // positions of the hits, in tile order
+  const float* x() const { return x_.data(); }
+  const float* y() const { return y_.data(); }
+
+  // copies a per-hit quantity into tile order
+  template <typename T>
+  void sort(const std::vector<T>& in, std::vector<T>& out) const {
+    out.resize(cells_.size());
+    for (unsigned int p = 0; p < cells_.size(); ++p)
+      out[p] = in[cells_[p]];
+  }
 
 private:
-  std::array<std::vector<int>, hgcaltilesconstants::nColumns * hgcaltilesconstants::nRows> tiles_;
+  std::vector<int> offsets_;
+  std::vector<int> cells_;
+  std::vector<float> x_;
+  std::vector<float> y_;
+  // work space for the sorting
+  std::vector<int> tileOfCell_;
+  std::vector<int> fillPosition_;
+  int maxTileSize_ = 0;
 };
 
 #endif
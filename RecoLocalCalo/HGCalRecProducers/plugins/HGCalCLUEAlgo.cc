@@ -11,15 +11,29 @@
 #include "DataFormats/CaloRecHit/interface/CaloID.h"
 #include "tbb/task_arena.h"
 #include "tbb/tbb.h"
+#include <algorithm>
 #include <limits>
 
 using namespace hgcal_clustering;
 
 void HGCalCLUEAlgo::getEventSetupPerAlgorithm(const edm::EventSetup& es) {
-  cells_.clear();
-  numberOfClustersPerLayer_.clear();
-  cells_.resize(2 * (maxlayer_ + 1));
-  numberOfClustersPerLayer_.resize(2 * (maxlayer_ + 1), 0);
+  // the per-layer containers keep their buffers across events, they are only reallocated
+  // when the number of layers changes
+  const unsigned int nLayers = 2 * (maxlayer_ + 1);
+  if (tiles_.size() != nLayers) {
+    cells_.clear();
+    tiles_.clear();
+    numberOfClustersPerLayer_.clear();
+    cells_.resize(nLayers);
+    tiles_.resize(nLayers);
+    numberOfClustersPerLayer_.resize(nLayers, 0);
+  } else {
+    for (auto& cells : cells_)
+      cells.clear();
+    for (auto& tiles : tiles_)
+      tiles.clear();
+    std::fill(numberOfClustersPerLayer_.begin(), numberOfClustersPerLayer_.end(), 0);
+  }
 }
 
 void HGCalCLUEAlgo::populate(const HGCRecHitCollection& hits) {
@@ -81,7 +95,7 @@ void HGCalCLUEAlgo::makeClusters() {
   // assign all hits in each layer to a cluster core
   tbb::this_task_arena::isolate([&] {
     tbb::parallel_for(size_t(0), size_t(2 * maxlayer_ + 2), [&](size_t i) {
-      HGCalLayerTiles lt;
+      HGCalLayerTiles& lt = tiles_[i];
       lt.fill(cells_[i].x, cells_[i].y);
       float delta_c;  // maximum search distance (critical distance) for local
                       // density calculation
@@ -107,57 +121,55 @@ void HGCalCLUEAlgo::makeClusters() {
 std::vector<reco::BasicCluster> HGCalCLUEAlgo::getClusters(bool) {
   std::vector<int> offsets(numberOfClustersPerLayer_.size(), 0);
 
-  int maxClustersOnLayer = numberOfClustersPerLayer_[0];
-
   for (unsigned layerId = 1; layerId < offsets.size(); ++layerId) {
     offsets[layerId] = offsets[layerId - 1] + numberOfClustersPerLayer_[layerId - 1];
-
-    maxClustersOnLayer = std::max(maxClustersOnLayer, numberOfClustersPerLayer_[layerId]);
   }
 
   auto totalNumberOfClusters = offsets.back() + numberOfClustersPerLayer_.back();
   clusters_v_.resize(totalNumberOfClusters);
-  std::vector<std::vector<int>> cellsIdInCluster;
-  cellsIdInCluster.reserve(maxClustersOnLayer);
-
-  for (unsigned int layerId = 0; layerId < 2 * maxlayer_ + 2; ++layerId) {
-    cellsIdInCluster.resize(numberOfClustersPerLayer_[layerId]);
-    auto& cellsOnLayer = cells_[layerId];
-    unsigned int numberOfCells = cellsOnLayer.detid.size();
-    auto firstClusterIdx = offsets[layerId];
-
-    for (unsigned int i = 0; i < numberOfCells; ++i) {
-      auto clusterIndex = cellsOnLayer.clusterIndex[i];
-      if (clusterIndex != -1)
-        cellsIdInCluster[clusterIndex].push_back(i);
-    }
 
-    std::vector<std::pair<DetId, float>> thisCluster;
+  // the clusters of each layer go to their own range of clusters_v_
+  tbb::this_task_arena::isolate([&] {
+    tbb::parallel_for(size_t(0), size_t(2 * maxlayer_ + 2), [&](size_t layerId) {
+      buildClusters(layerId, offsets[layerId]);
+    });
+  });
 
-    for (auto& cl : cellsIdInCluster) {
-      auto position = calculatePosition(cl, layerId);
-      float energy = 0.f;
-      int seedDetId = -1;
+  return clusters_v_;
+}
 
-      for (auto cellIdx : cl) {
-        energy += cellsOnLayer.weight[cellIdx];
-        thisCluster.emplace_back(cellsOnLayer.detid[cellIdx], 1.f);
-        if (cellsOnLayer.isSeed[cellIdx]) {
-          seedDetId = cellsOnLayer.detid[cellIdx];
-        }
-      }
-      auto globalClusterIndex = cellsOnLayer.clusterIndex[cl[0]] + firstClusterIdx;
+void HGCalCLUEAlgo::buildClusters(const unsigned int layerId, const int firstClusterIdx) {
+  std::vector<std::vector<int>> cellsIdInCluster(numberOfClustersPerLayer_[layerId]);
+  auto& cellsOnLayer = cells_[layerId];
+  unsigned int numberOfCells = cellsOnLayer.detid.size();
+
+  for (unsigned int i = 0; i < numberOfCells; ++i) {
+    auto clusterIndex = cellsOnLayer.clusterIndex[i];
+    if (clusterIndex != -1)
+      cellsIdInCluster[clusterIndex].push_back(i);
+  }
+
+  std::vector<std::pair<DetId, float>> thisCluster;
 
-      clusters_v_[globalClusterIndex] =
-          reco::BasicCluster(energy, position, reco::CaloID::DET_HGCAL_ENDCAP, thisCluster, algoId_);
-      clusters_v_[globalClusterIndex].setSeed(seedDetId);
-      thisCluster.clear();
+  for (auto& cl : cellsIdInCluster) {
+    auto position = calculatePosition(cl, layerId);
+    float energy = 0.f;
+    int seedDetId = -1;
+
+    for (auto cellIdx : cl) {
+      energy += cellsOnLayer.weight[cellIdx];
+      thisCluster.emplace_back(cellsOnLayer.detid[cellIdx], 1.f);
+      if (cellsOnLayer.isSeed[cellIdx]) {
+        seedDetId = cellsOnLayer.detid[cellIdx];
+      }
     }
+    auto globalClusterIndex = cellsOnLayer.clusterIndex[cl[0]] + firstClusterIdx;
 
-    cellsIdInCluster.clear();
+    clusters_v_[globalClusterIndex] =
+        reco::BasicCluster(energy, position, reco::CaloID::DET_HGCAL_ENDCAP, thisCluster, algoId_);
+    clusters_v_[globalClusterIndex].setSeed(seedDetId);
+    thisCluster.clear();
   }
-
-  return clusters_v_;
 }
 
 math::XYZPoint HGCalCLUEAlgo::calculatePosition(const std::vector<int>& v, const unsigned int layerId) const {
@@ -218,73 +230,106 @@ math::XYZPoint HGCalCLUEAlgo::calculatePosition(const std::vector<int>& v, const
 
 void HGCalCLUEAlgo::calculateLocalDensity(const HGCalLayerTiles& lt, const unsigned int layerId, float delta_c) {
   auto& cellsOnLayer = cells_[layerId];
-  unsigned int numberOfCells = cellsOnLayer.detid.size();
-
-  for (unsigned int i = 0; i < numberOfCells; i++) {
-    std::array<int, 4> search_box = lt.searchBox(cellsOnLayer.x[i] - delta_c,
-                                                 cellsOnLayer.x[i] + delta_c,
-                                                 cellsOnLayer.y[i] - delta_c,
-                                                 cellsOnLayer.y[i] + delta_c);
-
+  unsigned int numberOfCells = lt.size();
+
+  // the hits are taken in tile order, and the loops over the hits of a tile
+  // run over contiguous arrays: the contributions are computed in a loop that
+  // can be vectorized, and then summed in the order of the hits
+  const float* x = lt.x();
+  const float* y = lt.y();
+  lt.sort(cellsOnLayer.weight, cellsOnLayer.tileWeight);
+  const float* weight = cellsOnLayer.tileWeight.data();
+  cellsOnLayer.tileRho.resize(numberOfCells);
+  cellsOnLayer.work.resize(lt.maxTileSize());
+  float* contribution = cellsOnLayer.work.data();
+
+  for (unsigned int p = 0; p < numberOfCells; p++) {
+    const float xp = x[p];
+    const float yp = y[p];
+    std::array<int, 4> search_box = lt.searchBox(xp - delta_c, xp + delta_c, yp - delta_c, yp + delta_c);
+
+    float rho = 0.f;
     for (int xBin = search_box[0]; xBin < search_box[1] + 1; ++xBin) {
       for (int yBin = search_box[2]; yBin < search_box[3] + 1; ++yBin) {
         int binId = lt.getGlobalBinByBin(xBin, yBin);
-        size_t binSize = lt[binId].size();
-
-        for (unsigned int j = 0; j < binSize; j++) {
-          unsigned int otherId = lt[binId][j];
-          if (distance(i, otherId, layerId) < delta_c) {
-            cellsOnLayer.rho[i] += (i == otherId ? 1.f : 0.5f) * cellsOnLayer.weight[otherId];
-          }
+        const int begin = lt.begin(binId);
+        const int binSize = lt.end(binId) - begin;
+
+        for (int j = 0; j < binSize; j++) {
+          const float dx = xp - x[begin + j];
+          const float dy = yp - y[begin + j];
+          const float w = (begin + j == int(p) ? 1.f : 0.5f) * weight[begin + j];
+          contribution[j] = (std::sqrt(dx * dx + dy * dy) < delta_c) ? w : 0.f;
         }
+        for (int j = 0; j < binSize; j++)
+          rho += contribution[j];
       }
     }
+    cellsOnLayer.tileRho[p] = rho;
+    cellsOnLayer.rho[lt.cell(p)] = rho;
   }
 }
 
 void HGCalCLUEAlgo::calculateDistanceToHigher(const HGCalLayerTiles& lt, const unsigned int layerId, float delta_c) {
   auto& cellsOnLayer = cells_[layerId];
-  unsigned int numberOfCells = cellsOnLayer.detid.size();
-
-  for (unsigned int i = 0; i < numberOfCells; i++) {
+  unsigned int numberOfCells = lt.size();
+
+  // as for the density, the distances to the hits of a tile are computed
+  // first, and then compared in the order of the hits
+  const float* x = lt.x();
+  const float* y = lt.y();
+  const float* rho = cellsOnLayer.tileRho.data();
+  lt.sort(cellsOnLayer.detid, cellsOnLayer.tileDetid);
+  const DetId* detid = cellsOnLayer.tileDetid.data();
+  float* dist = cellsOnLayer.work.data();
+
+  for (unsigned int p = 0; p < numberOfCells; p++) {
     // initialize delta and nearest higher for i
     float maxDelta = std::numeric_limits<float>::max();
     float i_delta = maxDelta;
     int i_nearestHigher = -1;
 
+    const float xp = x[p];
+    const float yp = y[p];
+    const float rhop = rho[p];
+    const DetId detidp = detid[p];
+
     // get search box for ith hit
     // guarantee to cover a range "outlierDeltaFactor_*delta_c"
     auto range = outlierDeltaFactor_ * delta_c;
-    std::array<int, 4> search_box = lt.searchBox(
-        cellsOnLayer.x[i] - range, cellsOnLayer.x[i] + range, cellsOnLayer.y[i] - range, cellsOnLayer.y[i] + range);
+    std::array<int, 4> search_box = lt.searchBox(xp - range, xp + range, yp - range, yp + range);
 
     // loop over all bins in the search box
     for (int xBin = search_box[0]; xBin < search_box[1] + 1; ++xBin) {
       for (int yBin = search_box[2]; yBin < search_box[3] + 1; ++yBin) {
         // get the id of this bin
         size_t binId = lt.getGlobalBinByBin(xBin, yBin);
-        // get the size of this bin
-        size_t binSize = lt[binId].size();
+        // get the hits of this bin
+        const int begin = lt.begin(binId);
+        const int binSize = lt.end(binId) - begin;
+
+        for (int j = 0; j < binSize; j++) {
+          const float dx = xp - x[begin + j];
+          const float dy = yp - y[begin + j];
+          dist[j] = std::sqrt(dx * dx + dy * dy);
+        }
 
         // loop over all hits in this bin
-        for (unsigned int j = 0; j < binSize; j++) {
-          unsigned int otherId = lt[binId][j];
-
-          float dist = distance(i, otherId, layerId);
-          bool foundHigher =
-              (cellsOnLayer.rho[otherId] > cellsOnLayer.rho[i]) ||
-              (cellsOnLayer.rho[otherId] == cellsOnLayer.rho[i] && cellsOnLayer.detid[otherId] > cellsOnLayer.detid[i]);
+        for (int j = 0; j < binSize; j++) {
+          const int q = begin + j;
+          bool foundHigher = (rho[q] > rhop) || (rho[q] == rhop && detid[q] > detidp);
           // if dist == i_delta, then last comer being the nearest higher
-          if (foundHigher && dist <= i_delta) {
+          if (foundHigher && dist[j] <= i_delta) {
             // update i_delta
-            i_delta = dist;
+            i_delta = dist[j];
             // update i_nearestHigher
-            i_nearestHigher = otherId;
+            i_nearestHigher = lt.cell(q);
           }
         }
       }
     }
 
+    const int i = lt.cell(p);
     bool foundNearestHigherInSearchBox = (i_delta != maxDelta);
     if (foundNearestHigherInSearchBox) {
       cellsOnLayer.delta[i] = i_delta;
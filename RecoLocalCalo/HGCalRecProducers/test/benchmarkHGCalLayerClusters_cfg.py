@@ -0,0 +1,69 @@
+# Timing of the HGCal layer clustering (CLUE) on 200 pileup events.
+#
+# Runs the HGCal local reconstruction from the digis of a 200 pileup
+# sample (step2 of a Phase2 workflow) and reports the time per module
+# with the FastTimerService:
+#
+#   cmsRun benchmarkHGCalLayerClusters_cfg.py inputFiles=file:step2_PU200.root threads=8
+#
+import FWCore.ParameterSet.Config as cms
+import FWCore.ParameterSet.VarParsing as VarParsing
+
+from Configuration.StandardSequences.Eras import eras
+
+options = VarParsing.VarParsing('analysis')
+options.register('threads',
+                 1,
+                 VarParsing.VarParsing.multiplicity.singleton,
+                 VarParsing.VarParsing.varType.int,
+                 "Number of threads (and streams)")
+options.maxEvents = 100
+options.parseArguments()
+
+process = cms.Process('BENCH', eras.Phase2C8)
+
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('Configuration.Geometry.GeometryExtended2023D41Reco_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+process.load('RecoLocalCalo.Configuration.hgcalLocalReco_cff')
+
+# referenced by the clustering configuration
+from SimCalorimetry.HGCalSimProducers.hgcalDigitizer_cfi import HGCAL_noises
+process.HGCAL_noises = HGCAL_noises
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase2_realistic', '')
+
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(options.maxEvents) )
+process.source = cms.Source("PoolSource",
+                            fileNames = cms.untracked.vstring(options.inputFiles)
+                            )
+
+process.options = cms.untracked.PSet( numberOfThreads = cms.untracked.uint32(options.threads),
+                                      numberOfStreams = cms.untracked.uint32(0),
+                                      wantSummary = cms.untracked.bool(True)
+                                      )
+process.MessageLogger.cerr.FwkReport.reportEvery = 10
+
+process.p = cms.Path( process.HGCalUncalibRecHit *
+                      process.HGCalRecHit *
+                      process.hgcalLayerClusters )
+
+#########################
+#    Time Profiling     #
+#########################
+
+# remove any instance of the FastTimerService
+if 'FastTimerService' in process.__dict__:
+    del process.FastTimerService
+
+# instrument the menu with the FastTimerService
+process.load( "HLTrigger.Timer.FastTimerService_cfi" )
+
+# print a text summary at the end of the job
+process.FastTimerService.printEventSummary        = False
+process.FastTimerService.printRunSummary          = False
+process.FastTimerService.printJobSummary          = True
+process.FastTimerService.enableDQM                = False
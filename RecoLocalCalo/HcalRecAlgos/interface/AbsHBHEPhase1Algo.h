@@ -1,6 +1,8 @@
 #ifndef RecoLocalCalo_HcalRecAlgos_AbsHBHEPhase1Algo_h_
 #define RecoLocalCalo_HcalRecAlgos_AbsHBHEPhase1Algo_h_
 
+#include <vector>
+
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "DataFormats/HcalRecHit/interface/HBHERecHit.h"
 #include "DataFormats/HcalRecHit/interface/HBHEChannelInfo.h"
@@ -50,6 +52,24 @@ public:
                                  const HcalRecoParam* params,
                                  const HcalCalibrations& calibs,
                                  bool isRealData) = 0;
+
+  // Algorithms which reconstruct several channels together (typically,
+  // by fitting them at once) should return "true" here and override
+  // "reconstructBatch" below.
+  inline virtual bool hasBatchReconstruction() const { return false; }
+
+  // Reconstruct all the given channels, appending one rechit per channel
+  // to "rechits" (with the same convention as "reconstruct" for the
+  // discarded ones). The elements of "params" may be null. By default,
+  // the channels are reconstructed one by one.
+  inline virtual void reconstructBatch(const std::vector<HBHEChannelInfo>& infos,
+                                       const std::vector<const HcalRecoParam*>& params,
+                                       const std::vector<const HcalCalibrations*>& calibs,
+                                       bool isRealData,
+                                       std::vector<HBHERecHit>& rechits) {
+    for (unsigned i = 0; i < infos.size(); ++i)
+      rechits.push_back(reconstruct(infos[i], params[i], *calibs[i], isRealData));
+  }
 };
 
 #endif  // RecoLocalCalo_HcalRecAlgos_AbsHBHEPhase1Algo_h_
@@ -129,6 +129,9 @@ public:
   const HcalTimeSlew* hcalTimeSlewDelay_ = nullptr;
 
 private:
+  // batched version of the fit, which takes its configuration from this one
+  friend class MahiFitBatch;
+
   double minimize() const;
   void onePulseMinimize() const;
   void updateCov() const;
@@ -0,0 +1,149 @@
+#ifndef RecoLocalCalo_HcalRecAlgos_MahiFitBatch_HH
+#define RecoLocalCalo_HcalRecAlgos_MahiFitBatch_HH
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiPulseTable.h"
+
+//
+// Mahi fit of many channels at once, with the same configuration and
+// results as MahiFit::phase1Apply.
+//
+// The channels are grouped by number of time slices and sample of
+// interest, which fix the size of the fit and the active BXs, and each
+// group is fitted nLanes_ channels at a time. The matrices of the
+// channels are stored interleaved, as [row][column][lane], so that the
+// covariance update, the Cholesky decompositions and the solutions of
+// the NNLS iterations are loops over the lanes that the compiler can
+// vectorize. The NNLS active sets are kept as per-lane masks instead of
+// permuting the matrices, and a lane whose fit has converged is refilled
+// with the next channel of the group. The pulse shapes are taken from a
+// MahiPulseTable for each pulse shape template.
+//
+// Usage: for each channel, call setPulseShapeTemplate and addChannel
+// (as setPulseShapeTemplate and phase1Apply for MahiFit), then fit and
+// get the results of each channel.
+//
+class MahiFitBatch {
+public:
+  static constexpr unsigned int nLanes_ = 8;
+
+  // Takes the configuration of the fit, which needs consecutive active BXs
+  explicit MahiFitBatch(const MahiFit& config);
+
+  void setPulseShapeTemplate(const HcalPulseShapes::Shape& ps, const HcalTimeSlew* hcalTimeSlewDelay);
+
+  // Returns the index of the channel in the batch
+  unsigned int addChannel(const HBHEChannelInfo& channelData);
+  unsigned int size() const { return channels_.size(); }
+  void clear() { channels_.clear(); }
+
+  void fit();
+
+  void result(unsigned int ich,
+              float& reconstructedEnergy,
+              float& reconstructedTime,
+              bool& useTriple,
+              float& chi2) const;
+
+private:
+  static constexpr unsigned int nS_ = MaxSVSize;
+  static constexpr unsigned int nP_ = MaxPVSize;
+
+  struct Channel {
+    unsigned int tsSize;
+    unsigned int tsOffset;
+    double dt;
+    double pedVal;
+    double gain;
+    std::array<double, MaxSVSize> amplitudes;
+    std::array<double, MaxSVSize> noiseTerms;
+    const MahiPulseTable* pulseTable;
+    const HcalTimeSlew* hcalTimeSlewDelay;
+    float tsDelay1GeV;
+    bool doFit;
+
+    // as in MahiFit::phase1Apply
+    std::array<float, 3> reconstructedVals;
+    bool useTriple;
+  };
+
+  // fit the channels with nbx pulses, as in MahiFit::doFit
+  void fitChannels(std::vector<unsigned int>& channels, int nbx);
+  void fitGroup(const unsigned int* channels, unsigned int nChannels, int nbx);
+
+  void loadChannel(unsigned int ich, unsigned int l);
+  void loadEmpty(unsigned int l);
+  void storeResult(unsigned int l);
+
+  void updatePulseShape(const Channel& channel, double itQ, int offset, unsigned int ipulse, unsigned int l);
+  void updateCov();
+  void whiten();
+  void nnls(const bool* running);
+  void onePulseMinimize(const bool* running);
+  void calculateChiSq(double* chiSq) const;
+  float calculateArrivalTime(unsigned int l) const;
+
+  // configuration
+  bool dynamicPed_;
+  float ts4Thresh_;
+  float chiSqSwitch_;
+  bool applyTimeSlew_;
+  HcalTimeSlew::BiasSetting slewFlavor_;
+  bool calculateArrivalTime_;
+  float meanTime_;
+  float timeSigmaHPD_;
+  float timeSigmaSiPM_;
+  std::vector<int> activeBXs_;
+  int nMaxItersMin_;
+  int nMaxItersNNLS_;
+  float deltaChiSqThresh_;
+  float nnlsThresh_;
+  unsigned int bxSizeConf_;
+  int bxOffsetConf_;
+
+  // pulse shape tables, built once for each template
+  std::unordered_map<const HcalPulseShapes::Shape*, std::unique_ptr<MahiPulseTable>> pulseTables_;
+  const MahiPulseTable* currentPulseTable_ = nullptr;
+  const HcalTimeSlew* hcalTimeSlewDelay_ = nullptr;
+  float tsDelay1GeV_ = 0.f;
+
+  std::vector<Channel> channels_;
+
+  // current group: sizes and active BXs
+  unsigned int tsSize_;
+  unsigned int nPulseTot_;
+  int bxs_[nP_];
+
+  // channel in each lane (-1 if none) and its minimization state
+  int laneChannel_[nLanes_];
+  int iter_[nLanes_];
+  double chiSq_[nLanes_];
+  double oldChiSq_[nLanes_];
+
+  // inputs of the channels in the lanes
+  alignas(64) double amplitudes_[nS_][nLanes_];
+  alignas(64) double noiseTerms_[nS_][nLanes_];
+  alignas(64) double pedVal_[nLanes_];
+  alignas(64) double pulseMat_[nS_][nP_][nLanes_];
+  alignas(64) double pulseDerivMat_[nS_][nP_][nLanes_];
+  // pulse shape variations that make the pulse covariance of each BX
+  alignas(64) double pulseCovP_[nP_][nS_][nLanes_];
+  alignas(64) double pulseCovM_[nP_][nS_][nLanes_];
+
+  // fit state and work space
+  alignas(64) double covL_[nS_][nS_][nLanes_];
+  alignas(64) double covLInvDiag_[nS_][nLanes_];
+  alignas(64) double invcovp_[nS_][nP_][nLanes_];
+  alignas(64) double invcovs_[nS_][nLanes_];
+  alignas(64) double aTaMat_[nP_][nP_][nLanes_];
+  alignas(64) double aTbVec_[nP_][nLanes_];
+  alignas(64) double ampVec_[nP_][nLanes_];
+  alignas(64) double passive_[nP_][nLanes_];  // 1 for the unconstrained parameters of the NNLS, 0 otherwise
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef RecoLocalCalo_HcalRecAlgos_MahiPulseTable_h
+#define RecoLocalCalo_HcalRecAlgos_MahiPulseTable_h
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShapes.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/PulseShapeFunctor.h"
+
+//
+// Dense table of the unit-amplitude pulse shape used by Mahi, as a
+// function of the pulse time. The shape computed by PulseShapeFunctor
+// is linear in the time within each half-ns step, so the table keeps,
+// for each step, the value and the slope of the HcalConst::maxSamples
+// time slices, and gives the same shape as the functor with a single
+// multiply-add per time slice. The step boundaries and the times out
+// of the table range go through the functor itself.
+//
+class MahiPulseTable {
+public:
+  explicit MahiPulseTable(const HcalPulseShapes::Shape& ps);
+
+  // Same as PulseShapeFunctor::singlePulseShapeFuncMahi with
+  // parameters {t0, 1.0, 0.0, 3} followed by getPulseShape
+  void pulseShape(double t0, std::array<double, HcalConst::maxSamples>& pulse) const;
+
+private:
+  static constexpr int stepsPerNs_ = 2;
+  // the pulse starts within the time slices for t0 + HcalConst::iniTimeShift
+  // in (0, nsPerBX * maxSamples - 1)
+  static constexpr int nSteps_ = stepsPerNs_ * (HcalConst::nsPerBX * HcalConst::maxSamples - 1);
+
+  void evaluate(double t0, std::array<double, HcalConst::maxSamples>& pulse) const;
+
+  // [step][time slice]
+  std::vector<double> value_;
+  std::vector<double> slope_;
+
+  // not thread safe, as for MahiFit
+  std::unique_ptr<FitterFuncs::PulseShapeFunctor> psfPtr_;
+};
+
+#endif  // RecoLocalCalo_HcalRecAlgos_MahiPulseTable_h
@@ -13,6 +13,7 @@
 #include "RecoLocalCalo/HcalRecAlgos/interface/PulseShapeFitOOTPileupCorrection.h"
 #include "RecoLocalCalo/HcalRecAlgos/interface/HcalDeterministicFit.h"
 #include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiFitBatch.h"
 #include "CalibCalorimetry/HcalAlgos/interface/HcalTimeSlew.h"
 
 class SimpleHBHEPhase1Algo : public AbsHBHEPhase1Algo {
@@ -39,6 +40,11 @@ public:
   //
   //   detFit           -- "Method 3" (a.k.a. "deterministic fit") object
   //
+  //   mahi             -- Mahi object
+  //
+  //   batchedMahi      -- fit all the channels of "reconstructBatch"
+  //                       together with Mahi
+  //
   SimpleHBHEPhase1Algo(int firstSampleShift,
                        int samplesToAdd,
                        float phaseNS,
@@ -47,7 +53,8 @@ public:
                        bool applyLegacyHBMCorrection,
                        std::unique_ptr<PulseShapeFitOOTPileupCorrection> m2,
                        std::unique_ptr<HcalDeterministicFit> detFit,
-                       std::unique_ptr<MahiFit> mahi);
+                       std::unique_ptr<MahiFit> mahi,
+                       bool batchedMahi);
 
   inline ~SimpleHBHEPhase1Algo() override {}
 
@@ -61,6 +68,15 @@ public:
                          const HcalRecoParam* params,
                          const HcalCalibrations& calibs,
                          bool isRealData) override;
+
+  inline bool hasBatchReconstruction() const override { return mahiBatch_.get() != nullptr; }
+
+  void reconstructBatch(const std::vector<HBHEChannelInfo>& infos,
+                        const std::vector<const HcalRecoParam*>& params,
+                        const std::vector<const HcalCalibrations*>& calibs,
+                        bool isRealData,
+                        std::vector<HBHERecHit>& rechits) override;
+
   // Basic accessors
   inline int getFirstSampleShift() const { return firstSampleShift_; }
   inline int getSamplesToAdd() const { return samplesToAdd_; }
@@ -91,6 +107,14 @@ protected:
                int nSamplesToExamine) const;
 
 private:
+  // Reconstruction of one channel. If "mahiBatchIndex" is not negative,
+  // the Mahi results are taken from that channel of the batched fit.
+  HBHERecHit reconstructChannel(const HBHEChannelInfo& info,
+                                const HcalRecoParam* params,
+                                const HcalCalibrations& calibs,
+                                bool isRealData,
+                                int mahiBatchIndex);
+
   HcalPulseContainmentManager pulseCorr_;
 
   int firstSampleShift_;
@@ -110,6 +134,9 @@ private:
   // Mahi algorithm
   std::unique_ptr<MahiFit> mahiOOTpuCorr_;
 
+  // Mahi fit of many channels at once, with the same configuration
+  std::unique_ptr<MahiFitBatch> mahiBatch_;
+
   HcalPulseShapes theHcalPulseShapes_;
 };
 
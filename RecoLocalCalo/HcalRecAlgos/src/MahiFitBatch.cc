@@ -0,0 +1,708 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiFitBatch.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+namespace {
+
+  // all the helpers work on [row][column][lane] (or [row][lane]) arrays, with the lane loop innermost
+  // so that it is vectorized; n is the size of the (leading) square block that is used
+
+  // in-place Cholesky decomposition of the lower triangle of m, invdiag is set to 1/L(i,i)
+  template <unsigned int N, unsigned int L>
+  void cholesky(double (&m)[N][N][L], double (&invdiag)[N][L], unsigned int n) {
+    for (unsigned int j = 0; j < n; ++j) {
+      for (unsigned int k = 0; k < j; ++k)
+        for (unsigned int l = 0; l < L; ++l)
+          m[j][j][l] -= m[j][k][l] * m[j][k][l];
+      for (unsigned int l = 0; l < L; ++l) {
+        m[j][j][l] = std::sqrt(m[j][j][l]);
+        invdiag[j][l] = 1. / m[j][j][l];
+      }
+      for (unsigned int i = j + 1; i < n; ++i) {
+        for (unsigned int k = 0; k < j; ++k)
+          for (unsigned int l = 0; l < L; ++l)
+            m[i][j][l] -= m[i][k][l] * m[j][k][l];
+        for (unsigned int l = 0; l < L; ++l)
+          m[i][j][l] *= invdiag[j][l];
+      }
+    }
+  }
+
+  // solve L*y = b in place
+  template <unsigned int N, unsigned int L>
+  void forwardSubstitute(const double (&m)[N][N][L], const double (&invdiag)[N][L], double (&b)[N][L], unsigned int n) {
+    for (unsigned int i = 0; i < n; ++i) {
+      for (unsigned int k = 0; k < i; ++k)
+        for (unsigned int l = 0; l < L; ++l)
+          b[i][l] -= m[i][k][l] * b[k][l];
+      for (unsigned int l = 0; l < L; ++l)
+        b[i][l] *= invdiag[i][l];
+    }
+  }
+
+  // solve L^T*x = y in place
+  template <unsigned int N, unsigned int L>
+  void backSubstitute(const double (&m)[N][N][L], const double (&invdiag)[N][L], double (&b)[N][L], unsigned int n) {
+    for (int i = n - 1; i >= 0; --i) {
+      for (unsigned int k = i + 1; k < n; ++k)
+        for (unsigned int l = 0; l < L; ++l)
+          b[i][l] -= m[k][i][l] * b[k][l];
+      for (unsigned int l = 0; l < L; ++l)
+        b[i][l] *= invdiag[i][l];
+    }
+  }
+
+}  // namespace
+
+MahiFitBatch::MahiFitBatch(const MahiFit& config)
+    : dynamicPed_(config.dynamicPed_),
+      ts4Thresh_(config.ts4Thresh_),
+      chiSqSwitch_(config.chiSqSwitch_),
+      applyTimeSlew_(config.applyTimeSlew_),
+      slewFlavor_(config.slewFlavor_),
+      calculateArrivalTime_(config.calculateArrivalTime_),
+      meanTime_(config.meanTime_),
+      timeSigmaHPD_(config.timeSigmaHPD_),
+      timeSigmaSiPM_(config.timeSigmaSiPM_),
+      activeBXs_(config.activeBXs_),
+      nMaxItersMin_(config.nMaxItersMin_),
+      nMaxItersNNLS_(config.nMaxItersNNLS_),
+      deltaChiSqThresh_(config.deltaChiSqThresh_),
+      nnlsThresh_(config.nnlsThresh_),
+      bxSizeConf_(config.bxSizeConf_),
+      bxOffsetConf_(config.bxOffsetConf_),
+      tsSize_(0),
+      nPulseTot_(0) {
+  // the pulse covariance of each BX is found from its position in the active BXs
+  for (unsigned int iBX = 1; iBX < activeBXs_.size(); ++iBX) {
+    if (activeBXs_[iBX] != activeBXs_[iBX - 1] + 1)
+      throw cms::Exception("HcalMahiWeirdState") << "Batched Mahi fit needs consecutive active BXs";
+  }
+  if (bxSizeConf_ + (dynamicPed_ ? 1 : 0) > nP_)
+    throw cms::Exception("HcalMahiWeirdState")
+        << "Weird number of pulses encountered in Mahi, module is configured incorrectly!";
+}
+
+void MahiFitBatch::setPulseShapeTemplate(const HcalPulseShapes::Shape& ps, const HcalTimeSlew* hcalTimeSlewDelay) {
+  auto& table = pulseTables_[&ps];
+  if (!table)
+    table = std::make_unique<MahiPulseTable>(ps);
+  currentPulseTable_ = table.get();
+
+  if (hcalTimeSlewDelay != hcalTimeSlewDelay_) {
+    hcalTimeSlewDelay_ = hcalTimeSlewDelay;
+    tsDelay1GeV_ = hcalTimeSlewDelay->delay(1.0, slewFlavor_);
+  }
+}
+
+unsigned int MahiFitBatch::addChannel(const HBHEChannelInfo& channelData) {
+  assert(channelData.nSamples() == 8 || channelData.nSamples() == 10);
+
+  channels_.emplace_back();
+  Channel& channel = channels_.back();
+
+  // same inputs as in MahiFit::phase1Apply
+  channel.tsSize = channelData.nSamples();
+  channel.tsOffset = channelData.soi();
+
+  // 1 sigma time constraint
+  if (channelData.hasTimeInfo())
+    channel.dt = timeSigmaSiPM_;
+  else
+    channel.dt = timeSigmaHPD_;
+
+  //Average pedestal width (for covariance matrix constraint)
+  float pedVal = 0.25 * (channelData.tsPedestalWidth(0) * channelData.tsPedestalWidth(0) +
+                         channelData.tsPedestalWidth(1) * channelData.tsPedestalWidth(1) +
+                         channelData.tsPedestalWidth(2) * channelData.tsPedestalWidth(2) +
+                         channelData.tsPedestalWidth(3) * channelData.tsPedestalWidth(3));
+  channel.pedVal = pedVal;
+  channel.gain = channelData.tsGain(0);
+
+  channel.amplitudes.fill(0.);
+  channel.noiseTerms.fill(0.);
+
+  double tsTOT = 0, tstrig = 0;  // in GeV
+  for (unsigned int iTS = 0; iTS < channel.tsSize; ++iTS) {
+    double charge = channelData.tsRawCharge(iTS);
+    double ped = channelData.tsPedestal(iTS);
+
+    channel.amplitudes[iTS] = charge - ped;
+
+    //ADC granularity
+    double noiseADC = (1. / sqrt(12)) * channelData.tsDFcPerADC(iTS);
+
+    //Photostatistics
+    double noisePhoto = 0;
+    if ((charge - ped) > channelData.tsPedestalWidth(iTS)) {
+      noisePhoto = sqrt((charge - ped) * channelData.fcByPE());
+    }
+
+    //Electronic pedestal
+    double pedWidth = channelData.tsPedestalWidth(iTS);
+
+    //Total uncertainty from all sources
+    channel.noiseTerms[iTS] = noiseADC * noiseADC + noisePhoto * noisePhoto + pedWidth * pedWidth;
+
+    tsTOT += (charge - ped) * channelData.tsGain(0);
+    if (iTS == channel.tsOffset) {
+      tstrig += (charge - ped) * channelData.tsGain(0);
+    }
+  }
+
+  channel.pulseTable = currentPulseTable_;
+  channel.hcalTimeSlewDelay = hcalTimeSlewDelay_;
+  channel.tsDelay1GeV = tsDelay1GeV_;
+
+  channel.doFit = (tstrig >= ts4Thresh_ && tsTOT > 0);
+  channel.reconstructedVals = {{0.0, -9999, -9999}};
+  channel.useTriple = false;
+
+  return channels_.size() - 1;
+}
+
+void MahiFitBatch::fit() {
+  std::vector<unsigned int> toFit;
+  toFit.reserve(channels_.size());
+  for (unsigned int ich = 0; ich < channels_.size(); ++ich) {
+    if (channels_[ich].doFit)
+      toFit.push_back(ich);
+  }
+
+  // only do pre-fit with 1 pulse if chiSq threshold is positive
+  if (chiSqSwitch_ > 0) {
+    fitChannels(toFit, 1);
+    std::vector<unsigned int> toRefit;
+    for (unsigned int ich : toFit) {
+      if (channels_[ich].reconstructedVals[2] > chiSqSwitch_) {
+        channels_[ich].useTriple = true;
+        toRefit.push_back(ich);
+      }
+    }
+    fitChannels(toRefit, 0);
+  } else {
+    for (unsigned int ich : toFit)
+      channels_[ich].useTriple = true;
+    fitChannels(toFit, 0);
+  }
+}
+
+void MahiFitBatch::result(
+    unsigned int ich, float& reconstructedEnergy, float& reconstructedTime, bool& useTriple, float& chi2) const {
+  const Channel& channel = channels_[ich];
+  reconstructedEnergy = channel.reconstructedVals[0] * channel.gain;
+  reconstructedTime = channel.reconstructedVals[1];
+  useTriple = channel.useTriple;
+  chi2 = channel.reconstructedVals[2];
+}
+
+void MahiFitBatch::fitChannels(std::vector<unsigned int>& channels, int nbx) {
+  // the number of time slices and the SOI fix the size of the fit and the BXs
+  auto key = [this](unsigned int ich) { return std::make_pair(channels_[ich].tsSize, channels_[ich].tsOffset); };
+  std::stable_sort(
+      channels.begin(), channels.end(), [&key](unsigned int i, unsigned int j) { return key(i) < key(j); });
+
+  for (unsigned int first = 0; first < channels.size();) {
+    unsigned int last = first + 1;
+    while (last < channels.size() && key(channels[last]) == key(channels[first]))
+      ++last;
+    fitGroup(&channels[first], last - first, nbx);
+    first = last;
+  }
+}
+
+void MahiFitBatch::fitGroup(const unsigned int* channels, unsigned int nChannels, int nbx) {
+  // active BXs as in MahiFit::doFit
+  const unsigned int tsOffset = channels_[channels[0]].tsOffset;
+  tsSize_ = channels_[channels[0]].tsSize;
+
+  unsigned int bxSize = 1;
+  if (nbx == 1) {
+    bxs_[0] = 0;
+  } else {
+    bxSize = bxSizeConf_;
+    const int shift = (static_cast<int>(tsOffset) + activeBXs_[0]) >= 0 ? 0 : (tsOffset + activeBXs_[0]);
+    for (unsigned int iBX = 0; iBX < bxSize; ++iBX)
+      bxs_[iBX] = activeBXs_[iBX] - shift;
+  }
+  nPulseTot_ = bxSize;
+  if (dynamicPed_) {
+    bxs_[nPulseTot_] = MahiFit::pedestalBX_;
+    nPulseTot_++;
+  }
+
+  // each lane runs the iterations of MahiFit::minimize on its own. Every iteration runs over all
+  // the lanes, busy or not, so a channel loaded alone while the others are close to convergence
+  // would keep the whole group iterating for it: the idle lanes wait until half of them are free
+  // and are refilled together, which keeps the channels of a group in step
+  unsigned int nextChannel = 0;
+  bool running[nLanes_];
+  for (unsigned int l = 0; l < nLanes_; ++l) {
+    laneChannel_[l] = -1;
+    running[l] = false;
+    loadEmpty(l);
+  }
+
+  while (true) {
+    unsigned int nIdle = 0;
+    for (unsigned int l = 0; l < nLanes_; ++l) {
+      if (running[l] && iter_[l] >= nMaxItersMin_)
+        running[l] = false;
+      if (!running[l] && laneChannel_[l] >= 0)
+        storeResult(l);
+      nIdle += !running[l];
+    }
+
+    if (2 * nIdle >= nLanes_) {
+      for (unsigned int l = 0; l < nLanes_; ++l) {
+        while (!running[l] && nextChannel < nChannels) {
+          loadChannel(channels[nextChannel++], l);
+          if (iter_[l] < nMaxItersMin_) {
+            running[l] = true;
+            --nIdle;
+          } else {
+            storeResult(l);
+          }
+        }
+      }
+    }
+    if (nIdle == nLanes_)
+      break;
+
+    updateCov();
+    whiten();
+    if (nPulseTot_ > 1) {
+      nnls(running);
+    } else {
+      onePulseMinimize(running);
+    }
+
+    double newChiSq[nLanes_];
+    calculateChiSq(newChiSq);
+    for (unsigned int l = 0; l < nLanes_; ++l) {
+      if (!running[l])
+        continue;
+      const double deltaChiSq = newChiSq[l] - chiSq_[l];
+
+      if (newChiSq[l] == oldChiSq_[l] && newChiSq[l] < chiSq_[l]) {
+        running[l] = false;
+        continue;
+      }
+      oldChiSq_[l] = chiSq_[l];
+      chiSq_[l] = newChiSq[l];
+
+      if (std::abs(deltaChiSq) < deltaChiSqThresh_)
+        running[l] = false;
+      else
+        ++iter_[l];
+    }
+  }
+}
+
+void MahiFitBatch::loadChannel(unsigned int ich, unsigned int l) {
+  const Channel& channel = channels_[ich];
+  laneChannel_[l] = ich;
+
+  for (unsigned int i = 0; i < nS_; ++i) {
+    amplitudes_[i][l] = channel.amplitudes[i];
+    noiseTerms_[i][l] = channel.noiseTerms[i];
+  }
+  pedVal_[l] = channel.pedVal;
+
+  for (unsigned int ipulse = 0; ipulse < nPulseTot_; ++ipulse) {
+    const int offset = bxs_[ipulse];
+    if (offset == MahiFit::pedestalBX_) {
+      for (unsigned int i = 0; i < nS_; ++i) {
+        pulseMat_[i][ipulse][l] = i < tsSize_ ? 1. : 0.;
+        pulseDerivMat_[i][ipulse][l] = 0.;
+        pulseCovP_[ipulse][i][l] = 0.;
+        pulseCovM_[ipulse][i][l] = 0.;
+      }
+    } else {
+      updatePulseShape(channel, channel.amplitudes[channel.tsOffset + offset], offset, ipulse, l);
+    }
+  }
+
+  // initial state as in MahiFit::minimize
+  for (unsigned int ipulse = 0; ipulse < nP_; ++ipulse) {
+    ampVec_[ipulse][l] = 0.;
+    passive_[ipulse][l] = 0.;
+  }
+  iter_[l] = 1;
+  chiSq_[l] = 9999;
+  oldChiSq_[l] = 9999;
+}
+
+void MahiFitBatch::loadEmpty(unsigned int l) {
+  // trivial problem for the lanes left without channels, so that they stay finite
+  for (unsigned int i = 0; i < nS_; ++i) {
+    amplitudes_[i][l] = 0.;
+    noiseTerms_[i][l] = 1.;
+    for (unsigned int ipulse = 0; ipulse < nP_; ++ipulse) {
+      pulseMat_[i][ipulse][l] = 0.;
+      pulseDerivMat_[i][ipulse][l] = 0.;
+      pulseCovP_[ipulse][i][l] = 0.;
+      pulseCovM_[ipulse][i][l] = 0.;
+    }
+  }
+  for (unsigned int ipulse = 0; ipulse < nP_; ++ipulse) {
+    pulseMat_[ipulse][ipulse][l] = 1.;
+    ampVec_[ipulse][l] = 0.;
+    passive_[ipulse][l] = 0.;
+  }
+  pedVal_[l] = 0.;
+  iter_[l] = 0;
+  chiSq_[l] = 0.;
+  oldChiSq_[l] = 0.;
+}
+
+void MahiFitBatch::storeResult(unsigned int l) {
+  Channel& channel = channels_[laneChannel_[l]];
+  laneChannel_[l] = -1;
+
+  // as in MahiFit::doFit
+  bool foundintime = false;
+  unsigned int ipulseintime = 0;
+  for (unsigned int ipulse = 0; ipulse < nPulseTot_; ++ipulse) {
+    if (bxs_[ipulse] == 0) {
+      ipulseintime = ipulse;
+      foundintime = true;
+    }
+  }
+
+  if (foundintime) {
+    channel.reconstructedVals[0] = ampVec_[ipulseintime][l];  //charge
+    if (channel.reconstructedVals[0] != 0) {
+      float arrivalTime = 0.;
+      if (calculateArrivalTime_)
+        arrivalTime = calculateArrivalTime(l);
+      channel.reconstructedVals[1] = arrivalTime;  //time
+    } else
+      channel.reconstructedVals[1] = -9999;  //time
+
+    channel.reconstructedVals[2] = chiSq_[l];  //chi2
+  }
+}
+
+void MahiFitBatch::updatePulseShape(
+    const Channel& channel, double itQ, int offset, unsigned int ipulse, unsigned int l) {
+  float t0 = meanTime_;
+
+  if (applyTimeSlew_) {
+    if (itQ <= 1.0)
+      t0 += channel.tsDelay1GeV;
+    else
+      t0 += channel.hcalTimeSlewDelay->delay(float(itQ), slewFlavor_);
+  }
+
+  std::array<double, HcalConst::maxSamples> pulseN;
+  std::array<double, HcalConst::maxSamples> pulseM;
+  std::array<double, HcalConst::maxSamples> pulseP;
+
+  channel.pulseTable->pulseShape(t0, pulseN);
+  channel.pulseTable->pulseShape(-channel.dt + t0, pulseM);
+  channel.pulseTable->pulseShape(channel.dt + t0, pulseP);
+
+  //in the 2018+ case where the sample of interest (SOI) is in TS3, add an extra offset to align
+  //with previous SOI=TS4 case assumed by the pulse shape
+  const int delta = 4 - channel.tsOffset;
+  const int tsSize = tsSize_;
+
+  const double invDt = 0.5 / channel.dt;
+
+  // row i of the pulse matrix is the time slice i - offset of the pulse, as the
+  // segment taken by MahiFit::doFit; the variations for the pulse covariance
+  // are subtracted from the nominal shape for the same slices as in
+  // MahiFit::updatePulseShape
+  for (int i = 0; i < int(nS_); ++i) {
+    const int iTS = i - offset;
+    if (i < tsSize && iTS >= 0 && iTS < tsSize) {
+      const int k = iTS + delta;
+      pulseMat_[i][ipulse][l] = pulseN[k];
+      pulseDerivMat_[i][ipulse][l] = (pulseM[k] - pulseP[k]) * invDt;
+      pulseCovP_[ipulse][i][l] = k < tsSize ? pulseP[k] - pulseN[k] : pulseP[k];
+      pulseCovM_[ipulse][i][l] = k < tsSize ? pulseM[k] - pulseN[k] : pulseM[k];
+    } else {
+      pulseMat_[i][ipulse][l] = 0.;
+      pulseDerivMat_[i][ipulse][l] = 0.;
+      pulseCovP_[ipulse][i][l] = 0.;
+      pulseCovM_[ipulse][i][l] = 0.;
+    }
+  }
+}
+
+void MahiFitBatch::updateCov() {
+  const unsigned int tsSize = tsSize_;
+
+  // lower triangle only, which is the one used by the decomposition
+  for (unsigned int i = 0; i < tsSize; ++i) {
+    for (unsigned int j = 0; j < i; ++j)
+      for (unsigned int l = 0; l < nLanes_; ++l)
+        covL_[i][j][l] = pedVal_[l];
+    for (unsigned int l = 0; l < nLanes_; ++l)
+      covL_[i][i][l] = noiseTerms_[i][l] + pedVal_[l];
+  }
+
+  // the pulse covariance of each BX is the sum of the outer products of the two time variations,
+  // pulses with zero amplitude add nothing, so they do not need to be masked out
+  for (unsigned int ipulse = 0; ipulse < nPulseTot_; ++ipulse) {
+    if (bxs_[ipulse] == MahiFit::pedestalBX_)
+      continue;
+    double ampSq[nLanes_];
+    for (unsigned int l = 0; l < nLanes_; ++l)
+      ampSq[l] = ampVec_[ipulse][l] * ampVec_[ipulse][l];
+    for (unsigned int i = 0; i < tsSize; ++i)
+      for (unsigned int j = 0; j <= i; ++j)
+        for (unsigned int l = 0; l < nLanes_; ++l)
+          covL_[i][j][l] += ampSq[l] * (0.5 * (pulseCovP_[ipulse][i][l] * pulseCovP_[ipulse][j][l] +
+                                               pulseCovM_[ipulse][i][l] * pulseCovM_[ipulse][j][l]));
+  }
+
+  cholesky(covL_, covLInvDiag_, tsSize);
+}
+
+void MahiFitBatch::whiten() {
+  const unsigned int tsSize = tsSize_;
+  const unsigned int npulse = nPulseTot_;
+
+  // invcovp_ = L^-1 * pulseMat and invcovs_ = L^-1 * amplitudes, solved for all the columns at once
+  for (unsigned int i = 0; i < tsSize; ++i) {
+    for (unsigned int l = 0; l < nLanes_; ++l)
+      invcovs_[i][l] = amplitudes_[i][l];
+    for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+      for (unsigned int l = 0; l < nLanes_; ++l)
+        invcovp_[i][ipulse][l] = pulseMat_[i][ipulse][l];
+  }
+  for (unsigned int i = 0; i < tsSize; ++i) {
+    for (unsigned int k = 0; k < i; ++k) {
+      for (unsigned int l = 0; l < nLanes_; ++l)
+        invcovs_[i][l] -= covL_[i][k][l] * invcovs_[k][l];
+      for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+        for (unsigned int l = 0; l < nLanes_; ++l)
+          invcovp_[i][ipulse][l] -= covL_[i][k][l] * invcovp_[k][ipulse][l];
+    }
+    for (unsigned int l = 0; l < nLanes_; ++l)
+      invcovs_[i][l] *= covLInvDiag_[i][l];
+    for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+      for (unsigned int l = 0; l < nLanes_; ++l)
+        invcovp_[i][ipulse][l] *= covLInvDiag_[i][l];
+  }
+
+  for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse) {
+    for (unsigned int l = 0; l < nLanes_; ++l)
+      aTbVec_[ipulse][l] = 0.;
+    for (unsigned int jpulse = 0; jpulse <= ipulse; ++jpulse)
+      for (unsigned int l = 0; l < nLanes_; ++l)
+        aTaMat_[ipulse][jpulse][l] = 0.;
+    for (unsigned int i = 0; i < tsSize; ++i) {
+      for (unsigned int l = 0; l < nLanes_; ++l)
+        aTbVec_[ipulse][l] += invcovp_[i][ipulse][l] * invcovs_[i][l];
+      for (unsigned int jpulse = 0; jpulse <= ipulse; ++jpulse)
+        for (unsigned int l = 0; l < nLanes_; ++l)
+          aTaMat_[ipulse][jpulse][l] += invcovp_[i][ipulse][l] * invcovp_[i][jpulse][l];
+    }
+    for (unsigned int jpulse = 0; jpulse < ipulse; ++jpulse)
+      for (unsigned int l = 0; l < nLanes_; ++l)
+        aTaMat_[jpulse][ipulse][l] = aTaMat_[ipulse][jpulse][l];
+  }
+}
+
+void MahiFitBatch::nnls(const bool* running) {
+  // same iterations as MahiFit::nnls, with the passive set kept as a 0/1 mask: the masked
+  // out rows and columns of the system are replaced by the identity (with a zero right hand
+  // side), so that the same full-size solve gives the solution of each lane's passive subsystem
+
+  const unsigned int npulse = nPulseTot_;
+  const unsigned int nPmax = std::min(npulse, tsSize_);
+
+  enum class Step : char { update, solve, done };
+  Step step[nLanes_];
+  unsigned int nP[nLanes_];
+  int iter[nLanes_];
+  int idxwmax[nLanes_];
+  double wmax[nLanes_];
+  double threshold[nLanes_];
+  for (unsigned int l = 0; l < nLanes_; ++l) {
+    for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+      passive_[ipulse][l] = 0.;
+    nP[l] = 0;
+    step[l] = running[l] ? Step::update : Step::done;
+    iter[l] = 0;
+    idxwmax[l] = 0;
+    wmax[l] = 0.;
+    threshold[l] = nnlsThresh_;
+  }
+
+  auto nextIteration = [&](unsigned int l) {
+    step[l] = Step::update;
+    ++iter[l];
+    //adaptive convergence threshold to avoid infinite loops but still
+    //ensure best value is used
+    if (iter[l] % 10 == 0)
+      threshold[l] *= 10.;
+  };
+
+  alignas(64) double updateWork[nP_][nLanes_];
+  alignas(64) double mat[nP_][nP_][nLanes_];
+  alignas(64) double matInvDiag[nP_][nLanes_];
+  alignas(64) double ampvecpermtest[nP_][nLanes_];
+
+  while (true) {
+    // gradient of all the lanes, only used for the ones in the update step
+    for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse) {
+      for (unsigned int l = 0; l < nLanes_; ++l)
+        updateWork[ipulse][l] = aTbVec_[ipulse][l];
+      for (unsigned int jpulse = 0; jpulse < npulse; ++jpulse)
+        for (unsigned int l = 0; l < nLanes_; ++l)
+          updateWork[ipulse][l] -= aTaMat_[ipulse][jpulse][l] * ampVec_[jpulse][l];
+    }
+
+    // update step: add the constrained parameter with the largest gradient to the passive set
+    bool anySolve = false;
+    for (unsigned int l = 0; l < nLanes_; ++l) {
+      if (step[l] == Step::update) {
+        if (nP[l] == nPmax) {
+          step[l] = Step::done;
+          continue;
+        }
+
+        const int idxwmaxprev = idxwmax[l];
+        const double wmaxprev = wmax[l];
+        wmax[l] = std::numeric_limits<double>::lowest();
+        for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse) {
+          if (passive_[ipulse][l] == 0. && updateWork[ipulse][l] > wmax[l]) {
+            wmax[l] = updateWork[ipulse][l];
+            idxwmax[l] = ipulse;
+          }
+        }
+
+        if (wmax[l] < threshold[l] || (idxwmax[l] == idxwmaxprev && wmax[l] == wmaxprev)) {
+          step[l] = Step::done;
+          continue;
+        }
+
+        if (iter[l] >= nMaxItersNNLS_) {
+          step[l] = Step::done;
+          continue;
+        }
+
+        //unconstrain parameter
+        passive_[idxwmax[l]][l] = 1.;
+        ++nP[l];
+        step[l] = Step::solve;
+      }
+      anySolve |= (step[l] == Step::solve);
+    }
+    if (!anySolve)
+      break;
+
+    // solve step: unconstrained solution for the passive parameters, for all the lanes at once
+    for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse) {
+      for (unsigned int jpulse = 0; jpulse < npulse; ++jpulse)
+        for (unsigned int l = 0; l < nLanes_; ++l)
+          mat[ipulse][jpulse][l] = passive_[ipulse][l] * passive_[jpulse][l] * aTaMat_[ipulse][jpulse][l];
+      for (unsigned int l = 0; l < nLanes_; ++l) {
+        mat[ipulse][ipulse][l] += 1. - passive_[ipulse][l];
+        ampvecpermtest[ipulse][l] = passive_[ipulse][l] * aTbVec_[ipulse][l];
+      }
+    }
+    cholesky(mat, matInvDiag, npulse);
+    forwardSubstitute(mat, matInvDiag, ampvecpermtest, npulse);
+    backSubstitute(mat, matInvDiag, ampvecpermtest, npulse);
+
+    for (unsigned int l = 0; l < nLanes_; ++l) {
+      if (step[l] != Step::solve)
+        continue;
+
+      //check solution
+      bool positive = true;
+      for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+        positive &= (passive_[ipulse][l] == 0. || ampvecpermtest[ipulse][l] > 0);
+      if (positive) {
+        for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+          if (passive_[ipulse][l] != 0.)
+            ampVec_[ipulse][l] = ampvecpermtest[ipulse][l];
+        nextIteration(l);
+        continue;
+      }
+
+      //update parameter vector
+      unsigned int minratioidx = 0;
+      double minratio = std::numeric_limits<double>::max();
+      for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse) {
+        if (passive_[ipulse][l] != 0. && ampvecpermtest[ipulse][l] <= 0.) {
+          const double c_ampvec = ampVec_[ipulse][l];
+          const double ratio = c_ampvec / (c_ampvec - ampvecpermtest[ipulse][l]);
+          if (ratio < minratio) {
+            minratio = ratio;
+            minratioidx = ipulse;
+          }
+        }
+      }
+      for (unsigned int ipulse = 0; ipulse < npulse; ++ipulse)
+        if (passive_[ipulse][l] != 0.)
+          ampVec_[ipulse][l] += minratio * (ampvecpermtest[ipulse][l] - ampVec_[ipulse][l]);
+
+      //avoid numerical problems with later ==0. check
+      ampVec_[minratioidx][l] = 0.;
+      passive_[minratioidx][l] = 0.;
+      --nP[l];
+      if (nP[l] == 0)
+        nextIteration(l);
+    }
+  }
+}
+
+void MahiFitBatch::onePulseMinimize(const bool* running) {
+  for (unsigned int l = 0; l < nLanes_; ++l)
+    if (running[l])
+      ampVec_[0][l] = std::max(0., aTbVec_[0][l] / aTaMat_[0][0][l]);
+}
+
+void MahiFitBatch::calculateChiSq(double* chiSq) const {
+  // |L^-1 * (pulseMat*ampVec - amplitudes)|^2, with the whitened pulses and amplitudes
+  for (unsigned int l = 0; l < nLanes_; ++l)
+    chiSq[l] = 0.;
+  for (unsigned int i = 0; i < tsSize_; ++i) {
+    double res[nLanes_];
+    for (unsigned int l = 0; l < nLanes_; ++l)
+      res[l] = -invcovs_[i][l];
+    for (unsigned int ipulse = 0; ipulse < nPulseTot_; ++ipulse)
+      for (unsigned int l = 0; l < nLanes_; ++l)
+        res[l] += invcovp_[i][ipulse][l] * ampVec_[ipulse][l];
+    for (unsigned int l = 0; l < nLanes_; ++l)
+      chiSq[l] += res[l] * res[l];
+  }
+}
+
+float MahiFitBatch::calculateArrivalTime(unsigned int l) const {
+  // as MahiFit::calculateArrivalTime, for the channel in lane l
+  SamplePulseMatrix pulseMat(tsSize_, nPulseTot_);
+  SamplePulseMatrix pulseDerivMat(tsSize_, nPulseTot_);
+  PulseVector ampVec(nPulseTot_);
+  SampleVector amplitudes(tsSize_);
+
+  int itIndex = 0;
+  for (unsigned int ipulse = 0; ipulse < nPulseTot_; ++ipulse) {
+    if (bxs_[ipulse] == 0)
+      itIndex = ipulse;
+    ampVec.coeffRef(ipulse) = ampVec_[ipulse][l];
+    for (unsigned int i = 0; i < tsSize_; ++i) {
+      pulseMat.coeffRef(i, ipulse) = pulseMat_[i][ipulse][l];
+      pulseDerivMat.coeffRef(i, ipulse) = pulseDerivMat_[i][ipulse][l] * ampVec_[ipulse][l];
+    }
+  }
+  for (unsigned int i = 0; i < tsSize_; ++i)
+    amplitudes.coeffRef(i) = amplitudes_[i][l];
+
+  SampleVector residuals = pulseMat * ampVec - amplitudes;
+  PulseVector solution = pulseDerivMat.colPivHouseholderQr().solve(residuals);
+  float t = solution.coeff(itIndex);
+  t = (t > MahiFit::timeLimit_) ? MahiFit::timeLimit_ : ((t < -MahiFit::timeLimit_) ? -MahiFit::timeLimit_ : t);
+
+  return t;
+}
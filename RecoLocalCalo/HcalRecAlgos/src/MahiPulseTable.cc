@@ -0,0 +1,50 @@
+#include <cmath>
+
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiPulseTable.h"
+
+MahiPulseTable::MahiPulseTable(const HcalPulseShapes::Shape& ps)
+    : value_(nSteps_ * HcalConst::maxSamples),
+      slope_(nSteps_ * HcalConst::maxSamples),
+      psfPtr_(new FitterFuncs::PulseShapeFunctor(ps, false, false, false, 1, 0, 0, 10)) {
+  // value at the center of each step, and slope from two points inside the step
+  constexpr double halfWidth = 0.25 / stepsPerNs_;
+  std::array<double, HcalConst::maxSamples> pulse, pulseM, pulseP;
+  for (int iStep = 0; iStep < nSteps_; ++iStep) {
+    const double t0 = (iStep + 0.5) / stepsPerNs_ - HcalConst::iniTimeShift;
+    evaluate(t0, pulse);
+    evaluate(t0 - halfWidth, pulseM);
+    evaluate(t0 + halfWidth, pulseP);
+    for (int iTS = 0; iTS < HcalConst::maxSamples; ++iTS) {
+      value_[iStep * HcalConst::maxSamples + iTS] = pulse[iTS];
+      slope_[iStep * HcalConst::maxSamples + iTS] = (pulseP[iTS] - pulseM[iTS]) / (2. * halfWidth);
+    }
+  }
+}
+
+void MahiPulseTable::evaluate(double t0, std::array<double, HcalConst::maxSamples>& pulse) const {
+  const double xx[4] = {t0, 1.0, 0.0, 3};
+  psfPtr_->singlePulseShapeFuncMahi(&xx[0]);
+  psfPtr_->getPulseShape(pulse);
+}
+
+void MahiPulseTable::pulseShape(double t0, std::array<double, HcalConst::maxSamples>& pulse) const {
+  // margin around the step boundaries, where the functor may round into the other step
+  constexpr double boundaryMargin = 1.e-9;
+
+  const double x = (t0 + HcalConst::iniTimeShift) * stepsPerNs_;
+  const double step = std::floor(x);
+  const double frac = x - step;
+
+  // also false for NaN
+  if (!(x > 0. && x < nSteps_ && frac > boundaryMargin && frac < 1. - boundaryMargin)) {
+    evaluate(t0, pulse);
+    return;
+  }
+
+  const int iStep = static_cast<int>(step);
+  const double dx = (frac - 0.5) / stepsPerNs_;
+  const double* value = &value_[iStep * HcalConst::maxSamples];
+  const double* slope = &slope_[iStep * HcalConst::maxSamples];
+  for (int iTS = 0; iTS < HcalConst::maxSamples; ++iTS)
+    pulse[iTS] = value[iTS] + slope[iTS] * dx;
+}
@@ -25,7 +25,8 @@ SimpleHBHEPhase1Algo::SimpleHBHEPhase1Algo(const int firstSampleShift,
                                            const bool applyLegacyHBMCorrection,
                                            std::unique_ptr<PulseShapeFitOOTPileupCorrection> m2,
                                            std::unique_ptr<HcalDeterministicFit> detFit,
-                                           std::unique_ptr<MahiFit> mahi)
+                                           std::unique_ptr<MahiFit> mahi,
+                                           const bool batchedMahi)
     : pulseCorr_(PulseContainmentFractionalError),
       firstSampleShift_(firstSampleShift),
       samplesToAdd_(samplesToAdd),
@@ -38,6 +39,8 @@ SimpleHBHEPhase1Algo::SimpleHBHEPhase1Algo(const int firstSampleShift,
       hltOOTpuCorr_(std::move(detFit)),
       mahiOOTpuCorr_(std::move(mahi)) {
   hcalTimeSlew_delay_ = nullptr;
+  if (batchedMahi && mahiOOTpuCorr_)
+    mahiBatch_ = std::make_unique<MahiFitBatch>(*mahiOOTpuCorr_);
 }
 
 void SimpleHBHEPhase1Algo::beginRun(const edm::Run& r, const edm::EventSetup& es) {
@@ -55,6 +58,37 @@ HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
                                              const HcalRecoParam* params,
                                              const HcalCalibrations& calibs,
                                              const bool isData) {
+  return reconstructChannel(info, params, calibs, isData, -1);
+}
+
+void SimpleHBHEPhase1Algo::reconstructBatch(const std::vector<HBHEChannelInfo>& infos,
+                                            const std::vector<const HcalRecoParam*>& params,
+                                            const std::vector<const HcalCalibrations*>& calibs,
+                                            const bool isData,
+                                            std::vector<HBHERecHit>& rechits) {
+  if (!mahiBatch_) {
+    AbsHBHEPhase1Algo::reconstructBatch(infos, params, calibs, isData, rechits);
+    return;
+  }
+
+  // Fit all the channels with Mahi first, then build the rechits
+  mahiBatch_->clear();
+  for (const HBHEChannelInfo& info : infos) {
+    mahiBatch_->setPulseShapeTemplate(theHcalPulseShapes_.getShape(info.recoShape()), hcalTimeSlew_delay_);
+    mahiBatch_->addChannel(info);
+  }
+  mahiBatch_->fit();
+
+  rechits.reserve(rechits.size() + infos.size());
+  for (unsigned i = 0; i < infos.size(); ++i)
+    rechits.push_back(reconstructChannel(infos[i], params[i], *calibs[i], isData, i));
+}
+
+HBHERecHit SimpleHBHEPhase1Algo::reconstructChannel(const HBHEChannelInfo& info,
+                                                    const HcalRecoParam* params,
+                                                    const HcalCalibrations& calibs,
+                                                    const bool isData,
+                                                    const int mahiBatchIndex) {
   HBHERecHit rh;
 
   const HcalDetId channelId(info.id());
@@ -104,8 +138,12 @@ HBHERecHit SimpleHBHEPhase1Algo::reconstruct(const HBHEChannelInfo& info,
   const MahiFit* mahi = mahiOOTpuCorr_.get();
 
   if (mahi) {
-    mahiOOTpuCorr_->setPulseShapeTemplate(theHcalPulseShapes_.getShape(info.recoShape()), hcalTimeSlew_delay_);
-    mahi->phase1Apply(info, m4E, m4T, m4UseTriple, m4chi2);
+    if (mahiBatchIndex >= 0)
+      mahiBatch_->result(mahiBatchIndex, m4E, m4T, m4UseTriple, m4chi2);
+    else {
+      mahiOOTpuCorr_->setPulseShapeTemplate(theHcalPulseShapes_.getShape(info.recoShape()), hcalTimeSlew_delay_);
+      mahi->phase1Apply(info, m4E, m4T, m4UseTriple, m4chi2);
+    }
     m4E *= hbminusCorrectionFactor(channelId, m4E, isData);
   }
 
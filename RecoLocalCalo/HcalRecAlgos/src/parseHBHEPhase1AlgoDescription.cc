@@ -135,7 +135,8 @@ std::unique_ptr<AbsHBHEPhase1Algo> parseHBHEPhase1AlgoDescription(const edm::Par
                                                                     ps.getParameter<bool>("applyLegacyHBMCorrection"),
                                                                     std::move(m2),
                                                                     std::move(detFit),
-                                                                    std::move(mahi)));
+                                                                    std::move(mahi),
+                                                                    ps.getParameter<bool>("batchedFit")));
   }
 
   return algo;
@@ -156,6 +157,7 @@ edm::ParameterSetDescription fillDescriptionForParseHBHEPhase1Algo() {
   desc.add<bool>("correctForPhaseContainment", true);
   desc.add<bool>("applyLegacyHBMCorrection", true);
   desc.add<bool>("calculateArrivalTime", true);
+  desc.add<bool>("batchedFit", false);
 
   return desc;
 }
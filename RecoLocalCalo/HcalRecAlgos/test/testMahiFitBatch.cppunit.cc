@@ -0,0 +1,174 @@
+/* Unit test for MahiFitBatch and MahiPulseTable: the table must reproduce the
+   PulseShapeFunctor shape it tabulates, and the batched fit must give the
+   energy, time and chi2 of MahiFit::phase1Apply for the same channels
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "CalibCalorimetry/HcalAlgos/interface/HcalPulseShapes.h"
+#include "CalibCalorimetry/HcalAlgos/interface/HcalTimeSlew.h"
+#include "DataFormats/HcalRecHit/interface/HBHEChannelInfo.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiFit.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiFitBatch.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/MahiPulseTable.h"
+#include "RecoLocalCalo/HcalRecAlgos/interface/PulseShapeFunctor.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+class testMahiFitBatch : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testMahiFitBatch);
+  CPPUNIT_TEST(testPulseTable);
+  CPPUNIT_TEST(testFit);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown() {}
+
+  void testPulseTable();
+  void testFit();
+
+private:
+  // HPD (Run 2, 10 time slices) and SiPM (Run 3, 8 time slices) channels
+  void makeChannels(int recoShape, unsigned int nSamples, unsigned int soi, bool sipm);
+
+  static constexpr unsigned int nchannels = 500;
+  // tolerances of the comparison with MahiFit: the pulse shapes agree within rounding, but the
+  // batched fit sums in a different order so the iterations can stop at slightly different points
+  static constexpr double energyTolerance = 1.e-3;  // relative, or GeV below 1 GeV
+  static constexpr double timeTolerance = 0.05;     // ns
+  static constexpr double chi2Tolerance = 1.e-2;    // relative, or absolute below 1
+
+  std::unique_ptr<HcalPulseShapes> shapes_;
+  HcalTimeSlew timeSlew_;
+  std::vector<HBHEChannelInfo> channels_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testMahiFitBatch);
+
+void testMahiFitBatch::setUp() {
+  shapes_ = std::make_unique<HcalPulseShapes>();
+  // M2 parameters of HcalTimeSlew_cff, for the Slow, Medium and Fast settings
+  timeSlew_ = HcalTimeSlew();
+  timeSlew_.addM2ParameterSet(23.960177, -3.178648, 16.00);
+  timeSlew_.addM2ParameterSet(11.977461, -1.5610227, 10.00);
+  timeSlew_.addM2ParameterSet(9.109694, -1.075824, 6.25);
+}
+
+void testMahiFitBatch::makeChannels(int recoShape, unsigned int nSamples, unsigned int soi, bool sipm) {
+  const double ped = 3., pedWidth = 0.8, gain = 0.1, dFcPerADC = 2.6, fcByPE = sipm ? 0.2 : 0.3;
+
+  FitterFuncs::PulseShapeFunctor psf(shapes_->getShape(recoShape), false, false, false, 1, 0, 0, 10);
+  std::mt19937 rng(4321);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::normal_distribution<double> gauss;
+
+  // in-time pulse up to 2000 fC with a time jitter, out-of-time pileup in 30% of the BXs
+  channels_.assign(nchannels, HBHEChannelInfo(sipm, false));
+  for (auto& channel : channels_) {
+    channel.setChannelInfo(
+        HcalDetId(HcalBarrel, 1, 1, 1), recoShape, nSamples, soi, 0, 0., fcByPE, 0., false, false, false);
+    std::vector<double> charge(nSamples, ped);
+    for (int ibx = -static_cast<int>(soi); ibx < static_cast<int>(nSamples - soi); ++ibx) {
+      double amplitude = 0;
+      if (ibx == 0)
+        amplitude = 2000. * uniform(rng) * uniform(rng);
+      else if (uniform(rng) < 0.3)
+        amplitude = 100. * uniform(rng);
+      if (amplitude == 0)
+        continue;
+      // the functor gives the pulse with its SOI at the fifth of 10 time slices
+      const double xx[4] = {2. * gauss(rng), 1.0, 0.0, 3};
+      psf.singlePulseShapeFuncMahi(&xx[0]);
+      std::array<double, HcalConst::maxSamples> pulse;
+      psf.getPulseShape(pulse);
+      for (unsigned int its = 0; its < nSamples; ++its) {
+        const int ipulse = static_cast<int>(its) - ibx - static_cast<int>(soi) + 4;
+        if (ipulse >= 0 && ipulse < HcalConst::maxSamples)
+          charge[its] += amplitude * pulse[ipulse];
+      }
+    }
+    for (unsigned int its = 0; its < nSamples; ++its) {
+      const double q = charge[its] + pedWidth * gauss(rng);
+      channel.setSample(its, 0, dFcPerADC, q, ped, pedWidth, gain, 0., -1.f);
+    }
+  }
+}
+
+void testMahiFitBatch::testPulseTable() {
+  for (int recoShape : {105, 206}) {
+    const auto& shape = shapes_->getShape(recoShape);
+    MahiPulseTable table(shape);
+    FitterFuncs::PulseShapeFunctor psf(shape, false, false, false, 1, 0, 0, 10);
+
+    // times within the table, including the step boundaries, and outside of it
+    std::array<double, HcalConst::maxSamples> pulse, ref;
+    for (double t0 = -40.; t0 < 40.; t0 += 0.0137) {
+      for (double t : {t0, std::round(2. * t0) / 2.}) {
+        table.pulseShape(t, pulse);
+        const double xx[4] = {t, 1.0, 0.0, 3};
+        psf.singlePulseShapeFuncMahi(&xx[0]);
+        psf.getPulseShape(ref);
+        for (int its = 0; its < HcalConst::maxSamples; ++its)
+          CPPUNIT_ASSERT_DOUBLES_EQUAL(ref[its], pulse[its], 1.e-6);
+      }
+    }
+  }
+}
+
+void testMahiFitBatch::testFit() {
+  struct Setup {
+    int recoShape;
+    unsigned int nSamples, soi;
+    bool sipm;
+  };
+  for (const auto& setup : {Setup{105, 10, 4, false}, Setup{206, 8, 3, true}}) {
+    makeChannels(setup.recoShape, setup.nSamples, setup.soi, setup.sipm);
+    const auto& shape = shapes_->getShape(setup.recoShape);
+
+    // mahiParameters of HBHEMahiParameters_cfi
+    MahiFit mahi;
+    mahi.setParameters(false,
+                       0.,
+                       15.,
+                       true,
+                       HcalTimeSlew::Medium,
+                       true,
+                       0.,
+                       5.,
+                       2.5,
+                       {-3, -2, -1, 0, 1, 2, 3, 4},
+                       500,
+                       500,
+                       1e-3,
+                       1e-11);
+    mahi.setPulseShapeTemplate(shape, &timeSlew_);
+
+    auto batch = std::make_unique<MahiFitBatch>(mahi);
+    batch->setPulseShapeTemplate(shape, &timeSlew_);
+    for (unsigned int ich = 0; ich < nchannels; ++ich)
+      CPPUNIT_ASSERT_EQUAL(ich, batch->addChannel(channels_[ich]));
+    batch->fit();
+
+    unsigned int ntriple = 0;
+    for (unsigned int ich = 0; ich < nchannels; ++ich) {
+      float energy, time, chi2, benergy, btime, bchi2;
+      bool useTriple, buseTriple;
+      mahi.phase1Apply(channels_[ich], energy, time, useTriple, chi2);
+      batch->result(ich, benergy, btime, buseTriple, bchi2);
+
+      CPPUNIT_ASSERT_EQUAL(useTriple, buseTriple);
+      ntriple += useTriple;
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(energy, benergy, energyTolerance * std::max(1.f, std::abs(energy)));
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(time, btime, timeTolerance);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(chi2, bchi2, chi2Tolerance * std::max(1.f, std::abs(chi2)));
+    }
+    // both the one pulse and the multi pulse fits are compared
+    CPPUNIT_ASSERT(ntriple > 0 && ntriple < nchannels);
+  }
+}
@@ -11,5 +11,6 @@ mahiParameters = cms.PSet(
     nMaxItersMin      = cms.int32(500),
     nMaxItersNNLS     = cms.int32(500),
     deltaChiSqThresh  = cms.double(1e-3),
-    nnlsThresh        = cms.double(1e-11)
+    nnlsThresh        = cms.double(1e-11),
+    batchedFit        = cms.bool(False)
 )
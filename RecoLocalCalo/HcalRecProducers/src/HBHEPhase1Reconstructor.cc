@@ -20,6 +20,7 @@
 #include <cmath>
 #include <utility>
 #include <algorithm>
+#include <vector>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -409,6 +410,13 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
   // not going to be constructed from such channels.
   const bool skipDroppedChannels = !(infos && saveDroppedInfos_);
 
+  // Channels collected for algorithms which reconstruct them together
+  const bool batchReco = rechits && reco_->hasBatchReconstruction();
+  std::vector<DFrame> batchFrames;
+  std::vector<HBHEChannelInfo> batchInfos;
+  std::vector<const HcalRecoParam*> batchParams;
+  std::vector<const HcalCalibrations*> batchCalibs;
+
   // Iterate over the input collection
   for (typename Collection::const_iterator it = coll.begin(); it != coll.end(); ++it) {
     const DFrame& frame(*it);
@@ -514,6 +522,13 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
       const HcalRecoParam* pptr = nullptr;
       if (recoParamsFromDB_)
         pptr = param_ts;
+      if (batchReco) {
+        batchFrames.push_back(frame);
+        batchInfos.push_back(*channelInfo);
+        batchParams.push_back(pptr);
+        batchCalibs.push_back(&calib);
+        continue;
+      }
       HBHERecHit rh = reco_->reconstruct(*channelInfo, pptr, calib, isRealData);
       if (rh.id().rawId()) {
         setAsicSpecificBits(frame, coder, *channelInfo, calib, &rh);
@@ -522,6 +537,24 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
       }
     }
   }
+
+  // Reconstruct the collected channels, keeping the order of the input collection
+  if (!batchInfos.empty()) {
+    std::vector<HBHERecHit> batchRecHits;
+    batchRecHits.reserve(batchInfos.size());
+    reco_->reconstructBatch(batchInfos, batchParams, batchCalibs, isRealData, batchRecHits);
+    for (unsigned i = 0; i < batchRecHits.size(); ++i) {
+      HBHERecHit& rh = batchRecHits[i];
+      if (rh.id().rawId()) {
+        const HcalQIECoder* channelCoder = cond.getHcalCoder(batchInfos[i].id());
+        const HcalQIEShape* shape = cond.getHcalShape(channelCoder);
+        const HcalCoderDb coder(*channelCoder, *shape);
+        setAsicSpecificBits(batchFrames[i], coder, batchInfos[i], *batchCalibs[i], &rh);
+        setCommonStatusBits(batchInfos[i], *batchCalibs[i], &rh);
+        rechits->push_back(rh);
+      }
+    }
+  }
 }
 
 void HBHEPhase1Reconstructor::setCommonStatusBits(const HBHEChannelInfo& /* info */,
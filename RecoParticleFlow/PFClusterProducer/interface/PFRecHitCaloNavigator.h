@@ -19,21 +19,17 @@
 #include "Geometry/CaloTopology/interface/CaloTowerTopology.h"
 #include "DataFormats/CaloTowers/interface/CaloTowerDetId.h"
 
-template <typename DET, typename TOPO, bool ownsTopo = true>
-class PFRecHitCaloNavigator : public PFRecHitNavigatorBase {
-public:
-  ~PFRecHitCaloNavigator() override {
-    if (!ownsTopo) {
-      topology_.release();
-    }
-  }
-
-  void associateNeighbours(reco::PFRecHit& hit,
-                           std::unique_ptr<reco::PFRecHitCollection>& hits,
-                           edm::RefProd<reco::PFRecHitCollection>& refProd) override {
-    DetId detid(hit.detId());
-
-    CaloNavigator<DET> navigator(detid, topology_.get());
+namespace pfrechit {
+  // The eight neighbours of a cell found by navigating its topology, in the
+  // order in which they are associated to its rechit, and their eta and phi
+  // offsets. A missing neighbour is DetId(0).
+  constexpr unsigned kNeighbours = 8;
+  constexpr short kNeighbourEta[kNeighbours] = {0, 1, 0, -1, 1, 1, -1, -1};
+  constexpr short kNeighbourPhi[kNeighbours] = {1, 1, -1, -1, 0, -1, 0, 1};
+
+  template <typename DET>
+  void caloNeighbours(const DetId& detid, const CaloSubdetectorTopology* topology, DetId (&neighbours)[kNeighbours]) {
+    CaloNavigator<DET> navigator(detid, topology);
 
     DetId N(0);
     DetId E(0);
@@ -45,7 +41,7 @@ public:
     DetId SE(0);
 
     N = navigator.north();
-    associateNeighbour(N, hit, hits, refProd, 0, 1, 0);
+    neighbours[0] = N;
 
     if (N != DetId(0)) {
       NE = navigator.east();
@@ -54,11 +50,11 @@ public:
       E = navigator.east();
       NE = navigator.north();
     }
-    associateNeighbour(NE, hit, hits, refProd, 1, 1, 0);
+    neighbours[1] = NE;
     navigator.home();
 
     S = navigator.south();
-    associateNeighbour(S, hit, hits, refProd, 0, -1, 0);
+    neighbours[2] = S;
 
     if (S != DetId(0)) {
       SW = navigator.west();
@@ -67,11 +63,11 @@ public:
       W = navigator.west();
       SW = navigator.south();
     }
-    associateNeighbour(SW, hit, hits, refProd, -1, -1, 0);
+    neighbours[3] = SW;
     navigator.home();
 
     E = navigator.east();
-    associateNeighbour(E, hit, hits, refProd, 1, 0, 0);
+    neighbours[4] = E;
 
     if (E != DetId(0)) {
       SE = navigator.south();
@@ -80,11 +76,11 @@ public:
       S = navigator.south();
       SE = navigator.east();
     }
-    associateNeighbour(SE, hit, hits, refProd, 1, -1, 0);
+    neighbours[5] = SE;
     navigator.home();
 
     W = navigator.west();
-    associateNeighbour(W, hit, hits, refProd, -1, 0, 0);
+    neighbours[6] = W;
 
     if (W != DetId(0)) {
       NW = navigator.north();
@@ -93,7 +89,27 @@ public:
       N = navigator.north();
       NW = navigator.west();
     }
-    associateNeighbour(NW, hit, hits, refProd, -1, 1, 0);
+    neighbours[7] = NW;
+  }
+}  // namespace pfrechit
+
+template <typename DET, typename TOPO, bool ownsTopo = true>
+class PFRecHitCaloNavigator : public PFRecHitNavigatorBase {
+public:
+  ~PFRecHitCaloNavigator() override {
+    if (!ownsTopo) {
+      topology_.release();
+    }
+  }
+
+  void associateNeighbours(reco::PFRecHit& hit,
+                           std::unique_ptr<reco::PFRecHitCollection>& hits,
+                           edm::RefProd<reco::PFRecHitCollection>& refProd) override {
+    DetId neighbours[pfrechit::kNeighbours];
+    pfrechit::caloNeighbours<DET>(DetId(hit.detId()), topology_.get(), neighbours);
+    for (unsigned k = 0; k < pfrechit::kNeighbours; ++k) {
+      associateNeighbour(neighbours[k], hit, hits, refProd, pfrechit::kNeighbourEta[k], pfrechit::kNeighbourPhi[k], 0);
+    }
   }
 
 protected:
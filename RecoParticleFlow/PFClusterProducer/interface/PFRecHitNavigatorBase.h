@@ -37,6 +37,14 @@ public:
                                    std::unique_ptr<reco::PFRecHitCollection>&,
                                    edm::RefProd<reco::PFRecHitCollection>&) = 0;
 
+  // associates the neighbours of all the rechits, which are sorted by detId
+  virtual void associateAllNeighbours(std::unique_ptr<reco::PFRecHitCollection>& hits,
+                                      edm::RefProd<reco::PFRecHitCollection>& refProd) {
+    for (auto& hit : *hits) {
+      associateNeighbours(hit, hits, refProd);
+    }
+  }
+
 protected:
   void associateNeighbour(const DetId& id,
                           reco::PFRecHit& hit,
@@ -0,0 +1,39 @@
+#ifndef RecoParticleFlow_PFClusterProducer_PFRecHitNeighbourTable_h
+#define RecoParticleFlow_PFClusterProducer_PFRecHitNeighbourTable_h
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Neighbours of the cells of a calorimeter, made once per geometry by the
+// PFRecHitNeighbourTableESProducer. The cells are numbered by increasing
+// DetId, and each has eight slots with the number of its neighbour, or -1,
+// in the order of pfrechit::caloNeighbours.
+class PFRecHitNeighbourTable {
+public:
+  static constexpr unsigned kNeighbours = 8;
+
+  PFRecHitNeighbourTable() = default;
+  PFRecHitNeighbourTable(std::vector<uint32_t> detIds, std::vector<int> neighbours)
+      : detIds_(std::move(detIds)), neighbours_(std::move(neighbours)) {}
+
+  unsigned size() const { return detIds_.size(); }
+
+  uint32_t detId(unsigned cell) const { return detIds_[cell]; }
+
+  // number of the cell with this DetId, or -1; the search starts at the cell
+  // "from", for lookups by increasing DetId
+  int cell(uint32_t detId, unsigned from = 0) const {
+    auto it = std::lower_bound(detIds_.begin() + std::min<unsigned>(from, detIds_.size()), detIds_.end(), detId);
+    return (it != detIds_.end() && *it == detId) ? int(it - detIds_.begin()) : -1;
+  }
+
+  const int* neighbours(unsigned cell) const { return neighbours_.data() + kNeighbours * cell; }
+
+private:
+  std::vector<uint32_t> detIds_;
+  std::vector<int> neighbours_;
+};
+
+#endif
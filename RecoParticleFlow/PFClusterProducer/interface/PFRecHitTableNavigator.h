@@ -0,0 +1,95 @@
+#ifndef RecoParticleFlow_PFClusterProducer_PFRecHitTableNavigator_h
+#define RecoParticleFlow_PFClusterProducer_PFRecHitTableNavigator_h
+
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitNavigatorBase.h"
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitCaloNavigator.h"
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitNeighbourTable.h"
+
+#include <string>
+#include <vector>
+
+// Associates the same neighbours as the PFRecHitCaloNavigator, looking them
+// up in the PFRecHitNeighbourTable with the label "neighbourTable" instead of
+// navigating the topology for each rechit.
+class PFRecHitTableNavigator : public PFRecHitNavigatorBase {
+public:
+  PFRecHitTableNavigator(const edm::ParameterSet& iConfig)
+      : tableLabel_(iConfig.getParameter<std::string>("neighbourTable")) {}
+
+  void beginEvent(const edm::EventSetup& iSetup) override {
+    const CaloGeometryRecord& record = iSetup.get<CaloGeometryRecord>();
+    if (record.cacheIdentifier() != cacheId_) {
+      edm::ESHandle<PFRecHitNeighbourTable> table;
+      record.get(tableLabel_, table);
+      table_ = table.product();
+      hitOfCell_.assign(table_->size(), -1);
+      cacheId_ = record.cacheIdentifier();
+    }
+  }
+
+  void associateNeighbours(reco::PFRecHit& hit,
+                           std::unique_ptr<reco::PFRecHitCollection>& hits,
+                           edm::RefProd<reco::PFRecHitCollection>& refProd) override {
+    const int cell = table_->cell(hit.detId());
+    if (cell < 0)
+      return;
+    const int* neighbours = table_->neighbours(cell);
+    for (unsigned k = 0; k < pfrechit::kNeighbours; ++k) {
+      if (neighbours[k] >= 0)
+        associateNeighbour(DetId(table_->detId(neighbours[k])),
+                           hit,
+                           hits,
+                           refProd,
+                           pfrechit::kNeighbourEta[k],
+                           pfrechit::kNeighbourPhi[k],
+                           0);
+    }
+  }
+
+  void associateAllNeighbours(std::unique_ptr<reco::PFRecHitCollection>& hits,
+                              edm::RefProd<reco::PFRecHitCollection>& refProd) override {
+    auto& recHits = *hits;
+    const unsigned nhits = recHits.size();
+
+    // the rechits and the table are both sorted by detId
+    cellOfHit_.resize(nhits);
+    unsigned from = 0;
+    for (unsigned i = 0; i < nhits; ++i) {
+      const int cell = table_->cell(recHits[i].detId(), from);
+      cellOfHit_[i] = cell;
+      if (cell < 0) {
+        LogDebug("PFRecHitTableNavigator") << "rechit " << recHits[i].detId() << " is not in the neighbour table";
+        continue;
+      }
+      from = cell;
+      if (hitOfCell_[cell] < 0)
+        hitOfCell_[cell] = i;
+    }
+
+    for (unsigned i = 0; i < nhits; ++i) {
+      if (cellOfHit_[i] < 0)
+        continue;
+      const int* neighbours = table_->neighbours(cellOfHit_[i]);
+      for (unsigned k = 0; k < pfrechit::kNeighbours; ++k) {
+        if (neighbours[k] >= 0 && hitOfCell_[neighbours[k]] >= 0)
+          recHits[i].addNeighbour(pfrechit::kNeighbourEta[k], pfrechit::kNeighbourPhi[k], 0, hitOfCell_[neighbours[k]]);
+      }
+    }
+
+    // leave the map empty for the next event
+    for (unsigned i = 0; i < nhits; ++i) {
+      if (cellOfHit_[i] >= 0)
+        hitOfCell_[cellOfHit_[i]] = -1;
+    }
+  }
+
+private:
+  const std::string tableLabel_;
+  const PFRecHitNeighbourTable* table_ = nullptr;
+  unsigned long long cacheId_ = 0;
+  // rechit of each cell of the table, or -1, and cell of each rechit
+  std::vector<int> hitOfCell_;
+  std::vector<int> cellOfHit_;
+};
+
+#endif
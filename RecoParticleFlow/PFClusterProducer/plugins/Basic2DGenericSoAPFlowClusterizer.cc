@@ -0,0 +1,425 @@
+#include "Basic2DGenericSoAPFlowClusterizer.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "DataFormats/Math/interface/deltaR.h"
+
+#include "vdt/vdtMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#ifdef PFLOW_DEBUG
+#define LOGVERB(x) edm::LogVerbatim(x)
+#define LOGWARN(x) edm::LogWarning(x)
+#define LOGERR(x) edm::LogError(x)
+#define LOGDRESSED(x) edm::LogInfo(x)
+#else
+#define LOGVERB(x) LogTrace(x)
+#define LOGWARN(x) edm::LogWarning(x)
+#define LOGERR(x) edm::LogError(x)
+#define LOGDRESSED(x) LogDebug(x)
+#endif
+
+Basic2DGenericSoAPFlowClusterizer::Basic2DGenericSoAPFlowClusterizer(const edm::ParameterSet& conf)
+    : PFClusterBuilderBase(conf),
+      _maxIterations(conf.getParameter<unsigned>("maxIterations")),
+      _stoppingTolerance(conf.getParameter<double>("stoppingTolerance")),
+      _showerSigma2(std::pow(conf.getParameter<double>("showerSigma"), 2.0)),
+      _excludeOtherSeeds(conf.getParameter<bool>("excludeOtherSeeds")),
+      _minFracTot(conf.getParameter<double>("minFracTot")),
+      _layerMap({{"PS2", (int)PFLayer::PS2},
+                 {"PS1", (int)PFLayer::PS1},
+                 {"ECAL_ENDCAP", (int)PFLayer::ECAL_ENDCAP},
+                 {"ECAL_BARREL", (int)PFLayer::ECAL_BARREL},
+                 {"NONE", (int)PFLayer::NONE},
+                 {"HCAL_BARREL1", (int)PFLayer::HCAL_BARREL1},
+                 {"HCAL_BARREL2_RING0", (int)PFLayer::HCAL_BARREL2},
+                 {"HCAL_BARREL2_RING1", 100 * (int)PFLayer::HCAL_BARREL2},
+                 {"HCAL_ENDCAP", (int)PFLayer::HCAL_ENDCAP},
+                 {"HF_EM", (int)PFLayer::HF_EM},
+                 {"HF_HAD", (int)PFLayer::HF_HAD}}),
+      _hasAllCellsParams(false) {
+  const std::vector<edm::ParameterSet>& thresholds = conf.getParameterSetVector("recHitEnergyNorms");
+  for (const auto& pset : thresholds) {
+    const std::string& det = pset.getParameter<std::string>("detector");
+
+    std::vector<int> depths;
+    std::vector<double> rhE_norm;
+
+    if (det == std::string("HCAL_BARREL1") || det == std::string("HCAL_ENDCAP")) {
+      depths = pset.getParameter<std::vector<int> >("depths");
+      rhE_norm = pset.getParameter<std::vector<double> >("recHitEnergyNorm");
+    } else {
+      depths.push_back(0);
+      rhE_norm.push_back(pset.getParameter<double>("recHitEnergyNorm"));
+    }
+
+    if (rhE_norm.size() != depths.size()) {
+      throw cms::Exception("InvalidPFRecHitThreshold")
+          << "PFlowClusterizerThreshold mismatch with the numbers of depths";
+    }
+
+    auto entry = _layerMap.find(det);
+    if (entry == _layerMap.end()) {
+      throw cms::Exception("InvalidDetectorLayer") << "Detector layer : " << det << " is not in the list of recognized"
+                                                   << " detector layers!";
+    }
+    _recHitEnergyNorms.emplace(_layerMap.find(det)->second, std::make_pair(depths, rhE_norm));
+  }
+
+  // the positions of the iterations are computed here, so only the
+  // log-weighted position calculation is supported
+  if (!conf.exists("positionCalc")) {
+    throw cms::Exception("InvalidPositionCalc") << "Basic2DGenericSoAPFlowClusterizer needs a positionCalc";
+  }
+  _posParams[0] = positionParams(conf.getParameterSet("positionCalc"));
+  if (conf.exists("allCellsPositionCalc")) {
+    const edm::ParameterSet& acConf = conf.getParameterSet("allCellsPositionCalc");
+    const std::string& algoac = acConf.getParameter<std::string>("algoName");
+    _allCellsPosCalc = PFCPositionCalculatorFactory::get()->create(algoac, acConf);
+    _posParams[1] = positionParams(acConf);
+    _hasAllCellsParams = true;
+  }
+  if (conf.exists("positionCalcForConvergence")) {
+    throw cms::Exception("InvalidPositionCalc")
+        << "Basic2DGenericSoAPFlowClusterizer does not support a positionCalcForConvergence";
+  }
+}
+
+Basic2DGenericSoAPFlowClusterizer::PositionParams Basic2DGenericSoAPFlowClusterizer::positionParams(
+    const edm::ParameterSet& conf) {
+  const std::string& algo = conf.getParameter<std::string>("algoName");
+  if (algo != std::string("Basic2DGenericPFlowPositionCalc")) {
+    throw cms::Exception("InvalidPositionCalc")
+        << "Basic2DGenericSoAPFlowClusterizer only supports the Basic2DGenericPFlowPositionCalc, not " << algo;
+  }
+
+  PositionParams params;
+  params.nCrystals = conf.getParameter<int>("posCalcNCrystals");
+  params.minFractionInCalc = conf.getParameter<double>("minFractionInCalc");
+  params.minAllowedNorm = conf.getParameter<double>("minAllowedNormalization");
+  switch (params.nCrystals) {
+    case 5:
+    case 9:
+    case -1:
+      break;
+    default:
+      throw cms::Exception("InvalidPositionCalc") << "posCalcNCrystals not valid";
+  }
+
+  std::vector<double> logWeightDenom;
+  if (conf.exists("logWeightDenominatorByDetector")) {
+    const std::vector<edm::ParameterSet>& logWeightDenominatorByDetectorPSet =
+        conf.getParameterSetVector("logWeightDenominatorByDetector");
+
+    for (const auto& pset : logWeightDenominatorByDetectorPSet) {
+      if (!pset.exists("detector")) {
+        throw cms::Exception("logWeightDenominatorByDetectorPSet") << "logWeightDenominator : detector not specified";
+      }
+
+      const std::string& det = pset.getParameter<std::string>("detector");
+
+      if (det == std::string("HCAL_BARREL1") || det == std::string("HCAL_ENDCAP")) {
+        std::vector<int> depthsT = pset.getParameter<std::vector<int> >("depths");
+        std::vector<double> logWeightDenomT = pset.getParameter<std::vector<double> >("logWeightDenominator");
+        if (logWeightDenomT.size() != depthsT.size()) {
+          throw cms::Exception("logWeightDenominator") << "logWeightDenominator mismatch with the numbers of depths";
+        }
+        for (unsigned int i = 0; i < depthsT.size(); ++i) {
+          params.detectorEnum.push_back(det == std::string("HCAL_BARREL1") ? 1 : 2);
+          params.depths.push_back(depthsT[i]);
+          logWeightDenom.push_back(logWeightDenomT[i]);
+        }
+      }
+    }
+  } else {
+    params.detectorEnum.push_back(0);
+    params.depths.push_back(0);
+    logWeightDenom.push_back(conf.getParameter<double>("logWeightDenominator"));
+  }
+  for (double denom : logWeightDenom) {
+    params.logWeightDenomInv.push_back(1. / denom);
+  }
+  return params;
+}
+
+void Basic2DGenericSoAPFlowClusterizer::buildClusters(const reco::PFClusterCollection& input,
+                                                      const std::vector<bool>& seedable,
+                                                      reco::PFClusterCollection& output) {
+  reco::PFClusterCollection clustersInTopo;
+  for (const auto& topocluster : input) {
+    fillTopoArrays(topocluster, seedable);
+    const unsigned nclus = _seedHit.size();
+    const unsigned tolScal = std::pow(std::max(1.0, nclus - 1.0), 2.0);
+    growPFClusters(tolScal);
+
+    // make the PFClusters from the converged fractions
+    const auto& recHitFractions = topocluster.recHitFractions();
+    const unsigned nhits = recHitFractions.size();
+    clustersInTopo.clear();
+    clustersInTopo.resize(nclus);
+    for (unsigned i = 0; i < nclus; ++i) {
+      reco::PFCluster& cluster = clustersInTopo[i];
+      const double* frac = &_frac[i * nhits];
+      const uint8_t* inCluster = &_inCluster[i * nhits];
+      for (unsigned j = 0; j < nhits; ++j) {
+        if (inCluster[j])
+          cluster.addRecHitFraction(reco::PFRecHitFraction(recHitFractions[j].recHitRef(), frac[j]));
+      }
+      cluster.setSeed(recHitFractions[_seedHit[i]].recHitRef()->detId());
+      // same pruning as Basic2DGenericPFlowClusterizer
+      cluster.pruneUsing([&](const reco::PFRecHitFraction& rhf) { return rhf.fraction() > _minFractionToKeep; });
+    }
+    if (clustersInTopo.size() == 1 && _allCellsPosCalc) {
+      _allCellsPosCalc->calculateAndSetPosition(clustersInTopo.back());
+    } else {
+      _positionCalc->calculateAndSetPositions(clustersInTopo);
+    }
+    std::move(clustersInTopo.begin(), clustersInTopo.end(), std::back_inserter(output));
+  }
+}
+
+void Basic2DGenericSoAPFlowClusterizer::fillTopoArrays(const reco::PFCluster& topo, const std::vector<bool>& seedable) {
+  const auto& recHitFractions = topo.recHitFractions();
+  const unsigned nhits = recHitFractions.size();
+  const unsigned npar = _hasAllCellsParams ? 2 : 1;
+
+  _hitX.resize(nhits);
+  _hitY.resize(nhits);
+  _hitZ.resize(nhits);
+  _hitEnergy.resize(nhits);
+  _hitEnergyNorm.resize(nhits);
+  _hitSeedable.resize(nhits);
+  for (unsigned p = 0; p < npar; ++p)
+    _hitLogWeightDenomInv[p].resize(nhits);
+  _seedHit.clear();
+
+  // rechit keys of the topo-cluster by increasing key, to find the seed neighbours
+  std::vector<std::pair<unsigned, unsigned> > keys;
+  keys.reserve(nhits);
+
+  for (unsigned j = 0; j < nhits; ++j) {
+    const reco::PFRecHitRef& refhit = recHitFractions[j].recHitRef();
+    const reco::PFRecHit& hit = *refhit;
+    const auto& pos = hit.position();
+    _hitX[j] = pos.x();
+    _hitY[j] = pos.y();
+    _hitZ[j] = pos.z();
+    _hitEnergy[j] = hit.energy();
+    _hitSeedable[j] = seedable[refhit.key()];
+    if (_hitSeedable[j])
+      _seedHit.push_back(j);
+    keys.emplace_back(refhit.key(), j);
+
+    int cell_layer = (int)hit.layer();
+    if (cell_layer == PFLayer::HCAL_BARREL2 && std::abs(hit.positionREP().eta()) > 0.34) {
+      cell_layer *= 100;
+    }
+    double recHitEnergyNorm = 0.;
+    auto const& recHitEnergyNormDepthPair = _recHitEnergyNorms.find(cell_layer)->second;
+    for (unsigned int k = 0; k < recHitEnergyNormDepthPair.second.size(); ++k) {
+      int depth = recHitEnergyNormDepthPair.first[k];
+
+      if ((cell_layer == PFLayer::HCAL_BARREL1 && hit.depth() == depth) ||
+          (cell_layer == PFLayer::HCAL_ENDCAP && hit.depth() == depth) ||
+          (cell_layer != PFLayer::HCAL_ENDCAP && cell_layer != PFLayer::HCAL_BARREL1))
+        recHitEnergyNorm = recHitEnergyNormDepthPair.second[k];
+    }
+    _hitEnergyNorm[j] = recHitEnergyNorm;
+
+    const int layer = (int)hit.layer();
+    for (unsigned p = 0; p < npar; ++p) {
+      const PositionParams& params = _posParams[p];
+      float threshold = 0;
+      for (unsigned int k = 0; k < params.logWeightDenomInv.size(); ++k) {
+        const int detectorEnum = params.detectorEnum[k];
+        const int depth = params.depths[k];
+        if ((layer == PFLayer::HCAL_BARREL1 && detectorEnum == 1 && hit.depth() == depth) ||
+            (layer == PFLayer::HCAL_ENDCAP && detectorEnum == 2 && hit.depth() == depth) || detectorEnum == 0)
+          threshold = params.logWeightDenomInv[k];
+      }
+      _hitLogWeightDenomInv[p][j] = threshold;
+    }
+  }
+  std::sort(keys.begin(), keys.end());
+
+  // the rechits of the topo-cluster next to each seed, for the position
+  // calculations restricted to the seed and its neighbours
+  const unsigned nclus = _seedHit.size();
+  std::vector<unsigned> neighbourKeys;
+  for (unsigned p = 0; p < npar; ++p) {
+    _seedNeighbourOffsets[p].assign(1, 0);
+    _seedNeighbours[p].clear();
+    if (_posParams[p].nCrystals == -1)
+      continue;
+    for (unsigned i = 0; i < nclus; ++i) {
+      const reco::PFRecHit& seed = *recHitFractions[_seedHit[i]].recHitRef();
+      const auto& neighbours = (_posParams[p].nCrystals == 5 ? seed.neighbours4() : seed.neighbours8());
+      neighbourKeys.assign(neighbours.begin(), neighbours.end());
+      std::sort(neighbourKeys.begin(), neighbourKeys.end());
+      auto key = keys.begin();
+      for (unsigned nb : neighbourKeys) {
+        key = std::lower_bound(key, keys.end(), std::make_pair(nb, 0u));
+        if (key != keys.end() && key->first == nb)
+          _seedNeighbours[p].push_back(key->second);
+      }
+      _seedNeighbourOffsets[p].push_back(_seedNeighbours[p].size());
+    }
+  }
+
+  // each seed starts as a cluster of its own
+  _clusX.resize(nclus);
+  _clusY.resize(nclus);
+  _clusZ.resize(nclus);
+  _clusEnergy.resize(nclus);
+  _clusEta.resize(nclus);
+  _clusPhi.resize(nclus);
+  _dist2.resize(nclus * nhits);
+  _frac.assign(nclus * nhits, 0.0);
+  _inCluster.assign(nclus * nhits, 0);
+  _fracTot.resize(nhits);
+  _posNorm.resize(nhits);
+  for (unsigned i = 0; i < nclus; ++i) {
+    _frac[i * nhits + _seedHit[i]] = 1.0;
+    _inCluster[i * nhits + _seedHit[i]] = 1;
+    calculatePosition(_posParams[0], 0, i);
+  }
+}
+
+void Basic2DGenericSoAPFlowClusterizer::growPFClusters(const unsigned toleranceScaling) {
+  const unsigned nhits = _hitX.size();
+  const unsigned nclus = _seedHit.size();
+  const unsigned ipar = (nclus == 1 && _hasAllCellsParams) ? 1 : 0;
+
+  double diff = toleranceScaling;
+  for (unsigned iter = 0;; ++iter) {
+    if (iter >= _maxIterations) {
+      LOGDRESSED("Basic2DGenericSoAPFlowClusterizer:growAndStabilizePFClusters")
+          << "reached " << _maxIterations << " iterations, terminated position "
+          << "fit with diff = " << diff;
+      break;
+    }
+    if (diff <= _stoppingTolerance * toleranceScaling)
+      break;
+
+    // distances and fractions of the rechits to the current clusters
+    std::fill(_fracTot.begin(), _fracTot.end(), 0.0);
+    for (unsigned i = 0; i < nclus; ++i) {
+      const double clusX = _clusX[i];
+      const double clusY = _clusY[i];
+      const double clusZ = _clusZ[i];
+      const double clusEnergy = _clusEnergy[i];
+      double* dist2 = &_dist2[i * nhits];
+      double* frac = &_frac[i * nhits];
+      for (unsigned j = 0; j < nhits; ++j) {
+        const double dx = clusX - _hitX[j];
+        const double dy = clusY - _hitY[j];
+        const double dz = clusZ - _hitZ[j];
+        dist2[j] = (dx * dx + dy * dy + dz * dz) / _showerSigma2;
+        frac[j] = clusEnergy / _hitEnergyNorm[j] * vdt::fast_expf(-0.5 * dist2[j]);
+      }
+      if (_excludeOtherSeeds) {
+        for (unsigned j = 0; j < nhits; ++j) {
+          if (_hitSeedable[j])
+            frac[j] = (j == _seedHit[i] ? 1.0 : 0.0);
+        }
+      }
+      for (unsigned j = 0; j < nhits; ++j)
+        _fracTot[j] += frac[j];
+    }
+
+    // normalize the fractions, keeping only the close rechits or the ones
+    // with a large fraction, as in Basic2DGenericPFlowClusterizer
+    for (unsigned i = 0; i < nclus; ++i) {
+      const double* dist2 = &_dist2[i * nhits];
+      double* frac = &_frac[i * nhits];
+      uint8_t* inCluster = &_inCluster[i * nhits];
+      for (unsigned j = 0; j < nhits; ++j) {
+        const double fracTot = _fracTot[j];
+        const bool normalized = fracTot > _minFracTot || (j == _seedHit[i] && fracTot > 0.0);
+        if (normalized)
+          frac[j] /= fracTot;
+        inCluster[j] = normalized && (dist2[j] < 100.0 || frac[j] > 0.9999);
+      }
+    }
+
+    // recalculate positions and calculate convergence parameter
+    double diff2 = 0.0;
+    for (unsigned i = 0; i < nclus; ++i) {
+      const double prevEta = _clusEta[i];
+      const double prevPhi = _clusPhi[i];
+      calculatePosition(_posParams[ipar], ipar, i);
+      const double delta2 = reco::deltaR2(_clusEta[i], _clusPhi[i], prevEta, prevPhi);
+      if (delta2 > diff2)
+        diff2 = delta2;
+    }
+    diff = std::sqrt(diff2);
+  }
+}
+
+void Basic2DGenericSoAPFlowClusterizer::calculatePosition(const PositionParams& params,
+                                                          const unsigned ipar,
+                                                          const unsigned iclus) {
+  const unsigned nhits = _hitX.size();
+  const unsigned seed = _seedHit[iclus];
+  const double* frac = &_frac[iclus * nhits];
+  const uint8_t* inCluster = &_inCluster[iclus * nhits];
+  const float* logWeightDenomInv = _hitLogWeightDenomInv[ipar].data();
+
+  if (!inCluster[seed]) {
+    throw cms::Exception("Basic2DGenerticPFlowPositionCalc")
+        << "Cluster seed hit is null, something is wrong with PFlow RecHit!";
+  }
+
+  double energy = 0.0;
+  for (unsigned j = 0; j < nhits; ++j) {
+    if (inCluster[j])
+      energy += _hitEnergy[j] * float(frac[j]);
+  }
+  for (unsigned j = 0; j < nhits; ++j) {
+    const float fraction = frac[j];
+    const float norm = std::max(0.0f, vdt::fast_logf(_hitEnergy[j] * fraction * logWeightDenomInv[j]));
+    _posNorm[j] = (fraction < params.minFractionInCalc ? 0.0f : norm);
+  }
+
+  double position_norm = 0.0;
+  double x(0.0), y(0.0), z(0.0);
+  auto compute = [&](unsigned j) {
+    const float norm = _posNorm[j];
+    x += _hitX[j] * norm;
+    y += _hitY[j] * norm;
+    z += _hitZ[j] * norm;
+    position_norm += norm;
+  };
+  if (params.nCrystals == -1) {
+    for (unsigned j = 0; j < nhits; ++j) {
+      if (inCluster[j])
+        compute(j);
+    }
+  } else {  // only seed and its neighbours
+    compute(seed);
+    for (unsigned k = _seedNeighbourOffsets[ipar][iclus]; k < _seedNeighbourOffsets[ipar][iclus + 1]; ++k) {
+      if (inCluster[_seedNeighbours[ipar][k]])
+        compute(_seedNeighbours[ipar][k]);
+    }
+  }
+
+  _clusEnergy[iclus] = energy;
+  if (position_norm < params.minAllowedNorm) {
+    edm::LogError("WeirdClusterNormalization") << "PFCluster too far from seeding cell: set position to (0,0,0).";
+    x = y = z = 0.0;
+  } else {
+    const double norm_inverse = 1.0 / position_norm;
+    x *= norm_inverse;
+    y *= norm_inverse;
+    z *= norm_inverse;
+  }
+  _clusX[iclus] = x;
+  _clusY[iclus] = y;
+  _clusZ[iclus] = z;
+  const math::XYZPoint position(x, y, z);
+  const reco::PFCluster::REPPoint positionREP(position.Rho(), position.Eta(), position.Phi());
+  _clusEta[iclus] = positionREP.eta();
+  _clusPhi[iclus] = positionREP.phi();
+}
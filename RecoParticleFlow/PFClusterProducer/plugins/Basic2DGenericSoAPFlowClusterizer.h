@@ -0,0 +1,96 @@
+#ifndef __Basic2DGenericSoAPFlowClusterizer_H__
+#define __Basic2DGenericSoAPFlowClusterizer_H__
+
+#include "RecoParticleFlow/PFClusterProducer/interface/PFClusterBuilderBase.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHitFraction.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// The Gaussian-shower fit of Basic2DGenericPFlowClusterizer, run on arrays
+// of the rechits of each topo-cluster and of its seeded clusters: the
+// distances and fractions of all the (cluster, rechit) pairs are computed
+// in flat loops, and the log-weighted positions of the iterations are
+// computed in place, with the parameters of the Basic2DGenericPFlowPositionCalc
+// "positionCalc" and "allCellsPositionCalc". PFClusters are only made once
+// the fit has converged, and their final positions are set by the position
+// calculators as in Basic2DGenericPFlowClusterizer. The rechits are taken in
+// the order of the topo-clusters.
+class Basic2DGenericSoAPFlowClusterizer : public PFClusterBuilderBase {
+  typedef Basic2DGenericSoAPFlowClusterizer B2DGSoAPF;
+
+public:
+  Basic2DGenericSoAPFlowClusterizer(const edm::ParameterSet& conf);
+
+  ~Basic2DGenericSoAPFlowClusterizer() override = default;
+  Basic2DGenericSoAPFlowClusterizer(const B2DGSoAPF&) = delete;
+  B2DGSoAPF& operator=(const B2DGSoAPF&) = delete;
+
+  void update(const edm::EventSetup& es) override {
+    _positionCalc->update(es);
+    if (_allCellsPosCalc)
+      _allCellsPosCalc->update(es);
+  }
+
+  void buildClusters(const reco::PFClusterCollection&,
+                     const std::vector<bool>&,
+                     reco::PFClusterCollection& outclus) override;
+
+private:
+  // parameters of a Basic2DGenericPFlowPositionCalc
+  struct PositionParams {
+    int nCrystals;
+    float minFractionInCalc;
+    float minAllowedNorm;
+    std::vector<int> detectorEnum;
+    std::vector<int> depths;
+    std::vector<float> logWeightDenomInv;
+  };
+
+  const unsigned _maxIterations;
+  const double _stoppingTolerance;
+  const double _showerSigma2;
+  const bool _excludeOtherSeeds;
+  const double _minFracTot;
+  const std::unordered_map<std::string, int> _layerMap;
+
+  std::unordered_map<int, std::pair<std::vector<int>, std::vector<double> > > _recHitEnergyNorms;
+  std::unique_ptr<PFCPositionCalculatorBase> _allCellsPosCalc;
+  // [0] for the positionCalc, [1] for the allCellsPositionCalc
+  PositionParams _posParams[2];
+  bool _hasAllCellsParams;
+
+  // rechits of the topo-cluster
+  std::vector<float> _hitX, _hitY, _hitZ;
+  std::vector<float> _hitEnergy;
+  std::vector<double> _hitEnergyNorm;
+  std::vector<uint8_t> _hitSeedable;
+  std::vector<float> _hitLogWeightDenomInv[2];
+  // clusters seeded in the topo-cluster
+  std::vector<unsigned int> _seedHit;
+  std::vector<double> _clusX, _clusY, _clusZ;
+  std::vector<double> _clusEnergy;
+  std::vector<double> _clusEta, _clusPhi;
+  // rechits of the topo-cluster around each seed, by increasing index
+  std::vector<unsigned int> _seedNeighbourOffsets[2];
+  std::vector<unsigned int> _seedNeighbours[2];
+  // (cluster, rechit) matrices, by cluster
+  std::vector<double> _dist2;
+  std::vector<double> _frac;
+  std::vector<uint8_t> _inCluster;
+  std::vector<double> _fracTot;
+  std::vector<float> _posNorm;
+
+  static PositionParams positionParams(const edm::ParameterSet&);
+
+  void fillTopoArrays(const reco::PFCluster&, const std::vector<bool>&);
+
+  void growPFClusters(const unsigned toleranceScaling);
+
+  void calculatePosition(const PositionParams&, const unsigned ipar, const unsigned iclus);
+};
+
+DEFINE_EDM_PLUGIN(PFClusterBuilderFactory, Basic2DGenericSoAPFlowClusterizer, "Basic2DGenericSoAPFlowClusterizer");
+
+#endif
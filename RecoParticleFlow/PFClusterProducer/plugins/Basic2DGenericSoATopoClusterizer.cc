@@ -0,0 +1,86 @@
+#include "Basic2DGenericSoATopoClusterizer.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include <algorithm>
+#include <cmath>
+
+void Basic2DGenericSoATopoClusterizer::buildClusters(const edm::Handle<reco::PFRecHitCollection>& input,
+                                                     const std::vector<bool>& rechitMask,
+                                                     const std::vector<bool>& seedable,
+                                                     reco::PFClusterCollection& output) {
+  auto const& hits = *input;
+  const unsigned int nhits = hits.size();
+
+  _gathered.resize(nhits);
+  _used.assign(nhits, 0);
+  _seeds.clear();
+  for (unsigned int i = 0; i < nhits; ++i) {
+    _gathered[i] = rechitMask[i] && passesGatheringThresholds(hits[i]);
+    if (rechitMask[i] && seedable[i])
+      _seeds.push_back(i);
+  }
+  // the seeds descending in energy, as in Basic2DGenericTopoClusterizer
+  std::sort(
+      _seeds.begin(), _seeds.end(), [&](unsigned int i, unsigned int j) { return hits[i].energy() > hits[j].energy(); });
+
+  // depth-first walk from each seed along the neighbour lists of the rechits
+  // reached, in the order of the recursion of Basic2DGenericTopoClusterizer
+  _topoOffsets.assign(1, 0);
+  _topoHits.clear();
+  for (auto seed : _seeds) {
+    if (_used[seed] || !_gathered[seed])
+      continue;
+    _used[seed] = 1;
+    _topoHits.push_back(seed);
+    _stack.assign(1, std::make_pair(seed, 0u));
+    while (!_stack.empty()) {
+      const unsigned int cell = _stack.back().first;
+      auto const& neighbours = (_useCornerCells ? hits[cell].neighbours8() : hits[cell].neighbours4());
+      if (_stack.back().second == neighbours.size()) {
+        _stack.pop_back();
+        continue;
+      }
+      const unsigned int nb = neighbours.begin()[_stack.back().second++];
+      if (_used[nb] || !_gathered[nb])
+        continue;
+      _used[nb] = 1;
+      _topoHits.push_back(nb);
+      _stack.emplace_back(nb, 0u);
+    }
+    _topoOffsets.push_back(_topoHits.size());
+  }
+  const unsigned int ntopos = _topoOffsets.size() - 1;
+
+  output.reserve(output.size() + ntopos);
+  for (unsigned int t = 0; t < ntopos; ++t) {
+    output.emplace_back();
+    reco::PFCluster& topocluster = output.back();
+    for (unsigned int k = _topoOffsets[t]; k < _topoOffsets[t + 1]; ++k)
+      topocluster.addRecHitFraction(reco::PFRecHitFraction(makeRefhit(input, _topoHits[k]), 1.0));
+  }
+  LogDebug("Basic2DGenericSoATopoClusterizer") << "built " << ntopos << " topo-clusters from " << nhits << " rechits";
+}
+
+bool Basic2DGenericSoATopoClusterizer::passesGatheringThresholds(const reco::PFRecHit& cell) const {
+  int cell_layer = (int)cell.layer();
+  if (cell_layer == PFLayer::HCAL_BARREL2 && std::abs(cell.positionREP().eta()) > 0.34) {
+    cell_layer *= 100;
+  }
+
+  auto const& thresholds = _thresholds.find(cell_layer)->second;
+  double thresholdE = 0.;
+  double thresholdPT2 = 0.;
+
+  for (unsigned int j = 0; j < (std::get<1>(thresholds)).size(); ++j) {
+    int depth = std::get<0>(thresholds)[j];
+
+    if ((cell_layer == PFLayer::HCAL_BARREL1 && cell.depth() == depth) ||
+        (cell_layer == PFLayer::HCAL_ENDCAP && cell.depth() == depth) ||
+        (cell_layer != PFLayer::HCAL_BARREL1 && cell_layer != PFLayer::HCAL_ENDCAP)) {
+      thresholdE = std::get<1>(thresholds)[j];
+      thresholdPT2 = std::get<2>(thresholds)[j];
+    }
+  }
+
+  return !(cell.energy() < thresholdE || cell.pt2() < thresholdPT2);
+}
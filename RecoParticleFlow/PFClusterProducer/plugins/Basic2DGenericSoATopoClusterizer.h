@@ -0,0 +1,52 @@
+#ifndef __Basic2DGenericSoATopoClusterizer_H__
+#define __Basic2DGenericSoATopoClusterizer_H__
+
+#include "RecoParticleFlow/PFClusterProducer/interface/InitialClusteringStepBase.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHitFraction.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Same topo-clusters as Basic2DGenericTopoClusterizer, built without
+// recursion: the rechits passing the mask and the gathering thresholds are
+// flagged in one loop, and each seed, by decreasing energy, collects the
+// flagged rechits reached from it along the neighbour lists with an explicit
+// stack. As in the recursion, a rechit is only linked to the rechits in its
+// own neighbour list, which need not list it back, and the topo-clusters and
+// the order of their rechits are the same. test/compareSoAPFClusters_cfg.py
+// compares both on the same rechits.
+class Basic2DGenericSoATopoClusterizer : public InitialClusteringStepBase {
+  typedef Basic2DGenericSoATopoClusterizer B2DGSoAT;
+
+public:
+  Basic2DGenericSoATopoClusterizer(const edm::ParameterSet& conf, edm::ConsumesCollector& sumes)
+      : InitialClusteringStepBase(conf, sumes), _useCornerCells(conf.getParameter<bool>("useCornerCells")) {}
+  ~Basic2DGenericSoATopoClusterizer() override = default;
+  Basic2DGenericSoATopoClusterizer(const B2DGSoAT&) = delete;
+  B2DGSoAT& operator=(const B2DGSoAT&) = delete;
+
+  void buildClusters(const edm::Handle<reco::PFRecHitCollection>&,
+                     const std::vector<bool>&,
+                     const std::vector<bool>&,
+                     reco::PFClusterCollection&) override;
+
+private:
+  const bool _useCornerCells;
+
+  // per rechit: passes the mask and the gathering thresholds, already in a topo-cluster
+  std::vector<uint8_t> _gathered;
+  std::vector<uint8_t> _used;
+  // seeds by decreasing energy, and the rechits and next neighbour of the walk
+  std::vector<unsigned int> _seeds;
+  std::vector<std::pair<unsigned int, unsigned int> > _stack;
+  // rechits of the topo-clusters
+  std::vector<unsigned int> _topoOffsets;
+  std::vector<unsigned int> _topoHits;
+
+  bool passesGatheringThresholds(const reco::PFRecHit&) const;
+};
+
+DEFINE_EDM_PLUGIN(InitialClusteringStepFactory, Basic2DGenericSoATopoClusterizer, "Basic2DGenericSoATopoClusterizer");
+
+#endif
@@ -0,0 +1,136 @@
+// Builds the PFRecHitNeighbourTable of the cells of the given calorimeter
+// subdetectors once per geometry, navigating their topologies as the
+// PFRecHitCaloNavigator does for each rechit.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FWCore/Framework/interface/ESProducer.h"
+#include "FWCore/Framework/interface/ModuleFactory.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/ESGetToken.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "Geometry/Records/interface/CaloGeometryRecord.h"
+#include "Geometry/Records/interface/HcalRecNumberingRecord.h"
+
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitCaloNavigator.h"
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitNeighbourTable.h"
+
+class PFRecHitNeighbourTableESProducer : public edm::ESProducer {
+public:
+  PFRecHitNeighbourTableESProducer(const edm::ParameterSet& iConfig);
+
+  std::unique_ptr<PFRecHitNeighbourTable> produce(const CaloGeometryRecord&);
+
+private:
+  enum Topology { kEcalBarrel, kEcalEndcap, kEcalPreshower, kHcal, kCaloTower };
+  struct Subdetector {
+    DetId::Detector det;
+    int subdet;
+    Topology topology;
+  };
+  std::vector<Subdetector> subdetectors_;
+
+  edm::ESGetToken<CaloGeometry, CaloGeometryRecord> geometryToken_;
+  edm::ESGetToken<HcalTopology, HcalRecNumberingRecord> hcalTopologyToken_;
+  edm::ESGetToken<CaloTowerTopology, HcalRecNumberingRecord> caloTowerTopologyToken_;
+};
+
+PFRecHitNeighbourTableESProducer::PFRecHitNeighbourTableESProducer(const edm::ParameterSet& iConfig) {
+  bool useHcalTopology = false;
+  bool useCaloTowerTopology = false;
+  for (const auto& name : iConfig.getParameter<std::vector<std::string> >("detectors")) {
+    if (name == "EcalBarrel")
+      subdetectors_.push_back({DetId::Ecal, EcalBarrel, kEcalBarrel});
+    else if (name == "EcalEndcap")
+      subdetectors_.push_back({DetId::Ecal, EcalEndcap, kEcalEndcap});
+    else if (name == "EcalPreshower")
+      subdetectors_.push_back({DetId::Ecal, EcalPreshower, kEcalPreshower});
+    else if (name == "HcalBarrel")
+      subdetectors_.push_back({DetId::Hcal, HcalBarrel, kHcal});
+    else if (name == "HcalEndcap")
+      subdetectors_.push_back({DetId::Hcal, HcalEndcap, kHcal});
+    else if (name == "HcalOuter")
+      subdetectors_.push_back({DetId::Hcal, HcalOuter, kHcal});
+    else if (name == "HcalForward")
+      subdetectors_.push_back({DetId::Hcal, HcalForward, kHcal});
+    else if (name == "CaloTower")
+      subdetectors_.push_back({DetId::Calo, CaloTowerDetId::SubdetId, kCaloTower});
+    else
+      throw cms::Exception("InvalidDetector") << "PFRecHitNeighbourTableESProducer: unknown detector " << name;
+    useHcalTopology |= (subdetectors_.back().topology == kHcal);
+    useCaloTowerTopology |= (subdetectors_.back().topology == kCaloTower);
+  }
+
+  auto cc = setWhatProduced(this);
+  geometryToken_ = cc.consumesFrom<CaloGeometry, CaloGeometryRecord>();
+  if (useHcalTopology)
+    hcalTopologyToken_ = cc.consumesFrom<HcalTopology, HcalRecNumberingRecord>();
+  if (useCaloTowerTopology)
+    caloTowerTopologyToken_ = cc.consumesFrom<CaloTowerTopology, HcalRecNumberingRecord>();
+}
+
+std::unique_ptr<PFRecHitNeighbourTable> PFRecHitNeighbourTableESProducer::produce(const CaloGeometryRecord& iRecord) {
+  const CaloGeometry& geometry = iRecord.get(geometryToken_);
+
+  std::vector<uint32_t> detIds;
+  for (const auto& sub : subdetectors_) {
+    for (const DetId& id : geometry.getValidDetIds(sub.det, sub.subdet))
+      detIds.push_back(id.rawId());
+  }
+  std::sort(detIds.begin(), detIds.end());
+  detIds.erase(std::unique(detIds.begin(), detIds.end()), detIds.end());
+
+  auto cellOf = [&detIds](const DetId& id) -> int {
+    auto it = std::lower_bound(detIds.begin(), detIds.end(), id.rawId());
+    return (it != detIds.end() && *it == id.rawId()) ? int(it - detIds.begin()) : -1;
+  };
+
+  std::unique_ptr<EcalBarrelTopology> barrelTopology;
+  std::unique_ptr<EcalEndcapTopology> endcapTopology;
+  std::unique_ptr<EcalPreshowerTopology> preshowerTopology;
+
+  std::vector<int> neighbours(PFRecHitNeighbourTable::kNeighbours * detIds.size(), -1);
+  DetId cellNeighbours[pfrechit::kNeighbours];
+  for (const auto& sub : subdetectors_) {
+    for (const DetId& id : geometry.getValidDetIds(sub.det, sub.subdet)) {
+      switch (sub.topology) {
+        case kEcalBarrel:
+          if (!barrelTopology)
+            barrelTopology = std::make_unique<EcalBarrelTopology>(geometry);
+          pfrechit::caloNeighbours<EBDetId>(id, barrelTopology.get(), cellNeighbours);
+          break;
+        case kEcalEndcap:
+          if (!endcapTopology)
+            endcapTopology = std::make_unique<EcalEndcapTopology>(geometry);
+          pfrechit::caloNeighbours<EEDetId>(id, endcapTopology.get(), cellNeighbours);
+          break;
+        case kEcalPreshower:
+          if (!preshowerTopology)
+            preshowerTopology = std::make_unique<EcalPreshowerTopology>();
+          pfrechit::caloNeighbours<ESDetId>(id, preshowerTopology.get(), cellNeighbours);
+          break;
+        case kHcal:
+          pfrechit::caloNeighbours<HcalDetId>(id, &iRecord.get(hcalTopologyToken_), cellNeighbours);
+          break;
+        case kCaloTower:
+          pfrechit::caloNeighbours<CaloTowerDetId>(id, &iRecord.get(caloTowerTopologyToken_), cellNeighbours);
+          break;
+      }
+      int* slots = neighbours.data() + PFRecHitNeighbourTable::kNeighbours * cellOf(id);
+      for (unsigned k = 0; k < pfrechit::kNeighbours; ++k) {
+        if (cellNeighbours[k] != DetId(0))
+          slots[k] = cellOf(cellNeighbours[k]);
+      }
+    }
+  }
+
+  LogDebug("PFRecHitNeighbourTableESProducer") << "made the neighbours of " << detIds.size() << " cells";
+  return std::make_unique<PFRecHitNeighbourTable>(std::move(detIds), std::move(neighbours));
+}
+
+DEFINE_FWK_EVENTSETUP_MODULE(PFRecHitNeighbourTableESProducer);
@@ -0,0 +1,34 @@
+import FWCore.ParameterSet.Config as cms
+
+# Neighbour tables of the calorimeter cells, made once per geometry, for the
+# PFRecHitTableNavigator. To use one in a rechit producer:
+#
+#   particleFlowRecHitECAL.navigator = cms.PSet(
+#       name = cms.string("PFRecHitTableNavigator"),
+#       neighbourTable = cms.string("ECAL")
+#   )
+
+pfRecHitNeighbourTableECAL = cms.ESProducer("PFRecHitNeighbourTableESProducer",
+    detectors = cms.vstring("EcalBarrel", "EcalEndcap"),
+    appendToDataLabel = cms.string("ECAL")
+)
+
+pfRecHitNeighbourTablePS = cms.ESProducer("PFRecHitNeighbourTableESProducer",
+    detectors = cms.vstring("EcalPreshower"),
+    appendToDataLabel = cms.string("PS")
+)
+
+pfRecHitNeighbourTableHBHE = cms.ESProducer("PFRecHitNeighbourTableESProducer",
+    detectors = cms.vstring("HcalBarrel", "HcalEndcap"),
+    appendToDataLabel = cms.string("HBHE")
+)
+
+pfRecHitNeighbourTableHF = cms.ESProducer("PFRecHitNeighbourTableESProducer",
+    detectors = cms.vstring("HcalForward"),
+    appendToDataLabel = cms.string("HF")
+)
+
+pfRecHitNeighbourTableHO = cms.ESProducer("PFRecHitNeighbourTableESProducer",
+    detectors = cms.vstring("HcalOuter"),
+    appendToDataLabel = cms.string("HO")
+)
@@ -0,0 +1,4 @@
+#include "FWCore/Utilities/interface/typelookup.h"
+#include "RecoParticleFlow/PFClusterProducer/interface/PFRecHitNeighbourTable.h"
+
+TYPELOOKUP_DATA_REG(PFRecHitNeighbourTable);
@@ -0,0 +1,49 @@
+import FWCore.ParameterSet.Config as cms
+
+# Builds the HBHE PFClusters from the same rechits with the recursive
+# Basic2DGenericTopoClusterizer + Basic2DGenericPFlowClusterizer and with
+# their SoA versions, and compares the clusters seed by seed with the
+# PFClusterComparator, which prints the energies and positions differing by
+# more than 1e-5. Both topo-clusterizers follow the same neighbour lists from
+# the seeds, so the topo-clusters and the order of their rechits are the same.
+
+process = cms.Process("reRECO")
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(100)
+    )
+process.source = cms.Source(
+    "PoolSource",
+    fileNames = cms.untracked.vstring(
+    '/store/relval/CMSSW_7_1_0_pre3/RelValTTbar_13/GEN-SIM-RECO/POSTLS171_V1-v1/00000/76897917-C0A1-E311-A852-02163E00EA9A.root',
+    '/store/relval/CMSSW_7_1_0_pre3/RelValTTbar_13/GEN-SIM-RECO/POSTLS171_V1-v1/00000/7AAC4BC0-C3A1-E311-A8BF-02163E00EAEA.root'
+    )
+)
+
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_mc', '')
+
+process.TFileService = cms.Service('TFileService',
+                                   fileName = cms.string('clusterValid_soa.root')
+                                   )
+
+process.load("RecoParticleFlow.PFClusterProducer.particleFlowRecHitHBHE_cfi")
+process.load("RecoParticleFlow.PFClusterProducer.particleFlowClusterHBHE_cfi")
+process.particleFlowClusterHBHESoA = process.particleFlowClusterHBHE.clone()
+process.particleFlowClusterHBHESoA.initialClusteringStep.algoName = "Basic2DGenericSoATopoClusterizer"
+process.particleFlowClusterHBHESoA.pfClusterBuilder.algoName = "Basic2DGenericSoAPFlowClusterizer"
+
+process.hbheClusterCompare = cms.EDAnalyzer(
+    "PFClusterComparator",
+    PFClusters = cms.InputTag("particleFlowClusterHBHE",'','reRECO'),
+    PFClustersCompare = cms.InputTag("particleFlowClusterHBHESoA",'','reRECO'),
+    verbose = cms.untracked.bool(True),
+    printBlocks = cms.untracked.bool(True)
+)
+
+process.p = cms.Path( process.particleFlowRecHitHBHE     +
+                      process.particleFlowClusterHBHE    +
+                      process.particleFlowClusterHBHESoA +
+                      process.hbheClusterCompare           )
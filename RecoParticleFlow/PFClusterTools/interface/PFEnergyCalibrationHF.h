@@ -34,13 +34,13 @@ public:
 
   ~PFEnergyCalibrationHF();
 
-  double energyEm(double uncalibratedEnergyECAL, double eta, double phi);
+  double energyEm(double uncalibratedEnergyECAL, double eta, double phi) const;
 
   // HCAL only calibration
-  double energyHad(double uncalibratedEnergyHCAL, double eta, double phi);
+  double energyHad(double uncalibratedEnergyHCAL, double eta, double phi) const;
 
   // ECAL+HCAL (abc) calibration
-  double energyEmHad(double uncalibratedEnergyECAL, double uncalibratedEnergyHCAL, double eta, double phi);
+  double energyEmHad(double uncalibratedEnergyECAL, double uncalibratedEnergyHCAL, double eta, double phi) const;
 
   friend std::ostream& operator<<(std::ostream& out, const PFEnergyCalibrationHF& calib);
 
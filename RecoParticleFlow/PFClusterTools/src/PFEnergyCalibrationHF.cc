@@ -45,7 +45,7 @@ PFEnergyCalibrationHF::~PFEnergyCalibrationHF() {
   //--- nothing to be done yet
 }
 
-double PFEnergyCalibrationHF::energyEm(double uncalibratedEnergyECAL, double eta, double phi) {
+double PFEnergyCalibrationHF::energyEm(double uncalibratedEnergyECAL, double eta, double phi) const {
   double calibrated = 0.0;
   //find eta bin.  default : 0.00;2.90;3.00;3.20;4.20;4.40;4.60;4.80;5.20;5.40;
   int ietabin = 0;
@@ -60,7 +60,7 @@ double PFEnergyCalibrationHF::energyEm(double uncalibratedEnergyECAL, double eta
   // return calibrated;
 }
 
-double PFEnergyCalibrationHF::energyHad(double uncalibratedEnergyHCAL, double eta, double phi) {
+double PFEnergyCalibrationHF::energyHad(double uncalibratedEnergyHCAL, double eta, double phi) const {
   double calibrated = 0.0;
   //find eta bin.  default : 0.00;2.90;3.00;3.20;4.20;4.40;4.60;4.80;5.20;5.40;
   int ietabin = 0;
@@ -76,7 +76,7 @@ double PFEnergyCalibrationHF::energyHad(double uncalibratedEnergyHCAL, double et
 double PFEnergyCalibrationHF::energyEmHad(double uncalibratedEnergyECAL,
                                           double uncalibratedEnergyHCAL,
                                           double eta,
-                                          double phi) {
+                                          double phi) const {
   double calibrated = 0.0;
   //find eta bin.  default : 0.00;2.90;3.00;3.20;4.20;4.40;4.60;4.80;5.20;5.40+;
   int ietabin = 0;
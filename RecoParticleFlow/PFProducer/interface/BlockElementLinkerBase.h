@@ -4,8 +4,16 @@
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "DataFormats/Common/interface/Handle.h"
 #include "DataFormats/ParticleFlowReco/interface/PFBlockElement.h"
+#include "DataFormats/ParticleFlowReco/interface/PFLayer.h"
 
+#include <functional>
 #include <string>
+#include <vector>
+
+namespace reco {
+  class PFCluster;
+  class PFRecTrack;
+}  // namespace reco
 
 class BlockElementLinkerBase {
 public:
@@ -18,8 +26,61 @@ public:
 
   virtual double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const = 0;
 
+  // Linkers that only link two elements with a key in common (the same
+  // reference, a position found by the KD-tree, neighbouring (eta, phi) cells,
+  // a position inside the window of a cluster)
+  // fill the keys of an element and return true: the PFBlockAlgo then only
+  // tests them on the pairs of elements with a common key. An element for
+  // which they return false is tested with all elements.
+  virtual bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>& keys) const { return false; }
+
   const std::string& name() const { return _linkerName; }
 
+protected:
+  // key of a position, as stored in the multilinks by the KD-trees
+  static size_t positionKey(double phi, double eta) {
+    return combineKeys(std::hash<double>()(phi), std::hash<double>()(eta));
+  }
+
+  // key of a reference, the same for equal references
+  template <typename R>
+  static size_t refKey(const R& ref) {
+    return combineKeys(combineKeys(ref.id().processIndex(), ref.id().productIndex()), ref.key());
+  }
+
+  // keys of the (eta, phi) cell of (eta, phi), or of this cell and of its
+  // neighbours, the cells being larger than cellSize in eta and in phi: two
+  // positions closer than cellSize in eta and in phi share a key when the
+  // keys of one of them include the neighbours
+  static void etaPhiCellKeys(double eta, double phi, double cellSize, bool withNeighbours, std::vector<size_t>& keys);
+
+  // keys of the (eta, phi) cells of size cellSize overlapping the window
+  // [etaMin, etaMax] x [phiMin, phiMax], or of the (x, y) cells overlapping the
+  // window [xMin, xMax] x [yMin, yMax] on the side z of the detector (both
+  // sides for z = 0): a position inside a window shares a key with it when its
+  // keys are those of the window reduced to this position. They return false
+  // if the window covers too many cells to be keyed.
+  static bool etaPhiWindowKeys(
+      double etaMin, double etaMax, double phiMin, double phiMax, double cellSize, std::vector<size_t>& keys);
+  static bool xyWindowKeys(
+      double xMin, double xMax, double yMin, double yMax, double z, double cellSize, std::vector<size_t>& keys);
+
+  // keys of the windows around the rechits of a cluster inside which
+  // LinkByRecHit::testTrackAndClusterByRecHit can find a track, and keys of the
+  // position of a track in the calorimeter calo (ECAL_BARREL for the ECAL,
+  // HCAL_BARREL1 for the HCAL, HCAL_BARREL2 for the HO). The windows are only
+  // bounds for the tracks of pt above 2 GeV with a small HCAL crossing, the
+  // keys of the other tracks return false.
+  static bool clusterByRecHitKeys(const reco::PFCluster& cluster, std::vector<size_t>& keys);
+  static bool trackByRecHitKeys(const reco::PFRecTrack& track,
+                                bool isBrem,
+                                PFLayer::Layer calo,
+                                std::vector<size_t>& keys);
+
+  static size_t combineKeys(size_t seed, size_t key) {
+    return seed ^ (key + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+  }
+
 private:
   const std::string _linkerName;
 };
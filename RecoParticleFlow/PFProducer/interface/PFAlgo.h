@@ -55,12 +55,14 @@ public:
   /// constructor
   PFAlgo(double nSigmaECAL,
          double nSigmaHCAL,
-         PFEnergyCalibration& calibration,
-         PFEnergyCalibrationHF& thepfEnergyCalibrationHF,
+         const PFEnergyCalibration& calibration,
+         const PFEnergyCalibrationHF& thepfEnergyCalibrationHF,
          const edm::ParameterSet& pset,
          bool debug);
 
   void setHOTag(bool ho) { useHO_ = ho; }
+  /// process the blocks in parallel, unless the debug printout is on
+  void setParallelBlocks(bool parallelBlocks) { parallelBlocks_ = parallelBlocks; }
   void setMuonHandle(const edm::Handle<reco::MuonCollection>&);
 
   void setCandConnectorParameters(const edm::ParameterSet& iCfgCandConnector) {
@@ -121,9 +123,13 @@ public:
   friend std::ostream& operator<<(std::ostream& out, const PFAlgo& algo);
 
 private:
-  void egammaFilters(const reco::PFBlockRef& blockref, std::vector<bool>& active, PFEGammaFilters const* pfegamma);
+  void egammaFilters(reco::PFCandidateCollection& pfCandidates,
+                     const reco::PFBlockRef& blockref,
+                     std::vector<bool>& active,
+                     PFEGammaFilters const* pfegamma);
   void conversionAlgo(const edm::OwnVector<reco::PFBlockElement>& elements, std::vector<bool>& active);
-  void elementLoop(const reco::PFBlock& block,
+  void elementLoop(reco::PFCandidateCollection& pfCandidates,
+                   const reco::PFBlock& block,
                    reco::PFBlock::LinkData& linkData,
                    const edm::OwnVector<reco::PFBlockElement>& elements,
                    std::vector<bool>& active,
@@ -136,7 +142,8 @@ private:
                  ElementIndices& inds,
                  std::vector<bool>& deadArea,
                  unsigned int iEle);
-  bool recoTracksNotHCAL(const reco::PFBlock& block,
+  bool recoTracksNotHCAL(reco::PFCandidateCollection& pfCandidates,
+                         const reco::PFBlock& block,
                          reco::PFBlock::LinkData& linkData,
                          const edm::OwnVector<reco::PFBlockElement>& elements,
                          const reco::PFBlockRef& blockref,
@@ -148,19 +155,22 @@ private:
                          reco::TrackRef& trackRef);
 
   //Looks for a HF-associated element in the block and produces a PFCandidate from it with HF_EM and/or HF_HAD calibrations
-  void createCandidateHF(const reco::PFBlock& block,
+  void createCandidateHF(reco::PFCandidateCollection& pfCandidates,
+                         const reco::PFBlock& block,
                          const reco::PFBlockRef& blockref,
                          const edm::OwnVector<reco::PFBlockElement>& elements,
                          ElementIndices& inds);
 
-  void createCandidatesHCAL(const reco::PFBlock& block,
+  void createCandidatesHCAL(reco::PFCandidateCollection& pfCandidates,
+                            const reco::PFBlock& block,
                             reco::PFBlock::LinkData& linkData,
                             const edm::OwnVector<reco::PFBlockElement>& elements,
                             std::vector<bool>& active,
                             const reco::PFBlockRef& blockref,
                             ElementIndices& inds,
                             std::vector<bool>& deadArea);
-  void createCandidatesHCALUnlinked(const reco::PFBlock& block,
+  void createCandidatesHCALUnlinked(reco::PFCandidateCollection& pfCandidates,
+                                    const reco::PFBlock& block,
                                     reco::PFBlock::LinkData& linkData,
                                     const edm::OwnVector<reco::PFBlockElement>& elements,
                                     std::vector<bool>& active,
@@ -168,7 +178,8 @@ private:
                                     ElementIndices& inds,
                                     std::vector<bool>& deadArea);
 
-  void createCandidatesECAL(const reco::PFBlock& block,
+  void createCandidatesECAL(reco::PFCandidateCollection& pfCandidates,
+                            const reco::PFBlock& block,
                             reco::PFBlock::LinkData& linkData,
                             const edm::OwnVector<reco::PFBlockElement>& elements,
                             std::vector<bool>& active,
@@ -178,15 +189,16 @@ private:
 
   /// process one block. can be reimplemented in more sophisticated
   /// algorithms
-  void processBlock(const reco::PFBlockRef& blockref,
-                    std::list<reco::PFBlockRef>& hcalBlockRefs,
-                    std::list<reco::PFBlockRef>& ecalBlockRefs,
+  void processBlock(reco::PFCandidateCollection& pfCandidates,
+                    const reco::PFBlockRef& blockref,
                     PFEGammaFilters const* pfegamma);
 
   /// Reconstruct a charged particle from a track
-  /// Returns the index of the newly created candidate in pfCandidates_
+  /// Returns the index of the newly created candidate in pfCandidates
   /// Michalis added a flag here to treat muons inside jets
-  unsigned reconstructTrack(const reco::PFBlockElement& elt, bool allowLoose = false);
+  unsigned reconstructTrack(reco::PFCandidateCollection& pfCandidates,
+                            const reco::PFBlockElement& elt,
+                            bool allowLoose = false);
 
   /// Reconstruct a neutral particle from a cluster.
   /// If chargedEnergy is specified, the neutral
@@ -194,7 +206,8 @@ private:
   /// larger than the chargedEnergy. In this case, the energy of the
   /// neutral particle is cluster energy - chargedEnergy
 
-  unsigned reconstructCluster(const reco::PFCluster& cluster,
+  unsigned reconstructCluster(reco::PFCandidateCollection& pfCandidates,
+                              const reco::PFCluster& cluster,
                               double particleEnergy,
                               bool useDirection = false,
                               double particleX = 0.,
@@ -232,10 +245,11 @@ private:
   /// number of sigma to judge energy excess in HCAL
   const double nSigmaHCAL_;
 
-  PFEnergyCalibration& calibration_;
-  PFEnergyCalibrationHF& thepfEnergyCalibrationHF_;
+  const PFEnergyCalibration& calibration_;
+  const PFEnergyCalibrationHF& thepfEnergyCalibrationHF_;
 
   bool useHO_;
+  bool parallelBlocks_ = false;
   const bool debug_;
 
   std::unique_ptr<PFMuonAlgo> pfmu_;
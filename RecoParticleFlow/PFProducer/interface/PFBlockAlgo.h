@@ -11,6 +11,7 @@
 #include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerBase.h"
 #include "DataFormats/Common/interface/OwnVector.h"
 
+#include <array>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -35,8 +36,8 @@ class PFBlockAlgo {
 public:
   // the element list should **always** be a list of (smart) pointers
   typedef std::vector<std::unique_ptr<reco::PFBlockElement>> ElementList;
-  //for skipping ranges
-  typedef std::array<std::pair<unsigned int, unsigned int>, reco::PFBlockElement::kNBETypes> ElementRanges;
+  //first element of each type, the elements being sorted by type
+  typedef std::array<unsigned int, reco::PFBlockElement::kNBETypes + 1> ElementRanges;
 
   PFBlockAlgo();
 
@@ -58,6 +59,10 @@ public:
   /// sets debug printout flag
   void setDebug(bool debug) { debug_ = debug; }
 
+  /// test the linkers only on the pairs of elements with a common key,
+  /// see BlockElementLinkerBase::linkKeys (on by default)
+  void setUseLinkKeys(bool useLinkKeys) { useLinkKeys_ = useLinkKeys; }
+
 private:
   /// compute missing links in the blocks
   /// (the recursive procedure does not build all links)
@@ -67,6 +72,13 @@ private:
   /// check whether 2 elements are linked. Returns distance
   inline void link(const reco::PFBlockElement* el1, const reco::PFBlockElement* el2, double& dist) const;
 
+  /// fill the tables of the keys of the elements for the linkers
+  void buildLinkKeys();
+
+  /// fill the elements that can be linked to element i, using marks to
+  /// list each of them once
+  void findLinkCandidates(unsigned i, std::vector<unsigned>& marks, std::vector<unsigned>& candidates);
+
   // the test elements will be transferred to the blocks
   ElementList elements_;
   ElementRanges ranges_;
@@ -84,6 +96,18 @@ private:
   unsigned int linkTestSquare_[reco::PFBlockElement::kNBETypes][reco::PFBlockElement::kNBETypes];
 
   std::vector<std::unique_ptr<KDTreeLinkerBase>> kdtrees_;
+
+  // keys of the elements of each type, for each linker that reports them:
+  // the (key, element) pairs sorted by key, and the elements without keys,
+  // which can be linked to any element
+  struct LinkKeyTable {
+    std::vector<std::pair<size_t, unsigned>> keys;
+    std::vector<unsigned> unkeyed;
+  };
+  bool useLinkKeys_;
+  std::vector<bool> keyedLinks_;
+  std::vector<std::array<LinkKeyTable, 2>> linkKeyTables_;
+  std::vector<size_t> keys_;
 };
 
 #endif
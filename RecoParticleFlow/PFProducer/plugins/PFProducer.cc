@@ -239,6 +239,9 @@ PFProducer::PFProducer(const edm::ParameterSet& iConfig)
   useHO_ = iConfig.getParameter<bool>("useHO");
   pfAlgo_.setHOTag(useHO_);
 
+  // Process the independent blocks in parallel, with the same output
+  pfAlgo_.setParallelBlocks(iConfig.getUntrackedParameter<bool>("parallelBlocks", false));
+
   verbose_ = iConfig.getUntrackedParameter<bool>("verbose", false);
 }
 
@@ -11,6 +11,8 @@ public:
         _useKDTree(conf.getParameter<bool>("useKDTree")),
         _debug(conf.getUntrackedParameter<bool>("debug", false)) {}
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -39,3 +41,14 @@ double ECALAndBREMLinker::testLink(const reco::PFBlockElement* elem1, const reco
   }
   return dist;
 }
+
+bool ECALAndBREMLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  // the brems are only linked to the clusters with a rechit window around them
+  if (elem->type() == reco::PFBlockElement::BREM)
+    return trackByRecHitKeys(
+        static_cast<const reco::PFBlockElementBrem*>(elem)->trackPF(), true, PFLayer::ECAL_BARREL, keys);
+  const reco::PFClusterRef& clusterref = elem->clusterRef();
+  if (clusterref.isNull())
+    return false;
+  return clusterByRecHitKeys(*clusterref, keys);
+}
@@ -12,6 +12,8 @@ public:
 
   bool linkPrefilter(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -45,3 +47,11 @@ double ECALAndECALLinker::testLink(const reco::PFBlockElement* elem1, const reco
 
   return dist;
 }
+
+bool ECALAndECALLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  // the clusters are only linked to the clusters of the same supercluster
+  const reco::SuperClusterRef& sclus = static_cast<const reco::PFBlockElementCluster*>(elem)->superClusterRef();
+  if (sclus.isNonnull())
+    keys.push_back(refKey(sclus));
+  return true;
+}
@@ -12,6 +12,8 @@ public:
 
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
 private:
   bool _useKDTree, _debug;
 };
@@ -46,3 +48,13 @@ double ECALAndHCALCaloJetLinker::testLink(const reco::PFBlockElement* elem1, con
 
   return (dist < 0.2 ? dist : -1.0);
 }
+
+bool ECALAndHCALCaloJetLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  const reco::PFClusterRef& clusterref = elem->clusterRef();
+  if (clusterref.isNull())
+    return false;
+  // the ECAL clusters are linked to the HCAL clusters closer than 0.2
+  const reco::PFCluster::REPPoint& reppos = clusterref->positionREP();
+  etaPhiCellKeys(reppos.Eta(), reppos.Phi(), 0.2, elem->type() == reco::PFBlockElement::ECAL, keys);
+  return true;
+}
@@ -12,6 +12,8 @@ public:
 
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
 private:
   bool _useKDTree, _debug;
 };
@@ -40,3 +42,16 @@ double ECALAndHCALLinker::testLink(const reco::PFBlockElement* elem1, const reco
               : -1.0);
   return (dist < 0.2 ? dist : -1.0);
 }
+
+bool ECALAndHCALLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  const reco::PFClusterRef& clusterref = elem->clusterRef();
+  if (clusterref.isNull())
+    return false;
+  // the ECAL clusters beyond |eta| = 2.5 are linked to the HCAL clusters closer than 0.2
+  const reco::PFCluster::REPPoint& reppos = clusterref->positionREP();
+  if (elem->type() == reco::PFBlockElement::HCAL)
+    etaPhiCellKeys(reppos.Eta(), reppos.Phi(), 0.2, false, keys);
+  else if (std::abs(reppos.Eta()) > 2.5)
+    etaPhiCellKeys(reppos.Eta(), reppos.Phi(), 0.2, true, keys);
+  return true;
+}
@@ -11,6 +11,8 @@ public:
         _useKDTree(conf.getParameter<bool>("useKDTree")),
         _debug(conf.getUntrackedParameter<bool>("debug", false)) {}
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -37,3 +39,14 @@ double GSFAndBREMLinker::testLink(const reco::PFBlockElement* elem1, const reco:
   }
   return dist;
 }
+
+bool GSFAndBREMLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  // the brems are only linked to their GSF track
+  const reco::GsfPFRecTrackRef& gsfref =
+      (elem->type() == reco::PFBlockElement::GSF
+           ? static_cast<const reco::PFBlockElementGsfTrack*>(elem)->GsftrackRefPF()
+           : static_cast<const reco::PFBlockElementBrem*>(elem)->GsftrackRefPF());
+  if (gsfref.isNonnull())
+    keys.push_back(refKey(gsfref));
+  return true;
+}
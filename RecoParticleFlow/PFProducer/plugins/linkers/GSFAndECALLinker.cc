@@ -11,6 +11,8 @@ public:
         _useKDTree(conf.getParameter<bool>("useKDTree")),
         _debug(conf.getUntrackedParameter<bool>("debug", false)) {}
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -49,3 +51,14 @@ double GSFAndECALLinker::testLink(const reco::PFBlockElement* elem1, const reco:
 
   return dist;
 }
+
+bool GSFAndECALLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  // the GSF tracks are only linked to the clusters with a rechit window around them
+  if (elem->type() == reco::PFBlockElement::GSF)
+    return trackByRecHitKeys(
+        static_cast<const reco::PFBlockElementGsfTrack*>(elem)->GsftrackPF(), false, PFLayer::ECAL_BARREL, keys);
+  const reco::PFClusterRef& clusterref = elem->clusterRef();
+  if (clusterref.isNull())
+    return false;
+  return clusterByRecHitKeys(*clusterref, keys);
+}
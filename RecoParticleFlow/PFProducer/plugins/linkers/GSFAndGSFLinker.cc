@@ -11,6 +11,8 @@ public:
         _useKDTree(conf.getParameter<bool>("useKDTree")),
         _debug(conf.getUntrackedParameter<bool>("debug", false)) {}
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -35,3 +37,11 @@ double GSFAndGSFLinker::testLink(const reco::PFBlockElement* elem1, const reco::
   }
   return dist;
 }
+
+bool GSFAndGSFLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  // the GSF tracks are only linked to the GSF tracks of the same track id
+  const reco::GsfPFRecTrackRef& gsfref = static_cast<const reco::PFBlockElementGsfTrack*>(elem)->GsftrackRefPF();
+  if (gsfref.isNonnull())
+    keys.push_back(gsfref->trackId());
+  return true;
+}
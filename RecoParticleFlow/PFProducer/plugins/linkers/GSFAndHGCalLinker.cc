@@ -11,6 +11,8 @@ public:
         _useKDTree(conf.getParameter<bool>("useKDTree")),
         _debug(conf.getUntrackedParameter<bool>("debug", false)) {}
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -54,3 +56,20 @@ double GSFAndHGCalLinker::testLink(const reco::PFBlockElement* elem1, const reco
 
   return dist;
 }
+
+bool GSFAndHGCalLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  // the HGCal clusters are linked to the GSF tracks closer than 0.3 at the ECAL shower maximum
+  if (elem->type() == reco::PFBlockElement::GSF) {
+    const reco::PFTrajectoryPoint& tkAtECAL = static_cast<const reco::PFBlockElementGsfTrack*>(elem)
+                                                  ->GsftrackPF()
+                                                  .extrapolatedPoint(reco::PFTrajectoryPoint::ECALShowerMax);
+    if (tkAtECAL.isValid())
+      etaPhiCellKeys(tkAtECAL.positionREP().eta(), tkAtECAL.positionREP().phi(), 0.3, true, keys);
+    return true;
+  }
+  const reco::PFClusterRef& clusterref = elem->clusterRef();
+  if (clusterref.isNull())
+    return false;
+  etaPhiCellKeys(clusterref->positionREP().Eta(), clusterref->positionREP().Phi(), 0.3, false, keys);
+  return true;
+}
@@ -11,6 +11,8 @@ public:
         _useKDTree(conf.getParameter<bool>("useKDTree")),
         _debug(conf.getUntrackedParameter<bool>("debug", false)) {}
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -39,3 +41,8 @@ double HCALAndBREMLinker::testLink(const reco::PFBlockElement* elem1, const reco
   }
   return dist;
 }
+
+bool HCALAndBREMLinker::linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const {
+  // testTrackAndClusterByRecHit does not link the brems to the HCAL clusters
+  return true;
+}
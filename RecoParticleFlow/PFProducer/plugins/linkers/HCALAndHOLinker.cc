@@ -12,6 +12,8 @@ public:
 
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
 private:
   bool _useKDTree, _debug;
 };
@@ -40,3 +42,16 @@ double HCALAndHOLinker::testLink(const reco::PFBlockElement* elem1, const reco::
               : -1.0);
   return (dist < 0.2 ? dist : -1.0);
 }
+
+bool HCALAndHOLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  const reco::PFClusterRef& clusterref = elem->clusterRef();
+  if (clusterref.isNull())
+    return false;
+  // the HCAL clusters within |eta| = 1.5 are linked to the HO clusters closer than 0.2
+  const reco::PFCluster::REPPoint& reppos = clusterref->positionREP();
+  if (elem->type() == reco::PFBlockElement::HO)
+    etaPhiCellKeys(reppos.Eta(), reppos.Phi(), 0.2, false, keys);
+  else if (std::abs(reppos.Eta()) < 1.5)
+    etaPhiCellKeys(reppos.Eta(), reppos.Phi(), 0.2, true, keys);
+  return true;
+}
@@ -10,6 +10,8 @@ public:
         _useKDTree(conf.getParameter<bool>("useKDTree")),
         _debug(conf.getUntrackedParameter<bool>("debug", false)) {}
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -34,3 +36,13 @@ double HFEMAndHFHADLinker::testLink(const reco::PFBlockElement* elem1, const rec
   }
   return LinkByRecHit::testHFEMAndHFHADByRecHit(*hfemref, *hfhadref, _debug);
 }
+
+bool HFEMAndHFHADLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  const reco::PFClusterRef& clusterref = elem->clusterRef();
+  if (clusterref.isNull())
+    return false;
+  // the HFHAD clusters are linked to the HFEM clusters closer than sqrt(0.1) cm in (x, y)
+  const auto& posxyz = clusterref->position();
+  const double dxy = elem->type() == reco::PFBlockElement::HFEM ? 0.32 : 0.;
+  return xyWindowKeys(posxyz.X() - dxy, posxyz.X() + dxy, posxyz.Y() - dxy, posxyz.Y() + dxy, posxyz.Z(), 1., keys);
+}
@@ -12,6 +12,8 @@ public:
 
   bool linkPrefilter(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -77,3 +79,19 @@ double PreshowerAndECALLinker::testLink(const reco::PFBlockElement* elem1, const
   }
   return dist;
 }
+
+bool PreshowerAndECALLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  if (!_useKDTree)
+    return false;
+  // the preshower clusters are only linked to the ECAL clusters at the positions found by the KD-tree
+  if (elem->type() == reco::PFBlockElement::ECAL) {
+    const reco::PFClusterRef& clusterref = elem->clusterRef();
+    if (clusterref.isNull())
+      return false;
+    keys.push_back(positionKey(clusterref->positionREP().Phi(), clusterref->positionREP().Eta()));
+  } else if (elem->isMultilinksValide()) {
+    for (const auto& link : elem->getMultilinks())
+      keys.push_back(positionKey(link.first, link.second));
+  }
+  return true;
+}
@@ -13,6 +13,8 @@ public:
         _debug(conf.getUntrackedParameter<bool>("debug", false)),
         _superClusterMatchByRef(conf.getParameter<bool>("SuperClusterMatchByRef")) {}
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -50,3 +52,20 @@ double SCAndHGCalLinker::testLink(const reco::PFBlockElement* elem1, const reco:
 
   return dist;
 }
+
+bool SCAndHGCalLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  if (!_superClusterMatchByRef)
+    return false;
+  // the clusters are only linked to the superclusters they belong to
+  if (elem->type() == reco::PFBlockElement::SC) {
+    const reco::SuperClusterRef& sclus = static_cast<const reco::PFBlockElementSuperCluster*>(elem)->superClusterRef();
+    if (sclus.isNull())
+      return false;
+    keys.push_back(refKey(sclus));
+  } else {
+    const reco::SuperClusterRef& sclus = static_cast<const reco::PFBlockElementCluster*>(elem)->superClusterRef();
+    if (sclus.isNonnull())
+      keys.push_back(refKey(sclus));
+  }
+  return true;
+}
@@ -13,6 +13,8 @@ public:
 
   bool linkPrefilter(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -85,3 +87,21 @@ double TrackAndECALLinker::testLink(const reco::PFBlockElement* elem1, const rec
   }
   return dist;
 }
+
+bool TrackAndECALLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  if (!_useKDTree)
+    return false;
+  // the tracks are only linked to the ECAL clusters at the positions found by the KD-tree
+  if (elem->type() == reco::PFBlockElement::TRACK) {
+    if (elem->isMultilinksValide()) {
+      for (const auto& link : elem->getMultilinks())
+        keys.push_back(positionKey(link.first, link.second));
+    }
+  } else {
+    const reco::PFClusterRef& clusterref = elem->clusterRef();
+    if (clusterref.isNull())
+      return false;
+    keys.push_back(positionKey(clusterref->positionREP().Phi(), clusterref->positionREP().Eta()));
+  }
+  return true;
+}
@@ -12,6 +12,8 @@ public:
         _useConvertedBrems(conf.getParameter<bool>("useConvertedBrems")),
         _debug(conf.getUntrackedParameter<bool>("debug", false)) {}
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -63,3 +65,26 @@ double TrackAndGSFLinker::testLink(const reco::PFBlockElement* elem1, const reco
   }
   return dist;
 }
+
+bool TrackAndGSFLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  // the GSF tracks are only linked to the track they were seeded from and
+  // to the tracks of their converted brems
+  if (elem->type() == reco::PFBlockElement::TRACK) {
+    const reco::PFRecTrackRef& trackref = static_cast<const reco::PFBlockElementTrack*>(elem)->trackRefPF();
+    if (trackref.isNull())
+      return false;
+    keys.push_back(refKey(trackref->trackRef()));
+  } else {
+    const reco::GsfPFRecTrackRef& gsfref = static_cast<const reco::PFBlockElementGsfTrack*>(elem)->GsftrackRefPF();
+    if (gsfref.isNull())
+      return false;
+    const reco::PFRecTrackRef& refkf = gsfref->kfPFRecTrackRef();
+    if (refkf.isNonnull())
+      keys.push_back(refKey(refkf->trackRef()));
+    if (_useConvertedBrems) {
+      for (const auto& convbrem : gsfref->convBremPFRecTrackRef())
+        keys.push_back(refKey(convbrem->trackRef()));
+    }
+  }
+  return true;
+}
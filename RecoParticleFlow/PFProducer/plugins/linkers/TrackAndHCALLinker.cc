@@ -13,6 +13,8 @@ public:
         _useKDTree(conf.getParameter<bool>("useKDTree")),
         _debug(conf.getUntrackedParameter<bool>("debug", false)) {}
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -75,3 +77,22 @@ double TrackAndHCALLinker::testLink(const reco::PFBlockElement* elem1, const rec
   }
   return dist;
 }
+
+bool TrackAndHCALLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  if (!_useKDTree)
+    return false;
+  // the HCAL clusters are only linked to the tracks at the positions found by the KD-tree
+  if (elem->type() == reco::PFBlockElement::TRACK) {
+    const reco::PFRecTrackRef& trackref = elem->trackRefPF();
+    if (trackref.isNull())
+      return false;
+    const reco::PFTrajectoryPoint& tkAtHCALEnt = trackref->extrapolatedPoint(reco::PFTrajectoryPoint::HCALEntrance);
+    keys.push_back(positionKey(tkAtHCALEnt.positionREP().Phi(), tkAtHCALEnt.positionREP().Eta()));
+  } else {
+    if (!elem->isMultilinksValide())
+      return false;
+    for (const auto& link : elem->getMultilinks())
+      keys.push_back(positionKey(link.first, link.second));
+  }
+  return true;
+}
@@ -11,6 +11,8 @@ public:
         _useKDTree(conf.getParameter<bool>("useKDTree")),
         _debug(conf.getUntrackedParameter<bool>("debug", false)) {}
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -43,3 +45,19 @@ double TrackAndHOLinker::testLink(const reco::PFBlockElement* elem1, const reco:
   }
   return dist;
 }
+
+bool TrackAndHOLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  // the tracks are only linked to the clusters with a rechit window around them
+  if (elem->type() == reco::PFBlockElement::TRACK) {
+    const reco::PFRecTrackRef& tkref = elem->trackRefPF();
+    if (tkref.isNull())
+      return false;
+    if (!(elem->trackRef()->pt() > 3.00001))
+      return true;
+    return trackByRecHitKeys(*tkref, false, PFLayer::HCAL_BARREL2, keys);
+  }
+  const reco::PFClusterRef& horef = elem->clusterRef();
+  if (horef.isNull())
+    return false;
+  return clusterByRecHitKeys(*horef, keys);
+}
@@ -13,6 +13,8 @@ public:
 
   bool linkPrefilter(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
+  bool linkKeys(const reco::PFBlockElement*, std::vector<size_t>&) const override;
+
   double testLink(const reco::PFBlockElement*, const reco::PFBlockElement*) const override;
 
 private:
@@ -72,3 +74,22 @@ double TrackAndTrackLinker::testLink(const reco::PFBlockElement* elem1, const re
 
   return dist;
 }
+
+bool TrackAndTrackLinker::linkKeys(const reco::PFBlockElement* elem, std::vector<size_t>& keys) const {
+  // the tracks are only linked to the tracks of the same displaced vertex,
+  // conversion or V0
+  for (const auto trackType : {reco::PFBlockElement::T_TO_DISP, reco::PFBlockElement::T_FROM_DISP}) {
+    const reco::PFDisplacedTrackerVertexRef& ni = elem->displacedVertexRef(trackType);
+    if (ni.isNonnull())
+      keys.push_back(refKey(ni));
+  }
+  if (elem->trackType(reco::PFBlockElement::T_FROM_GAMMACONV)) {
+    for (const auto& conv : elem->convRefs()) {
+      if (conv.isNonnull())
+        keys.push_back(refKey(conv));
+    }
+  }
+  if (elem->trackType(reco::PFBlockElement::T_FROM_V0) && elem->V0Ref().isNonnull())
+    keys.push_back(refKey(elem->V0Ref()));
+  return true;
+}
@@ -20,6 +20,9 @@ particleFlowTmp = cms.EDProducer("PFProducer",
     verbose = cms.untracked.bool(False),
     debug = cms.untracked.bool(False),
 
+    # Process the blocks in parallel (same output as the serial loop)
+    parallelBlocks = cms.untracked.bool(False),
+
     # Use HO clusters in PF hadron reconstruction
     useHO = cms.bool(True),                                 
 
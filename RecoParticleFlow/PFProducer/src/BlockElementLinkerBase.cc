@@ -0,0 +1,218 @@
+#include "RecoParticleFlow/PFProducer/interface/BlockElementLinkerBase.h"
+#include "DataFormats/Math/interface/deltaPhi.h"
+#include "DataFormats/ParticleFlowReco/interface/PFCluster.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecHit.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecTrack.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // an element with a window wider than this number of cells is left unkeyed
+  constexpr double maxWindowCells = 64.;
+  // cells of the rechit windows: (eta, phi) cells in the ECAL barrel and in
+  // the HCAL, (x, y) cells of 10 cm in the ECAL endcaps
+  constexpr double ecalCellSize = 0.1;
+  constexpr double hcalCellSize = 0.2;
+  constexpr double ecalEndcapCellSize = 10.;
+  // the rechit windows bound the tracks above this pt at the vertex, and the
+  // tracks of which eta and phi change by less than this in the HCAL
+  constexpr double minKeyedTrackPt = 2.;
+  constexpr double maxHCALCrossing = 0.5;
+  // margins of the rechit windows against the rounding
+  constexpr double etaPhiMargin = 1.e-3;
+  constexpr double xyMargin = 0.1;
+  // to tell the (x, y) cells from the (eta, phi) cells
+  constexpr size_t xyKeyTag = 0x5859;
+
+  // first and last cells of size cellSize of [min, max], false if there are
+  // too many of them (or if min or max is not a number)
+  bool cellRange(double min, double max, double cellSize, long long& first, long long& last) {
+    const double firstCell = std::floor(min / cellSize);
+    const double lastCell = std::floor(max / cellSize);
+    if (!(lastCell - firstCell < maxWindowCells && std::abs(firstCell) < 1.e9 && std::abs(lastCell) < 1.e9))
+      return false;
+    first = firstCell;
+    last = lastCell;
+    return true;
+  }
+}  // namespace
+
+void BlockElementLinkerBase::etaPhiCellKeys(
+    double eta, double phi, double cellSize, bool withNeighbours, std::vector<size_t>& keys) {
+  // slightly wider cells, so that rounding cannot move close positions
+  // further than to the neighbouring cells
+  const double etaCellSize = 1.01 * cellSize;
+  const int nPhiCells = std::max(1, int(2. * M_PI / etaCellSize));
+  const int etaBin = int(std::floor(eta / etaCellSize));
+  const int phiBin = int(std::floor((phi + M_PI) * nPhiCells / (2. * M_PI)));
+  const int range = withNeighbours ? 1 : 0;
+  for (int ieta = etaBin - range; ieta <= etaBin + range; ++ieta) {
+    for (int iphi = phiBin - range; iphi <= phiBin + range; ++iphi) {
+      keys.push_back(combineKeys(ieta, ((iphi % nPhiCells) + nPhiCells) % nPhiCells));
+    }
+  }
+}
+
+bool BlockElementLinkerBase::etaPhiWindowKeys(
+    double etaMin, double etaMax, double phiMin, double phiMax, double cellSize, std::vector<size_t>& keys) {
+  const long long nPhiCells = std::max(1, int(2. * M_PI / cellSize));
+  const double phiCellSize = 2. * M_PI / nPhiCells;
+  long long etaFirst, etaLast, phiFirst, phiLast;
+  if (!cellRange(etaMin, etaMax, cellSize, etaFirst, etaLast) ||
+      !cellRange(phiMin + M_PI, std::min(phiMax, phiMin + 2. * M_PI) + M_PI, phiCellSize, phiFirst, phiLast))
+    return false;
+  // a window around the whole circle covers each phi cell once
+  phiLast = std::min(phiLast, phiFirst + nPhiCells - 1);
+  for (long long ieta = etaFirst; ieta <= etaLast; ++ieta) {
+    for (long long iphi = phiFirst; iphi <= phiLast; ++iphi) {
+      keys.push_back(combineKeys(ieta, ((iphi % nPhiCells) + nPhiCells) % nPhiCells));
+    }
+  }
+  return true;
+}
+
+bool BlockElementLinkerBase::xyWindowKeys(
+    double xMin, double xMax, double yMin, double yMax, double z, double cellSize, std::vector<size_t>& keys) {
+  long long xFirst, xLast, yFirst, yLast;
+  if (!cellRange(xMin, xMax, cellSize, xFirst, xLast) || !cellRange(yMin, yMax, cellSize, yFirst, yLast))
+    return false;
+  for (size_t side = 0; side < 2; ++side) {
+    if ((side == 0 && z > 0.) || (side == 1 && z < 0.))
+      continue;
+    for (long long ix = xFirst; ix <= xLast; ++ix) {
+      for (long long iy = yFirst; iy <= yLast; ++iy) {
+        keys.push_back(combineKeys(combineKeys(combineKeys(xyKeyTag, side), ix), iy));
+      }
+    }
+  }
+  return true;
+}
+
+bool BlockElementLinkerBase::clusterByRecHitKeys(const reco::PFCluster& cluster, std::vector<size_t>& keys) {
+  // half-sizes of the windows of testTrackAndClusterByRecHit in units of the
+  // rechit size, with the largest blow-up of the keyed tracks: up to 3 times
+  // the rechit size in the ECAL barrel, up to 2.5 times the distance of the
+  // corners to the centre in the ECAL endcaps, up to twice the rechit size
+  // (times 1.15 in the HO) and 0.2 times the crossing of the HCAL in the HCAL
+  bool xy = false;
+  double scale = 1.5, crossing = 0., cellSize = ecalCellSize;
+  switch (cluster.layer()) {
+    case PFLayer::ECAL_BARREL:
+      break;
+    case PFLayer::ECAL_ENDCAP:
+      xy = true;
+      scale = 2.5;
+      cellSize = ecalEndcapCellSize;
+      break;
+    case PFLayer::HCAL_BARREL1:
+    case PFLayer::HCAL_ENDCAP:
+      scale = 1.;
+      crossing = 0.1 * maxHCALCrossing;
+      cellSize = hcalCellSize;
+      break;
+    case PFLayer::HCAL_BARREL2:
+      scale = 1.15;
+      cellSize = hcalCellSize;
+      break;
+    default:
+      // the other clusters are not linked by rechit
+      return true;
+  }
+  const size_t first = keys.size();
+  for (const auto& fraction : cluster.recHitFractions()) {
+    const reco::PFRecHitRef& rh = fraction.recHitRef();
+    if (fraction.fraction() < 1E-4 || rh.isNull())
+      continue;
+    bool keyed = false;
+    if (xy) {
+      const auto& posxyz = rh->position();
+      const auto& cornersxyz = rh->getCornersXYZ();
+      double dx = 0., dy = 0.;
+      for (unsigned jc = 0; jc < 4; ++jc) {
+        dx = std::max(dx, std::abs(cornersxyz[jc].x() - posxyz.x()));
+        dy = std::max(dy, std::abs(cornersxyz[jc].y() - posxyz.y()));
+      }
+      dx = scale * dx + xyMargin;
+      dy = scale * dy + xyMargin;
+      keyed = xyWindowKeys(posxyz.x() - dx,
+                           posxyz.x() + dx,
+                           posxyz.y() - dy,
+                           posxyz.y() + dy,
+                           cluster.position().Z(),
+                           cellSize,
+                           keys);
+    } else {
+      const auto& posrep = rh->positionREP();
+      const auto& corners = rh->getCornersREP();
+      double rhsizeEta = std::abs(corners[3].eta() - corners[1].eta());
+      double rhsizePhi = std::abs(corners[3].phi() - corners[1].phi());
+      if (rhsizePhi > M_PI)
+        rhsizePhi = 2. * M_PI - rhsizePhi;
+      const double dEta = scale * rhsizeEta + crossing + etaPhiMargin;
+      const double dPhi = scale * rhsizePhi + crossing + etaPhiMargin;
+      keyed = etaPhiWindowKeys(
+          posrep.eta() - dEta, posrep.eta() + dEta, posrep.phi() - dPhi, posrep.phi() + dPhi, cellSize, keys);
+    }
+    if (!keyed)
+      return false;
+  }
+  std::sort(keys.begin() + first, keys.end());
+  keys.erase(std::unique(keys.begin() + first, keys.end()), keys.end());
+  return true;
+}
+
+bool BlockElementLinkerBase::trackByRecHitKeys(const reco::PFRecTrack& track,
+                                               bool isBrem,
+                                               PFLayer::Layer calo,
+                                               std::vector<size_t>& keys) {
+  switch (calo) {
+    case PFLayer::ECAL_BARREL:
+    case PFLayer::ECAL_ENDCAP: {
+      const reco::PFTrajectoryPoint& atECAL = track.extrapolatedPoint(reco::PFTrajectoryPoint::ECALShowerMax);
+      if (!atECAL.isValid())
+        return true;
+      if (!isBrem) {
+        // the windows of the softer tracks are larger
+        const reco::PFTrajectoryPoint& atVertex = track.extrapolatedPoint(reco::PFTrajectoryPoint::ClosestApproach);
+        if (!(std::sqrt(atVertex.momentum().Vect().Perp2()) >= minKeyedTrackPt))
+          return false;
+      }
+      // the barrel clusters are matched in (eta, phi), the endcap ones in (x, y)
+      const double eta = atECAL.positionREP().Eta();
+      const double phi = atECAL.positionREP().Phi();
+      const auto& pos = atECAL.position();
+      return etaPhiWindowKeys(eta, eta, phi, phi, ecalCellSize, keys) &&
+             xyWindowKeys(pos.X(), pos.X(), pos.Y(), pos.Y(), pos.Z(), ecalEndcapCellSize, keys);
+    }
+    case PFLayer::HCAL_BARREL1:
+    case PFLayer::HCAL_ENDCAP: {
+      // the brems are not linked to the HCAL
+      if (isBrem)
+        return true;
+      const reco::PFTrajectoryPoint& atHCAL = track.extrapolatedPoint(reco::PFTrajectoryPoint::HCALEntrance);
+      const reco::PFTrajectoryPoint& atHCALExit = track.extrapolatedPoint(reco::PFTrajectoryPoint::HCALExit);
+      if (!atHCAL.isValid())
+        return true;
+      const double dHEta = atHCALExit.positionREP().Eta() - atHCAL.positionREP().Eta();
+      const double dHPhi = reco::deltaPhi(atHCALExit.positionREP().Phi(), atHCAL.positionREP().Phi());
+      if (!(std::abs(dHEta) <= maxHCALCrossing && std::abs(dHPhi) <= maxHCALCrossing))
+        return false;
+      const double eta = atHCAL.positionREP().Eta() + 0.1 * dHEta;
+      const double phi = atHCAL.positionREP().Phi() + 0.1 * dHPhi;
+      return etaPhiWindowKeys(eta, eta, phi, phi, hcalCellSize, keys);
+    }
+    case PFLayer::HCAL_BARREL2: {
+      if (isBrem)
+        return true;
+      const reco::PFTrajectoryPoint& atHO = track.extrapolatedPoint(reco::PFTrajectoryPoint::HOLayer);
+      if (!atHO.isValid())
+        return true;
+      const double eta = atHO.positionREP().Eta();
+      const double phi = atHO.positionREP().Phi();
+      return etaPhiWindowKeys(eta, eta, phi, phi, hcalCellSize, keys);
+    }
+    default:
+      return false;
+  }
+}
@@ -6,6 +6,10 @@
 
 #include "TDecompChol.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+
+#include <iterator>
 #include <numeric>
 
 using namespace std;
@@ -13,8 +17,8 @@ using namespace reco;
 
 PFAlgo::PFAlgo(double nSigmaECAL,
                double nSigmaHCAL,
-               PFEnergyCalibration& calibration,
-               PFEnergyCalibrationHF& thepfEnergyCalibrationHF,
+               const PFEnergyCalibration& calibration,
+               const PFEnergyCalibrationHF& thepfEnergyCalibrationHF,
                const edm::ParameterSet& pset,
                bool debug)
     : pfCandidates_(new PFCandidateCollection),
@@ -179,29 +183,58 @@ void PFAlgo::reconstructParticles(const reco::PFBlockHandle& blockHandle, PFEGam
   // loop on blocks that are not single ecal,
   // and not single hcal.
 
-  unsigned nblcks = 0;
-  for (auto const& other : otherBlockRefs) {
-    if (debug_)
-      std::cout << "Block number " << nblcks++ << std::endl;
-    processBlock(other, hcalBlockRefs, ecalBlockRefs, pfegamma);
-  }
-
-  std::list<reco::PFBlockRef> empty;
+  if (parallelBlocks_ && !debug_) {
+    // The blocks are independent: each one fills its own candidates, which
+    // are then appended in the same order as in the serial loops below.
+    // The calibrations are shared by the tasks and only used through their
+    // const member functions: the TF1 of PFEnergyCalibration are built with
+    // their parameters in its constructor and only evaluated afterwards, and
+    // the TFormula of the payload are evaluated concurrently by all the
+    // streams already. test/comparePFCandidateOrder_cfg.py checks that the
+    // candidates are the same as with the serial loop.
+    std::vector<reco::PFBlockRef> blockRefs;
+    blockRefs.reserve(blocks.size());
+    blockRefs.insert(blockRefs.end(), otherBlockRefs.begin(), otherBlockRefs.end());
+    blockRefs.insert(blockRefs.end(), hcalBlockRefs.begin(), hcalBlockRefs.end());
+    blockRefs.insert(blockRefs.end(), ecalBlockRefs.begin(), ecalBlockRefs.end());
+
+    std::vector<reco::PFCandidateCollection> blockCandidates(blockRefs.size());
+    tbb::this_task_arena::isolate([&] {
+      tbb::parallel_for(std::size_t(0), blockRefs.size(), [&](std::size_t i) {
+        processBlock(blockCandidates[i], blockRefs[i], pfegamma);
+      });
+    });
+
+    std::size_t nCandidates = 0;
+    for (auto const& candidates : blockCandidates)
+      nCandidates += candidates.size();
+    pfCandidates_->reserve(nCandidates);
+    for (auto& candidates : blockCandidates) {
+      std::move(candidates.begin(), candidates.end(), std::back_inserter(*pfCandidates_));
+    }
+  } else {
+    unsigned nblcks = 0;
+    for (auto const& other : otherBlockRefs) {
+      if (debug_)
+        std::cout << "Block number " << nblcks++ << std::endl;
+      processBlock(*pfCandidates_, other, pfegamma);
+    }
 
-  unsigned hblcks = 0;
-  // process remaining single hcal blocks
-  for (auto const& hcal : hcalBlockRefs) {
-    if (debug_)
-      std::cout << "HCAL block number " << hblcks++ << std::endl;
-    processBlock(hcal, empty, empty, pfegamma);
-  }
+    unsigned hblcks = 0;
+    // process remaining single hcal blocks
+    for (auto const& hcal : hcalBlockRefs) {
+      if (debug_)
+        std::cout << "HCAL block number " << hblcks++ << std::endl;
+      processBlock(*pfCandidates_, hcal, pfegamma);
+    }
 
-  unsigned eblcks = 0;
-  // process remaining single ecal blocks
-  for (auto const& ecal : ecalBlockRefs) {
-    if (debug_)
-      std::cout << "ECAL block number " << eblcks++ << std::endl;
-    processBlock(ecal, empty, empty, pfegamma);
+    unsigned eblcks = 0;
+    // process remaining single ecal blocks
+    for (auto const& ecal : ecalBlockRefs) {
+      if (debug_)
+        std::cout << "ECAL block number " << eblcks++ << std::endl;
+      processBlock(*pfCandidates_, ecal, pfegamma);
+    }
   }
 
   // Post HF Cleaning
@@ -219,7 +252,8 @@ void PFAlgo::reconstructParticles(const reco::PFBlockHandle& blockHandle, PFEGam
     pfmu_->addMissingMuons(muonHandle_, pfCandidates_.get());
 }
 
-void PFAlgo::egammaFilters(const reco::PFBlockRef& blockref,
+void PFAlgo::egammaFilters(reco::PFCandidateCollection& pfCandidates,
+                           const reco::PFBlockRef& blockref,
                            std::vector<bool>& active,
                            PFEGammaFilters const* pfegamma) {
   // const edm::ValueMap<reco::GsfElectronRef> & myGedElectronValMap(*valueMapGedElectrons_);
@@ -326,7 +360,7 @@ void PFAlgo::egammaFilters(const reco::PFBlockRef& blockref,
           }
         }
 
-        pfCandidates_->push_back(myPFElectron);
+        pfCandidates.push_back(myPFElectron);
 
       } else {
         if (egmLocalDebug)
@@ -363,7 +397,7 @@ void PFAlgo::egammaFilters(const reco::PFBlockRef& blockref,
           if (egmLocalBlockDebug || (debug_ && egmLocalDebug))
             cout << " Elements used " << eb.second << endl;
         }
-        pfCandidates_->push_back(myPFPhoton);
+        pfCandidates.push_back(myPFPhoton);
 
       }  // end isSafe
     }    // end isGoodPhoton
@@ -387,7 +421,8 @@ void PFAlgo::conversionAlgo(const edm::OwnVector<reco::PFBlockElement>& elements
   }
 }
 
-bool PFAlgo::recoTracksNotHCAL(const reco::PFBlock& block,
+bool PFAlgo::recoTracksNotHCAL(reco::PFCandidateCollection& pfCandidates,
+                               const reco::PFBlock& block,
                                reco::PFBlock::LinkData& linkData,
                                const edm::OwnVector<reco::PFBlockElement>& elements,
                                const reco::PFBlockRef& blockref,
@@ -489,19 +524,19 @@ bool PFAlgo::recoTracksNotHCAL(const reco::PFBlock& block,
     return true;
   }
 
-  tmpi.push_back(reconstructTrack(elements[iTrack]));
+  tmpi.push_back(reconstructTrack(pfCandidates, elements[iTrack]));
 
   kTrack.push_back(iTrack);
   active[iTrack] = false;
 
   // No ECAL cluster either ... continue...
   if (ecalElems.empty()) {
-    (*pfCandidates_)[tmpi[0]].setEcalEnergy(0., 0.);
-    (*pfCandidates_)[tmpi[0]].setHcalEnergy(0., 0.);
-    (*pfCandidates_)[tmpi[0]].setHoEnergy(0., 0.);
-    (*pfCandidates_)[tmpi[0]].setPs1Energy(0);
-    (*pfCandidates_)[tmpi[0]].setPs2Energy(0);
-    (*pfCandidates_)[tmpi[0]].addElementInBlock(blockref, kTrack[0]);
+    pfCandidates[tmpi[0]].setEcalEnergy(0., 0.);
+    pfCandidates[tmpi[0]].setHcalEnergy(0., 0.);
+    pfCandidates[tmpi[0]].setHoEnergy(0., 0.);
+    pfCandidates[tmpi[0]].setPs1Energy(0);
+    pfCandidates[tmpi[0]].setPs2Energy(0);
+    pfCandidates[tmpi[0]].addElementInBlock(blockref, kTrack[0]);
     return true;
   }
 
@@ -513,12 +548,12 @@ bool PFAlgo::recoTracksNotHCAL(const reco::PFBlock& block,
 
   // Set ECAL energy for muons
   if (thisIsAMuon) {
-    (*pfCandidates_)[tmpi[0]].setEcalEnergy(clusterRef->energy(), std::min(clusterRef->energy(), muonECAL_[0]));
-    (*pfCandidates_)[tmpi[0]].setHcalEnergy(0., 0.);
-    (*pfCandidates_)[tmpi[0]].setHoEnergy(0., 0.);
-    (*pfCandidates_)[tmpi[0]].setPs1Energy(0);
-    (*pfCandidates_)[tmpi[0]].setPs2Energy(0);
-    (*pfCandidates_)[tmpi[0]].addElementInBlock(blockref, kTrack[0]);
+    pfCandidates[tmpi[0]].setEcalEnergy(clusterRef->energy(), std::min(clusterRef->energy(), muonECAL_[0]));
+    pfCandidates[tmpi[0]].setHcalEnergy(0., 0.);
+    pfCandidates[tmpi[0]].setHoEnergy(0., 0.);
+    pfCandidates[tmpi[0]].setPs1Energy(0);
+    pfCandidates[tmpi[0]].setPs2Energy(0);
+    pfCandidates[tmpi[0]].addElementInBlock(blockref, kTrack[0]);
   }
 
   double slopeEcal = 1.;
@@ -544,12 +579,12 @@ bool PFAlgo::recoTracksNotHCAL(const reco::PFBlock& block,
       if (debug_)
         cout << " the closest track to ECAL " << thisEcal << " is " << sortedTracks.begin()->second
              << " which is not the one being processed. Will skip ECAL linking for this track" << endl;
-      (*pfCandidates_)[tmpi[0]].setEcalEnergy(0., 0.);
-      (*pfCandidates_)[tmpi[0]].setHcalEnergy(0., 0.);
-      (*pfCandidates_)[tmpi[0]].setHoEnergy(0., 0.);
-      (*pfCandidates_)[tmpi[0]].setPs1Energy(0);
-      (*pfCandidates_)[tmpi[0]].setPs2Energy(0);
-      (*pfCandidates_)[tmpi[0]].addElementInBlock(blockref, kTrack[0]);
+      pfCandidates[tmpi[0]].setEcalEnergy(0., 0.);
+      pfCandidates[tmpi[0]].setHcalEnergy(0., 0.);
+      pfCandidates[tmpi[0]].setHoEnergy(0., 0.);
+      pfCandidates[tmpi[0]].setPs1Energy(0);
+      pfCandidates[tmpi[0]].setPs2Energy(0);
+      pfCandidates[tmpi[0]].addElementInBlock(blockref, kTrack[0]);
       return true;
     } else {
       if (debug_)
@@ -633,18 +668,18 @@ bool PFAlgo::recoTracksNotHCAL(const reco::PFBlock& block,
 
     // And create a charged particle candidate !
 
-    tmpi.push_back(reconstructTrack(elements[jTrack]));
+    tmpi.push_back(reconstructTrack(pfCandidates, elements[jTrack]));
 
     kTrack.push_back(jTrack);
     active[jTrack] = false;
 
     if (thatIsAMuon) {
-      (*pfCandidates_)[tmpi.back()].setEcalEnergy(clusterRef->energy(), std::min(clusterRef->energy(), muonECAL_[0]));
-      (*pfCandidates_)[tmpi.back()].setHcalEnergy(0., 0.);
-      (*pfCandidates_)[tmpi.back()].setHoEnergy(0., 0.);
-      (*pfCandidates_)[tmpi.back()].setPs1Energy(0);
-      (*pfCandidates_)[tmpi.back()].setPs2Energy(0);
-      (*pfCandidates_)[tmpi.back()].addElementInBlock(blockref, kTrack.back());
+      pfCandidates[tmpi.back()].setEcalEnergy(clusterRef->energy(), std::min(clusterRef->energy(), muonECAL_[0]));
+      pfCandidates[tmpi.back()].setHcalEnergy(0., 0.);
+      pfCandidates[tmpi.back()].setHoEnergy(0., 0.);
+      pfCandidates[tmpi.back()].setPs1Energy(0);
+      pfCandidates[tmpi.back()].setPs2Energy(0);
+      pfCandidates[tmpi.back()].addElementInBlock(blockref, kTrack.back());
     }
   }
 
@@ -737,8 +772,8 @@ bool PFAlgo::recoTracksNotHCAL(const reco::PFBlock& block,
       std::multimap<double, unsigned> assTracks;
       block.associatedElements(index, linkData, assTracks, reco::PFBlockElement::TRACK, reco::PFBlock::LINKTEST_ALL);
 
-      auto& ecalCand = (*pfCandidates_)[reconstructCluster(
-          *clusterRef, ecalEnergyCalibrated)];  // KH: use the PF ECAL cluster calibrated energy
+      auto& ecalCand = pfCandidates[reconstructCluster(
+          pfCandidates, *clusterRef, ecalEnergyCalibrated)];  // KH: use the PF ECAL cluster calibrated energy
       ecalCand.setEcalEnergy(clusterRef->energy(), ecalEnergyCalibrated);
       ecalCand.setHcalEnergy(0., 0.);
       ecalCand.setHoEnergy(0., 0.);
@@ -763,7 +798,7 @@ bool PFAlgo::recoTracksNotHCAL(const reco::PFBlock& block,
     iEcal = index;
     active[index] = false;
     for (unsigned ic : tmpi)
-      (*pfCandidates_)[ic].addElementInBlock(blockref, iEcal);
+      pfCandidates[ic].addElementInBlock(blockref, iEcal);
 
   }  // Loop ecal elements
 
@@ -813,55 +848,56 @@ bool PFAlgo::recoTracksNotHCAL(const reco::PFBlock& block,
     resol *= trackMomentum;
     if (neutralEnergy > std::max(0.5, nSigmaECAL_ * resol)) {
       neutralEnergy /= slopeEcal;
-      unsigned tmpj = reconstructCluster(*pivotalRef, neutralEnergy);
-      (*pfCandidates_)[tmpj].setEcalEnergy(pivotalRef->energy(), neutralEnergy);
-      (*pfCandidates_)[tmpj].setHcalEnergy(0., 0.);
-      (*pfCandidates_)[tmpj].setHoEnergy(0., 0.);
-      (*pfCandidates_)[tmpj].setPs1Energy(0.);
-      (*pfCandidates_)[tmpj].setPs2Energy(0.);
-      (*pfCandidates_)[tmpj].addElementInBlock(blockref, iEcal);
+      unsigned tmpj = reconstructCluster(pfCandidates, *pivotalRef, neutralEnergy);
+      pfCandidates[tmpj].setEcalEnergy(pivotalRef->energy(), neutralEnergy);
+      pfCandidates[tmpj].setHcalEnergy(0., 0.);
+      pfCandidates[tmpj].setHoEnergy(0., 0.);
+      pfCandidates[tmpj].setPs1Energy(0.);
+      pfCandidates[tmpj].setPs2Energy(0.);
+      pfCandidates[tmpj].addElementInBlock(blockref, iEcal);
       bNeutralProduced = true;
       for (unsigned ic = 0; ic < kTrack.size(); ++ic)
-        (*pfCandidates_)[tmpj].addElementInBlock(blockref, kTrack[ic]);
+        pfCandidates[tmpj].addElementInBlock(blockref, kTrack[ic]);
     }  // End neutral energy
 
     // Set elements in blocks and ECAL energies to all tracks
     for (unsigned ic = 0; ic < tmpi.size(); ++ic) {
       // Skip muons
-      if ((*pfCandidates_)[tmpi[ic]].particleId() == reco::PFCandidate::mu)
+      if (pfCandidates[tmpi[ic]].particleId() == reco::PFCandidate::mu)
         continue;
 
-      double fraction = trackMomentum > 0 ? (*pfCandidates_)[tmpi[ic]].trackRef()->p() / trackMomentum : 0;
+      double fraction = trackMomentum > 0 ? pfCandidates[tmpi[ic]].trackRef()->p() / trackMomentum : 0;
       double ecalCal = bNeutralProduced ? (calibEcal - neutralEnergy * slopeEcal) * fraction : calibEcal * fraction;
       double ecalRaw = totalEcal * fraction;
 
       if (debug_)
         cout << "The fraction after photon supression is " << fraction << " calibrated ecal = " << ecalCal << endl;
 
-      (*pfCandidates_)[tmpi[ic]].setEcalEnergy(ecalRaw, ecalCal);
-      (*pfCandidates_)[tmpi[ic]].setHcalEnergy(0., 0.);
-      (*pfCandidates_)[tmpi[ic]].setHoEnergy(0., 0.);
-      (*pfCandidates_)[tmpi[ic]].setPs1Energy(0);
-      (*pfCandidates_)[tmpi[ic]].setPs2Energy(0);
-      (*pfCandidates_)[tmpi[ic]].addElementInBlock(blockref, kTrack[ic]);
+      pfCandidates[tmpi[ic]].setEcalEnergy(ecalRaw, ecalCal);
+      pfCandidates[tmpi[ic]].setHcalEnergy(0., 0.);
+      pfCandidates[tmpi[ic]].setHoEnergy(0., 0.);
+      pfCandidates[tmpi[ic]].setPs1Energy(0);
+      pfCandidates[tmpi[ic]].setPs2Energy(0);
+      pfCandidates[tmpi[ic]].addElementInBlock(blockref, kTrack[ic]);
     }
 
   }  // End connected ECAL
 
   // Fill the element_in_block for tracks that are eventually linked to no ECAL clusters at all.
   for (unsigned ic = 0; ic < tmpi.size(); ++ic) {
-    const PFCandidate& pfc = (*pfCandidates_)[tmpi[ic]];
+    const PFCandidate& pfc = pfCandidates[tmpi[ic]];
     const PFCandidate::ElementsInBlocks& eleInBlocks = pfc.elementsInBlocks();
     if (eleInBlocks.empty()) {
       if (debug_)
         std::cout << "Single track / Fill element in block! " << std::endl;
-      (*pfCandidates_)[tmpi[ic]].addElementInBlock(blockref, kTrack[ic]);
+      pfCandidates[tmpi[ic]].addElementInBlock(blockref, kTrack[ic]);
     }
   }
   return false;
 }
 
-void PFAlgo::elementLoop(const reco::PFBlock& block,
+void PFAlgo::elementLoop(reco::PFCandidateCollection& pfCandidates,
+                         const reco::PFBlock& block,
                          reco::PFBlock::LinkData& linkData,
                          const edm::OwnVector<reco::PFBlockElement>& elements,
                          std::vector<bool>& active,
@@ -899,8 +935,8 @@ void PFAlgo::elementLoop(const reco::PFBlock& block,
         if (debug_)
           cout << "Primary Track reconstructed alone" << endl;
 
-        unsigned tmpi = reconstructTrack(elements[iEle]);
-        (*pfCandidates_)[tmpi].addElementInBlock(blockref, iEle);
+        unsigned tmpi = reconstructTrack(pfCandidates, elements[iEle]);
+        pfCandidates[tmpi].addElementInBlock(blockref, iEle);
         active[iTrack] = false;
       }
     }
@@ -1120,8 +1156,17 @@ void PFAlgo::elementLoop(const reco::PFBlock& block,
     // are reconstructed now.
 
     if (hcalElems.empty()) {
-      auto ret_continue = recoTracksNotHCAL(
-          block, linkData, elements, blockref, active, goodTrackDeadHcal, hasDeadHcal, iTrack, ecalElems, trackRef);
+      auto ret_continue = recoTracksNotHCAL(pfCandidates,
+                                            block,
+                                            linkData,
+                                            elements,
+                                            blockref,
+                                            active,
+                                            goodTrackDeadHcal,
+                                            hasDeadHcal,
+                                            iTrack,
+                                            ecalElems,
+                                            trackRef);
       if (ret_continue) {
         continue;
       }
@@ -1225,7 +1270,8 @@ int PFAlgo::decideType(const edm::OwnVector<reco::PFBlockElement>& elements,
   return 0;
 }
 
-void PFAlgo::createCandidateHF(const reco::PFBlock& block,
+void PFAlgo::createCandidateHF(reco::PFCandidateCollection& pfCandidates,
+                               const reco::PFBlock& block,
                                const reco::PFBlockRef& blockref,
                                const edm::OwnVector<reco::PFBlockElement>& elements,
                                ElementIndices& inds) {
@@ -1248,13 +1294,13 @@ void PFAlgo::createCandidateHF(const reco::PFBlock& block,
           energyHF = thepfEnergyCalibrationHF_.energyEm(
               uncalibratedenergyHF, clusterRef->positionREP().Eta(), clusterRef->positionREP().Phi());
         }
-        tmpi = reconstructCluster(*clusterRef, energyHF);
-        (*pfCandidates_)[tmpi].setEcalEnergy(uncalibratedenergyHF, energyHF);
-        (*pfCandidates_)[tmpi].setHcalEnergy(0., 0.);
-        (*pfCandidates_)[tmpi].setHoEnergy(0., 0.);
-        (*pfCandidates_)[tmpi].setPs1Energy(0.);
-        (*pfCandidates_)[tmpi].setPs2Energy(0.);
-        (*pfCandidates_)[tmpi].addElementInBlock(blockref, inds.hfEmIs[0]);
+        tmpi = reconstructCluster(pfCandidates, *clusterRef, energyHF);
+        pfCandidates[tmpi].setEcalEnergy(uncalibratedenergyHF, energyHF);
+        pfCandidates[tmpi].setHcalEnergy(0., 0.);
+        pfCandidates[tmpi].setHoEnergy(0., 0.);
+        pfCandidates[tmpi].setPs1Energy(0.);
+        pfCandidates[tmpi].setPs2Energy(0.);
+        pfCandidates[tmpi].addElementInBlock(blockref, inds.hfEmIs[0]);
         //std::cout << "HF EM alone ! " << energyHF << std::endl;
         break;
       case PFLayer::HF_HAD:
@@ -1265,13 +1311,13 @@ void PFAlgo::createCandidateHF(const reco::PFBlock& block,
           energyHF = thepfEnergyCalibrationHF_.energyHad(
               uncalibratedenergyHF, clusterRef->positionREP().Eta(), clusterRef->positionREP().Phi());
         }
-        tmpi = reconstructCluster(*clusterRef, energyHF);
-        (*pfCandidates_)[tmpi].setHcalEnergy(uncalibratedenergyHF, energyHF);
-        (*pfCandidates_)[tmpi].setEcalEnergy(0., 0.);
-        (*pfCandidates_)[tmpi].setHoEnergy(0., 0.);
-        (*pfCandidates_)[tmpi].setPs1Energy(0.);
-        (*pfCandidates_)[tmpi].setPs2Energy(0.);
-        (*pfCandidates_)[tmpi].addElementInBlock(blockref, inds.hfHadIs[0]);
+        tmpi = reconstructCluster(pfCandidates, *clusterRef, energyHF);
+        pfCandidates[tmpi].setHcalEnergy(uncalibratedenergyHF, energyHF);
+        pfCandidates[tmpi].setEcalEnergy(0., 0.);
+        pfCandidates[tmpi].setHoEnergy(0., 0.);
+        pfCandidates[tmpi].setPs1Energy(0.);
+        pfCandidates[tmpi].setPs2Energy(0.);
+        pfCandidates[tmpi].addElementInBlock(blockref, inds.hfHadIs[0]);
         //std::cout << "HF Had alone ! " << energyHF << std::endl;
         break;
       default:
@@ -1303,7 +1349,7 @@ void PFAlgo::createCandidateHF(const reco::PFBlock& block,
       energyHfHad = thepfEnergyCalibrationHF_.energyEmHad(
           0.0, uncalibratedenergyHFHad, c1->positionREP().Eta(), c1->positionREP().Phi());
     }
-    auto& cand = (*pfCandidates_)[reconstructCluster(*chad, energyHfEm + energyHfHad)];
+    auto& cand = pfCandidates[reconstructCluster(pfCandidates, *chad, energyHfEm + energyHfHad)];
     cand.setEcalEnergy(uncalibratedenergyHFEm, energyHfEm);
     cand.setHcalEnergy(uncalibratedenergyHFHad, energyHfHad);
     cand.setHoEnergy(0., 0.);
@@ -1322,7 +1368,8 @@ void PFAlgo::createCandidateHF(const reco::PFBlock& block,
   }
 }
 
-void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
+void PFAlgo::createCandidatesHCAL(reco::PFCandidateCollection& pfCandidates,
+                                  const reco::PFBlock& block,
                                   reco::PFBlock::LinkData& linkData,
                                   const edm::OwnVector<reco::PFBlockElement>& elements,
                                   std::vector<bool>& active,
@@ -1481,10 +1528,10 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
 
         // Create a muon.
 
-        unsigned tmpi = reconstructTrack(elements[iTrack]);
+        unsigned tmpi = reconstructTrack(pfCandidates, elements[iTrack]);
 
-        (*pfCandidates_)[tmpi].addElementInBlock(blockref, iTrack);
-        (*pfCandidates_)[tmpi].addElementInBlock(blockref, iHcal);
+        pfCandidates[tmpi].addElementInBlock(blockref, iTrack);
+        pfCandidates[tmpi].addElementInBlock(blockref, iHcal);
         double muonHcal = std::min(muonHCAL_[0] + muonHCAL_[1], totalHcal);
 
         // if muon is isolated and muon momentum exceeds the calo energy, absorb the calo energy
@@ -1512,9 +1559,9 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
             }
           }
 
-          // std::cout << "muon p / total calo = " << muonRef->p() << " "  << (pfCandidates_->back()).p() << " " << totalCaloEnergy << std::endl;
+          // std::cout << "muon p / total calo = " << muonRef->p() << " "  << (pfCandidates.back()).p() << " " << totalCaloEnergy << std::endl;
           //if(muonRef->p() > totalCaloEnergy ) letMuonEatCaloEnergy = true;
-          if ((pfCandidates_->back()).p() > totalCaloEnergy)
+          if ((pfCandidates.back()).p() > totalCaloEnergy)
             letMuonEatCaloEnergy = true;
         }
 
@@ -1525,14 +1572,14 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
         if (!sortedEcals.empty()) {
           iEcal = sortedEcals.begin()->second;
           PFClusterRef eclusterref = elements[iEcal].clusterRef();
-          (*pfCandidates_)[tmpi].addElementInBlock(blockref, iEcal);
+          pfCandidates[tmpi].addElementInBlock(blockref, iEcal);
           muonEcal = std::min(muonECAL_[0] + muonECAL_[1], eclusterref->energy());
           if (letMuonEatCaloEnergy)
             muonEcal = eclusterref->energy();
           // If the muon expected energy accounts for the whole ecal cluster energy, lock the ecal cluster
           if (eclusterref->energy() - muonEcal < 0.2)
             active[iEcal] = false;
-          (*pfCandidates_)[tmpi].setEcalEnergy(eclusterref->energy(), muonEcal);
+          pfCandidates[tmpi].setEcalEnergy(eclusterref->energy(), muonEcal);
         }
         unsigned iHO = 0;
         double muonHO = 0.;
@@ -1540,20 +1587,20 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
           if (!sortedHOs.empty()) {
             iHO = sortedHOs.begin()->second;
             PFClusterRef hoclusterref = elements[iHO].clusterRef();
-            (*pfCandidates_)[tmpi].addElementInBlock(blockref, iHO);
+            pfCandidates[tmpi].addElementInBlock(blockref, iHO);
             muonHO = std::min(muonHO_[0] + muonHO_[1], hoclusterref->energy());
             if (letMuonEatCaloEnergy)
               muonHO = hoclusterref->energy();
             // If the muon expected energy accounts for the whole HO cluster energy, lock the HO cluster
             if (hoclusterref->energy() - muonHO < 0.2)
               active[iHO] = false;
-            (*pfCandidates_)[tmpi].setHcalEnergy(totalHcal, muonHcal);
-            (*pfCandidates_)[tmpi].setHoEnergy(hoclusterref->energy(), muonHO);
+            pfCandidates[tmpi].setHcalEnergy(totalHcal, muonHcal);
+            pfCandidates[tmpi].setHoEnergy(hoclusterref->energy(), muonHO);
           }
         } else {
-          (*pfCandidates_)[tmpi].setHcalEnergy(totalHcal, muonHcal);
+          pfCandidates[tmpi].setHcalEnergy(totalHcal, muonHcal);
         }
-        setHcalDepthInfo((*pfCandidates_)[tmpi], *hclusterref);
+        setHcalDepthInfo(pfCandidates[tmpi], *hclusterref);
 
         if (letMuonEatCaloEnergy) {
           muonHCALEnergy += totalHcal;
@@ -1878,7 +1925,7 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
           block.associatedElements(iTrack, linkData, sortedHOs, reco::PFBlockElement::HO, reco::PFBlock::LINKTEST_ALL);
 
           //Here allow for loose muons!
-          auto& muon = (*pfCandidates_)[reconstructTrack(elements[iTrack], true)];
+          auto& muon = pfCandidates[reconstructTrack(pfCandidates, elements[iTrack], true)];
 
           muon.addElementInBlock(blockref, iTrack);
           muon.addElementInBlock(blockref, iHcal);
@@ -2062,17 +2109,17 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
       reco::TrackRef trackRef = elements[iTrack].trackRef();
       double trackMomentum = trackRef->p();
       double Dp = trackRef->qoverpError() * trackMomentum * trackMomentum;
-      unsigned tmpi = reconstructTrack(elements[iTrack]);
+      unsigned tmpi = reconstructTrack(pfCandidates, elements[iTrack]);
 
-      (*pfCandidates_)[tmpi].addElementInBlock(blockref, iTrack);
-      (*pfCandidates_)[tmpi].addElementInBlock(blockref, iHcal);
-      setHcalDepthInfo((*pfCandidates_)[tmpi], *hclusterref);
+      pfCandidates[tmpi].addElementInBlock(blockref, iTrack);
+      pfCandidates[tmpi].addElementInBlock(blockref, iHcal);
+      setHcalDepthInfo(pfCandidates[tmpi], *hclusterref);
       auto myEcals = associatedEcals.equal_range(iTrack);
       for (auto ii = myEcals.first; ii != myEcals.second; ++ii) {
         unsigned iEcal = ii->second.second;
         if (active[iEcal])
           continue;
-        (*pfCandidates_)[tmpi].addElementInBlock(blockref, iEcal);
+        pfCandidates[tmpi].addElementInBlock(blockref, iEcal);
       }
 
       if (useHO_) {
@@ -2081,12 +2128,12 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
           unsigned iHO = ii->second.second;
           if (active[iHO])
             continue;
-          (*pfCandidates_)[tmpi].addElementInBlock(blockref, iHO);
+          pfCandidates[tmpi].addElementInBlock(blockref, iHO);
         }
       }
 
       if (iTrack == corrTrack) {
-        (*pfCandidates_)[tmpi].rescaleMomentum(corrFact);
+        pfCandidates[tmpi].rescaleMomentum(corrFact);
         trackMomentum *= corrFact;
       }
       chargedHadronsIndices.push_back(tmpi);
@@ -2172,7 +2219,7 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
             //      unsigned iTrack = trackInfos[i].index;
             unsigned ich = chargedHadronsIndices[i];
             double rescaleFactor = x(i) / hcalP[i];
-            (*pfCandidates_)[ich].rescaleMomentum(rescaleFactor);
+            pfCandidates[ich].rescaleMomentum(rescaleFactor);
 
             if (debug_) {
               cout << "\t\t\told p " << hcalP[i] << " new p " << x(i) << " rescale " << rescaleFactor << endl;
@@ -2354,12 +2401,13 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
           std::cout << "ALARM = Negative energy ! " << particleEnergy[iPivot] << std::endl;
 
         const bool useDirection = true;
-        auto& neutral = (*pfCandidates_)[reconstructCluster(*pivotalClusterRef[iPivot],
-                                                            particleEnergy[iPivot],
-                                                            useDirection,
-                                                            particleDirection[iPivot].X(),
-                                                            particleDirection[iPivot].Y(),
-                                                            particleDirection[iPivot].Z())];
+        auto& neutral = pfCandidates[reconstructCluster(pfCandidates,
+                                                        *pivotalClusterRef[iPivot],
+                                                        particleEnergy[iPivot],
+                                                        useDirection,
+                                                        particleDirection[iPivot].X(),
+                                                        particleDirection[iPivot].Y(),
+                                                        particleDirection[iPivot].Z())];
 
         neutral.setEcalEnergy(rawecalEnergy[iPivot], ecalEnergy[iPivot]);
         if (!useHO_) {
@@ -2423,12 +2471,12 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
     // not exactly equal to sum p, this is sum E
     double chargedHadronsTotalEnergy = 0;
     for (unsigned index : chargedHadronsIndices) {
-      reco::PFCandidate& chargedHadron = (*pfCandidates_)[index];
+      reco::PFCandidate& chargedHadron = pfCandidates[index];
       chargedHadronsTotalEnergy += chargedHadron.energy();
     }
 
     for (unsigned index : chargedHadronsIndices) {
-      reco::PFCandidate& chargedHadron = (*pfCandidates_)[index];
+      reco::PFCandidate& chargedHadron = pfCandidates[index];
       float fraction = chargedHadron.energy() / chargedHadronsTotalEnergy;
 
       if (!useHO_) {
@@ -2468,7 +2516,7 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
           sqrt(std::get<1>(ecalSatellite.second).Mag2()) *
           std::get<2>(
               ecalSatellite.second);  // KH: calibrated under the egamma hypothesis (rawEcalClusterEnergy * calibration)
-      auto& cand = (*pfCandidates_)[reconstructCluster(*eclusterref, ecalClusterEnergyCalibrated)];
+      auto& cand = pfCandidates[reconstructCluster(pfCandidates, *eclusterref, ecalClusterEnergyCalibrated)];
       cand.setEcalEnergy(eclusterref->energy(), ecalClusterEnergyCalibrated);
       cand.setHcalEnergy(0., 0.);
       cand.setHoEnergy(0., 0.);
@@ -2490,7 +2538,8 @@ void PFAlgo::createCandidatesHCAL(const reco::PFBlock& block,
   // end loop on hcal element iHcal= hcalIs[i]
 }
 
-void PFAlgo::createCandidatesHCALUnlinked(const reco::PFBlock& block,
+void PFAlgo::createCandidatesHCALUnlinked(reco::PFCandidateCollection& pfCandidates,
+                                          const reco::PFBlock& block,
                                           reco::PFBlock::LinkData& linkData,
                                           const edm::OwnVector<reco::PFBlockElement>& elements,
                                           std::vector<bool>& active,
@@ -2682,7 +2731,7 @@ void PFAlgo::createCandidatesHCALUnlinked(const reco::PFBlock& block,
     // double particleEnergy = totalEcal + calibHcal;
     // particleEnergy /= (1.-0.724/sqrt(particleEnergy)-0.0226/particleEnergy);
 
-    auto& cand = (*pfCandidates_)[reconstructCluster(*hclusterRef, calibEcal + calibHcal)];
+    auto& cand = pfCandidates[reconstructCluster(pfCandidates, *hclusterRef, calibEcal + calibHcal)];
 
     cand.setEcalEnergy(totalEcal, calibEcal);
     if (!useHO_) {
@@ -2703,7 +2752,8 @@ void PFAlgo::createCandidatesHCALUnlinked(const reco::PFBlock& block,
   }  //loop hcal elements
 }
 
-void PFAlgo::createCandidatesECAL(const reco::PFBlock& block,
+void PFAlgo::createCandidatesECAL(reco::PFCandidateCollection& pfCandidates,
+                                  const reco::PFBlock& block,
                                   reco::PFBlock::LinkData& linkData,
                                   const edm::OwnVector<reco::PFBlockElement>& elements,
                                   std::vector<bool>& active,
@@ -2739,7 +2789,7 @@ void PFAlgo::createCandidatesECAL(const reco::PFBlock& block,
     // float ecalEnergy = calibration_.energyEm( clusterref->energy() );
     double particleEnergy = ecalEnergy;
 
-    auto& cand = (*pfCandidates_)[reconstructCluster(*clusterref, particleEnergy)];
+    auto& cand = pfCandidates[reconstructCluster(pfCandidates, *clusterref, particleEnergy)];
 
     cand.setEcalEnergy(clusterref->energy(), ecalEnergy);
     cand.setHcalEnergy(0., 0.);
@@ -2751,9 +2801,8 @@ void PFAlgo::createCandidatesECAL(const reco::PFBlock& block,
   }  // end loop on ecal elements iEcal = ecalIs[i]
 }
 
-void PFAlgo::processBlock(const reco::PFBlockRef& blockref,
-                          std::list<reco::PFBlockRef>& hcalBlockRefs,
-                          std::list<reco::PFBlockRef>& ecalBlockRefs,
+void PFAlgo::processBlock(reco::PFCandidateCollection& pfCandidates,
+                          const reco::PFBlockRef& blockref,
                           PFEGammaFilters const* pfegamma) {
   // debug_ = false;
   assert(!blockref.isNull());
@@ -2780,7 +2829,7 @@ void PFAlgo::processBlock(const reco::PFBlockRef& blockref,
 
   // New EGamma Reconstruction 10/10/2013
   if (useEGammaFilters_) {
-    egammaFilters(blockref, active, pfegamma);
+    egammaFilters(pfCandidates, blockref, active, pfegamma);
   }  // end if use EGammaFilters
 
   //Lock extra conversion tracks not used by Photon Algo
@@ -2820,22 +2869,24 @@ void PFAlgo::processBlock(const reco::PFBlockRef& blockref,
   // vectors to store indices to ho, hcal and ecal elements
   ElementIndices inds;
 
-  elementLoop(block, linkData, elements, active, blockref, inds, deadArea);
+  elementLoop(pfCandidates, block, linkData, elements, active, blockref, inds, deadArea);
 
   // deal with HF.
   if (!(inds.hfEmIs.empty() && inds.hfHadIs.empty())) {
-    createCandidateHF(block, blockref, elements, inds);
+    createCandidateHF(pfCandidates, block, blockref, elements, inds);
   }
 
-  createCandidatesHCAL(block, linkData, elements, active, blockref, inds, deadArea);
+  createCandidatesHCAL(pfCandidates, block, linkData, elements, active, blockref, inds, deadArea);
   // COLINFEB16: now dealing with the HCAL elements that are not linked to any track
-  createCandidatesHCALUnlinked(block, linkData, elements, active, blockref, inds, deadArea);
-  createCandidatesECAL(block, linkData, elements, active, blockref, inds, deadArea);
+  createCandidatesHCALUnlinked(pfCandidates, block, linkData, elements, active, blockref, inds, deadArea);
+  createCandidatesECAL(pfCandidates, block, linkData, elements, active, blockref, inds, deadArea);
 
 }  // end processBlock
 
 /////////////////////////////////////////////////////////////////////
-unsigned PFAlgo::reconstructTrack(const reco::PFBlockElement& elt, bool allowLoose) {
+unsigned PFAlgo::reconstructTrack(reco::PFCandidateCollection& pfCandidates,
+                                  const reco::PFBlockElement& elt,
+                                  bool allowLoose) {
   const auto* eltTrack = dynamic_cast<const reco::PFBlockElementTrack*>(&elt);
 
   const reco::TrackRef& trackRef = eltTrack->trackRef();
@@ -2859,20 +2910,20 @@ unsigned PFAlgo::reconstructTrack(const reco::PFBlockElement& elt, bool allowLoo
   reco::PFCandidate::ParticleType particleType = reco::PFCandidate::h;
 
   // Add it to the stack
-  pfCandidates_->push_back(PFCandidate(charge, momentum, particleType));
+  pfCandidates.push_back(PFCandidate(charge, momentum, particleType));
   //Set vertex and stuff like this
-  pfCandidates_->back().setVertexSource(PFCandidate::kTrkVertex);
-  pfCandidates_->back().setTrackRef(trackRef);
-  pfCandidates_->back().setPositionAtECALEntrance(eltTrack->positionAtECALEntrance());
+  pfCandidates.back().setVertexSource(PFCandidate::kTrkVertex);
+  pfCandidates.back().setTrackRef(trackRef);
+  pfCandidates.back().setPositionAtECALEntrance(eltTrack->positionAtECALEntrance());
   if (muonRef.isNonnull())
-    pfCandidates_->back().setMuonRef(muonRef);
+    pfCandidates.back().setMuonRef(muonRef);
 
   //Set time
   if (elt.isTimeValid())
-    pfCandidates_->back().setTime(elt.time(), elt.timeError());
+    pfCandidates.back().setTime(elt.time(), elt.timeError());
 
   //OK Now try to reconstruct the particle as a muon
-  bool isMuon = pfmu_->reconstructMuon(pfCandidates_->back(), muonRef, allowLoose);
+  bool isMuon = pfmu_->reconstructMuon(pfCandidates.back(), muonRef, allowLoose);
   bool isFromDisp = isFromSecInt(elt, "secondary");
 
   if ((!isMuon) && isFromDisp) {
@@ -2894,25 +2945,26 @@ unsigned PFAlgo::reconstructTrack(const reco::PFBlockElement& elt, bool allowLoo
       if (debug_)
         cout << "Refitted px = " << px << " py = " << py << " pz = " << pz << " energy = " << energy << endl;
     }
-    pfCandidates_->back().setFlag(reco::PFCandidate::T_FROM_DISP, true);
-    pfCandidates_->back().setDisplacedVertexRef(
+    pfCandidates.back().setFlag(reco::PFCandidate::T_FROM_DISP, true);
+    pfCandidates.back().setDisplacedVertexRef(
         eltTrack->displacedVertexRef(reco::PFBlockElement::T_FROM_DISP)->displacedVertexRef(),
         reco::PFCandidate::T_FROM_DISP);
   }
 
   // do not label as primary a track which would be recognised as a muon. A muon cannot produce NI. It is with high probability a fake
   if (isFromSecInt(elt, "primary") && !isMuon) {
-    pfCandidates_->back().setFlag(reco::PFCandidate::T_TO_DISP, true);
-    pfCandidates_->back().setDisplacedVertexRef(
+    pfCandidates.back().setFlag(reco::PFCandidate::T_TO_DISP, true);
+    pfCandidates.back().setDisplacedVertexRef(
         eltTrack->displacedVertexRef(reco::PFBlockElement::T_TO_DISP)->displacedVertexRef(),
         reco::PFCandidate::T_TO_DISP);
   }
 
   // returns index to the newly created PFCandidate
-  return pfCandidates_->size() - 1;
+  return pfCandidates.size() - 1;
 }
 
-unsigned PFAlgo::reconstructCluster(const reco::PFCluster& cluster,
+unsigned PFAlgo::reconstructCluster(reco::PFCandidateCollection& pfCandidates,
+                                    const reco::PFCluster& cluster,
                                     double particleEnergy,
                                     bool useDirection,
                                     double particleX,
@@ -2995,26 +3047,26 @@ unsigned PFAlgo::reconstructCluster(const reco::PFCluster& cluster,
   }
 
   // The pf candidate
-  pfCandidates_->push_back(PFCandidate(charge, tmp, particleType));
+  pfCandidates.push_back(PFCandidate(charge, tmp, particleType));
 
   // The position at ECAL entrance (well: watch out, it is not true
   // for HCAL clusters... to be fixed)
-  pfCandidates_->back().setPositionAtECALEntrance(
+  pfCandidates.back().setPositionAtECALEntrance(
       ::math::XYZPointF(cluster.position().X(), cluster.position().Y(), cluster.position().Z()));
 
   //Set the cnadidate Vertex
-  pfCandidates_->back().setVertex(vertexPos);
+  pfCandidates.back().setVertex(vertexPos);
 
   // depth info
-  setHcalDepthInfo(pfCandidates_->back(), cluster);
+  setHcalDepthInfo(pfCandidates.back(), cluster);
 
   //*TODO* cluster time is not reliable at the moment, so only use track timing
 
   if (debug_)
-    cout << "** candidate: " << pfCandidates_->back() << endl;
+    cout << "** candidate: " << pfCandidates.back() << endl;
 
   // returns index to the newly created PFCandidate
-  return pfCandidates_->size() - 1;
+  return pfCandidates.size() - 1;
 }
 
 void PFAlgo::setHcalDepthInfo(reco::PFCandidate& cand, const reco::PFCluster& cluster) const {
@@ -3350,7 +3402,7 @@ void PFAlgo::checkCleaning(const reco::PFRecHitCollection& cleanedHits) {
     for (unsigned int hitIdx : hitsToBeAdded) {
       const PFRecHit& hit = cleanedHits[hitIdx];
       PFCluster cluster(hit.layer(), hit.energy(), hit.position().x(), hit.position().y(), hit.position().z());
-      reconstructCluster(cluster, hit.energy());
+      reconstructCluster(*pfCandidates_, cluster, hit.energy());
       if (debug_) {
         std::cout << pfCandidates_->back() << ". time = " << hit.time() << std::endl;
       }
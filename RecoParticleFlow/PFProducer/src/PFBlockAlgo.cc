@@ -51,7 +51,6 @@ namespace {
     void unite(unsigned p, unsigned q) {
       unsigned rootP = find(p);
       unsigned rootQ = find(q);
-      id_[p] = q;
 
       if (size_[rootP] < size_[rootQ]) {
         id_[rootP] = rootQ;
@@ -81,7 +80,8 @@ PFBlockAlgo::PFBlockAlgo()
                      INIT_ENTRY(PFBlockElement::HFHAD),
                      INIT_ENTRY(PFBlockElement::SC),
                      INIT_ENTRY(PFBlockElement::HO),
-                     INIT_ENTRY(PFBlockElement::HGCAL)}) {}
+                     INIT_ENTRY(PFBlockElement::HGCAL)}),
+      useLinkKeys_(true) {}
 
 void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
   constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
@@ -121,6 +121,8 @@ void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
       kdtrees_.back()->setFieldType(std::max(type1, type2));
     }
   }
+  keyedLinks_.assign(linkTests_.size(), false);
+  linkKeyTables_.resize(linkTests_.size());
 }
 
 void PFBlockAlgo::setImporters(const std::vector<edm::ParameterSet>& confs, edm::ConsumesCollector& sumes) {
@@ -144,20 +146,25 @@ reco::PFBlockCollection PFBlockAlgo::findBlocks() {
     kdtree->process();
   }
   // !Glowinski & Gouzevitch
+  buildLinkKeys();
   reco::PFBlockCollection blocks;
   // the blocks have not been passed to the event, and need to be cleared
   blocks.reserve(elements_.size());
 
-  QuickUnion qu(elements_.size());
+  // the links are only tested between each element and the elements that the
+  // linkers can link to it, which are tested in both orders as on all pairs.
+  // The blocks are ordered by their first element and their elements by
+  // index, so that the order does not depend on the order of the tests.
   const auto elem_size = elements_.size();
+  QuickUnion qu(elem_size);
+  std::vector<unsigned> marks(elem_size, 0);
+  std::vector<unsigned> candidates;
+  candidates.reserve(elem_size);
   for (unsigned i = 0; i < elem_size; ++i) {
-    for (unsigned j = 0; j < elem_size; ++j) {
-      if (qu.connected(i, j) || j == i)
+    findLinkCandidates(i, marks, candidates);
+    for (const unsigned j : candidates) {
+      if (j == i || qu.connected(i, j))
         continue;
-      if (!linkTests_[linkTestSquare_[elements_[i]->type()][elements_[j]->type()]]) {
-        j = ranges_[elements_[j]->type()].second;
-        continue;
-      }
       auto p1(elements_[i].get()), p2(elements_[j].get());
       const PFBlockElement::Type type1 = p1->type();
       const PFBlockElement::Type type2 = p2->type();
@@ -172,33 +179,27 @@ reco::PFBlockCollection PFBlockAlgo::findBlocks() {
     }
   }
 
-  std::unordered_multimap<unsigned, unsigned> blocksmap(elements_.size());
-  std::vector<unsigned> keys;
-  keys.reserve(elements_.size());
-  for (unsigned i = 0; i < elements_.size(); ++i) {
-    unsigned key = i;
-    while (key != qu.find(key))
-      key = qu.find(key);  // make sure we always find the root node...
-    auto pos = std::lower_bound(keys.begin(), keys.end(), key);
-    if (pos == keys.end() || *pos != key) {
-      keys.insert(pos, key);
+  std::vector<int> blockOfRoot(elem_size, -1);
+  std::vector<std::vector<unsigned>> blockElements;
+  for (unsigned i = 0; i < elem_size; ++i) {
+    const unsigned root = qu.find(i);
+    if (blockOfRoot[root] < 0) {
+      blockOfRoot[root] = blockElements.size();
+      blockElements.emplace_back();
     }
-    blocksmap.emplace(key, i);
+    blockElements[blockOfRoot[root]].push_back(i);
   }
 
-  for (auto key : keys) {
+  for (const auto& elementIndices : blockElements) {
     blocks.push_back(reco::PFBlock());
-    auto range = blocksmap.equal_range(key);
     auto& the_block = blocks.back();
-    ElementList::value_type::pointer p1(elements_[range.first->second].get());
+    ElementList::value_type::pointer p1(elements_[elementIndices.front()].get());
     the_block.addElement(p1);
-    const unsigned block_size = blocksmap.count(key) + 1;
+    const unsigned block_size = elementIndices.size() + 1;
     //reserve up to 1M or 8MB; pay rehash cost for more
     std::unordered_map<std::pair<unsigned int, unsigned int>, double> links(min(1000000u, block_size * block_size));
-    auto itr = range.first;
-    ++itr;
-    for (; itr != range.second; ++itr) {
-      ElementList::value_type::pointer p2(elements_[itr->second].get());
+    for (auto itr = elementIndices.begin() + 1; itr != elementIndices.end(); ++itr) {
+      ElementList::value_type::pointer p2(elements_[*itr].get());
       const PFBlockElement::Type type1 = p1->type();
       const PFBlockElement::Type type2 = p2->type();
       the_block.addElement(p2);
@@ -216,6 +217,71 @@ reco::PFBlockCollection PFBlockAlgo::findBlocks() {
   return blocks;
 }
 
+void PFBlockAlgo::buildLinkKeys() {
+  constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
+  for (unsigned index = 0; index < linkTests_.size(); ++index) {
+    keyedLinks_[index] = false;
+    if (!useLinkKeys_ || !linkTests_[index])
+      continue;
+    const unsigned types[2] = {index % rowsize, index / rowsize};
+    for (unsigned side = 0; side < 2; ++side) {
+      auto& table = linkKeyTables_[index][side];
+      table.keys.clear();
+      table.unkeyed.clear();
+      if (side == 1 && types[1] == types[0])
+        continue;
+      for (unsigned i = ranges_[types[side]]; i < ranges_[types[side] + 1]; ++i) {
+        keys_.clear();
+        if (linkTests_[index]->linkKeys(elements_[i].get(), keys_)) {
+          keyedLinks_[index] = true;
+          for (const auto key : keys_)
+            table.keys.emplace_back(key, i);
+        } else {
+          table.unkeyed.push_back(i);
+        }
+      }
+      std::sort(table.keys.begin(), table.keys.end());
+    }
+  }
+}
+
+void PFBlockAlgo::findLinkCandidates(unsigned i, std::vector<unsigned>& marks, std::vector<unsigned>& candidates) {
+  constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
+  const unsigned type1 = elements_[i]->type();
+  candidates.clear();
+  for (unsigned type2 = 0; type2 < rowsize; ++type2) {
+    const unsigned index = linkTestSquare_[type1][type2];
+    if (!linkTests_[index])
+      continue;
+    // the pairs of types without their own linker fall back to the linker
+    // of index 0, which is tested on all of their pairs as before
+    const bool ownLinker = (index == rowsize * std::max(type1, type2) + std::min(type1, type2));
+    keys_.clear();
+    if (!keyedLinks_[index] || !ownLinker || !linkTests_[index]->linkKeys(elements_[i].get(), keys_)) {
+      for (unsigned j = ranges_[type2]; j < ranges_[type2 + 1]; ++j)
+        candidates.push_back(j);
+      continue;
+    }
+    const auto& table = linkKeyTables_[index][type2 > type1 ? 1 : 0];
+    for (const auto key : keys_) {
+      for (auto itr = std::lower_bound(table.keys.begin(), table.keys.end(), std::make_pair(key, 0u));
+           itr != table.keys.end() && itr->first == key;
+           ++itr) {
+        if (marks[itr->second] != i + 1) {
+          marks[itr->second] = i + 1;
+          candidates.push_back(itr->second);
+        }
+      }
+    }
+    for (const auto j : table.unkeyed) {
+      if (marks[j] != i + 1) {
+        marks[j] = i + 1;
+        candidates.push_back(j);
+      }
+    }
+  }
+}
+
 void PFBlockAlgo::packLinks(reco::PFBlock& block,
                             const std::unordered_map<std::pair<unsigned int, unsigned int>, double>& links) const {
   constexpr unsigned rowsize = reco::PFBlockElement::kNBETypes;
@@ -285,7 +351,6 @@ void PFBlockAlgo::updateEventSetup(const edm::EventSetup& es) {
 // and kdtree preprocessors
 void PFBlockAlgo::buildElements(const edm::Event& evt) {
   // import block elements as defined in python configuration
-  ranges_.fill(std::make_pair(0, 0));
   elements_.clear();
   for (const auto& importer : importers_) {
     importer->importToBlock(evt, elements_);
@@ -294,18 +359,14 @@ void PFBlockAlgo::buildElements(const edm::Event& evt) {
   std::sort(elements_.begin(), elements_.end(), [](const auto& a, const auto& b) { return a->type() < b->type(); });
 
   // list is now partitioned, so mark the boundaries so we can efficiently skip chunks
-  unsigned current_type = (!elements_.empty() ? elements_[0]->type() : 0);
-  unsigned last_type = (!elements_.empty() ? elements_.back()->type() : 0);
-  ranges_[current_type].first = 0;
-  ranges_[last_type].second = elements_.size() - 1;
-  for (size_t i = 0; i < elements_.size(); ++i) {
-    const auto the_type = elements_[i]->type();
-    if (the_type != current_type) {
-      ranges_[the_type].first = i;
-      ranges_[current_type].second = i - 1;
-      current_type = the_type;
-    }
+  ranges_.fill(0);
+  for (const auto& element : elements_) {
+    ++ranges_[element->type() + 1];
+  }
+  for (unsigned type = 1; type < ranges_.size(); ++type) {
+    ranges_[type] += ranges_[type - 1];
   }
+
   // -------------- Loop over block elements ---------------------
 
   // Here we provide to all KDTree linkers the collections to link.
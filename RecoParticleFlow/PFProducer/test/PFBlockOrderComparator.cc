@@ -0,0 +1,96 @@
+//
+// Class: PFBlockOrderComparator.cc
+//
+// Info: Checks that two block collections built from the same elements are
+//       identical, block by block and element by element, including the
+//       order of the blocks and of the elements, and the link data.
+//       Throws at the first difference.
+//
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/ParticleFlowReco/interface/PFBlock.h"
+#include "DataFormats/ParticleFlowReco/interface/PFBlockFwd.h"
+
+#include <sstream>
+#include <string>
+
+class PFBlockOrderComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit PFBlockOrderComparator(const edm::ParameterSet&);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  static std::string dump(const reco::PFBlockElement& element);
+
+  const edm::EDGetTokenT<reco::PFBlockCollection> srcToken_;
+  const edm::EDGetTokenT<reco::PFBlockCollection> srcOldToken_;
+};
+
+PFBlockOrderComparator::PFBlockOrderComparator(const edm::ParameterSet& conf)
+    : srcToken_(consumes<reco::PFBlockCollection>(conf.getParameter<edm::InputTag>("source"))),
+      srcOldToken_(consumes<reco::PFBlockCollection>(conf.getParameter<edm::InputTag>("sourceOld"))) {}
+
+void PFBlockOrderComparator::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("source", edm::InputTag("particleFlowBlock"));
+  desc.add<edm::InputTag>("sourceOld", edm::InputTag("particleFlowBlockAllPairs"));
+  descriptions.add("pfBlockOrderComparator", desc);
+}
+
+std::string PFBlockOrderComparator::dump(const reco::PFBlockElement& element) {
+  std::ostringstream str;
+  element.Dump(str);
+  return str.str();
+}
+
+void PFBlockOrderComparator::analyze(edm::StreamID, const edm::Event& e, const edm::EventSetup&) const {
+  const auto& blocks = e.get(srcToken_);
+  const auto& oldBlocks = e.get(srcOldToken_);
+
+  if (blocks.size() != oldBlocks.size())
+    throw cms::Exception("PFBlockMismatch") << e.id() << ": " << blocks.size() << " blocks instead of "
+                                            << oldBlocks.size();
+
+  for (unsigned ib = 0; ib < blocks.size(); ++ib) {
+    const auto& elements = blocks[ib].elements();
+    const auto& oldElements = oldBlocks[ib].elements();
+    if (elements.size() != oldElements.size())
+      throw cms::Exception("PFBlockMismatch") << e.id() << ": block " << ib << " has " << elements.size()
+                                              << " elements instead of " << oldElements.size();
+    for (unsigned ie = 0; ie < elements.size(); ++ie) {
+      const std::string element = dump(elements[ie]);
+      const std::string oldElement = dump(oldElements[ie]);
+      if (element != oldElement)
+        throw cms::Exception("PFBlockMismatch")
+            << e.id() << ": element " << ie << " of block " << ib << " is\n"
+            << element << "\ninstead of\n"
+            << oldElement;
+    }
+
+    const auto& links = blocks[ib].linkData();
+    const auto& oldLinks = oldBlocks[ib].linkData();
+    if (links.size() != oldLinks.size())
+      throw cms::Exception("PFBlockMismatch") << e.id() << ": block " << ib << " has " << links.size()
+                                              << " links instead of " << oldLinks.size();
+    for (auto link = links.begin(), oldLink = oldLinks.begin(); link != links.end(); ++link, ++oldLink) {
+      if (link->first != oldLink->first || link->second.distance != oldLink->second.distance ||
+          link->second.test != oldLink->second.test)
+        throw cms::Exception("PFBlockMismatch")
+            << e.id() << ": link " << link->first << " of block " << ib << " at distance " << link->second.distance
+            << " instead of link " << oldLink->first << " at distance " << oldLink->second.distance;
+    }
+  }
+}
+
+DEFINE_FWK_MODULE(PFBlockOrderComparator);
@@ -0,0 +1,83 @@
+//
+// Class: PFCandidateOrderComparator.cc
+//
+// Info: Checks that two candidate collections built from the same blocks are
+//       identical, candidate by candidate, including the order of the
+//       candidates and the elements they are made of.
+//       Throws at the first difference.
+//
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
+
+class PFCandidateOrderComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit PFCandidateOrderComparator(const edm::ParameterSet&);
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  void analyze(edm::StreamID, const edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  static bool sameCandidate(const reco::PFCandidate& cand, const reco::PFCandidate& oldCand);
+
+  const edm::EDGetTokenT<reco::PFCandidateCollection> srcToken_;
+  const edm::EDGetTokenT<reco::PFCandidateCollection> srcOldToken_;
+};
+
+PFCandidateOrderComparator::PFCandidateOrderComparator(const edm::ParameterSet& conf)
+    : srcToken_(consumes<reco::PFCandidateCollection>(conf.getParameter<edm::InputTag>("source"))),
+      srcOldToken_(consumes<reco::PFCandidateCollection>(conf.getParameter<edm::InputTag>("sourceOld"))) {}
+
+void PFCandidateOrderComparator::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("source", edm::InputTag("particleFlowTmpParallel"));
+  desc.add<edm::InputTag>("sourceOld", edm::InputTag("particleFlowTmp"));
+  descriptions.add("pfCandidateOrderComparator", desc);
+}
+
+bool PFCandidateOrderComparator::sameCandidate(const reco::PFCandidate& cand, const reco::PFCandidate& oldCand) {
+  if (cand.particleId() != oldCand.particleId() || cand.pdgId() != oldCand.pdgId() ||
+      cand.charge() != oldCand.charge() || cand.p4() != oldCand.p4() || cand.vertex() != oldCand.vertex())
+    return false;
+  if (cand.ecalEnergy() != oldCand.ecalEnergy() || cand.rawEcalEnergy() != oldCand.rawEcalEnergy() ||
+      cand.hcalEnergy() != oldCand.hcalEnergy() || cand.rawHcalEnergy() != oldCand.rawHcalEnergy())
+    return false;
+
+  const auto& elements = cand.elementsInBlocks();
+  const auto& oldElements = oldCand.elementsInBlocks();
+  if (elements.size() != oldElements.size())
+    return false;
+  for (unsigned ie = 0; ie < elements.size(); ++ie) {
+    if (elements[ie].first.key() != oldElements[ie].first.key() || elements[ie].second != oldElements[ie].second)
+      return false;
+  }
+  return true;
+}
+
+void PFCandidateOrderComparator::analyze(edm::StreamID, const edm::Event& e, const edm::EventSetup&) const {
+  const auto& cands = e.get(srcToken_);
+  const auto& oldCands = e.get(srcOldToken_);
+
+  if (cands.size() != oldCands.size())
+    throw cms::Exception("PFCandidateMismatch")
+        << e.id() << ": " << cands.size() << " candidates instead of " << oldCands.size();
+
+  for (unsigned ic = 0; ic < cands.size(); ++ic) {
+    if (!sameCandidate(cands[ic], oldCands[ic]))
+      throw cms::Exception("PFCandidateMismatch") << e.id() << ": candidate " << ic << " is\n"
+                                                  << cands[ic] << "\ninstead of\n"
+                                                  << oldCands[ic];
+  }
+}
+
+DEFINE_FWK_MODULE(PFCandidateOrderComparator);
@@ -0,0 +1,41 @@
+import FWCore.ParameterSet.Config as cms
+
+# Rebuilds the particle flow blocks twice on the same elements, once testing
+# the links only on the pairs with a common link key (the default) and once
+# on all the pairs, and checks that the blocks, their order and the order of
+# their elements are the same. Both order the blocks by their first element
+# and the elements of a block by index. The comparator throws at the first
+# difference.
+
+process = cms.Process("PFBLOCKCMP")
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(100)
+    )
+process.source = cms.Source(
+    "PoolSource",
+    fileNames = cms.untracked.vstring(
+    '/store/relval/CMSSW_7_1_0_pre3/RelValTTbar_13/GEN-SIM-RECO/POSTLS171_V1-v1/00000/76897917-C0A1-E311-A852-02163E00EA9A.root',
+    '/store/relval/CMSSW_7_1_0_pre3/RelValTTbar_13/GEN-SIM-RECO/POSTLS171_V1-v1/00000/7AAC4BC0-C3A1-E311-A8BF-02163E00EAEA.root'
+    )
+)
+
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:run2_mc', '')
+
+process.load("RecoParticleFlow.PFProducer.particleFlowBlock_cfi")
+process.particleFlowBlockAllPairs = process.particleFlowBlock.clone(
+    useLinkKeys = cms.untracked.bool(False)
+)
+
+process.pfBlockOrderComparator = cms.EDAnalyzer(
+    "PFBlockOrderComparator",
+    source = cms.InputTag("particleFlowBlock",'','PFBLOCKCMP'),
+    sourceOld = cms.InputTag("particleFlowBlockAllPairs",'','PFBLOCKCMP')
+)
+
+process.p = cms.Path( process.particleFlowBlock         +
+                      process.particleFlowBlockAllPairs +
+                      process.pfBlockOrderComparator      )
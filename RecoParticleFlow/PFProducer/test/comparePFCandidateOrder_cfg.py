@@ -0,0 +1,50 @@
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+# Runs the particle flow twice on the same blocks, once with the blocks
+# processed in parallel (parallelBlocks) and once with the serial loop, and
+# checks that the candidates and their order are the same. The comparator
+# throws at the first difference. Takes GEN-SIM-DIGI-RAW input, e.g.
+#   cmsRun comparePFCandidateOrder_cfg.py inputFiles=file:step2.root
+
+options = VarParsing('analysis')
+options.maxEvents = 100
+options.parseArguments()
+
+from Configuration.Eras.Era_Run2_2018_cff import Run2_2018
+process = cms.Process("PFCANDCMP", Run2_2018)
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+    )
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(0)
+    )
+process.source = cms.Source(
+    "PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.load("Configuration.StandardSequences.Services_cff")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.RawToDigi_cff")
+process.load("Configuration.StandardSequences.Reconstruction_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2018_realistic', '')
+
+process.particleFlowTmpParallel = process.particleFlowTmp.clone(
+    parallelBlocks = cms.untracked.bool(True)
+)
+
+process.pfCandidateOrderComparator = cms.EDAnalyzer(
+    "PFCandidateOrderComparator",
+    source = cms.InputTag("particleFlowTmpParallel",'','PFCANDCMP'),
+    sourceOld = cms.InputTag("particleFlowTmp",'','PFCANDCMP')
+)
+
+process.p = cms.Path( process.RawToDigi                  +
+                      process.reconstruction             +
+                      process.particleFlowTmpParallel    +
+                      process.pfCandidateOrderComparator   )
@@ -27,6 +27,7 @@
 #include "RecoTracker/MeasurementDet/interface/MeasurementTrackerEvent.h"
 
 #include <memory>
+#include <vector>
 
 class TransientInitialStateEstimator;
 
@@ -70,6 +71,12 @@ namespace cms {
 
     unsigned int maxSeedsBeforeCleaning_;
 
+    // concurrent building: the seeds are split in chunks processed by independent tasks,
+    // each with its own builder and seed cleaner (chunk 0 uses theTrajectoryBuilder and theSeedCleaner)
+    unsigned int theNumberOfSeedChunks;
+    std::vector<std::unique_ptr<BaseCkfTrajectoryBuilder> > theChunkTrajectoryBuilders;
+    std::vector<std::unique_ptr<RedundantSeedCleaner> > theChunkSeedCleaners;
+
     edm::EDGetTokenT<edm::View<TrajectorySeed> > theSeedLabel;
     edm::EDGetTokenT<MeasurementTrackerEvent> theMTELabel;
 
@@ -17,6 +17,9 @@ ckfTrackCandidates = cms.EDProducer("CkfTrackCandidateMaker",
 #    SeedLabel = cms.string(''),
     maxNSeeds = cms.uint32(500000),
     maxSeedsBeforeCleaning = cms.uint32(5000),
+# Build the seeds in this many chunks processed by concurrent tasks (1: serial building).
+# Each chunk has its own builder and seed cleaner, the results are merged in seed order before the final cleaning.
+    numberOfSeedChunks = cms.uint32(1),
 # SeedProducer:SeedLabel descoped to src
     src = cms.InputTag('globalMixedSeeds'),                                  
     SimpleMagneticField = cms.string(''),                                    
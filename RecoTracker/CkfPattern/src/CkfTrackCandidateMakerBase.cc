@@ -34,15 +34,15 @@
 
 #include <algorithm>
 #include <functional>
+#include <iterator>
 
 // #define VI_SORTSEED
 // #define VI_REPRODUCIBLE
 // #define VI_TBB
 
+#include <mutex>
 #include <thread>
-#ifdef VI_TBB
 #include "tbb/parallel_for.h"
-#endif
 
 #include "RecoTracker/CkfPattern/interface/PrintoutHelper.h"
 
@@ -54,6 +54,22 @@ namespace {
                                                                            edm::ConsumesCollector& iC) {
     return BaseCkfTrajectoryBuilderFactory::get()->create(pset.getParameter<std::string>("ComponentType"), pset, iC);
   }
+
+  std::unique_ptr<RedundantSeedCleaner> createRedundantSeedCleaner(const edm::ParameterSet& conf) {
+    std::string cleaner = conf.getParameter<std::string>("RedundantSeedCleaner");
+    if (cleaner == "CachingSeedCleanerBySharedInput") {
+      int numHitsForSeedCleaner =
+          conf.existsAs<int>("numHitsForSeedCleaner") ? conf.getParameter<int>("numHitsForSeedCleaner") : 4;
+      int onlyPixelHits = conf.existsAs<bool>("onlyPixelHitsForSeedCleaner")
+                              ? conf.getParameter<bool>("onlyPixelHitsForSeedCleaner")
+                              : false;
+      return std::make_unique<CachingSeedCleanerBySharedInput>(numHitsForSeedCleaner, onlyPixelHits);
+    } else if (cleaner != "none") {
+      throw cms::Exception("RedundantSeedCleaner not found, please use CachingSeedCleanerBySharedInput ro none",
+                           cleaner);
+    }
+    return nullptr;
+  }
 }  // namespace
 
 namespace cms {
@@ -77,6 +93,9 @@ namespace cms {
         theNavigationSchoolName(conf.getParameter<std::string>("NavigationSchool")),
         theNavigationSchool(nullptr),
         maxSeedsBeforeCleaning_(0),
+        theNumberOfSeedChunks(conf.existsAs<unsigned int>("numberOfSeedChunks")
+                                  ? std::max(1U, conf.getParameter<unsigned int>("numberOfSeedChunks"))
+                                  : 1U),
         theMTELabel(iC.consumes<MeasurementTrackerEvent>(conf.getParameter<edm::InputTag>("MeasurementTrackerEvent"))),
         skipClusters_(false),
         phase2skipClusters_(false) {
@@ -97,20 +116,16 @@ namespace cms {
       maskPhase2OTs_ = iC.consumes<Phase2OTClusterMask>(conf.getParameter<edm::InputTag>("phase2clustersToSkip"));
     }
 #ifndef VI_REPRODUCIBLE
-    std::string cleaner = conf.getParameter<std::string>("RedundantSeedCleaner");
-    if (cleaner == "CachingSeedCleanerBySharedInput") {
-      int numHitsForSeedCleaner =
-          conf.existsAs<int>("numHitsForSeedCleaner") ? conf.getParameter<int>("numHitsForSeedCleaner") : 4;
-      int onlyPixelHits = conf.existsAs<bool>("onlyPixelHitsForSeedCleaner")
-                              ? conf.getParameter<bool>("onlyPixelHitsForSeedCleaner")
-                              : false;
-      theSeedCleaner = std::make_unique<CachingSeedCleanerBySharedInput>(numHitsForSeedCleaner, onlyPixelHits);
-    } else if (cleaner != "none") {
-      throw cms::Exception("RedundantSeedCleaner not found, please use CachingSeedCleanerBySharedInput ro none",
-                           cleaner);
-    }
+    theSeedCleaner = createRedundantSeedCleaner(conf);
 #endif
 
+    // concurrent building: chunk 0 uses the main builder and seed cleaner, the others get their own copies
+    for (unsigned int i = 1; i < theNumberOfSeedChunks; ++i) {
+      theChunkTrajectoryBuilders.push_back(
+          createBaseCkfTrajectoryBuilder(conf.getParameter<edm::ParameterSet>("TrajectoryBuilderPSet"), iC));
+      theChunkSeedCleaners.push_back(theSeedCleaner ? createRedundantSeedCleaner(conf) : nullptr);
+    }
+
 #ifdef VI_REPRODUCIBLE
     std::cout << "CkfTrackCandidateMaker in reproducible setting" << std::endl;
     assert(nullptr == theSeedCleaner);
@@ -139,6 +154,8 @@ namespace cms {
     es.get<NavigationSchoolRecord>().get(theNavigationSchoolName, navigationSchoolH);
     theNavigationSchool = navigationSchoolH.product();
     theTrajectoryBuilder->setNavigationSchool(theNavigationSchool);
+    for (auto& builder : theChunkTrajectoryBuilders)
+      builder->setNavigationSchool(theNavigationSchool);
   }
 
   // Functions that gets called by framework every event
@@ -161,6 +178,7 @@ namespace cms {
     e.getByToken(theMTELabel, data);
 
     std::unique_ptr<MeasurementTrackerEvent> dataWithMasks;
+    const MeasurementTrackerEvent* measurementTrackerEvent = &*data;
     if (skipClusters_) {
       edm::Handle<PixelClusterMask> pixelMask;
       e.getByToken(maskPixels_, pixelMask);
@@ -168,7 +186,7 @@ namespace cms {
       e.getByToken(maskStrips_, stripMask);
       dataWithMasks = std::make_unique<MeasurementTrackerEvent>(*data, *stripMask, *pixelMask);
       //std::cout << "Trajectory builder " << conf_.getParameter<std::string>("@module_label") << " created with masks " << std::endl;
-      theTrajectoryBuilder->setEvent(e, es, &*dataWithMasks);
+      measurementTrackerEvent = &*dataWithMasks;
     } else if (phase2skipClusters_) {
       //FIXME:just temporary solution for phase2!
       edm::Handle<PixelClusterMask> pixelMask;
@@ -177,11 +195,11 @@ namespace cms {
       e.getByToken(maskPhase2OTs_, phase2OTMask);
       dataWithMasks = std::make_unique<MeasurementTrackerEvent>(*data, *pixelMask, *phase2OTMask);
       //std::cout << "Trajectory builder " << conf_.getParameter<std::string>("@module_label") << " created with phase2 masks " << std::endl;
-      theTrajectoryBuilder->setEvent(e, es, &*dataWithMasks);
-    } else {
-      //std::cout << "Trajectory builder " << conf_.getParameter<std::string>("@module_label") << " created without masks " << std::endl;
-      theTrajectoryBuilder->setEvent(e, es, &*data);
+      measurementTrackerEvent = &*dataWithMasks;
     }
+    theTrajectoryBuilder->setEvent(e, es, measurementTrackerEvent);
+    for (auto& builder : theChunkTrajectoryBuilders)
+      builder->setEvent(e, es, measurementTrackerEvent);
     // TISE ES must be set here due to dependence on theTrajectoryBuilder
     theInitialState->setEventSetup(
         es, static_cast<TkTransientTrackingRecHitBuilder const*>(theTrajectoryBuilder->hitBuilder())->cloner());
@@ -211,18 +229,9 @@ namespace cms {
 
     // Step D: Invoke the building algorithm
     if (!(*collseed).empty()) {
-      unsigned int lastCleanResult = 0;
-      std::vector<Trajectory> rawResult;
-      rawResult.reserve(collseed->size() * 4);
-
-      if (theSeedCleaner)
-        theSeedCleaner->init(&rawResult);
-
       // method for debugging
       countSeedsDebugger();
 
-      // the mutex
-      std::mutex theMutex;
       using Lock = std::unique_lock<std::mutex>;
 
       // Loop over seeds
@@ -263,8 +272,33 @@ namespace cms {
       // std::cout << spt(indeces[0]) << ' ' << spt(indeces[collseed_size-1]) << std::endl;
 #endif
 
+      // The seeds are split in contiguous chunks, each built by its own builder and seed cleaner into its own
+      // raw result. By default there is a single chunk holding all the seeds.
+      struct SeedChunk {
+        const BaseCkfTrajectoryBuilder* builder = nullptr;
+        RedundantSeedCleaner* seedCleaner = nullptr;
+        size_t begin = 0, end = 0;
+        std::vector<Trajectory> rawResult;
+        unsigned int lastCleanResult = 0;
+        std::mutex mutex;
+      };
+      const auto nChunks = std::min<size_t>(theNumberOfSeedChunks, collseed_size);
+      std::vector<SeedChunk> chunks(nChunks);
+      for (auto ic = 0U; ic < nChunks; ++ic) {
+        auto& chunk = chunks[ic];
+        chunk.builder = ic == 0 ? theTrajectoryBuilder.get() : theChunkTrajectoryBuilders[ic - 1].get();
+        chunk.seedCleaner = ic == 0 ? theSeedCleaner.get() : theChunkSeedCleaners[ic - 1].get();
+        chunk.begin = ic * collseed_size / nChunks;
+        chunk.end = (ic + 1) * collseed_size / nChunks;
+        chunk.rawResult.reserve((chunk.end - chunk.begin) * 4);
+      }
+      if (nChunks > 1)
+        measurementTrackerEvent->prepareForConcurrentAccess();
+
       std::atomic<unsigned int> ntseed(0);
-      auto theLoop = [&](size_t ii) {
+      auto theLoop = [&](SeedChunk& chunk, size_t ii) {
+        auto& theMutex = chunk.mutex;
+        auto& rawResult = chunk.rawResult;
         auto j = indeces[ii];
 
         ntseed++;
@@ -277,7 +311,7 @@ namespace cms {
         {
           Lock lock(theMutex);
           // Check if seed hits already used by another track
-          if (theSeedCleaner && !theSeedCleaner->good(&((*collseed)[j]))) {
+          if (chunk.seedCleaner && !chunk.seedCleaner->good(&((*collseed)[j]))) {
             LogDebug("CkfTrackCandidateMakerBase") << " Seed cleaning kills seed " << j;
             (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
             return;  // from the lambda!
@@ -288,7 +322,7 @@ namespace cms {
         theTmpTrajectories.clear();
         unsigned int nCandPerSeed = 0;
         auto const& startTraj =
-            theTrajectoryBuilder->buildTrajectories((*collseed)[j], theTmpTrajectories, nCandPerSeed, nullptr);
+            chunk.builder->buildTrajectories((*collseed)[j], theTmpTrajectories, nCandPerSeed, nullptr);
         {
           Lock lock(theMutex);
           (*outputSeedStopInfos)[j].setCandidatesPerSeed(nCandPerSeed);
@@ -315,7 +349,7 @@ namespace cms {
         // seed and if possible further inwards.
 
         if (doSeedingRegionRebuilding) {
-          theTrajectoryBuilder->rebuildTrajectories(startTraj, (*collseed)[j], theTmpTrajectories);
+          chunk.builder->rebuildTrajectories(startTraj, (*collseed)[j], theTmpTrajectories);
 
           LogDebug("CkfPattern") << "======== Out-in trajectory building found " << theTmpTrajectories.size()
                                  << " valid/invalid trajectories from seed " << j << " ========\n"
@@ -344,8 +378,8 @@ namespace cms {
               rawResult.push_back(std::move(*it));
               // Tell seed cleaner which hits this trajectory used.
               //TO BE FIXED: this cut should be configurable via cfi file
-              if (theSeedCleaner && rawResult.back().foundHits() > 3)
-                theSeedCleaner->add(&rawResult.back());
+              if (chunk.seedCleaner && rawResult.back().foundHits() > 3)
+                chunk.seedCleaner->add(&rawResult.back());
               //if (theSeedCleaner ) theSeedCleaner->add( & (*it) );
             }
           }
@@ -357,30 +391,55 @@ namespace cms {
 
         {
           Lock lock(theMutex);
-          if (maxSeedsBeforeCleaning_ > 0 && rawResult.size() > maxSeedsBeforeCleaning_ + lastCleanResult) {
+          if (maxSeedsBeforeCleaning_ > 0 && rawResult.size() > maxSeedsBeforeCleaning_ + chunk.lastCleanResult) {
             theTrajectoryCleaner->clean(rawResult);
-            rawResult.erase(
-                std::remove_if(rawResult.begin() + lastCleanResult, rawResult.end(), std::not_fn(&Trajectory::isValid)),
-                rawResult.end());
-            lastCleanResult = rawResult.size();
+            rawResult.erase(std::remove_if(rawResult.begin() + chunk.lastCleanResult,
+                                           rawResult.end(),
+                                           std::not_fn(&Trajectory::isValid)),
+                            rawResult.end());
+            chunk.lastCleanResult = rawResult.size();
           }
         }
       };
       // end of loop over seeds
 
+      for (auto& chunk : chunks)
+        if (chunk.seedCleaner)
+          chunk.seedCleaner->init(&chunk.rawResult);
+
+      if (nChunks > 1) {
+        // one task per chunk: the chunks share only read-only data and their own slots of outputSeedStopInfos
+        tbb::parallel_for(size_t(0), nChunks, size_t(1), [&](size_t ic) {
+          auto& chunk = chunks[ic];
+          for (size_t ii = chunk.begin; ii < chunk.end; ++ii)
+            theLoop(chunk, ii);
+        });
+      } else {
+        auto& chunk = chunks.front();
 #ifdef VI_TBB
-      tbb::parallel_for(0UL, collseed_size, 1UL, theLoop);
+        tbb::parallel_for(0UL, collseed_size, 1UL, [&](size_t ii) { theLoop(chunk, ii); });
 #else
 #ifdef VI_OMP
 #pragma omp parallel for schedule(dynamic, 4)
 #endif
-      for (size_t j = 0; j < collseed_size; j++) {
-        theLoop(j);
-      }
+        for (size_t j = 0; j < collseed_size; j++) {
+          theLoop(chunk, j);
+        }
 #endif
+      }
       assert(ntseed == collseed_size);
-      if (theSeedCleaner)
-        theSeedCleaner->done();
+      for (auto& chunk : chunks)
+        if (chunk.seedCleaner)
+          chunk.seedCleaner->done();
+
+      // merge the chunks in seed order, independently of the task scheduling
+      std::vector<Trajectory> rawResult = std::move(chunks.front().rawResult);
+      for (auto ic = 1U; ic < nChunks; ++ic) {
+        auto& chunkResult = chunks[ic].rawResult;
+        rawResult.insert(rawResult.end(),
+                         std::make_move_iterator(chunkResult.begin()),
+                         std::make_move_iterator(chunkResult.end()));
+      }
 
         // std::cout << "VICkfPattern " << "rawResult trajectories found = " << rawResult.size() << " in " << ntseed << " seeds " << collseed_size << std::endl;
 
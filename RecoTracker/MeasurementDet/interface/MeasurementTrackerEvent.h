@@ -38,6 +38,7 @@ public:
         thePhase2OTClustersToSkip(phase2OTClustersToSkip) {}
 
   /// Real constructor 2: with new cluster skips (checked)
+  /// The masks are not copied: the ContainerMask objects must outlive this object (as event products do)
   MeasurementTrackerEvent(const MeasurementTrackerEvent &trackerEvent,
                           const edm::ContainerMask<edmNew::DetSetVector<SiStripCluster> > &stripClustersToSkip,
                           const edm::ContainerMask<edmNew::DetSetVector<SiPixelCluster> > &pixelClustersToSkip);
@@ -57,9 +58,9 @@ public:
   const StMeasurementDetSet &stripData() const { return *theStripData; }
   const PxMeasurementDetSet &pixelData() const { return *thePixelData; }
   const Phase2OTMeasurementDetSet &phase2OTData() const { return *thePhase2OTData; }
-  const std::vector<bool> &stripClustersToSkip() const { return theStripClustersToSkip; }
-  const std::vector<bool> &pixelClustersToSkip() const { return thePixelClustersToSkip; }
-  const std::vector<bool> &phase2OTClustersToSkip() const { return thePhase2OTClustersToSkip; }
+  const std::vector<bool> &stripClustersToSkip() const { return *theStripMask; }
+  const std::vector<bool> &pixelClustersToSkip() const { return *thePixelMask; }
+  const std::vector<bool> &phase2OTClustersToSkip() const { return *thePhase2OTMask; }
 
   // forwarded calls
   const TrackingGeometry *geomTracker() const { return measurementTracker().geomTracker(); }
@@ -68,16 +69,26 @@ public:
   /// Previous MeasurementDetSystem interface
   MeasurementDetWithData idToDet(const DetId &id) const { return measurementTracker().idToDet(id, *this); }
 
+  /// Complete the on-demand unpacking of the strip data, to allow concurrent read access (e.g. by several CKF tasks)
+  void prepareForConcurrentAccess() const;
+
 private:
   const MeasurementTracker *theTracker = nullptr;
   const StMeasurementDetSet *theStripData = nullptr;
   const PxMeasurementDetSet *thePixelData = nullptr;
   const Phase2OTMeasurementDetSet *thePhase2OTData = nullptr;
   bool theOwner = false;  // do I own the tree above?
-  // these  could be const pointers as well, but ContainerMask doesn't expose the vector
+  // masks owned by the full-data event (constructor 1)
   std::vector<bool> theStripClustersToSkip;
   std::vector<bool> thePixelClustersToSkip;
   std::vector<bool> thePhase2OTClustersToSkip;
+  // masks in use: either the ones above, or shared read-only with the ContainerMask products
+  // (constructor 2), so that moving to the next tracking iteration does not copy them
+  const std::vector<bool> *theStripMask = &theStripClustersToSkip;
+  const std::vector<bool> *thePixelMask = &thePixelClustersToSkip;
+  const std::vector<bool> *thePhase2OTMask = &thePhase2OTClustersToSkip;
+
+  void moveMasksFrom(MeasurementTrackerEvent &other);
 };
 
 #endif  // MeasurementTrackerEvent_H
@@ -20,8 +20,7 @@ MeasurementTrackerEvent::MeasurementTrackerEvent(MeasurementTrackerEvent &&other
   thePhase2OTData = std::move(other.thePhase2OTData);
   theOwner = other.theOwner;
   other.theOwner = false;  // make sure to fully transfer the ownership
-  theStripClustersToSkip = std::move(other.theStripClustersToSkip);
-  thePixelClustersToSkip = std::move(other.thePixelClustersToSkip);
+  moveMasksFrom(other);
 }
 MeasurementTrackerEvent &MeasurementTrackerEvent::operator=(MeasurementTrackerEvent &&other) {
   theTracker = std::move(other.theTracker);
@@ -30,11 +29,26 @@ MeasurementTrackerEvent &MeasurementTrackerEvent::operator=(MeasurementTrackerEv
   thePhase2OTData = std::move(other.thePhase2OTData);
   theOwner = other.theOwner;
   other.theOwner = false;  // make sure to fully transfer the ownership
-  theStripClustersToSkip = std::move(other.theStripClustersToSkip);
-  thePixelClustersToSkip = std::move(other.thePixelClustersToSkip);
+  moveMasksFrom(other);
   return *this;
 }
 
+void MeasurementTrackerEvent::moveMasksFrom(MeasurementTrackerEvent &other) {
+  // shared masks are just pointed to, owned ones are moved and must then be pointed to here
+  auto moveMask = [](std::vector<bool> &mine,
+                     const std::vector<bool> *&myMask,
+                     std::vector<bool> &others,
+                     const std::vector<bool> *&othersMask) {
+    mine = std::move(others);
+    myMask = (othersMask == &others) ? &mine : othersMask;
+    others.clear();
+    othersMask = &others;
+  };
+  moveMask(theStripClustersToSkip, theStripMask, other.theStripClustersToSkip, other.theStripMask);
+  moveMask(thePixelClustersToSkip, thePixelMask, other.thePixelClustersToSkip, other.thePixelMask);
+  moveMask(thePhase2OTClustersToSkip, thePhase2OTMask, other.thePhase2OTClustersToSkip, other.thePhase2OTMask);
+}
+
 MeasurementTrackerEvent::MeasurementTrackerEvent(
     const MeasurementTrackerEvent &trackerEvent,
     const edm::ContainerMask<edmNew::DetSetVector<SiStripCluster> > &stripClustersToSkip,
@@ -61,11 +75,8 @@ MeasurementTrackerEvent::MeasurementTrackerEvent(
         << pixelClustersToSkip.refProd().id() << "!=" << thePixelData->handle().id() << "\n";
   }
 
-  theStripClustersToSkip.resize(stripClustersToSkip.size());
-  stripClustersToSkip.copyMaskTo(theStripClustersToSkip);
-
-  thePixelClustersToSkip.resize(pixelClustersToSkip.size());
-  pixelClustersToSkip.copyMaskTo(thePixelClustersToSkip);
+  theStripMask = &stripClustersToSkip.maskVector();
+  thePixelMask = &pixelClustersToSkip.maskVector();
 }
 
 //FIXME:just temporary solution for phase2!
@@ -94,9 +105,11 @@ MeasurementTrackerEvent::MeasurementTrackerEvent(
         << pixelClustersToSkip.refProd().id() << "!=" << thePixelData->handle().id() << "\n";
   }
 
-  thePixelClustersToSkip.resize(pixelClustersToSkip.size());
-  pixelClustersToSkip.copyMaskTo(thePixelClustersToSkip);
+  thePixelMask = &pixelClustersToSkip.maskVector();
+  thePhase2OTMask = &phase2OTClustersToSkip.maskVector();
+}
 
-  thePhase2OTClustersToSkip.resize(phase2OTClustersToSkip.size());
-  phase2OTClustersToSkip.copyMaskTo(thePhase2OTClustersToSkip);
+void MeasurementTrackerEvent::prepareForConcurrentAccess() const {
+  if (theStripData)
+    theStripData->getAllDetSets();
 }
@@ -213,6 +213,14 @@ public:
     return detSet_[i];
   }
 
+  /// Resolve all the det sets not yet accessed: after this call detSet() does not modify the object anymore,
+  /// so that it can be read concurrently
+  void getAllDetSets() const {
+    for (int i = 0, n = size(); i < n; ++i)
+      if (ready_[i])
+        const_cast<StMeasurementDetSet*>(this)->getDetSet(i);
+  }
+
   //// ------- pieces for on-demand unpacking --------
   std::vector<uint32_t>& rawInactiveStripDetIds() { return theRawInactiveStripDetIds_; }
   const std::vector<uint32_t>& rawInactiveStripDetIds() const { return theRawInactiveStripDetIds_; }
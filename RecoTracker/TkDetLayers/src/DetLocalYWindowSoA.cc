@@ -0,0 +1,31 @@
+#include "DetLocalYWindowSoA.h"
+
+#include "TrackingTools/DetLayers/interface/DetLayerException.h"
+
+#include <string>
+
+DetLocalYWindowSoA::DetLocalYWindowSoA(const std::vector<const GeomDet*>& dets) {
+  const auto n = dets.size();
+  if (n > maxSize)
+    throw DetLayerException("DetLocalYWindowSoA: " + std::to_string(n) + " dets in a sub-rod, at most " +
+                            std::to_string(maxSize) + " are supported");
+  x_.reserve(n);
+  y_.reserve(n);
+  z_.reserve(n);
+  yx_.reserve(n);
+  yy_.reserve(n);
+  yz_.reserve(n);
+  halfLength_.reserve(n);
+  for (auto det : dets) {
+    const auto& surface = det->surface();
+    const auto& pos = surface.position();
+    const auto& rot = surface.rotation();
+    x_.push_back(pos.x());
+    y_.push_back(pos.y());
+    z_.push_back(pos.z());
+    yx_.push_back(rot.yx());
+    yy_.push_back(rot.yy());
+    yz_.push_back(rot.yz());
+    halfLength_.push_back(0.5f * surface.bounds().length());
+  }
+}
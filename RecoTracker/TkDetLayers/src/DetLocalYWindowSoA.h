@@ -0,0 +1,56 @@
+#ifndef TkDetLayers_DetLocalYWindowSoA_h
+#define TkDetLayers_DetLocalYWindowSoA_h
+
+#include "Geometry/CommonDetUnit/interface/GeomDet.h"
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+/** Flat, structure-of-arrays copy of the surface parameters needed to check if a window along the
+ *  local y of the dets of a rod (or blade) overlaps with the det: position, local y axis and half length.
+ *  It is built once together with the rod, so that the window query runs over all the dets in a single
+ *  vectorizable loop, without going through the GeomDet surfaces and their (virtual) bounds.
+ */
+
+#pragma GCC visibility push(hidden)
+class DetLocalYWindowSoA {
+public:
+  /// maximal number of dets in a sub-rod, the query result has a fixed size so that it can live on the stack
+  static constexpr unsigned int maxSize = 32;
+  using Mask = std::array<bool, maxSize>;
+
+  DetLocalYWindowSoA() {}
+  explicit DetLocalYWindowSoA(const std::vector<const GeomDet*>& dets);
+
+  unsigned int size() const { return halfLength_.size(); }
+
+  /// check if the window around crossPoint overlaps with the dets (with a 1% margin added);
+  /// only the first size() elements of overlaps are set
+  void overlaps(const GlobalPoint& crossPoint, float window, Mask& overlaps) const {
+    constexpr float relativeMargin = 1.01;
+    const float cx = crossPoint.x(), cy = crossPoint.y(), cz = crossPoint.z();
+    const unsigned int n = size();
+    const float* __restrict__ px = x_.data();
+    const float* __restrict__ py = y_.data();
+    const float* __restrict__ pz = z_.data();
+    const float* __restrict__ yx = yx_.data();
+    const float* __restrict__ yy = yy_.data();
+    const float* __restrict__ yz = yz_.data();
+    const float* __restrict__ hl = halfLength_.data();
+#pragma GCC ivdep
+    for (unsigned int i = 0; i < n; ++i) {
+      float localY = yx[i] * (cx - px[i]) + yy[i] * (cy - py[i]) + yz[i] * (cz - pz[i]);
+      overlaps[i] = (std::abs(localY) - window) < relativeMargin * hl[i];
+    }
+  }
+
+private:
+  std::vector<float> x_, y_, z_;     // surface position
+  std::vector<float> yx_, yy_, yz_;  // local y axis in the global frame
+  std::vector<float> halfLength_;
+};
+#pragma GCC visibility pop
+
+#endif
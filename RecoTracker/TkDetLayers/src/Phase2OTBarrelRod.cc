@@ -47,6 +47,8 @@ Phase2OTBarrelRod::Phase2OTBarrelRod(vector<const GeomDet*>& innerDets,
 
   theInnerBinFinder = BinFinderType(theInnerDets.begin(), theInnerDets.end());
   theOuterBinFinder = BinFinderType(theOuterDets.begin(), theOuterDets.end());
+  theInnerWindowSoA = DetLocalYWindowSoA(theInnerDets);
+  theOuterWindowSoA = DetLocalYWindowSoA(theOuterDets);
 
 #ifdef EDM_ML_DEBUG
   LogDebug("TkDetLayers") << "==== DEBUG Phase2OTBarrelRod =====";
@@ -212,31 +214,6 @@ float Phase2OTBarrelRod::computeWindowSize(const GeomDet* det,
   return est.maximalLocalDisplacement(tsos, det->surface()).y();
 }
 
-namespace {
-
-  inline bool overlap(const GlobalPoint& crossPoint, const GeomDet& det, float window) {
-    // check if the z window around TSOS overlaps with the detector theDet (with a 1% margin added)
-
-    //   const float tolerance = 0.1;
-    constexpr float relativeMargin = 1.01;
-
-    LocalPoint localCrossPoint(det.surface().toLocal(crossPoint));
-    //   if (std::abs(localCrossPoint.z()) > tolerance) {
-    //     edm::LogInfo(TkDetLayers) << "TOBRod::overlap calculation assumes point on surface, but it is off by "
-    // 	 << localCrossPoint.z() ;
-    //   }
-
-    float localY = localCrossPoint.y();
-    float detHalfLength = 0.5f * det.surface().bounds().length();
-
-    //   edm::LogInfo(TkDetLayers) << "TOBRod::overlap: Det at " << det.position() << " hit at " << localY
-    //        << " Window " << window << " halflength "  << detHalfLength ;
-
-    return (std::abs(localY) - window) < relativeMargin * detHalfLength;
-  }
-
-}  // namespace
-
 void Phase2OTBarrelRod::searchNeighbors(const TrajectoryStateOnSurface& tsos,
                                         const Propagator& prop,
                                         const MeasurementEstimator& est,
@@ -250,6 +227,11 @@ void Phase2OTBarrelRod::searchNeighbors(const TrajectoryStateOnSurface& tsos,
   const vector<const GeomDet*>& sRod(subRod(crossing.subLayerIndex()));
   const vector<const GeomDet*>& sBrotherRod(subRodBrothers(crossing.subLayerIndex()));
 
+  // the window is checked at once on all the dets of the sub-rod
+  const DetLocalYWindowSoA& sRodWindow(subRodWindowSoA(crossing.subLayerIndex()));
+  DetLocalYWindowSoA::Mask overlaps;
+  sRodWindow.overlaps(gCrossingPos, window, overlaps);
+
   int closestIndex = crossing.closestDetIndex();
   int negStartIndex = closestIndex - 1;
   int posStartIndex = closestIndex + 1;
@@ -264,7 +246,7 @@ void Phase2OTBarrelRod::searchNeighbors(const TrajectoryStateOnSurface& tsos,
 
   typedef CompatibleDetToGroupAdder Adder;
   for (int idet = negStartIndex; idet >= 0; idet--) {
-    if (!overlap(gCrossingPos, *sRod[idet], window))
+    if (!overlaps[idet])
       break;
     if (!Adder::add(*sRod[idet], tsos, prop, est, result))
       break;
@@ -272,7 +254,7 @@ void Phase2OTBarrelRod::searchNeighbors(const TrajectoryStateOnSurface& tsos,
     Adder::add(*sBrotherRod[idet], tsos, prop, est, brotherresult);
   }
   for (int idet = posStartIndex; idet < static_cast<int>(sRod.size()); idet++) {
-    if (!overlap(gCrossingPos, *sRod[idet], window))
+    if (!overlaps[idet])
       break;
     if (!Adder::add(*sRod[idet], tsos, prop, est, result))
       break;
@@ -5,6 +5,7 @@
 #include "TrackingTools/DetLayers/interface/DetRod.h"
 #include "Utilities/BinningTools/interface/GenericBinFinderInZ.h"
 #include "SubLayerCrossings.h"
+#include "DetLocalYWindowSoA.h"
 
 /** A concrete implementation for TOB Rod 
  *  
@@ -65,6 +66,10 @@ private:
 
   const std::vector<const GeomDet*>& subRod(int ind) const { return (ind == 0 ? theInnerDets : theOuterDets); }
 
+  const DetLocalYWindowSoA& subRodWindowSoA(int ind) const {
+    return (ind == 0 ? theInnerWindowSoA : theOuterWindowSoA);
+  }
+
   const std::vector<const GeomDet*>& subRodBrothers(int ind) const {
     return (ind == 0 ? theInnerDetBrothers : theOuterDetBrothers);
   }
@@ -81,6 +86,9 @@ private:
 
   BinFinderType theInnerBinFinder;
   BinFinderType theOuterBinFinder;
+
+  DetLocalYWindowSoA theInnerWindowSoA;
+  DetLocalYWindowSoA theOuterWindowSoA;
 };
 
 #pragma GCC visibility pop
@@ -5,6 +5,7 @@
 #include "TrackingTools/DetLayers/interface/DetRod.h"
 #include "TrackingTools/DetLayers/interface/PeriodicBinFinderInZ.h"
 #include "SubLayerCrossings.h"
+#include "DetLocalYWindowSoA.h"
 
 /** A concrete implementation for TOB Rod 
  *  
@@ -60,6 +61,10 @@ private:
 
   const std::vector<const GeomDet*>& subRod(int ind) const { return (ind == 0 ? theInnerDets : theOuterDets); }
 
+  const DetLocalYWindowSoA& subRodWindowSoA(int ind) const {
+    return (ind == 0 ? theInnerWindowSoA : theOuterWindowSoA);
+  }
+
 private:
   std::vector<const GeomDet*> theDets;
   std::vector<const GeomDet*> theInnerDets;
@@ -70,6 +75,9 @@ private:
 
   BinFinderType theInnerBinFinder;
   BinFinderType theOuterBinFinder;
+
+  DetLocalYWindowSoA theInnerWindowSoA;
+  DetLocalYWindowSoA theOuterWindowSoA;
 };
 
 #pragma GCC visibility pop
@@ -149,6 +149,11 @@ public:
 
   std::vector<TransientVertex> vertices(const std::vector<reco::TransientTrack> &tracks, const int verbosity = 0) const;
 
+  // full annealing sequence starting from a single prototype, returns the final beta
+  double anneal(track_t &tks, vertex_t &y, double &rho0) const;
+  // same result, but with the z-sorted tracks split in overlapping blocks annealed concurrently
+  double annealInBlocks(track_t &tks, vertex_t &y, double &rho0) const;
+
   track_t fill(const std::vector<reco::TransientTrack> &tracks) const;
 
   double update(double beta, track_t &gtracks, vertex_t &gvertices, bool useRho0, const double &rho0) const;
@@ -179,6 +184,10 @@ private:
   double uniquetrkweight_;
   double zmerge_;
   double betapurge_;
+
+  bool runInBlocks_;
+  unsigned int block_size_;
+  double overlap_frac_;
 };
 
 //#ifndef DAClusterizerInZ_new_h
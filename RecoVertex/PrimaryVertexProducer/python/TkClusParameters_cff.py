@@ -11,7 +11,10 @@ DA_vectParameters = cms.PSet(
         d0CutOff = cms.double(3.),        # downweight high IP tracks 
         dzCutOff = cms.double(3.),        # outlier rejection after freeze-out (T<Tmin)       
         zmerge = cms.double(1e-2),        # merge intermediat clusters separated by less than zmerge
-        uniquetrkweight = cms.double(0.8) # require at least two tracks with this weight at T=Tpurge
+        uniquetrkweight = cms.double(0.8),# require at least two tracks with this weight at T=Tpurge
+        runInBlocks = cms.bool(False),    # anneal z-sorted blocks of tracks concurrently
+        block_size = cms.uint32(512),     # number of tracks per block
+        overlap_frac = cms.double(0.5)    # fraction of tracks shared by neighbouring blocks
         )
 )
 
@@ -45,6 +48,9 @@ DA2D_vectParameters = cms.PSet(
         t0Max = cms.double(1.0),          # outlier rejection for use of timing information
         zmerge = cms.double(1e-2),        # merge intermediat clusters separated by less than zmerge and tmerge
         tmerge = cms.double(1e-1),        # merge intermediat clusters separated by less than zmerge and tmerge
-        uniquetrkweight = cms.double(0.8) # require at least two tracks with this weight at T=Tpurge
+        uniquetrkweight = cms.double(0.8),# require at least two tracks with this weight at T=Tpurge
+        runInBlocks = cms.bool(False),    # anneal z-sorted blocks of tracks concurrently
+        block_size = cms.uint32(512),     # number of tracks per block
+        overlap_frac = cms.double(0.5)    # fraction of tracks shared by neighbouring blocks
         )
 )
@@ -7,8 +7,11 @@
 #include <cassert>
 #include <limits>
 #include <iomanip>
+#include <numeric>
+#include <algorithm>
 #include "FWCore/Utilities/interface/isFinite.h"
 #include "vdt/vdtMath.h"
+#include "tbb/parallel_for.h"
 
 using namespace std;
 //#define VI_DEBUG
@@ -42,6 +45,9 @@ DAClusterizerInZT_vect::DAClusterizerInZT_vect(const edm::ParameterSet& conf) {
   uniquetrkweight_ = conf.getParameter<double>("uniquetrkweight");
   zmerge_ = conf.getParameter<double>("zmerge");
   tmerge_ = conf.getParameter<double>("tmerge");
+  runInBlocks_ = conf.existsAs<bool>("runInBlocks") ? conf.getParameter<bool>("runInBlocks") : false;
+  block_size_ = conf.existsAs<unsigned int>("block_size") ? conf.getParameter<unsigned int>("block_size") : 512;
+  overlap_frac_ = conf.existsAs<double>("overlap_frac") ? conf.getParameter<double>("overlap_frac") : 0.5;
 
 #ifdef VI_DEBUG
   if (verbose_) {
@@ -58,9 +64,19 @@ DAClusterizerInZT_vect::DAClusterizerInZT_vect(const edm::ParameterSet& conf) {
     std::cout << "DAClusterizerinZT_vect: d0CutOff = " << d0CutOff_ << std::endl;
     std::cout << "DAClusterizerinZT_vect: dzCutOff = " << dzCutOff_ << std::endl;
     std::cout << "DAClusterizerinZT_vect: dtCutoff = " << dtCutOff_ << std::endl;
+    std::cout << "DAClusterizerinZT_vect: runInBlocks = " << runInBlocks_ << std::endl;
+    std::cout << "DAClusterizerinZT_vect: block_size = " << block_size_ << std::endl;
+    std::cout << "DAClusterizerinZT_vect: overlap_frac = " << overlap_frac_ << std::endl;
   }
 #endif
 
+  if (runInBlocks_ && ((block_size_ < 2) || (overlap_frac_ < 0) || (overlap_frac_ >= 1))) {
+    edm::LogWarning("DAClusterizerinZT_vectorized")
+        << "DAClusterizerInZT: invalid block_size " << block_size_ << " or overlap_frac " << overlap_frac_
+        << ", blocks switched off";
+    runInBlocks_ = false;
+  }
+
   if (minT == 0) {
     edm::LogWarning("DAClusterizerinZT_vectorized")
         << "DAClusterizerInZT: invalid Tmin" << minT << "  reset do default " << 1. / betamax_;
@@ -814,19 +830,8 @@ void DAClusterizerInZT_vect::splitAll(vertex_t& y) const {
 #endif
 }
 
-vector<TransientVertex> DAClusterizerInZT_vect::vertices(const vector<reco::TransientTrack>& tracks,
-                                                         const int verbosity) const {
-  track_t&& tks = fill(tracks);
-  tks.extractRaw();
-
-  unsigned int nt = tks.getSize();
-  double rho0 = 0.0;  // start with no outlier rejection
-
-  vector<TransientVertex> clusters;
-  if (tks.getSize() == 0)
-    return clusters;
-
-  vertex_t y;  // the vertex prototypes
+double DAClusterizerInZT_vect::anneal(track_t& tks, vertex_t& y, double& rho0) const {
+  const unsigned int nt = tks.getSize();
 
   // initialize:single vertex at infinite temperature
   y.addItem(0, 0, 1.0);
@@ -995,6 +1000,121 @@ vector<TransientVertex> DAClusterizerInZT_vect::vertices(const vector<reco::Tran
   }
 #endif
 
+  return beta;
+}
+
+double DAClusterizerInZT_vect::annealInBlocks(track_t& tks, vertex_t& y, double& rho0) const {
+  // the z-sorted tracks are split in blocks of block_size_ tracks overlapping by overlap_frac_,
+  // annealed independently and concurrently. Each block keeps the prototypes found in the core of its z range
+  // (up to the middle of the overlaps) and the merged prototypes are relaxed with all the tracks at the final
+  // temperature. The result does not depend on the task scheduling.
+  const unsigned int nt = tks.getSize();
+
+  std::vector<unsigned int> order(nt);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(
+      order.begin(), order.end(), [&tks](unsigned int a, unsigned int b) { return tks.z_[a] < tks.z_[b]; });
+
+  const unsigned int step = std::max(1U, static_cast<unsigned int>(block_size_ * (1. - overlap_frac_)));
+  std::vector<unsigned int> blockBegin;
+  for (unsigned int b = 0;; b += step) {
+    blockBegin.push_back(b);
+    if (b + block_size_ >= nt)
+      break;
+  }
+  const unsigned int nBlocks = blockBegin.size();
+  auto blockEnd = [&](unsigned int ib) { return (ib + 1 == nBlocks) ? nt : blockBegin[ib] + block_size_; };
+
+  // core of each block: from the middle of the overlap with the previous block to the middle of the next one
+  std::vector<double> zcore(nBlocks + 1);
+  zcore.front() = -std::numeric_limits<double>::max();
+  zcore.back() = std::numeric_limits<double>::max();
+  for (unsigned int ib = 1; ib < nBlocks; ++ib) {
+    unsigned int mid = (blockBegin[ib] + blockEnd(ib - 1)) / 2;
+    zcore[ib] = 0.5 * (tks.z_[order[mid - 1]] + tks.z_[order[mid]]);
+  }
+
+  std::vector<vertex_t> blockVertices(nBlocks);
+  std::vector<double> blockBeta(nBlocks);
+  tbb::parallel_for(0U, nBlocks, [&](unsigned int ib) {
+    track_t blockTracks;
+    for (unsigned int i = blockBegin[ib]; i < blockEnd(ib); ++i) {
+      const unsigned int it = order[i];
+      blockTracks.addItem(tks.z_[it], tks.t_[it], tks.dz2_[it], tks.dt2_[it], tks.tt[it], tks.pi_[it]);
+    }
+    blockTracks.extractRaw();
+    double blockRho0 = 0.0;
+    blockBeta[ib] = anneal(blockTracks, blockVertices[ib], blockRho0);
+  });
+
+  // merge the block prototypes, the weights are rescaled to the full track sample
+  double beta = *std::max_element(blockBeta.begin(), blockBeta.end());
+  for (unsigned int ib = 0; ib < nBlocks; ++ib) {
+    const vertex_t& yb = blockVertices[ib];
+    const double scale = double(blockEnd(ib) - blockBegin[ib]) / nt;
+    for (unsigned int k = 0; k < yb.getSize(); ++k) {
+      if ((yb.z_[k] >= zcore[ib]) && (yb.z_[k] < zcore[ib + 1])) {
+        y.addItem(yb.z_[k], yb.t_[k], yb.pk_[k] * scale);
+      }
+    }
+  }
+
+  if (y.getSize() == 0) {
+    edm::LogWarning("DAClusterizerinZT_vectorized")
+        << "no prototype left after merging the blocks, annealing all tracks";
+    return anneal(tks, y, rho0);
+  }
+
+#ifdef VI_DEBUG
+  if (verbose_) {
+    std::cout << "merged " << nBlocks << " blocks into " << y.getSize() << " prototypes" << std::endl;
+  }
+#endif
+
+  // relax at the final temperature with all the tracks, then clean up duplicates near the block boundaries
+  if (dzCutOff_ > 0) {
+    rho0 = 1. / nt;
+  }
+  int niter = 0;
+  while ((update(beta, tks, y, true, rho0) > 1.e-6) && (niter++ < maxIterations_)) {
+  }
+  zorder(y);
+  while (merge(y, beta)) {
+    update(beta, tks, y, true, rho0);
+  }
+  while (purge(y, tks, rho0, beta)) {
+    niter = 0;
+    while ((update(beta, tks, y, true, rho0) > 1.e-6) && (niter++ < maxIterations_)) {
+      zorder(y);
+    }
+  }
+
+#ifdef VI_DEBUG
+  if (verbose_) {
+    std::cout << "Final result after merging the blocks, rho0=" << std::scientific << rho0 << endl;
+    dump(beta, y, tks, 2);
+  }
+#endif
+
+  return beta;
+}
+
+vector<TransientVertex> DAClusterizerInZT_vect::vertices(const vector<reco::TransientTrack>& tracks,
+                                                         const int verbosity) const {
+  track_t&& tks = fill(tracks);
+  tks.extractRaw();
+
+  unsigned int nt = tks.getSize();
+  double rho0 = 0.0;  // start with no outlier rejection
+
+  vector<TransientVertex> clusters;
+  if (tks.getSize() == 0)
+    return clusters;
+
+  vertex_t y;  // the vertex prototypes
+
+  double beta = (runInBlocks_ && (nt > block_size_)) ? annealInBlocks(tks, y, rho0) : anneal(tks, y, rho0);
+
   // new, merge here and not in "clusterize"
   // final merging step
   double betadummy = 1;
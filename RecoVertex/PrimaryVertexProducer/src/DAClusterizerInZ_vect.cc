@@ -7,8 +7,11 @@
 #include <cassert>
 #include <limits>
 #include <iomanip>
+#include <numeric>
+#include <algorithm>
 #include "FWCore/Utilities/interface/isFinite.h"
 #include "vdt/vdtMath.h"
+#include "tbb/parallel_for.h"
 
 using namespace std;
 
@@ -37,6 +40,9 @@ DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
   dzCutOff_ = conf.getParameter<double>("dzCutOff");
   uniquetrkweight_ = conf.getParameter<double>("uniquetrkweight");
   zmerge_ = conf.getParameter<double>("zmerge");
+  runInBlocks_ = conf.existsAs<bool>("runInBlocks") ? conf.getParameter<bool>("runInBlocks") : false;
+  block_size_ = conf.existsAs<unsigned int>("block_size") ? conf.getParameter<unsigned int>("block_size") : 512;
+  overlap_frac_ = conf.existsAs<double>("overlap_frac") ? conf.getParameter<double>("overlap_frac") : 0.5;
 
   if (verbose_) {
     std::cout << "DAClusterizerinZ_vect: mintrkweight = " << mintrkweight_ << std::endl;
@@ -49,6 +55,16 @@ DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
     std::cout << "DAClusterizerinZ_vect: coolingFactor = " << coolingFactor_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: d0CutOff = " << d0CutOff_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: dzCutOff = " << dzCutOff_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: runInBlocks = " << runInBlocks_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: block_size = " << block_size_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: overlap_frac = " << overlap_frac_ << std::endl;
+  }
+
+  if (runInBlocks_ && ((block_size_ < 2) || (overlap_frac_ < 0) || (overlap_frac_ >= 1))) {
+    edm::LogWarning("DAClusterizerinZ_vectorized")
+        << "DAClusterizerInZ: invalid block_size " << block_size_ << " or overlap_frac " << overlap_frac_
+        << ", blocks switched off";
+    runInBlocks_ = false;
   }
 
   if (Tmin == 0) {
@@ -536,19 +552,8 @@ void DAClusterizerInZ_vect::splitAll(vertex_t& y) const {
   }
 }
 
-vector<TransientVertex> DAClusterizerInZ_vect::vertices(const vector<reco::TransientTrack>& tracks,
-                                                        const int verbosity) const {
-  track_t&& tks = fill(tracks);
-  tks.ExtractRaw();
-
-  unsigned int nt = tks.GetSize();
-  double rho0 = 0.0;  // start with no outlier rejection
-
-  vector<TransientVertex> clusters;
-  if (tks.GetSize() == 0)
-    return clusters;
-
-  vertex_t y;  // the vertex prototypes
+double DAClusterizerInZ_vect::anneal(track_t& tks, vertex_t& y, double& rho0) const {
+  const unsigned int nt = tks.GetSize();
 
   // initialize:single vertex at infinite temperature
   y.AddItem(0, 1.0);
@@ -688,6 +693,115 @@ vector<TransientVertex> DAClusterizerInZ_vect::vertices(const vector<reco::Trans
     dump(beta, y, tks, 2);
   }
 
+  return beta;
+}
+
+double DAClusterizerInZ_vect::annealInBlocks(track_t& tks, vertex_t& y, double& rho0) const {
+  // the z-sorted tracks are split in blocks of block_size_ tracks overlapping by overlap_frac_,
+  // annealed independently and concurrently. Each block keeps the prototypes found in the core of its z range
+  // (up to the middle of the overlaps) and the merged prototypes are relaxed with all the tracks at the final
+  // temperature. The result does not depend on the task scheduling.
+  const unsigned int nt = tks.GetSize();
+
+  std::vector<unsigned int> order(nt);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(
+      order.begin(), order.end(), [&tks](unsigned int a, unsigned int b) { return tks._z[a] < tks._z[b]; });
+
+  const unsigned int step = std::max(1U, static_cast<unsigned int>(block_size_ * (1. - overlap_frac_)));
+  std::vector<unsigned int> blockBegin;
+  for (unsigned int b = 0;; b += step) {
+    blockBegin.push_back(b);
+    if (b + block_size_ >= nt)
+      break;
+  }
+  const unsigned int nBlocks = blockBegin.size();
+  auto blockEnd = [&](unsigned int ib) { return (ib + 1 == nBlocks) ? nt : blockBegin[ib] + block_size_; };
+
+  // core of each block: from the middle of the overlap with the previous block to the middle of the next one
+  std::vector<double> zcore(nBlocks + 1);
+  zcore.front() = -std::numeric_limits<double>::max();
+  zcore.back() = std::numeric_limits<double>::max();
+  for (unsigned int ib = 1; ib < nBlocks; ++ib) {
+    unsigned int mid = (blockBegin[ib] + blockEnd(ib - 1)) / 2;
+    zcore[ib] = 0.5 * (tks._z[order[mid - 1]] + tks._z[order[mid]]);
+  }
+
+  std::vector<vertex_t> blockVertices(nBlocks);
+  std::vector<double> blockBeta(nBlocks);
+  tbb::parallel_for(0U, nBlocks, [&](unsigned int ib) {
+    track_t blockTracks;
+    for (unsigned int i = blockBegin[ib]; i < blockEnd(ib); ++i) {
+      const unsigned int it = order[i];
+      blockTracks.AddItem(tks._z[it], tks._dz2[it], tks.tt[it], tks._pi[it]);
+    }
+    blockTracks.ExtractRaw();
+    double blockRho0 = 0.0;
+    blockBeta[ib] = anneal(blockTracks, blockVertices[ib], blockRho0);
+  });
+
+  // merge the block prototypes, in z order; the weights are rescaled to the full track sample
+  double beta = *std::max_element(blockBeta.begin(), blockBeta.end());
+  for (unsigned int ib = 0; ib < nBlocks; ++ib) {
+    const vertex_t& yb = blockVertices[ib];
+    const double scale = double(blockEnd(ib) - blockBegin[ib]) / nt;
+    for (unsigned int k = 0; k < yb.GetSize(); ++k) {
+      if ((yb._z[k] >= zcore[ib]) && (yb._z[k] < zcore[ib + 1])) {
+        y.AddItem(yb._z[k], yb._pk[k] * scale);
+      }
+    }
+  }
+
+  if (y.GetSize() == 0) {
+    edm::LogWarning("DAClusterizerinZ_vectorized")
+        << "no prototype left after merging the blocks, annealing all tracks";
+    return anneal(tks, y, rho0);
+  }
+
+  if (verbose_) {
+    std::cout << "merged " << nBlocks << " blocks into " << y.GetSize() << " prototypes" << std::endl;
+  }
+
+  // relax at the final temperature with all the tracks, then clean up duplicates near the block boundaries
+  if (dzCutOff_ > 0) {
+    rho0 = 1. / nt;
+  }
+  int niter = 0;
+  while ((update(beta, tks, y, true, rho0) > 1.e-6) && (niter++ < maxIterations_)) {
+  }
+  while (merge(y, beta)) {
+    update(beta, tks, y, true, rho0);
+  }
+  while (purge(y, tks, rho0, beta)) {
+    niter = 0;
+    while ((update(beta, tks, y, true, rho0) > 1.e-6) && (niter++ < maxIterations_)) {
+    }
+  }
+
+  if (verbose_) {
+    std::cout << "Final result after merging the blocks, rho0=" << std::scientific << rho0 << endl;
+    dump(beta, y, tks, 2);
+  }
+
+  return beta;
+}
+
+vector<TransientVertex> DAClusterizerInZ_vect::vertices(const vector<reco::TransientTrack>& tracks,
+                                                        const int verbosity) const {
+  track_t&& tks = fill(tracks);
+  tks.ExtractRaw();
+
+  unsigned int nt = tks.GetSize();
+  double rho0 = 0.0;  // start with no outlier rejection
+
+  vector<TransientVertex> clusters;
+  if (tks.GetSize() == 0)
+    return clusters;
+
+  vertex_t y;  // the vertex prototypes
+
+  double beta = (runInBlocks_ && (nt > block_size_)) ? annealInBlocks(tks, y, rho0) : anneal(tks, y, rho0);
+
   // select significant tracks and use a TransientVertex as a container
   GlobalError dummyError(0.01, 0, 0.01, 0., 0., 0.01);
 
@@ -0,0 +1,138 @@
+/* Unit test for the block annealing of DAClusterizerInZ_vect and DAClusterizerInZT_vect:
+   the prototypes found on a fixed set of tracks must be the same with and without blocks
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZ_vect.h"
+#include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZT_vect.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+class testDAClusterizerBlocks : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(testDAClusterizerBlocks);
+  CPPUNIT_TEST(testZ);
+  CPPUNIT_TEST(testZT);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown() {}
+
+  void testZ();
+  void testZT();
+
+private:
+  edm::ParameterSet parameters(bool blocks, bool timing) const;
+  void compare(const std::vector<double>& ref, const std::vector<double>& blocks) const;
+
+  static constexpr unsigned int nvertices = 60;
+  static constexpr unsigned int ntracksPerVertex = 20;
+  // several blocks of tracks, so that the merging near the boundaries is exercised
+  static constexpr unsigned int blockSize = 256;
+  // the relaxation with all the tracks at the final temperature brings the prototypes to the same minimum
+  static constexpr double tolerance = 1.e-3;  // cm
+
+  std::vector<double> z_, t_, dz2_, dt2_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testDAClusterizerBlocks);
+
+void testDAClusterizerBlocks::setUp() {
+  // well separated vertices along the luminous region, tracks with 100 um in z and 35 ps in t
+  const double sigmaz = 0.01, sigmat = 0.035;
+  std::mt19937 engine(1234);
+  std::normal_distribution<double> gaus(0., 1.);
+  z_.clear();
+  t_.clear();
+  for (unsigned int iv = 0; iv < nvertices; ++iv) {
+    const double zv = -15. + 30. * (iv + 0.5) / nvertices;
+    const double tv = 0.2 * gaus(engine);
+    for (unsigned int it = 0; it < ntracksPerVertex; ++it) {
+      z_.push_back(zv + sigmaz * gaus(engine));
+      t_.push_back(tv + sigmat * gaus(engine));
+    }
+  }
+  // the clusterizers add the intrinsic vertex size in quadrature, as in fill()
+  dz2_.assign(z_.size(), 1. / (sigmaz * sigmaz + 0.006 * 0.006));
+  dt2_.assign(t_.size(), 1. / (sigmat * sigmat + 0.008 * 0.008));
+}
+
+edm::ParameterSet testDAClusterizerBlocks::parameters(bool blocks, bool timing) const {
+  // TkDAClusParameters of DA_vectParameters and DA2D_vectParameters
+  edm::ParameterSet ps;
+  ps.addParameter<double>("coolingFactor", 0.6);
+  ps.addParameter<double>("Tmin", timing ? 4.0 : 2.0);
+  ps.addParameter<double>("Tpurge", timing ? 4.0 : 2.0);
+  ps.addParameter<double>("Tstop", timing ? 2.0 : 0.5);
+  ps.addParameter<double>("vertexSize", 0.006);
+  ps.addParameter<double>("d0CutOff", 3.);
+  ps.addParameter<double>("dzCutOff", 3.);
+  ps.addParameter<double>("zmerge", 1e-2);
+  ps.addParameter<double>("uniquetrkweight", 0.8);
+  if (timing) {
+    ps.addParameter<double>("vertexSizeTime", 0.008);
+    ps.addParameter<double>("dtCutOff", 4.);
+    ps.addParameter<double>("t0Max", 1.0);
+    ps.addParameter<double>("tmerge", 1e-1);
+  }
+  ps.addParameter<bool>("runInBlocks", blocks);
+  ps.addParameter<unsigned int>("block_size", blockSize);
+  ps.addParameter<double>("overlap_frac", 0.5);
+  return ps;
+}
+
+void testDAClusterizerBlocks::compare(const std::vector<double>& ref, const std::vector<double>& blocks) const {
+  CPPUNIT_ASSERT_EQUAL(ref.size(), blocks.size());
+  for (unsigned int k = 0; k < ref.size(); ++k) {
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(ref[k], blocks[k], tolerance);
+  }
+}
+
+void testDAClusterizerBlocks::testZ() {
+  std::vector<double> zref, zblocks;
+  for (bool blocks : {false, true}) {
+    DAClusterizerInZ_vect clusterizer(parameters(blocks, false));
+    DAClusterizerInZ_vect::track_t tks;
+    for (unsigned int i = 0; i < z_.size(); ++i)
+      tks.AddItem(z_[i], dz2_[i], nullptr, 1.);
+    tks.ExtractRaw();
+    DAClusterizerInZ_vect::vertex_t y;
+    double rho0 = 0.;
+    if (blocks)
+      clusterizer.annealInBlocks(tks, y, rho0);
+    else
+      clusterizer.anneal(tks, y, rho0);
+    auto& z = blocks ? zblocks : zref;
+    z = y.z;
+    std::sort(z.begin(), z.end());
+  }
+  CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(nvertices), zref.size());
+  compare(zref, zblocks);
+}
+
+void testDAClusterizerBlocks::testZT() {
+  std::vector<double> zref, zblocks;
+  for (bool blocks : {false, true}) {
+    DAClusterizerInZT_vect clusterizer(parameters(blocks, true));
+    DAClusterizerInZT_vect::track_t tks;
+    for (unsigned int i = 0; i < z_.size(); ++i)
+      tks.addItem(z_[i], t_[i], dz2_[i], dt2_[i], nullptr, 1.);
+    tks.extractRaw();
+    DAClusterizerInZT_vect::vertex_t y;
+    double rho0 = 0.;
+    if (blocks)
+      clusterizer.annealInBlocks(tks, y, rho0);
+    else
+      clusterizer.anneal(tks, y, rho0);
+    auto& z = blocks ? zblocks : zref;
+    z = y.z;
+    std::sort(z.begin(), z.end());
+  }
+  CPPUNIT_ASSERT_EQUAL(static_cast<size_t>(nvertices), zref.size());
+  compare(zref, zblocks);
+}
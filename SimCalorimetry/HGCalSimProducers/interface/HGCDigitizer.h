@@ -19,8 +19,6 @@
 #include "Geometry/HcalTowerAlgo/interface/HcalGeometry.h"
 
 #include <vector>
-#include <map>
-#include <unordered_set>
 #include <memory>
 #include <tuple>
 
@@ -84,7 +82,6 @@ public:
   void endRun();
 
 private:
-  uint32_t getType() const;
   bool getWeight(std::array<float, 3>& tdcForToAOnset, float& keV2fC) const;
 
   //input/output names
@@ -108,7 +105,6 @@ private:
   int maxSimHitsAccTime_;
   double bxTime_, ev_per_eh_pair_;
   std::unique_ptr<hgc::HGCSimHitDataAccumulator> simHitAccumulator_;
-  void resetSimHitDataAccumulator();
 
   //debug position
   void checkPosition(const HGCalDigiCollection* digis) const;
@@ -120,7 +116,6 @@ private:
   std::unique_ptr<HFNoseDigitizer> theHFNoseDigitizer_;
 
   //geometries
-  std::unordered_set<DetId> validIds_;
   const HGCalGeometry* gHGCal_;
   const HcalGeometry* gHcal_;
 
@@ -137,13 +132,10 @@ private:
   //delay to apply after evaluating time of arrival at the sensitive detector
   float tofDelay_;
 
-  //average occupancies
-  std::array<double, 4> averageOccupancies_;
-  uint32_t nEvents_;
-
   std::vector<float> cce_;
 
-  std::map<uint32_t, std::vector<std::pair<float, float> > > hitRefs_bx0;
+  //in-time (charge, time of flight) references, by dense cell index of the accumulator
+  std::vector<std::vector<std::pair<float, float> > > hitRefs_bx0;
 };
 
 #endif
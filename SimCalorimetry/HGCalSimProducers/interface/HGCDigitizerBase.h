@@ -5,8 +5,6 @@
 #include <iostream>
 #include <vector>
 #include <memory>
-#include <unordered_map>
-#include <unordered_set>
 
 #include "DataFormats/HGCDigi/interface/HGCDigiCollections.h"
 #include "FWCore/Utilities/interface/EDMException.h"
@@ -72,7 +70,6 @@ public:
   void run(std::unique_ptr<DColl>& digiColl,
            hgc::HGCSimHitDataAccumulator& simData,
            const CaloSubdetectorGeometry* theGeom,
-           const std::unordered_set<DetId>& validIds,
            uint32_t digitizationType,
            CLHEP::HepRandomEngine* engine);
 
@@ -90,7 +87,6 @@ public:
   void runSimple(std::unique_ptr<DColl>& coll,
                  hgc::HGCSimHitDataAccumulator& simData,
                  const CaloSubdetectorGeometry* theGeom,
-                 const std::unordered_set<DetId>& validIds,
                  CLHEP::HepRandomEngine* engine);
 
   /**
@@ -104,7 +100,6 @@ public:
   virtual void runDigitizer(std::unique_ptr<DColl>& coll,
                             hgc::HGCSimHitDataAccumulator& simData,
                             const CaloSubdetectorGeometry* theGeom,
-                            const std::unordered_set<DetId>& validIds,
                             uint32_t digitizerType,
                             CLHEP::HepRandomEngine* engine) {
     throw cms::Exception("HGCDigitizerBaseException") << " Failed to find specialization of runDigitizer";
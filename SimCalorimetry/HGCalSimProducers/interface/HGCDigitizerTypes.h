@@ -1,9 +1,10 @@
 #ifndef __SimCalorimetry_HGCCalSimProducers_HGCDigitizerTypes_h__
 #define __SimCalorimetry_HGCCalSimProducers_HGCDigitizerTypes_h__
 
-#include <unordered_map>
+#include <algorithm>
 #include <array>
 #include <functional>
+#include <vector>
 
 #include "DataFormats/DetId/interface/DetId.h"
 
@@ -23,7 +24,112 @@ namespace hgc_digi {
     double size;
   };
 
-  typedef std::unordered_map<uint32_t, HGCCellInfo> HGCSimHitDataAccumulator;
+  /**
+     @short accumulator of the sim hit data of all the valid cells of a detector
+
+     The cells are stored in a flat array, indexed by the position of their DetId
+     among the valid ones of the geometry (sorted by raw id). The cells filled in
+     an event are listed, so that only they are reset for the next event.
+   */
+  class HGCSimHitDataAccumulator {
+  public:
+    /**
+       @short sets the valid cells, all of them empty
+     */
+    void setValidIds(const std::vector<DetId>& validIds) {
+      ids_.clear();
+      ids_.reserve(validIds.size());
+      for (const auto& id : validIds)
+        ids_.push_back(id.rawId());
+      std::sort(ids_.begin(), ids_.end());
+      ids_.erase(std::unique(ids_.begin(), ids_.end()), ids_.end());
+
+      cells_.assign(ids_.size(), HGCCellInfo());
+      filledFlags_.assign(ids_.size(), 0);
+      filled_.clear();
+    }
+
+    /**
+       @short releases the memory of the cells
+     */
+    void clearValidIds() {
+      std::vector<uint32_t>().swap(ids_);
+      std::vector<HGCCellInfo>().swap(cells_);
+      std::vector<char>().swap(filledFlags_);
+      std::vector<uint32_t>().swap(filled_);
+    }
+
+    size_t nCells() const { return ids_.size(); }
+    DetId id(uint32_t index) const { return DetId(ids_[index]); }
+
+    /**
+       @short dense index of a valid cell, -1 if the cell is not valid
+     */
+    int index(uint32_t rawId) const {
+      auto it = std::lower_bound(ids_.begin(), ids_.end(), rawId);
+      return (it != ids_.end() && *it == rawId) ? it - ids_.begin() : -1;
+    }
+
+    /**
+       @short as above, for raw ids looked up in increasing order: the search
+       starts from the index found in the previous call, which is kept in hint
+     */
+    int index(uint32_t rawId, uint32_t& hint) const {
+      if (hint >= ids_.size() || ids_[hint] > rawId)
+        hint = 0;
+      // exponential search for the range holding rawId, then binary search within it
+      uint32_t step = 1;
+      uint32_t last = hint;
+      while (last + step < ids_.size() && ids_[last + step] < rawId) {
+        last += step;
+        step *= 2;
+      }
+      auto begin = ids_.begin() + last;
+      auto end = ids_.begin() + std::min<size_t>(last + step + 1, ids_.size());
+      auto it = std::lower_bound(begin, end, rawId);
+      hint = it - ids_.begin();
+      return (it != ids_.end() && *it == rawId) ? hint : -1;
+    }
+
+    /**
+       @short cell to be filled, which is reset with the next call to reset()
+     */
+    HGCCellInfo& fill(uint32_t index) {
+      if (!filledFlags_[index]) {
+        filledFlags_[index] = 1;
+        filled_.push_back(index);
+      }
+      return cells_[index];
+    }
+
+    HGCCellInfo& operator[](uint32_t index) { return cells_[index]; }
+    const HGCCellInfo& operator[](uint32_t index) const { return cells_[index]; }
+
+    /**
+       @short dense indices of the cells filled since the last reset, in the order they were filled
+     */
+    const std::vector<uint32_t>& filled() const { return filled_; }
+    size_t size() const { return filled_.size(); }
+    bool empty() const { return filled_.empty(); }
+
+    /**
+       @short empties the filled cells
+     */
+    void reset() {
+      for (uint32_t index : filled_) {
+        cells_[index].hit_info[0].fill(0.f);
+        cells_[index].hit_info[1].fill(0.f);
+        filledFlags_[index] = 0;
+      }
+      filled_.clear();
+    }
+
+  private:
+    std::vector<uint32_t> ids_;
+    std::vector<HGCCellInfo> cells_;
+    std::vector<char> filledFlags_;
+    std::vector<uint32_t> filled_;
+  };
 
 }  // namespace hgc_digi
 #endif
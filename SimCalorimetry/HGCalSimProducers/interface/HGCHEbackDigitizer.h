@@ -41,7 +41,6 @@ public:
   void runDigitizer(std::unique_ptr<HGCalDigiCollection>& digiColl,
                     hgc::HGCSimHitDataAccumulator& simData,
                     const CaloSubdetectorGeometry* theGeom,
-                    const std::unordered_set<DetId>& validIds,
                     uint32_t digitizationType,
                     CLHEP::HepRandomEngine* engine) override;
   ~HGCHEbackDigitizer() override;
@@ -58,19 +57,16 @@ private:
   void runEmptyDigitizer(std::unique_ptr<HGCalDigiCollection>& digiColl,
                          hgc::HGCSimHitDataAccumulator& simData,
                          const CaloSubdetectorGeometry* theGeom,
-                         const std::unordered_set<DetId>& validIds,
                          CLHEP::HepRandomEngine* engine);
 
   void runRealisticDigitizer(std::unique_ptr<HGCalDigiCollection>& digiColl,
                              hgc::HGCSimHitDataAccumulator& simData,
                              const CaloSubdetectorGeometry* theGeom,
-                             const std::unordered_set<DetId>& validIds,
                              CLHEP::HepRandomEngine* engine);
 
   void runCaliceLikeDigitizer(std::unique_ptr<HGCalDigiCollection>& digiColl,
                               hgc::HGCSimHitDataAccumulator& simData,
                               const CaloSubdetectorGeometry* theGeom,
-                              const std::unordered_set<DetId>& validIds,
                               CLHEP::HepRandomEngine* engine);
 };
 
@@ -10,7 +10,6 @@ public:
   void runDigitizer(std::unique_ptr<HGCalDigiCollection>& digiColl,
                     hgc::HGCSimHitDataAccumulator& simData,
                     const CaloSubdetectorGeometry* theGeom,
-                    const std::unordered_set<DetId>& validIds,
                     uint32_t digitizationType,
                     CLHEP::HepRandomEngine* engine) override;
   ~HGCHEfrontDigitizer() override;
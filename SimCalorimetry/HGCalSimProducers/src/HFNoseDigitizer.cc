@@ -9,7 +9,6 @@ HFNoseDigitizer::HFNoseDigitizer(const edm::ParameterSet& ps) : HGCDigitizerBase
 void HFNoseDigitizer::runDigitizer(std::unique_ptr<HGCalDigiCollection>& digiColl,
                                    HGCSimHitDataAccumulator& simData,
                                    const CaloSubdetectorGeometry* theGeom,
-                                   const std::unordered_set<DetId>& validIds,
                                    uint32_t digitizationType,
                                    CLHEP::HepRandomEngine* engine) {}
 
@@ -29,8 +29,6 @@ using namespace hgc_digi;
 
 namespace {
 
-  constexpr std::array<double, 4> occupancyGuesses = {{0.5, 0.2, 0.2, 0.8}};
-
   float getPositionDistance(const HGCalGeometry* geom, const DetId& id) { return geom->getPosition(id).mag(); }
 
   float getPositionDistance(const HcalGeometry* geom, const DetId& id) {
@@ -44,19 +42,14 @@ namespace {
 
   int getCellThickness(const HcalGeometry* geom, const DetId& detid) { return 1; }
 
-  void getValidDetIds(const HGCalGeometry* geom, std::unordered_set<DetId>& valid) {
-    const std::vector<DetId>& ids = geom->getValidDetIds();
-    valid.reserve(ids.size());
-    valid.insert(ids.begin(), ids.end());
-  }
+  void getValidDetIds(const HGCalGeometry* geom, std::vector<DetId>& valid) { valid = geom->getValidDetIds(); }
 
-  void getValidDetIds(const HcalGeometry* geom, std::unordered_set<DetId>& valid) {
+  void getValidDetIds(const HcalGeometry* geom, std::vector<DetId>& valid) {
     const std::vector<DetId>& ids = geom->getValidDetIds();
     for (const auto& id : ids) {
       if (HcalEndcap == id.subdetId() && DetId::Hcal == id.det())
-        valid.emplace(id);
+        valid.push_back(id);
     }
-    valid.reserve(valid.size());
   }
 
   DetId simToReco(const HcalGeometry* geom, unsigned simid) {
@@ -117,7 +110,6 @@ namespace {
   // Dumps the internals of the SimHit accumulator to the digis for premixing
   void saveSimHitAccumulator(PHGCSimAccumulator& simResult,
                              const hgc::HGCSimHitDataAccumulator& simData,
-                             const std::unordered_set<DetId>& validIds,
                              const float minCharge,
                              const float maxCharge) {
     constexpr auto nEnergies = std::tuple_size<decltype(hgc_digi::HGCCellInfo().hit_info)>::value;
@@ -130,15 +122,16 @@ namespace {
     const float maxPackChargeLog = std::log(maxCharge);
     constexpr uint16_t base = 1 << PHGCSimAccumulator::Data::sampleOffset;
 
-    simResult.reserve(simData.size());
-    // mimicing the digitization
-    for (const auto& id : validIds) {
-      auto found = simData.find(id);
-      if (found == simData.end())
-        continue;
+    // mimicing the digitization, in the order of the cells
+    std::vector<uint32_t> filled(simData.filled());
+    std::sort(filled.begin(), filled.end());
+
+    simResult.reserve(filled.size());
+    for (uint32_t idx : filled) {
+      const DetId id = simData.id(idx);
       // store only non-zero
       for (size_t iEn = 0; iEn < nEnergies; ++iEn) {
-        const auto& samples = found->second.hit_info[iEn];
+        const auto& samples = simData[idx].hit_info[iEn];
         for (size_t iSample = 0; iSample < hgc_digi::nSamples; ++iSample) {
           if (samples[iSample] > minCharge) {
             const auto packed = logintpack::pack16log(samples[iSample], minPackChargeLog, maxPackChargeLog, base);
@@ -160,9 +153,13 @@ namespace {
     const float maxPackChargeLog = std::log(maxCharge);
     constexpr uint16_t base = 1 << PHGCSimAccumulator::Data::sampleOffset;
 
+    // the cells are saved in increasing order of the raw id
+    uint32_t hint = 0;
     for (const auto& detIdIndexHitInfo : simAccumulator) {
-      auto simIt = simData.emplace(detIdIndexHitInfo.detId(), HGCCellInfo()).first;
-      auto& hit_info = simIt->second.hit_info;
+      const int idx = simData.index(detIdIndexHitInfo.detId(), hint);
+      if (idx < 0)
+        continue;
+      auto& hit_info = simData.fill(idx).hit_info;
 
       size_t iEn = detIdIndexHitInfo.energyIndex();
       size_t iSample = detIdIndexHitInfo.sampleIndex();
@@ -183,9 +180,7 @@ HGCDigitizer::HGCDigitizer(const edm::ParameterSet& ps, edm::ConsumesCollector&
     : simHitAccumulator_(new HGCSimHitDataAccumulator()),
       myDet_(DetId::Forward),
       mySubDet_(ForwardSubdetector::ForwardEmpty),
-      refSpeed_(0.1 * CLHEP::c_light),  //[CLHEP::c_light]=mm/ns convert to cm/ns
-      averageOccupancies_(occupancyGuesses),
-      nEvents_(1) {
+      refSpeed_(0.1 * CLHEP::c_light) {  //[CLHEP::c_light]=mm/ns convert to cm/ns
   //configure from cfg
   hitCollection_ = ps.getParameter<std::string>("hitCollection");
   digiCollection_ = ps.getParameter<std::string>("digiCollection");
@@ -199,8 +194,6 @@ HGCDigitizer::HGCDigitizer(const edm::ParameterSet& ps, edm::ConsumesCollector&
   premixStage1MinCharge_ = ps.getParameter<double>("premixStage1MinCharge");
   premixStage1MaxCharge_ = ps.getParameter<double>("premixStage1MaxCharge");
 
-  std::unordered_set<DetId>().swap(validIds_);
-
   iC.consumes<std::vector<PCaloHit>>(edm::InputTag("g4SimHits", hitCollection_));
   const auto& myCfg_ = ps.getParameter<edm::ParameterSet>("digiCfg");
 
@@ -247,40 +240,27 @@ HGCDigitizer::HGCDigitizer(const edm::ParameterSet& ps, edm::ConsumesCollector&
 }
 
 //
-void HGCDigitizer::initializeEvent(edm::Event const& e, edm::EventSetup const& es) {
-  // reserve memory for a full detector
-  unsigned idx = getType();
-  simHitAccumulator_->reserve(averageOccupancies_[idx] * validIds_.size());
-}
+void HGCDigitizer::initializeEvent(edm::Event const& e, edm::EventSetup const& es) {}
 
 //
 void HGCDigitizer::finalizeEvent(edm::Event& e, edm::EventSetup const& es, CLHEP::HepRandomEngine* hre) {
-  hitRefs_bx0.clear();
+  for (uint32_t idx : simHitAccumulator_->filled())
+    hitRefs_bx0[idx].clear();
 
   const CaloSubdetectorGeometry* theGeom = (nullptr == gHGCal_ ? static_cast<const CaloSubdetectorGeometry*>(gHcal_)
                                                                : static_cast<const CaloSubdetectorGeometry*>(gHGCal_));
 
-  ++nEvents_;
-  unsigned idx = getType();
-  // release memory for unfilled parts of hash table
-  if (validIds_.size() * averageOccupancies_[idx] > simHitAccumulator_->size()) {
-    simHitAccumulator_->reserve(simHitAccumulator_->size());
-  }
-  //update occupancy guess
-  const double thisOcc = simHitAccumulator_->size() / ((double)validIds_.size());
-  averageOccupancies_[idx] = (averageOccupancies_[idx] * (nEvents_ - 1) + thisOcc) / nEvents_;
-
   if (premixStage1_) {
     std::unique_ptr<PHGCSimAccumulator> simResult;
     if (!simHitAccumulator_->empty()) {
       simResult = std::make_unique<PHGCSimAccumulator>();
-      saveSimHitAccumulator(*simResult, *simHitAccumulator_, validIds_, premixStage1MinCharge_, premixStage1MaxCharge_);
+      saveSimHitAccumulator(*simResult, *simHitAccumulator_, premixStage1MinCharge_, premixStage1MaxCharge_);
     }
     e.put(std::move(simResult), digiCollection());
   } else {
     if (producesEEDigis()) {
       auto digiResult = std::make_unique<HGCalDigiCollection>();
-      theHGCEEDigitizer_->run(digiResult, *simHitAccumulator_, theGeom, validIds_, digitizationType_, hre);
+      theHGCEEDigitizer_->run(digiResult, *simHitAccumulator_, theGeom, digitizationType_, hre);
       edm::LogVerbatim("HGCDigitizer") << "HGCDigitizer:: finalize event - produced " << digiResult->size()
                                        << " EE hits";
 #ifdef EDM_ML_DEBUG
@@ -290,7 +270,7 @@ void HGCDigitizer::finalizeEvent(edm::Event& e, edm::EventSetup const& es, CLHEP
     }
     if (producesHEfrontDigis()) {
       auto digiResult = std::make_unique<HGCalDigiCollection>();
-      theHGCHEfrontDigitizer_->run(digiResult, *simHitAccumulator_, theGeom, validIds_, digitizationType_, hre);
+      theHGCHEfrontDigitizer_->run(digiResult, *simHitAccumulator_, theGeom, digitizationType_, hre);
       edm::LogVerbatim("HGCDigitizer") << "HGCDigitizer:: finalize event - produced " << digiResult->size()
                                        << " HE silicon hits";
 #ifdef EDM_ML_DEBUG
@@ -300,7 +280,7 @@ void HGCDigitizer::finalizeEvent(edm::Event& e, edm::EventSetup const& es, CLHEP
     }
     if (producesHEbackDigis()) {
       auto digiResult = std::make_unique<HGCalDigiCollection>();
-      theHGCHEbackDigitizer_->run(digiResult, *simHitAccumulator_, theGeom, validIds_, digitizationType_, hre);
+      theHGCHEbackDigitizer_->run(digiResult, *simHitAccumulator_, theGeom, digitizationType_, hre);
       edm::LogVerbatim("HGCDigitizer") << "HGCDigitizer:: finalize event - produced " << digiResult->size()
                                        << " HE Scintillator hits";
 #ifdef EDM_ML_DEBUG
@@ -310,7 +290,7 @@ void HGCDigitizer::finalizeEvent(edm::Event& e, edm::EventSetup const& es, CLHEP
     }
     if (producesHFNoseDigis()) {
       auto digiResult = std::make_unique<HGCalDigiCollection>();
-      theHFNoseDigitizer_->run(digiResult, *simHitAccumulator_, theGeom, validIds_, digitizationType_, hre);
+      theHFNoseDigitizer_->run(digiResult, *simHitAccumulator_, theGeom, digitizationType_, hre);
       edm::LogVerbatim("HGCDigitizer") << "HGCDigitizer:: finalize event - produced " << digiResult->size()
                                        << " HFNose hits";
 #ifdef EDM_ML_DEBUG
@@ -320,7 +300,7 @@ void HGCDigitizer::finalizeEvent(edm::Event& e, edm::EventSetup const& es, CLHEP
     }
   }
 
-  hgc::HGCSimHitDataAccumulator().swap(*simHitAccumulator_);
+  simHitAccumulator_->reset();
 }
 
 //
@@ -403,7 +383,8 @@ void HGCDigitizer::accumulate(edm::Handle<edm::PCaloHitContainer> const& hits,
   }
   std::sort(hitRefs.begin(), hitRefs.end(), this->orderByDetIdThenTime);
 
-  //loop over sorted hits
+  //loop over sorted hits, looking up their cells in increasing order
+  uint32_t hint = 0;
   nchits = hitRefs.size();
   for (int i = 0; i < nchits; ++i) {
     const int hitidx = std::get<0>(hitRefs[i]);
@@ -411,9 +392,10 @@ void HGCDigitizer::accumulate(edm::Handle<edm::PCaloHitContainer> const& hits,
 
     //get the data for this cell, if not available then we skip it
 
-    if (!validIds_.count(id))
+    const int idx = simHitAccumulator_->index(id, hint);
+    if (idx < 0)
       continue;
-    HGCSimHitDataAccumulator::iterator simHitIt = simHitAccumulator_->emplace(id, HGCCellInfo()).first;
+    HGCCellInfo& cell = simHitAccumulator_->fill(idx);
 
     if (id == 0)
       continue;  // to be ignored at RECO level
@@ -438,63 +420,63 @@ void HGCDigitizer::accumulate(edm::Handle<edm::PCaloHitContainer> const& hits,
       continue;
 
     //check if time index is ok and store energy
-    if (itime >= (int)simHitIt->second.hit_info[0].size())
+    if (itime >= (int)cell.hit_info[0].size())
       continue;
 
-    (simHitIt->second).hit_info[0][itime] += charge;
+    cell.hit_info[0][itime] += charge;
 
     //working version with pileup only for in-time hits
     int waferThickness = getCellThickness(geom, id);
     bool orderChanged = false;
     if (itime == 9) {
-      if (hitRefs_bx0[id].empty()) {
-        hitRefs_bx0[id].emplace_back(charge, tof);
-      } else if (tof <= hitRefs_bx0[id].back().second) {
+      if (hitRefs_bx0[idx].empty()) {
+        hitRefs_bx0[idx].emplace_back(charge, tof);
+      } else if (tof <= hitRefs_bx0[idx].back().second) {
         std::vector<std::pair<float, float>>::iterator findPos =
-            std::upper_bound(hitRefs_bx0[id].begin(),
-                             hitRefs_bx0[id].end(),
+            std::upper_bound(hitRefs_bx0[idx].begin(),
+                             hitRefs_bx0[idx].end(),
                              std::pair<float, float>(0.f, tof),
                              [](const auto& i, const auto& j) { return i.second < j.second; });
 
-        std::vector<std::pair<float, float>>::iterator insertedPos = hitRefs_bx0[id].insert(
+        std::vector<std::pair<float, float>>::iterator insertedPos = hitRefs_bx0[idx].insert(
             findPos,
-            (findPos == hitRefs_bx0[id].begin()) ? std::pair<float, float>(charge, tof)
+            (findPos == hitRefs_bx0[idx].begin()) ? std::pair<float, float>(charge, tof)
                                                  : std::pair<float, float>((findPos - 1)->first + charge, tof));
 
-        for (std::vector<std::pair<float, float>>::iterator step = insertedPos + 1; step != hitRefs_bx0[id].end();
+        for (std::vector<std::pair<float, float>>::iterator step = insertedPos + 1; step != hitRefs_bx0[idx].end();
              ++step) {
           step->first += charge;
-          if (step->first > tdcForToAOnset[waferThickness - 1] && step->second != hitRefs_bx0[id].back().second) {
-            hitRefs_bx0[id].resize(std::upper_bound(hitRefs_bx0[id].begin(),
-                                                    hitRefs_bx0[id].end(),
+          if (step->first > tdcForToAOnset[waferThickness - 1] && step->second != hitRefs_bx0[idx].back().second) {
+            hitRefs_bx0[idx].resize(std::upper_bound(hitRefs_bx0[idx].begin(),
+                                                    hitRefs_bx0[idx].end(),
                                                     std::pair<float, float>(0.f, step->second),
                                                     [](const auto& i, const auto& j) { return i.second < j.second; }) -
-                                   hitRefs_bx0[id].begin());
-            for (auto stepEnd = step + 1; stepEnd != hitRefs_bx0[id].end(); ++stepEnd)
+                                   hitRefs_bx0[idx].begin());
+            for (auto stepEnd = step + 1; stepEnd != hitRefs_bx0[idx].end(); ++stepEnd)
               stepEnd->first += charge;
             break;
           }
         }
         orderChanged = true;
       } else {
-        if (hitRefs_bx0[id].back().first <= tdcForToAOnset[waferThickness - 1]) {
-          hitRefs_bx0[id].emplace_back(hitRefs_bx0[id].back().first + charge, tof);
+        if (hitRefs_bx0[idx].back().first <= tdcForToAOnset[waferThickness - 1]) {
+          hitRefs_bx0[idx].emplace_back(hitRefs_bx0[idx].back().first + charge, tof);
         }
       }
     }
 
-    float accChargeForToA = hitRefs_bx0[id].empty() ? 0.f : hitRefs_bx0[id].back().first;
+    float accChargeForToA = hitRefs_bx0[idx].empty() ? 0.f : hitRefs_bx0[idx].back().first;
 
     //time-of-arrival (check how to be used)
     if (weightToAbyEnergy)
-      (simHitIt->second).hit_info[1][itime] += charge * tof;
+      cell.hit_info[1][itime] += charge * tof;
     else if (accChargeForToA > tdcForToAOnset[waferThickness - 1] &&
-             ((simHitIt->second).hit_info[1][itime] == 0 || orderChanged == true)) {
-      float fireTDC = hitRefs_bx0[id].back().second;
-      if (hitRefs_bx0[id].size() > 1) {
+             (cell.hit_info[1][itime] == 0 || orderChanged == true)) {
+      float fireTDC = hitRefs_bx0[idx].back().second;
+      if (hitRefs_bx0[idx].size() > 1) {
         float chargeBeforeThr = 0.f;
         float tofchargeBeforeThr = 0.f;
-        for (const auto& step : hitRefs_bx0[id]) {
+        for (const auto& step : hitRefs_bx0[idx]) {
           if (step.first + chargeBeforeThr <= tdcForToAOnset[waferThickness - 1]) {
             chargeBeforeThr += step.first;
             tofchargeBeforeThr = step.second;
@@ -505,7 +487,7 @@ void HGCDigitizer::accumulate(edm::Handle<edm::PCaloHitContainer> const& hits,
         float deltaTOF = fireTDC - tofchargeBeforeThr;
         fireTDC = (tdcForToAOnset[waferThickness - 1] - chargeBeforeThr) * deltaTOF / deltaQ + tofchargeBeforeThr;
       }
-      (simHitIt->second).hit_info[1][itime] = fireTDC;
+      cell.hit_info[1][itime] = fireTDC;
     }
   }
   hitRefs.clear();
@@ -546,68 +528,26 @@ void HGCDigitizer::beginRun(const edm::EventSetup& es) {
 
   int nadded(0);
   //valid ID lists
+  std::vector<DetId> validIds;
   if (nullptr != gHGCal_) {
-    getValidDetIds(gHGCal_, validIds_);
+    getValidDetIds(gHGCal_, validIds);
   } else if (nullptr != gHcal_) {
-    getValidDetIds(gHcal_, validIds_);
+    getValidDetIds(gHcal_, validIds);
   } else {
     throw cms::Exception("BadConfiguration") << "HGCDigitizer is not producing EE, FH, or BH digis!";
   }
+  simHitAccumulator_->setValidIds(validIds);
+  hitRefs_bx0.assign(simHitAccumulator_->nCells(), std::vector<std::pair<float, float>>());
 
   if (verbosity_ > 0)
-    edm::LogInfo("HGCDigitizer") << "Added " << nadded << ":" << validIds_.size() << " detIds without "
+    edm::LogInfo("HGCDigitizer") << "Added " << nadded << ":" << simHitAccumulator_->nCells() << " detIds without "
                                  << hitCollection_ << " in first event processed" << std::endl;
 }
 
 //
-void HGCDigitizer::endRun() { std::unordered_set<DetId>().swap(validIds_); }
-
-//
-void HGCDigitizer::resetSimHitDataAccumulator() {
-  for (HGCSimHitDataAccumulator::iterator it = simHitAccumulator_->begin(); it != simHitAccumulator_->end(); it++) {
-    it->second.hit_info[0].fill(0.);
-    it->second.hit_info[1].fill(0.);
-  }
-}
-
-uint32_t HGCDigitizer::getType() const {
-  uint32_t idx = std::numeric_limits<unsigned>::max();
-  if (geometryType_ == 0) {
-    switch (mySubDet_) {
-      case ForwardSubdetector::HGCEE:
-        idx = 0;
-        break;
-      case ForwardSubdetector::HGCHEF:
-        idx = 1;
-        break;
-      case ForwardSubdetector::HGCHEB:
-        idx = 2;
-        break;
-      case ForwardSubdetector::HFNose:
-        idx = 3;
-        break;
-      default:
-        break;
-    }
-  } else {
-    switch (myDet_) {
-      case DetId::HGCalEE:
-        idx = 0;
-        break;
-      case DetId::HGCalHSi:
-        idx = 1;
-        break;
-      case DetId::HGCalHSc:
-        idx = 2;
-        break;
-      case DetId::Forward:
-        idx = 3;
-        break;
-      default:
-        break;
-    }
-  }
-  return idx;
+void HGCDigitizer::endRun() {
+  simHitAccumulator_->clearValidIds();
+  std::vector<std::vector<std::pair<float, float>>>().swap(hitRefs_bx0);
 }
 
 bool HGCDigitizer::getWeight(std::array<float, 3>& tdcForToAOnset, float& keV2fC) const {
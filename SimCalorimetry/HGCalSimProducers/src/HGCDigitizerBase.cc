@@ -42,33 +42,26 @@ template <class DFr>
 void HGCDigitizerBase<DFr>::run(std::unique_ptr<HGCDigitizerBase::DColl>& digiColl,
                                 HGCSimHitDataAccumulator& simData,
                                 const CaloSubdetectorGeometry* theGeom,
-                                const std::unordered_set<DetId>& validIds,
                                 uint32_t digitizationType,
                                 CLHEP::HepRandomEngine* engine) {
   if (digitizationType == 0)
-    runSimple(digiColl, simData, theGeom, validIds, engine);
+    runSimple(digiColl, simData, theGeom, engine);
   else
-    runDigitizer(digiColl, simData, theGeom, validIds, digitizationType, engine);
+    runDigitizer(digiColl, simData, theGeom, digitizationType, engine);
 }
 
 template <class DFr>
 void HGCDigitizerBase<DFr>::runSimple(std::unique_ptr<HGCDigitizerBase::DColl>& coll,
                                       HGCSimHitDataAccumulator& simData,
                                       const CaloSubdetectorGeometry* theGeom,
-                                      const std::unordered_set<DetId>& validIds,
                                       CLHEP::HepRandomEngine* engine) {
   HGCSimHitData chargeColl, toa;
 
-  // this represents a cell with no signal charge
-  HGCCellInfo zeroData;
-  zeroData.hit_info[0].fill(0.f);  //accumulated energy
-  zeroData.hit_info[1].fill(0.f);  //time-of-flight
-
-  for (const auto& id : validIds) {
+  for (uint32_t idx = 0; idx < simData.nCells(); ++idx) {
+    const DetId id = simData.id(idx);
     chargeColl.fill(0.f);
     toa.fill(0.f);
-    HGCSimHitDataAccumulator::iterator it = simData.find(id);
-    HGCCellInfo& cell = (simData.end() == it ? zeroData : it->second);
+    HGCCellInfo& cell = simData[idx];
     addCellMetadata(cell, theGeom, id);
 
     for (size_t i = 0; i < cell.hit_info[0].size(); i++) {
@@ -9,7 +9,6 @@ HGCEEDigitizer::HGCEEDigitizer(const edm::ParameterSet& ps) : HGCDigitizerBase(p
 void HGCEEDigitizer::runDigitizer(std::unique_ptr<HGCalDigiCollection>& digiColl,
                                   HGCSimHitDataAccumulator& simData,
                                   const CaloSubdetectorGeometry* theGeom,
-                                  const std::unordered_set<DetId>& validIds,
                                   uint32_t digitizationType,
                                   CLHEP::HepRandomEngine* engine) {}
 
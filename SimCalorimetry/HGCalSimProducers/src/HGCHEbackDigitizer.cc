@@ -148,33 +148,27 @@ HGCHEbackDigitizer::HGCHEbackDigitizer(const edm::ParameterSet& ps) : HGCDigitiz
 void HGCHEbackDigitizer::runDigitizer(std::unique_ptr<HGCalDigiCollection>& digiColl,
                                       HGCSimHitDataAccumulator& simData,
                                       const CaloSubdetectorGeometry* theGeom,
-                                      const std::unordered_set<DetId>& validIds,
                                       uint32_t digitizationType,
                                       CLHEP::HepRandomEngine* engine) {
   if (algo_ == 0)
-    runEmptyDigitizer(digiColl, simData, theGeom, validIds, engine);
+    runEmptyDigitizer(digiColl, simData, theGeom, engine);
   else if (algo_ == 1)
-    runCaliceLikeDigitizer(digiColl, simData, theGeom, validIds, engine);
+    runCaliceLikeDigitizer(digiColl, simData, theGeom, engine);
   else if (algo_ == 2)
-    runRealisticDigitizer(digiColl, simData, theGeom, validIds, engine);
+    runRealisticDigitizer(digiColl, simData, theGeom, engine);
 }
 
 void HGCHEbackDigitizer::runEmptyDigitizer(std::unique_ptr<HGCalDigiCollection>& digiColl,
                                            HGCSimHitDataAccumulator& simData,
                                            const CaloSubdetectorGeometry* theGeom,
-                                           const std::unordered_set<DetId>& validIds,
                                            CLHEP::HepRandomEngine* engine) {
   HGCSimHitData chargeColl, toa;
-  // this represents a cell with no signal charge
-  HGCCellInfo zeroData;
-  zeroData.hit_info[0].fill(0.f);  //accumulated energy
-  zeroData.hit_info[1].fill(0.f);  //time-of-flight
 
-  for (const auto& id : validIds) {
+  for (uint32_t idx = 0; idx < simData.nCells(); ++idx) {
+    const DetId id = simData.id(idx);
     chargeColl.fill(0.f);
     toa.fill(0.f);
-    HGCSimHitDataAccumulator::iterator it = simData.find(id);
-    HGCCellInfo& cell = (simData.end() == it ? zeroData : it->second);
+    HGCCellInfo& cell = simData[idx];
     addCellMetadata(cell, theGeom, id);
 
     for (size_t i = 0; i < cell.hit_info[0].size(); ++i) {
@@ -197,25 +191,20 @@ void HGCHEbackDigitizer::runEmptyDigitizer(std::unique_ptr<HGCalDigiCollection>&
 void HGCHEbackDigitizer::runRealisticDigitizer(std::unique_ptr<HGCalDigiCollection>& digiColl,
                                                HGCSimHitDataAccumulator& simData,
                                                const CaloSubdetectorGeometry* theGeom,
-                                               const std::unordered_set<DetId>& validIds,
                                                CLHEP::HepRandomEngine* engine) {
   //switch to true if you want to print some details
   constexpr bool debug(false);
 
   HGCSimHitData chargeColl, toa;
-  // this represents a cell with no signal charge
-  HGCCellInfo zeroData;
-  zeroData.hit_info[0].fill(0.f);  //accumulated energy
-  zeroData.hit_info[1].fill(0.f);  //time-of-flight
 
   // needed to compute the radiation and geometry scale factors
   scal_.setGeometry(theGeom);
 
-  for (const auto& id : validIds) {
+  for (uint32_t idx = 0; idx < simData.nCells(); ++idx) {
+    const DetId id = simData.id(idx);
     chargeColl.fill(0.f);
     toa.fill(0.f);
-    HGCSimHitDataAccumulator::iterator it = simData.find(id);
-    HGCCellInfo& cell = (simData.end() == it ? zeroData : it->second);
+    HGCCellInfo& cell = simData[idx];
     addCellMetadata(cell, theGeom, id);
 
     float scaledPePerMip = nPEperMIP_;           //needed to scale according to tile geometry
@@ -291,22 +280,16 @@ void HGCHEbackDigitizer::runRealisticDigitizer(std::unique_ptr<HGCalDigiCollecti
 void HGCHEbackDigitizer::runCaliceLikeDigitizer(std::unique_ptr<HGCalDigiCollection>& digiColl,
                                                 HGCSimHitDataAccumulator& simData,
                                                 const CaloSubdetectorGeometry* theGeom,
-                                                const std::unordered_set<DetId>& validIds,
                                                 CLHEP::HepRandomEngine* engine) {
   //switch to true if you want to print some details
   constexpr bool debug(false);
 
   HGCSimHitData chargeColl, toa;
 
-  // this represents a cell with no signal charge
-  HGCCellInfo zeroData;
-  zeroData.hit_info[0].fill(0.f);  //accumulated energy
-  zeroData.hit_info[1].fill(0.f);  //time-of-flight
-
-  for (const auto& id : validIds) {
+  for (uint32_t idx = 0; idx < simData.nCells(); ++idx) {
+    const DetId id = simData.id(idx);
     chargeColl.fill(0.f);
-    HGCSimHitDataAccumulator::iterator it = simData.find(id);
-    HGCCellInfo& cell = (simData.end() == it ? zeroData : it->second);
+    HGCCellInfo& cell = simData[idx];
     addCellMetadata(cell, theGeom, id);
 
     for (size_t i = 0; i < cell.hit_info[0].size(); ++i) {
@@ -8,6 +8,7 @@
 
 #include <map>
 #include <set>
+#include <utility>
 #include <vector>
 
 namespace CLHEP {
@@ -62,6 +63,9 @@ private:
   const std::vector<DetId>* theDetIds;
 
   std::map<int, HcalSiPMShape> shapeMap;
+
+  // start bin and amplitude of the SiPM pulses being smeared in a channel
+  std::vector<std::pair<int, double> > pulses;
 };
 
 #endif  //HcalSimAlgos_HcalSiPMHitResponse_h
@@ -16,12 +16,20 @@ public:
 
   double timeToRise() const override { return 0.0; }
 
+  // the shape in bins of HcalPulseShapes::deltaTSiPM_
+  const std::vector<double>& data() const { return nt_; }
+  int nBins() const { return nBins_; }
+  // first bin after the rise where the shape is below 1e-7, where a pulse can be dropped
+  int lastBin() const { return lastBin_; }
+
 protected:
   void computeShape(unsigned int signalShape);
+  void computeLastBin();
 
 private:
   int nBins_;
   std::vector<double> nt_;
+  int lastBin_;
 };
 
 #endif  //HcalSimAlgos_HcalSiPMShape_h
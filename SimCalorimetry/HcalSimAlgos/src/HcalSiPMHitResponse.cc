@@ -14,7 +14,6 @@
 #include "CLHEP/Random/RandPoissonQ.h"
 
 #include <cmath>
-#include <list>
 
 HcalSiPMHitResponse::HcalSiPMHitResponse(const CaloVSimParameterMap* parameterMap,
                                          const CaloShapes* shapes,
@@ -88,12 +87,12 @@ void HcalSiPMHitResponse::add(const CaloSamples& signal) {
   DetId id(signal.id());
   int photonTimeHistSize = nbins * getReadoutFrameSize(id);
   assert(photonTimeHistSize == signal.size());
-  if (precisionTimedPhotons.find(id) == precisionTimedPhotons.end()) {
-    precisionTimedPhotons.insert(std::pair<DetId, photonTimeHist>(id, photonTimeHist(photonTimeHistSize, 0)));
-  }
+  photonTimeHist& photonTimes(
+      precisionTimedPhotons.insert(std::pair<DetId, photonTimeHist>(id, photonTimeHist(photonTimeHistSize, 0)))
+          .first->second);
   for (int i = 0; i < signal.size(); ++i) {
     unsigned int photons(signal[i] + 0.5);
-    precisionTimedPhotons[id][i] += photons;
+    photonTimes[i] += photons;
   }
 }
 
@@ -109,11 +108,12 @@ void HcalSiPMHitResponse::add(const PCaloHit& hit, CLHEP::HepRandomEngine* engin
     if (ignoreTime)
       time = tof;
 
+    photonTimeHist* photonTimes(nullptr);
     if (photons > 0)
-      if (precisionTimedPhotons.find(id) == precisionTimedPhotons.end()) {
-        precisionTimedPhotons.insert(
-            std::pair<DetId, photonTimeHist>(id, photonTimeHist(nbins * getReadoutFrameSize(id), 0)));
-      }
+      photonTimes = &precisionTimedPhotons
+                         .insert(std::pair<DetId, photonTimeHist>(
+                             id, photonTimeHist(nbins * getReadoutFrameSize(id), 0)))
+                         .first->second;
 
     LogDebug("HcalSiPMHitResponse") << id;
     LogDebug("HcalSiPMHitResponse") << " fCtoGeV: " << pars.fCtoGeV(id)
@@ -135,8 +135,8 @@ void HcalSiPMHitResponse::add(const PCaloHit& hit, CLHEP::HepRandomEngine* engin
       t_bin = int(t_pe * invdt + tzero_bin + 0.5);
       LogDebug("HcalSiPMHitResponse") << "t_pe: " << t_pe << " t_pe + tzero: " << (t_pe + tzero_bin * dt)
                                       << " t_bin: " << t_bin << '\n';
-      if ((t_bin >= 0) && (static_cast<unsigned int>(t_bin) < precisionTimedPhotons[id].size()))
-        precisionTimedPhotons[id][t_bin] += 1;
+      if ((t_bin >= 0) && (static_cast<unsigned int>(t_bin) < photonTimes->size()))
+        (*photonTimes)[t_bin] += 1;
     }
   }
 }
@@ -157,17 +157,15 @@ void HcalSiPMHitResponse::addPEnoise(CLHEP::HepRandomEngine* engine) {
 
     unsigned int sumnoisePE(0);
     double elapsedTime(0.);
+    photonTimeHist* photons(nullptr);
     for (int tprecise(0); tprecise < nPreciseBins; ++tprecise) {
       int noisepe = CLHEP::RandPoissonQ::shoot(engine, dc_pe_avg);  // add dark current noise
 
       if (noisepe > 0) {
-        if (precisionTimedPhotons.find(id) == precisionTimedPhotons.end()) {
-          photonTimeHist photons(nPreciseBins, 0);
-          photons[tprecise] = noisepe;
-          precisionTimedPhotons.insert(std::pair<DetId, photonTimeHist>(id, photons));
-        } else {
-          precisionTimedPhotons[id][tprecise] += noisepe;
-        }
+        if (photons == nullptr)
+          photons = &precisionTimedPhotons.insert(std::pair<DetId, photonTimeHist>(id, photonTimeHist(nPreciseBins, 0)))
+                         .first->second;
+        (*photons)[tprecise] += noisepe;
 
         sumnoisePE += noisepe;
       }
@@ -210,10 +208,16 @@ CaloSamples HcalSiPMHitResponse::makeSiPMSignal(DetId const& id,
   double sumHits(0.);
 
   auto& sipmPulseShape(shapeMap[pars.signalShape(id)]);
-
-  std::list<std::pair<double, double> > pulses;
-  std::list<std::pair<double, double> >::iterator pulse;
-  double timeDiff, pulseBit;
+  // the pulses are read from the shape table bin by bin, and all end after the same number of bins,
+  // so they are dropped in the order in which they were added
+  const std::vector<double>& shapeBins(sipmPulseShape.data());
+  const int nShapeBins(sipmPulseShape.nBins());
+  const int lastShapeBin(sipmPulseShape.lastBin());
+
+  pulses.clear();
+  unsigned int firstPulse(0);
+  int shapeBin;
+  double pulseBit;
   LogDebug("HcalSiPMHitResponse") << "makeSiPMSignal for " << HcalDetId(id);
 
   for (unsigned int tbin(0); tbin < photonTimeBins.size(); ++tbin) {
@@ -235,7 +239,7 @@ CaloSamples HcalSiPMHitResponse::makeSiPMSignal(DetId const& id,
       LogDebug("HcalSiPMHitResponse") << " elapsedTime: " << elapsedTime << " sampleBin: " << sampleBin
                                       << " preciseBin: " << preciseBin << " pe: " << pe << " hitPixels: " << hitPixels;
       if (pars.doSiPMSmearing()) {
-        pulses.push_back(std::pair<double, double>(elapsedTime, hitPixels));
+        pulses.push_back(std::pair<int, double>(tbin, hitPixels));
       } else {
         signal[sampleBin] += hitPixels;
         hitPixels *= invdt;
@@ -248,20 +252,17 @@ CaloSamples HcalSiPMHitResponse::makeSiPMSignal(DetId const& id,
     }
 
     if (pars.doSiPMSmearing()) {
-      pulse = pulses.begin();
-      while (pulse != pulses.end()) {
-        timeDiff = elapsedTime - pulse->first;
-        pulseBit = sipmPulseShape(timeDiff) * pulse->second;
-        LogDebug("HcalSiPMHitResponse") << " pulse t: " << pulse->first << " pulse A: " << pulse->second
-                                        << " timeDiff: " << timeDiff << " pulseBit: " << pulseBit;
+      for (unsigned int ipulse(firstPulse); ipulse < pulses.size(); ++ipulse) {
+        shapeBin = static_cast<int>(tbin) - pulses[ipulse].first;
+        pulseBit = (shapeBin < nShapeBins ? shapeBins[shapeBin] : 0.) * pulses[ipulse].second;
+        LogDebug("HcalSiPMHitResponse") << " pulse t: " << pulses[ipulse].first * dt
+                                        << " pulse A: " << pulses[ipulse].second << " timeDiff: " << shapeBin * dt
+                                        << " pulseBit: " << pulseBit;
         signal[sampleBin] += pulseBit;
         signal.preciseAtMod(preciseBin) += pulseBit * invdt;
-
-        if (timeDiff > 1 && sipmPulseShape(timeDiff) < 1e-7)
-          pulse = pulses.erase(pulse);
-        else
-          ++pulse;
       }
+      while (firstPulse < pulses.size() && static_cast<int>(tbin) - pulses[firstPulse].first >= lastShapeBin)
+        ++firstPulse;
     }
     elapsedTime += dt;
   }
@@ -6,9 +6,11 @@
 HcalSiPMShape::HcalSiPMShape(unsigned int signalShape)
     : CaloVShape(), nBins_(HcalPulseShapes::nBinsSiPM_ * HcalPulseShapes::invDeltaTSiPM_), nt_(nBins_, 0.) {
   computeShape(signalShape);
+  computeLastBin();
 }
 
-HcalSiPMShape::HcalSiPMShape(const HcalSiPMShape& other) : CaloVShape(other), nBins_(other.nBins_), nt_(other.nt_) {}
+HcalSiPMShape::HcalSiPMShape(const HcalSiPMShape& other)
+    : CaloVShape(other), nBins_(other.nBins_), nt_(other.nt_), lastBin_(other.lastBin_) {}
 
 double HcalSiPMShape::operator()(double time) const {
   int jtime(time * HcalPulseShapes::invDeltaTSiPM_ + 0.5);
@@ -37,3 +39,10 @@ void HcalSiPMShape::computeShape(unsigned int signalShape) {
     nt_[j] /= norm;
   }
 }
+
+void HcalSiPMShape::computeLastBin() {
+  // same condition as (time > 1 && (*this)(time) < 1e-7) on the bin times
+  lastBin_ = 3;
+  while (lastBin_ < nBins_ && nt_[lastBin_] >= 1e-7)
+    ++lastBin_;
+}
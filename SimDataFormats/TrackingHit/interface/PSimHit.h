@@ -105,6 +105,8 @@ public:
    */
   unsigned int trackId() const { return theTrackId; }
 
+  void setTrackId(unsigned int trackId) { theTrackId = trackId; }
+
   EncodedEventId eventId() const { return theEventId; }
 
   void setEventId(EncodedEventId e) { theEventId = e; }
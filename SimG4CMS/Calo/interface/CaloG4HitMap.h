@@ -0,0 +1,71 @@
+#ifndef SimG4CMS_CaloG4HitMap_h
+#define SimG4CMS_CaloG4HitMap_h
+///////////////////////////////////////////////////////////////////////////////
+// File: CaloG4HitMap.h
+// Description: Flat hash table (open addressing, linear probing) of the
+//              CaloG4Hits of an event by CaloHitID. Two IDs are the same
+//              key if they have the same track, unit, depth and time slice,
+//              as for the ordering of CaloHitID. The slots are kept between
+//              events.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Calo/interface/CaloHitID.h"
+
+#include <cstdint>
+#include <vector>
+
+class CaloG4Hit;
+
+class CaloG4HitMap {
+public:
+  // initialSize is rounded up to a power of 2
+  CaloG4HitMap(unsigned int initialSize = 1024);
+
+  CaloG4Hit* find(const CaloHitID& id) const {
+    for (unsigned int i = slot(id);; i = (i + 1) & theMask) {
+      const Entry& entry = theEntries[i];
+      if (entry.hit == nullptr)
+        return nullptr;
+      if (sameKey(entry, id))
+        return entry.hit;
+    }
+  }
+
+  // does nothing if the ID is already there
+  void insert(const CaloHitID& id, CaloG4Hit* hit);
+  void erase(const CaloHitID& id);
+  void clear();
+
+  unsigned int size() const { return theSize; }
+
+private:
+  struct Entry {
+    uint32_t unitID;
+    int trackID;
+    int timeSliceID;
+    uint16_t depth;
+    CaloG4Hit* hit;
+  };
+
+  unsigned int slot(const CaloHitID& id) const { return slot(id.unitID(), id.trackID(), id.timeSliceID(), id.depth()); }
+  unsigned int slot(const Entry& entry) const {
+    return slot(entry.unitID, entry.trackID, entry.timeSliceID, entry.depth);
+  }
+  unsigned int slot(uint32_t unitID, int trackID, int timeSliceID, uint16_t depth) const {
+    uint64_t key = ((uint64_t)unitID << 32) | (uint32_t)trackID;
+    key ^= (((uint64_t)(uint32_t)timeSliceID << 16) | depth) * 0x9e3779b97f4a7c15ULL;
+    key *= 0xff51afd7ed558ccdULL;
+    return (unsigned int)(key ^ (key >> 32)) & theMask;
+  }
+  static bool sameKey(const Entry& entry, const CaloHitID& id) {
+    return (entry.unitID == id.unitID() && entry.trackID == id.trackID() && entry.timeSliceID == id.timeSliceID() &&
+            entry.depth == id.depth());
+  }
+  void grow();
+
+  std::vector<Entry> theEntries;
+  unsigned int theMask;
+  unsigned int theSize;
+};
+
+#endif
@@ -39,5 +39,11 @@ private:
   bool ignoreTrackID;
 };
 
+// inline: compared with the previous ID for every step in the calorimeters
+inline bool CaloHitID::operator==(const CaloHitID& id) const {
+  return ((theUnitID == id.theUnitID) && (theTimeSliceID == id.theTimeSliceID) && (theDepth == id.theDepth) &&
+          (theTrackID == id.theTrackID || ignoreTrackID));
+}
+
 std::ostream& operator<<(std::ostream&, const CaloHitID&);
 #endif
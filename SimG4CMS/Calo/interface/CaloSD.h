@@ -9,6 +9,7 @@
 
 #include "SimG4CMS/Calo/interface/CaloG4Hit.h"
 #include "SimG4CMS/Calo/interface/CaloG4HitCollection.h"
+#include "SimG4CMS/Calo/interface/CaloG4HitMap.h"
 #include "SimG4CMS/Calo/interface/CaloMeanResponse.h"
 #include "SimG4Core/Notification/interface/Observer.h"
 #include "SimG4Core/Notification/interface/BeginOfRun.h"
@@ -27,6 +28,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <memory>
 
 class G4Step;
@@ -163,8 +165,8 @@ private:
   double eminHitD;
   double correctT;
 
-  std::map<CaloHitID, CaloG4Hit*> hitMap;
-  std::map<int, TrackWithHistory*> tkMap;
+  CaloG4HitMap hitMap;
+  std::unordered_map<int, TrackWithHistory*> tkMap;
   std::vector<std::unique_ptr<CaloG4Hit>> reusehit;
 };
 
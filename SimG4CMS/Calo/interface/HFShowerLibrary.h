@@ -9,6 +9,7 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "Geometry/HcalCommonData/interface/HcalDDDSimConstants.h"
 #include "SimG4CMS/Calo/interface/HFFibre.h"
+#include "SimG4CMS/Calo/interface/HFShowerLibraryFile.h"
 #include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
 #include "DetectorDescription/Core/interface/DDsvalues.h"
 
@@ -58,12 +59,18 @@ protected:
   void interpolate(int, double);
   void extrapolate(int, double);
   void storePhoton(int j);
+  HFShowerPhoton recordPhoton(int j) const;
+  int recordSize() const;
   std::vector<double> getDDDArray(const std::string &, const DDsvalues_type &, int &);
 
 private:
   HFFibre *fibre;
   TFile *hf;
   TBranch *emBranch, *hadBranch;
+  // library converted by HFShowerLibraryConverter, used instead of the ROOT file
+  std::unique_ptr<HFShowerLibraryFile> mapped;
+  const HFShowerLibraryFile::Photon *mappedPhotons;
+  int nMappedPhotons;
 
   bool verbose, applyFidCut, newForm, v3version;
   int nMomBin, totEvents, evtPerBin;
@@ -0,0 +1,81 @@
+#ifndef SimG4CMS_HFShowerLibraryFile_h
+#define SimG4CMS_HFShowerLibraryFile_h 1
+///////////////////////////////////////////////////////////////////////////////
+// File: HFShowerLibraryFile.h
+// Description: HF shower library in a flat binary file, mapped read-only
+//              into memory. The file is written by HFShowerLibraryConverter
+//              from the ROOT library; the pages of the mapping are shared
+//              by all the threads which open the same file.
+//
+// Layout (native byte order):
+//   Header
+//   double   energy bins (GeV) [nMomBin]
+//   uint64_t offsets of the records [2][totEvents + 1], in photons from the
+//            start of the photon block, em records first
+//   Photon   photons of all the records
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FWCore/Utilities/interface/Range.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class HFShowerLibraryFile {
+public:
+  struct Header {
+    char magic[8];
+    int32_t totEvents;
+    int32_t nMomBin;
+    int32_t evtPerBin;
+    float libVers;
+    float listVersion;
+    int32_t unused;
+  };
+
+  struct Photon {
+    float x, y, z, lambda, t;
+  };
+
+  static constexpr char kMagic[8] = {'H', 'F', 'S', 'H', 'L', 'I', 'B', '1'};
+
+  HFShowerLibraryFile(const std::string& fileName);
+  ~HFShowerLibraryFile();
+  HFShowerLibraryFile(const HFShowerLibraryFile&) = delete;
+  HFShowerLibraryFile& operator=(const HFShowerLibraryFile&) = delete;
+
+  int totalEvents() const { return header_->totEvents; }
+  int numberOfBins() const { return header_->nMomBin; }
+  int eventsPerBin() const { return header_->evtPerBin; }
+  float showerLibraryVersion() const { return header_->libVers; }
+  float physListVersion() const { return header_->listVersion; }
+  std::vector<double> energyBins() const { return std::vector<double>(pmom_, pmom_ + header_->nMomBin); }
+
+  // photons of the record (1 to totalEvents) of type 0 (em) or 1 (had);
+  // the constructor checks that the offsets are ordered and within the file
+  edm::Range<const Photon*> record(int type, int record) const {
+    const uint64_t* offsets = offsets_ + (type > 0 ? header_->totEvents + 1 : 0);
+    return edm::Range<const Photon*>(photons_ + offsets[record - 1], photons_ + offsets[record]);
+  }
+
+  // true if the file starts as a library written by HFShowerLibraryConverter
+  static bool hasFormat(const std::string& fileName);
+
+  // writes a library, getting the photons of each record (1 to totEvents) of type 0 and 1 from fillRecord
+  static void write(const std::string& fileName,
+                    const Header& header,
+                    const std::vector<double>& pmom,
+                    const std::function<void(int type, int record, std::vector<Photon>& photons)>& fillRecord);
+
+private:
+  void* data_;
+  size_t size_;
+  const Header* header_;
+  const double* pmom_;
+  const uint64_t* offsets_;
+  const Photon* photons_;
+};
+
+#endif
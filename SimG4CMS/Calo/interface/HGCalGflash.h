@@ -0,0 +1,47 @@
+#ifndef SimG4CMS_HGCalGflash_h
+#define SimG4CMS_HGCalGflash_h
+///////////////////////////////////////////////////////////////////////////////
+// File: HGCalGflash.h
+// Description: GFlash parametrisation of electromagnetic showers in the
+//              silicon part of the High Granularity Calorimeter. The
+//              sampling structure is described by effective material
+//              constants, the energy spots are given back to HGCalSD
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "G4ThreeVector.hh"
+
+#include <memory>
+#include <vector>
+
+class G4Step;
+class GflashTrajectory;
+
+class HGCalGflash {
+public:
+  HGCalGflash(edm::ParameterSet const& p);
+  ~HGCalGflash();
+
+  struct Hit {
+    Hit() {}
+    G4ThreeVector position;
+    double time = 0.;
+    double edep = 0.;
+  };
+
+  // spots (position in mm, time in ns, visible energy in MeV) of the shower of
+  // the track of the step, developed over a path of at most maxLength (mm)
+  std::vector<Hit> gfParameterization(const G4Step* aStep, double maxLength);
+
+  double radiationLength() const { return radLength_; }
+
+private:
+  std::unique_ptr<GflashTrajectory> theHelix_;
+
+  double theBField_;
+  double zEff_, radLength_, rMoliere_, criticalEnergy_;
+  double samplingFraction_, energyScale_;
+};
+
+#endif  // HGCalGflash_h
@@ -10,6 +10,7 @@
 #include "SimG4Core/Notification/interface/BeginOfJob.h"
 #include "SimG4CMS/Calo/interface/HGCalNumberingScheme.h"
 #include "SimG4CMS/Calo/interface/HGCMouseBite.h"
+#include "SimG4CMS/Calo/interface/HGCalGflash.h"
 
 #include <string>
 
@@ -30,6 +31,7 @@ public:
 
 protected:
   double getEnergyDeposit(const G4Step *) override;
+  bool getFromLibrary(const G4Step *) override;
   using CaloSD::update;
   void update(const BeginOfJob *) override;
   void initRun() override;
@@ -42,11 +44,13 @@ private:
   const HGCalDDDConstants *hgcons_;
   std::unique_ptr<HGCalNumberingScheme> numberingScheme_;
   std::unique_ptr<HGCMouseBite> mouseBite_;
+  std::unique_ptr<HGCalGflash> showerParam_;
   DetId::Detector mydet_;
   std::string nameX_;
   HGCalGeometryMode::GeometryMode geom_mode_;
   double eminHit_, slopeMin_, distanceFromEdge_;
   double mouseBiteCut_, weight_;
+  double eminParam_, containmentParam_, zmaxParam_;
   int levelT1_, levelT2_, cornerMinMask_;
   bool storeAllG4Hits_;
   bool fiducialCut_, rejectMB_, waferRot_;
@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: CaloG4HitMap.cc
+// Description: Flat hash table of the CaloG4Hits of an event by CaloHitID
+///////////////////////////////////////////////////////////////////////////////
+#include "SimG4CMS/Calo/interface/CaloG4HitMap.h"
+
+CaloG4HitMap::CaloG4HitMap(unsigned int initialSize) : theSize(0) {
+  unsigned int nslots = 16;
+  while (nslots < initialSize)
+    nslots *= 2;
+  theEntries.resize(nslots, Entry{0, 0, 0, 0, nullptr});
+  theMask = nslots - 1;
+}
+
+void CaloG4HitMap::insert(const CaloHitID& id, CaloG4Hit* hit) {
+  // keep the table at most half full
+  if (2 * (theSize + 1) > theEntries.size())
+    grow();
+  unsigned int i = slot(id);
+  while (theEntries[i].hit != nullptr) {
+    if (sameKey(theEntries[i], id))
+      return;
+    i = (i + 1) & theMask;
+  }
+  theEntries[i] = Entry{id.unitID(), id.trackID(), id.timeSliceID(), id.depth(), hit};
+  ++theSize;
+}
+
+void CaloG4HitMap::erase(const CaloHitID& id) {
+  unsigned int i = slot(id);
+  while (theEntries[i].hit != nullptr && !sameKey(theEntries[i], id))
+    i = (i + 1) & theMask;
+  if (theEntries[i].hit == nullptr)
+    return;
+
+  // move back the following entries of the cluster which can not be reached from their slot any more
+  unsigned int j = i;
+  while (true) {
+    j = (j + 1) & theMask;
+    if (theEntries[j].hit == nullptr)
+      break;
+    const unsigned int k = slot(theEntries[j]);
+    const bool reachable = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+    if (!reachable) {
+      theEntries[i] = theEntries[j];
+      i = j;
+    }
+  }
+  theEntries[i].hit = nullptr;
+  --theSize;
+}
+
+void CaloG4HitMap::clear() {
+  if (theSize == 0)
+    return;
+  for (auto& entry : theEntries)
+    entry.hit = nullptr;
+  theSize = 0;
+}
+
+void CaloG4HitMap::grow() {
+  std::vector<Entry> entries(2 * theEntries.size(), Entry{0, 0, 0, 0, nullptr});
+  entries.swap(theEntries);
+  theMask = theEntries.size() - 1;
+  for (const auto& entry : entries) {
+    if (entry.hit == nullptr)
+      continue;
+    unsigned int i = slot(entry);
+    while (theEntries[i].hit != nullptr)
+      i = (i + 1) & theMask;
+    theEntries[i] = entry;
+  }
+}
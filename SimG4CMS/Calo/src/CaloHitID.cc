@@ -53,13 +53,6 @@ void CaloHitID::reset() {
   theDepth = 0;
 }
 
-bool CaloHitID::operator==(const CaloHitID& id) const {
-  return ((theUnitID == id.unitID()) && (theTrackID == id.trackID() || ignoreTrackID) &&
-          (theTimeSliceID == id.timeSliceID()) && (theDepth == id.depth()))
-             ? true
-             : false;
-}
-
 bool CaloHitID::operator<(const CaloHitID& id) const {
   if (theTrackID != id.trackID()) {
     return (theTrackID > id.trackID());
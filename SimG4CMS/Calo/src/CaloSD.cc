@@ -318,9 +318,9 @@ bool CaloSD::checkHit() {
   //look in the HitContainer whether a hit with the same ID already exists:
   bool found = false;
   if (useMap) {
-    std::map<CaloHitID, CaloG4Hit*>::const_iterator it = hitMap.find(currentID);
-    if (it != hitMap.end()) {
-      currentHit = it->second;
+    CaloG4Hit* hit = hitMap.find(currentID);
+    if (hit != nullptr) {
+      currentHit = hit;
       found = true;
     }
   } else if (nCheckedHits > 0) {
@@ -391,7 +391,8 @@ CaloG4Hit* CaloSD::createNewHit(const G4Step* aStep) {
       trkInfo->putInHistory();
     }
   } else {
-    TrackWithHistory* trkh = tkMap[currentID.trackID()];
+    auto it = tkMap.find(currentID.trackID());
+    TrackWithHistory* trkh = (it != tkMap.end()) ? it->second : nullptr;
 #ifdef EDM_ML_DEBUG
     edm::LogVerbatim("CaloSim") << "CaloSD : TrackwithHistory pointer for " << currentID.trackID() << " is " << trkh;
 #endif
@@ -543,10 +544,11 @@ void CaloSD::update(const ::EndOfEvent*) {
                               << "\n EmeanHAD= " << eHAD << " ErmsHAD= " << eHAD2 << " TimeMean= " << tt
                               << " E0mean= " << ee << " Zglob= " << zglob << " Zloc= " << zloc << " ";
 
-  tkMap.erase(tkMap.begin(), tkMap.end());
-  std::vector<std::unique_ptr<CaloG4Hit>>().swap(reusehit);
+  tkMap.clear();
+  // free the spare hits before the allocator is reset, keeping the capacity of the vector
+  reusehit.clear();
   if (useMap)
-    hitMap.erase(hitMap.begin(), hitMap.end());
+    hitMap.clear();
 }
 
 void CaloSD::clearHits() {
@@ -639,7 +641,7 @@ void CaloSD::storeHit(CaloG4Hit* hit) {
 
   theHC->insert(hit);
   if (useMap)
-    hitMap.insert(std::pair<CaloHitID, CaloG4Hit*>(previousID, hit));
+    hitMap.insert(previousID, hit);
 }
 
 bool CaloSD::saveHit(CaloG4Hit* aHit) {
@@ -24,7 +24,13 @@
 //#define EDM_ML_DEBUG
 
 HFShowerLibrary::HFShowerLibrary(const std::string& name, const DDCompactView& cpv, edm::ParameterSet const& p)
-    : fibre(nullptr), hf(nullptr), emBranch(nullptr), hadBranch(nullptr), npe(0) {
+    : fibre(nullptr),
+      hf(nullptr),
+      emBranch(nullptr),
+      hadBranch(nullptr),
+      mappedPhotons(nullptr),
+      nMappedPhotons(0),
+      npe(0) {
   edm::ParameterSet m_HF = p.getParameter<edm::ParameterSet>("HFShower");
   probMax = m_HF.getParameter<double>("ProbMax");
 
@@ -44,38 +50,47 @@ HFShowerLibrary::HFShowerLibrary(const std::string& name, const DDCompactView& c
   if (pTreeName.find(".") == 0)
     pTreeName.erase(0, 2);
   const char* nTree = pTreeName.c_str();
-  hf = TFile::Open(nTree);
-
-  if (!hf->IsOpen()) {
-    edm::LogError("HFShower") << "HFShowerLibrary: opening " << nTree << " failed";
-    throw cms::Exception("Unknown", "HFShowerLibrary") << "Opening of " << pTreeName << " fails\n";
+  TTree* event(nullptr);
+  newForm = (branchEvInfo.empty());
+  v3version = false;
+  if (HFShowerLibraryFile::hasFormat(pTreeName)) {
+    // converted library: the records are read from the mapped file
+    mapped = std::make_unique<HFShowerLibraryFile>(pTreeName);
+    edm::LogVerbatim("HFShower") << "HFShowerLibrary: mapping " << nTree << " successfully";
+    newForm = false;
+    loadEventInfo(nullptr);
   } else {
-    edm::LogVerbatim("HFShower") << "HFShowerLibrary: opening " << nTree << " successfully";
-  }
+    hf = TFile::Open(nTree);
 
-  newForm = (branchEvInfo.empty());
-  TTree* event(nullptr);
-  if (newForm)
-    event = (TTree*)hf->Get("HFSimHits");
-  else
-    event = (TTree*)hf->Get("Events");
-  if (event) {
-    TBranch* evtInfo(nullptr);
-    if (!newForm) {
-      std::string info = branchEvInfo + branchPost;
-      evtInfo = event->GetBranch(info.c_str());
+    if (!hf->IsOpen()) {
+      edm::LogError("HFShower") << "HFShowerLibrary: opening " << nTree << " failed";
+      throw cms::Exception("Unknown", "HFShowerLibrary") << "Opening of " << pTreeName << " fails\n";
+    } else {
+      edm::LogVerbatim("HFShower") << "HFShowerLibrary: opening " << nTree << " successfully";
     }
-    if (evtInfo || newForm) {
-      loadEventInfo(evtInfo);
+
+    if (newForm)
+      event = (TTree*)hf->Get("HFSimHits");
+    else
+      event = (TTree*)hf->Get("Events");
+    if (event) {
+      TBranch* evtInfo(nullptr);
+      if (!newForm) {
+        std::string info = branchEvInfo + branchPost;
+        evtInfo = event->GetBranch(info.c_str());
+      }
+      if (evtInfo || newForm) {
+        loadEventInfo(evtInfo);
+      } else {
+        edm::LogError("HFShower") << "HFShowerLibrary: HFShowerLibrayEventInfo"
+                                  << " Branch does not exist in Event";
+        throw cms::Exception("Unknown", "HFShowerLibrary") << "Event information absent\n";
+      }
     } else {
-      edm::LogError("HFShower") << "HFShowerLibrary: HFShowerLibrayEventInfo"
-                                << " Branch does not exist in Event";
-      throw cms::Exception("Unknown", "HFShowerLibrary") << "Event information absent\n";
+      edm::LogError("HFShower") << "HFShowerLibrary: Events Tree does not "
+                                << "exist";
+      throw cms::Exception("Unknown", "HFShowerLibrary") << "Events tree absent\n";
     }
-  } else {
-    edm::LogError("HFShower") << "HFShowerLibrary: Events Tree does not "
-                              << "exist";
-    throw cms::Exception("Unknown", "HFShowerLibrary") << "Events tree absent\n";
   }
 
   std::stringstream ss;
@@ -90,23 +105,25 @@ HFShowerLibrary::HFShowerLibrary(const std::string& name, const DDCompactView& c
   }
   edm::LogVerbatim("HFShower") << ss.str();
 
-  std::string nameBr = branchPre + emName + branchPost;
-  emBranch = event->GetBranch(nameBr.c_str());
-  if (verbose)
-    emBranch->Print();
-  nameBr = branchPre + hadName + branchPost;
-  hadBranch = event->GetBranch(nameBr.c_str());
-  if (verbose)
-    hadBranch->Print();
+  if (!mapped) {
+    std::string nameBr = branchPre + emName + branchPost;
+    emBranch = event->GetBranch(nameBr.c_str());
+    if (verbose)
+      emBranch->Print();
+    nameBr = branchPre + hadName + branchPost;
+    hadBranch = event->GetBranch(nameBr.c_str());
+    if (verbose)
+      hadBranch->Print();
+
+    if (emBranch->GetClassName() == std::string("vector<float>")) {
+      v3version = true;
+    }
 
-  v3version = false;
-  if (emBranch->GetClassName() == std::string("vector<float>")) {
-    v3version = true;
+    edm::LogVerbatim("HFShower") << " HFShowerLibrary:Branch " << emName << " has " << emBranch->GetEntries()
+                                 << " entries and Branch " << hadName << " has " << hadBranch->GetEntries()
+                                 << " entries";
   }
-
-  edm::LogVerbatim("HFShower") << " HFShowerLibrary:Branch " << emName << " has " << emBranch->GetEntries()
-                               << " entries and Branch " << hadName << " has " << hadBranch->GetEntries() << " entries"
-                               << "\n HFShowerLibrary::No packing information -"
+  edm::LogVerbatim("HFShower") << " HFShowerLibrary::No packing information -"
                                << " Assume x, y, z are not in packed form"
                                << "\n Maximum probability cut off " << probMax << "  Back propagation of light prob. "
                                << backProb;
@@ -348,7 +365,11 @@ void HFShowerLibrary::getRecord(int type, int record) {
   int nrc = record - 1;
   photon.clear();
   photo->clear();
-  if (type > 0) {
+  if (mapped) {
+    auto photons = mapped->record(type, record);
+    mappedPhotons = photons.begin();
+    nMappedPhotons = photons.end() - photons.begin();
+  } else if (type > 0) {
     if (newForm) {
       if (!v3version) {
         hadBranch->SetAddress(&photo);
@@ -392,11 +413,18 @@ void HFShowerLibrary::getRecord(int type, int record) {
     }
   }
 #ifdef EDM_ML_DEBUG
-  int nPhoton = (newForm) ? photo->size() : photon.size();
+  int nPhoton = recordSize();
   edm::LogVerbatim("HFShower") << "HFShowerLibrary::getRecord: Record " << record << " of type " << type << " with "
                                << nPhoton << " photons";
   for (int j = 0; j < nPhoton; j++)
-    if (newForm)
+    if (mapped)
+      edm::LogVerbatim("HFShower") << "Photon " << j << " "
+                                   << HFShowerPhoton(mappedPhotons[j].x,
+                                                     mappedPhotons[j].y,
+                                                     mappedPhotons[j].z,
+                                                     mappedPhotons[j].lambda,
+                                                     mappedPhotons[j].t);
+    else if (newForm)
       edm::LogVerbatim("HFShower") << "Photon " << j << " " << photo->at(j);
     else
       edm::LogVerbatim("HFShower") << "Photon " << j << " " << photon[j];
@@ -404,7 +432,14 @@ void HFShowerLibrary::getRecord(int type, int record) {
 }
 
 void HFShowerLibrary::loadEventInfo(TBranch* branch) {
-  if (branch) {
+  if (mapped) {
+    totEvents = mapped->totalEvents();
+    nMomBin = mapped->numberOfBins();
+    evtPerBin = mapped->eventsPerBin();
+    libVers = mapped->showerLibraryVersion();
+    listVersion = mapped->physListVersion();
+    pmom = mapped->energyBins();
+  } else if (branch) {
     std::vector<HFShowerLibraryEventInfo> eventInfoCollection;
     branch->SetAddress(&eventInfoCollection);
     branch->GetEntry(0);
@@ -487,7 +522,7 @@ void HFShowerLibrary::interpolate(int type, double pin) {
   for (int ir = 0; ir < 2; ir++) {
     if (irc[ir] > 0) {
       getRecord(type, irc[ir]);
-      int nPhoton = (newForm) ? photo->size() : photon.size();
+      int nPhoton = recordSize();
       npold += nPhoton;
       for (int j = 0; j < nPhoton; j++) {
         r = G4UniformRand();
@@ -545,7 +580,7 @@ void HFShowerLibrary::extrapolate(int type, double pin) {
   for (int ir = 0; ir < nrec; ir++) {
     if (irc[ir] > 0) {
       getRecord(type, irc[ir]);
-      int nPhoton = (newForm) ? photo->size() : photon.size();
+      int nPhoton = recordSize();
       npold += nPhoton;
       for (int j = 0; j < nPhoton; j++) {
         double r = G4UniformRand();
@@ -577,16 +612,26 @@ void HFShowerLibrary::extrapolate(int type, double pin) {
 }
 
 void HFShowerLibrary::storePhoton(int j) {
-  if (newForm)
-    pe.push_back(photo->at(j));
-  else
-    pe.push_back(photon[j]);
+  pe.push_back(recordPhoton(j));
 #ifdef EDM_ML_DEBUG
   edm::LogVerbatim("HFShower") << "HFShowerLibrary: storePhoton " << j << " npe " << npe << " " << pe[npe];
 #endif
   npe++;
 }
 
+HFShowerPhoton HFShowerLibrary::recordPhoton(int j) const {
+  if (mapped)
+    return HFShowerPhoton(
+        mappedPhotons[j].x, mappedPhotons[j].y, mappedPhotons[j].z, mappedPhotons[j].lambda, mappedPhotons[j].t);
+  return (newForm) ? photo->at(j) : photon[j];
+}
+
+int HFShowerLibrary::recordSize() const {
+  if (mapped)
+    return nMappedPhotons;
+  return (newForm) ? photo->size() : photon.size();
+}
+
 std::vector<double> HFShowerLibrary::getDDDArray(const std::string& str, const DDsvalues_type& sv, int& nmin) {
 #ifdef EDM_ML_DEBUG
   edm::LogVerbatim("HFShower") << "HFShowerLibrary:getDDDArray called for " << str << " with nMin " << nmin;
@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: HFShowerLibraryFile.cc
+// Description: HF shower library in a flat binary file mapped into memory
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Calo/interface/HFShowerLibraryFile.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr char HFShowerLibraryFile::kMagic[8];
+
+HFShowerLibraryFile::HFShowerLibraryFile(const std::string& fileName) : data_(nullptr), size_(0) {
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw cms::Exception("Unknown", "HFShowerLibraryFile") << "Opening of " << fileName << " fails\n";
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Header)) {
+    ::close(fd);
+    throw cms::Exception("Unknown", "HFShowerLibraryFile") << fileName << " is not a shower library\n";
+  }
+  size_ = st.st_size;
+  data_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data_ == MAP_FAILED) {
+    data_ = nullptr;
+    throw cms::Exception("Unknown", "HFShowerLibraryFile") << "Mapping of " << fileName << " fails\n";
+  }
+
+  const char* base = static_cast<const char*>(data_);
+  header_ = reinterpret_cast<const Header*>(base);
+  size_t pos = sizeof(Header);
+  pmom_ = reinterpret_cast<const double*>(base + pos);
+  pos += sizeof(double) * std::max(header_->nMomBin, 0);
+  offsets_ = reinterpret_cast<const uint64_t*>(base + pos);
+  pos += sizeof(uint64_t) * 2 * (std::max(header_->totEvents, 0) + 1);
+  photons_ = reinterpret_cast<const Photon*>(base + pos);
+
+  bool ok = (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) == 0 && header_->nMomBin > 0 &&
+             header_->totEvents > 0 && pos <= size_);
+  // record() trusts the offsets: they must not decrease, from the em records
+  // to the had ones, and must stay within the photons of the file
+  if (ok) {
+    const uint64_t nPhotons = (size_ - pos) / sizeof(Photon);
+    const size_t nOffsets = 2 * (size_t(header_->totEvents) + 1);
+    for (size_t i = 0; ok && i < nOffsets; ++i)
+      ok = (offsets_[i] <= nPhotons && (i == 0 || offsets_[i - 1] <= offsets_[i]));
+  }
+  if (!ok) {
+    ::munmap(data_, size_);
+    data_ = nullptr;
+    throw cms::Exception("Unknown", "HFShowerLibraryFile") << fileName << " is not a valid shower library\n";
+  }
+}
+
+HFShowerLibraryFile::~HFShowerLibraryFile() {
+  if (data_)
+    ::munmap(data_, size_);
+}
+
+bool HFShowerLibraryFile::hasFormat(const std::string& fileName) {
+  char magic[sizeof(kMagic)];
+  std::ifstream file(fileName, std::ios::binary);
+  return (file.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0);
+}
+
+void HFShowerLibraryFile::write(
+    const std::string& fileName,
+    const Header& header,
+    const std::vector<double>& pmom,
+    const std::function<void(int type, int record, std::vector<Photon>& photons)>& fillRecord) {
+  std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+  if (!file)
+    throw cms::Exception("Unknown", "HFShowerLibraryFile") << "Opening of " << fileName << " fails\n";
+
+  Header head(header);
+  std::memcpy(head.magic, kMagic, sizeof(kMagic));
+  head.nMomBin = pmom.size();
+  head.unused = 0;
+  file.write(reinterpret_cast<const char*>(&head), sizeof(head));
+  file.write(reinterpret_cast<const char*>(pmom.data()), sizeof(double) * pmom.size());
+
+  // the offsets are written again once the records are known
+  const std::streampos offsetPos = file.tellp();
+  std::vector<uint64_t> offsets(2 * (head.totEvents + 1), 0);
+  file.write(reinterpret_cast<const char*>(offsets.data()), sizeof(uint64_t) * offsets.size());
+
+  uint64_t nphotons = 0;
+  std::vector<Photon> photons;
+  for (int type = 0; type < 2; ++type) {
+    uint64_t* typeOffsets = offsets.data() + type * (head.totEvents + 1);
+    typeOffsets[0] = nphotons;
+    for (int record = 1; record <= head.totEvents; ++record) {
+      photons.clear();
+      fillRecord(type, record, photons);
+      file.write(reinterpret_cast<const char*>(photons.data()), sizeof(Photon) * photons.size());
+      nphotons += photons.size();
+      typeOffsets[record] = nphotons;
+    }
+  }
+
+  file.seekp(offsetPos);
+  file.write(reinterpret_cast<const char*>(offsets.data()), sizeof(uint64_t) * offsets.size());
+  if (!file)
+    throw cms::Exception("Unknown", "HFShowerLibraryFile") << "Writing of " << fileName << " fails\n";
+}
@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: HGCalGflash.cc
+// Description: GFlash parametrisation of electromagnetic showers in HGCal
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SimG4CMS/Calo/interface/HGCalGflash.h"
+#include "SimGeneral/GFlash/interface/GflashTrajectory.h"
+#include "SimGeneral/GFlash/interface/GflashTrajectoryPoint.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "G4Gamma.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "Randomize.hh"
+
+#include "CLHEP/GenericFunctions/IncompleteGamma.hh"
+#include "CLHEP/Units/GlobalPhysicalConstants.h"
+#include "CLHEP/Units/GlobalSystemOfUnits.h"
+
+#include <algorithm>
+#include <cmath>
+
+//#define EDM_ML_DEBUG
+
+HGCalGflash::HGCalGflash(edm::ParameterSet const& p) : theHelix_(new GflashTrajectory) {
+  edm::ParameterSet m_Gflash = p.getParameter<edm::ParameterSet>("HGCalGflash");
+  theBField_ = m_Gflash.getParameter<double>("BField");
+  zEff_ = m_Gflash.getParameter<double>("EffectiveZ");
+  radLength_ = m_Gflash.getParameter<double>("RadiationLength") * cm;
+  rMoliere_ = m_Gflash.getParameter<double>("MoliereRadius") * cm;
+  criticalEnergy_ = m_Gflash.getParameter<double>("CriticalEnergy") * MeV;
+  samplingFraction_ = m_Gflash.getParameter<double>("SamplingFraction");
+  energyScale_ = m_Gflash.getParameter<double>("EnergyScale");
+  edm::LogVerbatim("HGCSim") << "HGCalGflash:: B-Field " << theBField_ << " T; effective Z " << zEff_ << " X0 "
+                             << radLength_ / cm << " cm RM " << rMoliere_ / cm << " cm Ec " << criticalEnergy_ / MeV
+                             << " MeV; sampling fraction " << samplingFraction_ << " energy scale " << energyScale_;
+}
+
+HGCalGflash::~HGCalGflash() {}
+
+std::vector<HGCalGflash::Hit> HGCalGflash::gfParameterization(const G4Step* aStep, double maxLength) {
+  // The longitudinal and lateral profiles are those of GflashEMShowerProfile
+  // (hep-ex/0001020v1), the units here are cm and GeV as there
+  std::vector<HGCalGflash::Hit> hits;
+
+  auto const preStepPoint = aStep->GetPreStepPoint();
+  auto const track = aStep->GetTrack();
+
+  const double invgev = 1.0 / GeV;
+  const double radLength = radLength_ / cm;
+  const double rMoliere = rMoliere_ / cm;
+  double energy = preStepPoint->GetTotalEnergy() * invgev;
+  double logEinc = std::log(energy);
+  double logY = std::log(energy / (criticalEnergy_ * invgev));
+
+  // the fluctuations of the parametrisation are defined well above the critical energy
+  if (logY < 1.2)
+    return hits;
+
+  G4ThreeVector showerStartingPosition = preStepPoint->GetPosition() / cm;
+  G4ThreeVector showerMomentum = preStepPoint->GetMomentum() / GeV;
+  double charge = preStepPoint->GetCharge();
+  theHelix_->initializeTrajectory(showerMomentum, showerStartingPosition, charge, theBField_);
+
+  double pathLength0 = theHelix_->getPathLengthAtZ(showerStartingPosition.getZ());
+  double stepLengthLeft = maxLength / cm;
+  // a photon starts its shower where it converts
+  if (track->GetDefinition() == G4Gamma::Gamma()) {
+    double conversion = -(9.0 / 7.0) * radLength * std::log(G4UniformRand());
+    pathLength0 += conversion;
+    stepLengthLeft -= conversion;
+  }
+  double pathLength = pathLength0;  // this will grow along the shower development
+
+  double nSpots = 93.0 * std::log(zEff_) * std::pow(energy, 0.876);
+
+  //--- intrinsic properties of em. showers with their correlated fluctuations
+  double fluctuatedTmax = std::log(logY - 0.7157);
+  double fluctuatedAlpha = std::log(0.7996 + (0.4581 + 1.8628 / zEff_) * logY);
+
+  double sigmaTmax = 1.0 / (-1.4 + 1.26 * logY);
+  double sigmaAlpha = 1.0 / (-0.58 + 0.86 * logY);
+  double rho = 0.705 - 0.023 * logY;
+  double sqrtPL = std::sqrt((1.0 + rho) / 2.0);
+  double sqrtLE = std::sqrt((1.0 - rho) / 2.0);
+
+  double norm1 = G4RandGauss::shoot();
+  double norm2 = G4RandGauss::shoot();
+  double tempTmax = fluctuatedTmax + sigmaTmax * (sqrtPL * norm1 + sqrtLE * norm2);
+  double tempAlpha = fluctuatedAlpha + sigmaAlpha * (sqrtPL * norm1 - sqrtLE * norm2);
+
+  // tmax, alpha, beta : parameters of gamma distribution
+  double tmax = std::exp(tempTmax);
+  double alpha = std::exp(tempAlpha);
+  double beta = std::max(0.0, (alpha - 1.0) / tmax);
+
+  // spot fluctuations are added to tmax, alpha, beta
+  double averageTmax = logY - 0.858;
+  double averageAlpha = 0.21 + (0.492 + 2.38 / zEff_) * logY;
+  double spotTmax = averageTmax * (0.698 + .00212 * zEff_);
+  double spotAlpha = averageAlpha * (0.639 + .00334 * zEff_);
+  double spotBeta = std::max(0.0, (spotAlpha - 1.0) / spotTmax);
+  if (alpha <= 1.0 || beta <= 0.0 || spotBeta <= 0.0)
+    return hits;
+
+  //  parameters for lateral distribution and fluctuation
+  double z1 = 0.0251 + 0.00319 * logEinc;
+  double z2 = 0.1162 - 0.000381 * zEff_;
+
+  double k1 = 0.659 - 0.00309 * zEff_;
+  double k2 = 0.645;
+  double k3 = -2.59;
+  double k4 = 0.3585 + 0.0421 * logEinc;
+
+  double p1 = 2.623 - 0.00094 * zEff_;
+  double p2 = 0.401 + 0.00187 * zEff_;
+  double p3 = 1.313 - 0.0686 * logEinc;
+
+  // only a fraction of the energy is seen in the silicon
+  double visibleScale = samplingFraction_ * energyScale_ * GeV;
+
+  const double energyCutoff = 0.01;
+  const double divisionStepInX0 = 0.1;  // step size in X0 unit
+  double energyLeft = energy;           // energy left in GeV
+  double zInX0 = 0.0;                   // shower depth in X0 unit
+  double deltaStep = 0.0;               // step increment along the shower direction
+
+  Genfun::IncompleteGamma gammaDist;
+  double energyInGamma = 0.0;  // integral of the Gamma distribution up to the current depth
+  double sigmaInGamma = 0.0;   // same for the spots
+
+  double timeGlobal = preStepPoint->GetGlobalTime();
+  GflashTrajectoryPoint trajectoryPoint;
+  hits.reserve(static_cast<unsigned int>(nSpots));
+
+  // loop for longitudinal integration
+  while (energyLeft > 0.0 && stepLengthLeft > 0.0) {
+    double deltaZ = std::min(stepLengthLeft, divisionStepInX0 * radLength);
+    double deltaZInX0 = deltaZ / radLength;
+    stepLengthLeft -= deltaZ;
+    zInX0 += deltaZInX0;
+
+    double deltaEnergy(0);
+    int nSpotsInStep(0);
+    if (energyLeft > energyCutoff) {
+      double preEnergyInGamma = energyInGamma;
+      gammaDist.a().setValue(alpha);
+      energyInGamma = gammaDist(beta * zInX0);
+      deltaEnergy = std::min(energyLeft, energy * (energyInGamma - preEnergyInGamma));
+
+      double preSigmaInGamma = sigmaInGamma;
+      gammaDist.a().setValue(spotAlpha);
+      sigmaInGamma = gammaDist(spotBeta * zInX0);
+      nSpotsInStep = std::max(1, int(nSpots * (sigmaInGamma - preSigmaInGamma)));
+    } else {
+      deltaEnergy = energyLeft;
+      nSpotsInStep = std::max(1, int(nSpots * (1.0 - sigmaInGamma)));
+    }
+    if ((energyLeft - deltaEnergy) < energyCutoff)
+      deltaEnergy = energyLeft;
+    energyLeft -= deltaEnergy;
+
+    // It begins with 0.5 of deltaZ and then increases by 1 deltaZ
+    deltaStep += 0.5 * deltaZ;
+    pathLength += deltaStep;
+    deltaStep = 0.5 * deltaZ;
+
+    // lateral shape and fluctuations
+    double tScale = tmax * alpha / (alpha - 1.0) * (1.0 - std::exp(-fluctuatedAlpha));
+    double tau = std::min(10.0, (zInX0 - 0.5 * deltaZInX0) / tScale);
+    double rCore = z1 + z2 * tau;
+    double rTail = k1 * (std::exp(k3 * (tau - k2)) + std::exp(k4 * (tau - k2)));
+    double p23 = (p2 - tau) / p3;
+    double probabilityWeight = p1 * std::exp(p23 - std::exp(p23));
+
+    double spotEnergy = deltaEnergy / nSpotsInStep * visibleScale;
+    for (int ispot = 0; ispot < nSpotsInStep; ++ispot) {
+      double u1 = G4UniformRand();
+      double u2 = G4UniformRand();
+      double rInRM = ((u1 < probabilityWeight) ? rCore : rTail) * std::sqrt(u2 / (1.0 - u2));
+      double rShower = rInRM * rMoliere;
+      double azimuthalAngle = twopi * G4UniformRand();
+
+      // the spots of a step are spread uniformly over its length
+      double incrementPath = (deltaZ / nSpotsInStep) * (ispot + 0.5 - 0.5 * nSpotsInStep);
+      theHelix_->getGflashTrajectoryPoint(trajectoryPoint, pathLength + incrementPath);
+
+      HGCalGflash::Hit oneHit;
+      oneHit.position = (trajectoryPoint.getPosition() +
+                         rShower * std::cos(azimuthalAngle) * trajectoryPoint.getOrthogonalUnitVector() +
+                         rShower * std::sin(azimuthalAngle) * trajectoryPoint.getCrossUnitVector()) *
+                        cm;
+      oneHit.time = timeGlobal + (pathLength + incrementPath - pathLength0) * cm / c_light;
+      oneHit.edep = spotEnergy;
+      hits.push_back(oneHit);
+    }
+  }
+#ifdef EDM_ML_DEBUG
+  edm::LogVerbatim("HGCSim") << "HGCalGflash: " << hits.size() << " spots for " << energy << " GeV at "
+                             << showerStartingPosition << " cm, shower depth " << zInX0 << " X0, energy left "
+                             << energyLeft << " GeV";
+#endif
+  return hits;
+}
@@ -7,6 +7,7 @@
 #include "DataFormats/ForwardDetId/interface/HGCSiliconDetId.h"
 #include "SimG4CMS/Calo/interface/HGCalSD.h"
 #include "SimG4Core/Notification/interface/TrackInformation.h"
+#include "SimG4Core/Notification/interface/G4TrackToParticleID.h"
 #include "FWCore/Utilities/interface/Exception.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/Framework/interface/EventSetup.h"
@@ -41,11 +42,13 @@ HGCalSD::HGCalSD(const std::string& name,
              p.getParameter<edm::ParameterSet>("HGCSD").getParameter<bool>("IgnoreTrackID")),
       hgcons_(nullptr),
       slopeMin_(0),
+      zmaxParam_(0),
       levelT1_(99),
       levelT2_(99),
       tan30deg_(std::tan(30.0 * CLHEP::deg)) {
   numberingScheme_.reset(nullptr);
   mouseBite_.reset(nullptr);
+  showerParam_.reset(nullptr);
 
   edm::ParameterSet m_HGC = p.getParameter<edm::ParameterSet>("HGCSD");
   eminHit_ = m_HGC.getParameter<double>("EminHit") * CLHEP::MeV;
@@ -56,6 +59,9 @@ HGCalSD::HGCalSD(const std::string& name,
   waferRot_ = m_HGC.getParameter<bool>("RotatedWafer");
   cornerMinMask_ = m_HGC.getParameter<int>("CornerMinMask");
   angles_ = m_HGC.getUntrackedParameter<std::vector<double>>("WaferAngles");
+  bool useParam = m_HGC.getParameter<bool>("UseParametrize");
+  eminParam_ = m_HGC.getParameter<double>("EminParametrize") * CLHEP::GeV;
+  containmentParam_ = m_HGC.getParameter<double>("ContainmentParametrize");
 
   if (storeAllG4Hits_) {
     setUseMap(false);
@@ -74,6 +80,12 @@ HGCalSD::HGCalSD(const std::string& name,
     nameX_ = "HGCalHESiliconSensitive";
   }
 
+  // electromagnetic showers are parametrized in the electromagnetic section only
+  if (useParam && mydet_ == DetId::HGCalEE) {
+    showerParam_.reset(new HGCalGflash(p));
+    setParameterized(true);
+  }
+
 #ifdef EDM_ML_DEBUG
   edm::LogVerbatim("HGCSim") << "**************************************************"
                              << "\n"
@@ -91,6 +103,8 @@ HGCalSD::HGCalSD(const std::string& name,
                              << "boundary " << fiducialCut_ << " at " << distanceFromEdge_;
   edm::LogVerbatim("HGCSim") << "Reject MosueBite Flag: " << rejectMB_ << " cuts along " << angles_.size()
                              << " axes: " << angles_[0] << ", " << angles_[1];
+  edm::LogVerbatim("HGCSim") << "Shower parametrization " << (showerParam_ != nullptr) << " for e+-/gamma above "
+                             << eminParam_ / CLHEP::GeV << " GeV contained within " << containmentParam_ << " X0";
 }
 
 double HGCalSD::getEnergyDeposit(const G4Step* aStep) {
@@ -124,6 +138,56 @@ double HGCalSD::getEnergyDeposit(const G4Step* aStep) {
   return destep;
 }
 
+// The shower is parametrized here rather than by a G4VFastSimulationModel of
+// the HGCal region, as HFGflash is in HCalSD: the spots of a fast simulation
+// model are only collected in the sensitive volume they fall in, which for
+// the thin silicon layers of CE-E would lose most of them, while here each
+// spot is moved to the closest layer, which needs the HGCal constants.
+bool HGCalSD::getFromLibrary(const G4Step* aStep) {
+  auto const preStepPoint = aStep->GetPreStepPoint();
+  if ((preStepPoint->GetKineticEnergy() < eminParam_) ||
+      !G4TrackToParticleID::isGammaElectronPositron(aStep->GetTrack()))
+    return false;
+
+  // the shower must be contained before the end of the section
+  const G4ThreeVector& point = preStepPoint->GetPosition();
+  double cosTheta = std::abs(preStepPoint->GetMomentumDirection().z());
+  double maxLength = (cosTheta > 0) ? (zmaxParam_ - std::abs(point.z())) / cosTheta : 0;
+  if (maxLength < containmentParam_ * showerParam_->radiationLength())
+    return false;
+
+  std::vector<HGCalGflash::Hit> hits = showerParam_->gfParameterization(aStep, maxLength);
+  if (hits.empty())
+    return false;
+
+  int primaryID = setTrackID(aStep);
+  resetForNewPrimary(aStep);
+  for (auto const& hit : hits) {
+    // each spot is collected by the sensitive layer closest to it
+    double z = std::abs(hit.position.z());
+    if (z > zmaxParam_)
+      continue;
+    int iz = (hit.position.z() > 0) ? 1 : -1;
+    int layer = hgcons_->getLayer(z, false);
+    G4ThreeVector hitPoint(hit.position.x(), hit.position.y(), iz * hgcons_->waferZ(layer, false));
+    uint32_t id = setDetUnitId(layer, -1, -1, iz, hitPoint);
+    if (id == 0)
+      continue;
+    currentID.setID(id, hit.time / CLHEP::nanosecond, primaryID, 0);
+    posGlobal = hitPoint;
+    edepositEM = weight_ * hit.edep;
+    edepositHAD = 0.f;
+    processHit(aStep);
+  }
+#ifdef EDM_ML_DEBUG
+  edm::LogVerbatim("HGCSim") << "HGCalSD: " << hits.size() << " spots from parametrization for Track "
+                             << aStep->GetTrack()->GetTrackID() << " ("
+                             << aStep->GetTrack()->GetDefinition()->GetParticleName() << ") of "
+                             << preStepPoint->GetKineticEnergy() / CLHEP::GeV << " GeV at " << point;
+#endif
+  return true;
+}
+
 uint32_t HGCalSD::setDetUnitId(const G4Step* aStep) {
   const G4StepPoint* preStepPoint = aStep->GetPreStepPoint();
   const G4VTouchable* touch = preStepPoint->GetTouchable();
@@ -201,6 +265,13 @@ void HGCalSD::update(const BeginOfJob* job) {
     double waferSize = hgcons_->waferSize(false);
     double mouseBite = hgcons_->mouseBite(false);
     mouseBiteCut_ = waferSize * tan30deg_ - mouseBite;
+    zmaxParam_ = hgcons_->rangeZ(false).second;
+    // the cells of the spots are found from their position
+    if (showerParam_ && geom_mode_ != HGCalGeometryMode::Hexagon8Full) {
+      edm::LogWarning("HGCSim") << "HGCalSD: no shower parametrization for geometry mode " << geom_mode_;
+      showerParam_.reset(nullptr);
+      setParameterized(false);
+    }
 #ifdef EDM_ML_DEBUG
     edm::LogVerbatim("HGCSim") << "HGCalSD::Initialized with mode " << geom_mode_ << " Slope cut " << slopeMin_
                                << " top Level " << levelT1_ << ":" << levelT2_ << " wafer " << waferSize << ":"
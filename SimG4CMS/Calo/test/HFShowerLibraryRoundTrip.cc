@@ -0,0 +1,106 @@
+// -*- C++ -*-
+//
+// Package:    SimG4CMS/Calo
+// Class:      HFShowerLibraryRoundTrip
+//
+/**\class HFShowerLibraryRoundTrip HFShowerLibraryRoundTrip.cc test/HFShowerLibraryRoundTrip.cc
+
+ Description: Checks a library converted by HFShowerLibraryConverter against
+              the ROOT library it was converted from: every em and had record
+              read by HFShowerLibrary::getRecord from the mapped file has the
+              same photons as the record read from the ROOT file. Throws at
+              the first difference.
+*/
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESTransientHandle.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DetectorDescription/Core/interface/DDCompactView.h"
+#include "Geometry/Records/interface/IdealGeometryRecord.h"
+#include "SimG4CMS/Calo/interface/HFShowerLibrary.h"
+#include "SimG4CMS/Calo/interface/HFShowerLibraryFile.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+  // gives access to the records of the library
+  class HFShowerLibraryReader : public HFShowerLibrary {
+  public:
+    using HFShowerLibrary::HFShowerLibrary;
+
+    std::vector<HFShowerPhoton> photons(int type, int record) {
+      getRecord(type, record);
+      std::vector<HFShowerPhoton> result;
+      for (int j = 0; j < recordSize(); ++j)
+        result.push_back(recordPhoton(j));
+      return result;
+    }
+  };
+}  // namespace
+
+class HFShowerLibraryRoundTrip : public edm::one::EDAnalyzer<> {
+public:
+  explicit HFShowerLibraryRoundTrip(const edm::ParameterSet&);
+
+  void analyze(edm::Event const&, edm::EventSetup const&) override;
+
+private:
+  edm::ParameterSet rootConf_, convertedConf_;
+  std::string convertedFile_;
+};
+
+HFShowerLibraryRoundTrip::HFShowerLibraryRoundTrip(const edm::ParameterSet& ps) {
+  rootConf_.addParameter<edm::ParameterSet>("HFShower", ps.getParameter<edm::ParameterSet>("HFShower"));
+  rootConf_.addParameter<edm::ParameterSet>("HFShowerLibrary", ps.getParameter<edm::ParameterSet>("HFShowerLibrary"));
+  // the same library, read from the converted file
+  const edm::FileInPath converted = ps.getParameter<edm::FileInPath>("ConvertedFileName");
+  convertedFile_ = converted.fullPath();
+  edm::ParameterSet convertedLibrary = ps.getParameter<edm::ParameterSet>("HFShowerLibrary");
+  convertedLibrary.addParameter<edm::FileInPath>("FileName", converted);
+  convertedConf_.addParameter<edm::ParameterSet>("HFShower", ps.getParameter<edm::ParameterSet>("HFShower"));
+  convertedConf_.addParameter<edm::ParameterSet>("HFShowerLibrary", convertedLibrary);
+}
+
+void HFShowerLibraryRoundTrip::analyze(const edm::Event&, const edm::EventSetup& iSetup) {
+  edm::ESTransientHandle<DDCompactView> cpv;
+  iSetup.get<IdealGeometryRecord>().get(cpv);
+
+  if (!HFShowerLibraryFile::hasFormat(convertedFile_))
+    throw cms::Exception("HFShowerLibraryMismatch") << convertedFile_ << " is not a converted shower library";
+  const int totEvents = HFShowerLibraryFile(convertedFile_).totalEvents();
+
+  HFShowerLibraryReader rootLibrary("HFShowerLibrary", *cpv, rootConf_);
+  HFShowerLibraryReader convertedLibrary("HFShowerLibrary", *cpv, convertedConf_);
+  long long nPhotons = 0;
+  for (int type = 0; type < 2; ++type) {
+    for (int record = 1; record <= totEvents; ++record) {
+      const auto expected = rootLibrary.photons(type, record);
+      const auto found = convertedLibrary.photons(type, record);
+      if (found.size() != expected.size())
+        throw cms::Exception("HFShowerLibraryMismatch")
+            << "record " << record << " of type " << type << " has " << found.size() << " photons instead of "
+            << expected.size();
+      for (size_t j = 0; j < expected.size(); ++j) {
+        const auto &a = expected[j], &b = found[j];
+        if (a.x() != b.x() || a.y() != b.y() || a.z() != b.z() || a.lambda() != b.lambda() || a.t() != b.t())
+          throw cms::Exception("HFShowerLibraryMismatch")
+              << "photon " << j << " of record " << record << " of type " << type << " is " << b << " instead of "
+              << a;
+      }
+      nPhotons += expected.size();
+    }
+  }
+  edm::LogVerbatim("HFShower") << "HFShowerLibraryRoundTrip: " << 2 * totEvents << " records with " << nPhotons
+                               << " photons are identical in " << convertedFile_;
+}
+
+DEFINE_FWK_MODULE(HFShowerLibraryRoundTrip);
@@ -0,0 +1,188 @@
+///////////////////////////////////////////////////////////////////////////////
+// File: HGCalShowerProfile.cc
+// Description: Longitudinal and transverse profiles of single particle
+//              showers in the silicon part of HGCal, to compare the full
+//              simulation with the shower parametrization of HGCalSD
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+
+#include "DataFormats/ForwardDetId/interface/HGCSiliconDetId.h"
+#include "Geometry/HGCalCommonData/interface/HGCalDDDConstants.h"
+#include "Geometry/Records/interface/IdealGeometryRecord.h"
+#include "SimDataFormats/CaloHit/interface/PCaloHit.h"
+#include "SimDataFormats/CaloHit/interface/PCaloHitContainer.h"
+#include "SimDataFormats/GeneratorProducts/interface/HepMCProduct.h"
+
+#include <TH1F.h>
+#include <TProfile.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+class HGCalShowerProfile : public edm::one::EDAnalyzer<edm::one::WatchRuns, edm::one::SharedResources> {
+public:
+  HGCalShowerProfile(const edm::ParameterSet &ps);
+  ~HGCalShowerProfile() override {}
+  static void fillDescriptions(edm::ConfigurationDescriptions &descriptions);
+
+protected:
+  void beginJob() override;
+  void beginRun(edm::Run const &, edm::EventSetup const &) override;
+  void endRun(edm::Run const &, edm::EventSetup const &) override {}
+  void analyze(const edm::Event &e, const edm::EventSetup &c) override;
+
+private:
+  const std::string nameDetector_;
+  const double maxEnergy_, maxRadius_, tcut_;
+  edm::EDGetTokenT<edm::HepMCProduct> tok_evt_;
+  edm::EDGetTokenT<edm::PCaloHitContainer> tok_hits_;
+  const HGCalDDDConstants *hgcons_;
+  int layers_;
+  TH1F *eneInc_, *response_, *nHits_, *depth_, *width_, *lateral_;
+  TProfile *longitudinal_;
+};
+
+HGCalShowerProfile::HGCalShowerProfile(const edm::ParameterSet &ps)
+    : nameDetector_(ps.getParameter<std::string>("DetectorName")),
+      maxEnergy_(ps.getParameter<double>("MaxEnergy")),
+      maxRadius_(ps.getParameter<double>("MaxRadius")),
+      tcut_(ps.getParameter<double>("TimeCut")),
+      hgcons_(nullptr),
+      layers_(0) {
+  usesResource(TFileService::kSharedResource);
+  tok_evt_ = consumes<edm::HepMCProduct>(ps.getParameter<edm::InputTag>("SourceLabel"));
+  tok_hits_ = consumes<edm::PCaloHitContainer>(ps.getParameter<edm::InputTag>("HitCollection"));
+  edm::LogVerbatim("HitStudy") << "HGCalShowerProfile:: hits of " << nameDetector_ << " from "
+                               << ps.getParameter<edm::InputTag>("HitCollection") << " within " << tcut_
+                               << " ns, incident energy up to " << maxEnergy_ << " GeV";
+}
+
+void HGCalShowerProfile::fillDescriptions(edm::ConfigurationDescriptions &descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<std::string>("DetectorName", "HGCalEESensitive");
+  desc.add<edm::InputTag>("SourceLabel", edm::InputTag("generatorSmeared"));
+  desc.add<edm::InputTag>("HitCollection", edm::InputTag("g4SimHits", "HGCHitsEE"));
+  desc.add<double>("MaxEnergy", 200.0);
+  desc.add<double>("MaxRadius", 100.0);
+  desc.add<double>("TimeCut", 100.0);
+  descriptions.add("hgcalShowerProfile", desc);
+}
+
+void HGCalShowerProfile::beginJob() {
+  edm::Service<TFileService> tfile;
+  if (!tfile.isAvailable())
+    throw cms::Exception("BadConfig") << "TFileService unavailable: "
+                                      << "please add it to config file";
+  eneInc_ = tfile->make<TH1F>("EneInc", "Incident energy;E (GeV);Events", 1000, 0., maxEnergy_);
+  response_ = tfile->make<TH1F>("Response", "Visible energy;E_{vis}/E_{inc};Events", 1000, 0., 0.05);
+  nHits_ = tfile->make<TH1F>("NHits", "Cells with energy;Cells;Events", 500, 0., 5000.);
+  depth_ = tfile->make<TH1F>("Depth", "Energy weighted mean layer;Layer;Events", 200, 0., 50.);
+  width_ = tfile->make<TH1F>("Width", "Energy weighted RMS radius;r (mm);Events", 200, 0., 0.5 * maxRadius_);
+  lateral_ = tfile->make<TH1F>(
+      "Lateral", "Transverse profile;r from the layer barycentre (mm);E/E_{vis}", 200, 0., maxRadius_);
+}
+
+void HGCalShowerProfile::beginRun(edm::Run const &, edm::EventSetup const &es) {
+  edm::ESHandle<HGCalDDDConstants> hdc;
+  es.get<IdealGeometryRecord>().get(nameDetector_, hdc);
+  if (!hdc.isValid())
+    throw cms::Exception("Unknown", "HGCalShowerProfile") << "Cannot find HGCalDDDConstants for " << nameDetector_;
+  hgcons_ = hdc.product();
+  if (layers_ == 0) {
+    layers_ = hgcons_->layers(false);
+    edm::Service<TFileService> tfile;
+    longitudinal_ = tfile->make<TProfile>("Longitudinal",
+                                          "Longitudinal profile;Layer;E_{layer}/E_{inc}",
+                                          layers_,
+                                          hgcons_->firstLayer() - 0.5,
+                                          hgcons_->firstLayer() + layers_ - 0.5);
+  }
+}
+
+void HGCalShowerProfile::analyze(const edm::Event &e, const edm::EventSetup &) {
+  edm::Handle<edm::HepMCProduct> evtMC;
+  e.getByToken(tok_evt_, evtMC);
+  if (!evtMC.isValid())
+    return;
+  const HepMC::GenEvent *myGenEvent = evtMC->GetEvent();
+  auto p = myGenEvent->particles_begin();
+  if (p == myGenEvent->particles_end())
+    return;
+  double eInc = (*p)->momentum().e();
+  eneInc_->Fill(eInc);
+
+  edm::Handle<edm::PCaloHitContainer> hits;
+  e.getByToken(tok_hits_, hits);
+  if (!hits.isValid())
+    return;
+
+  // position of each cell and energy collected in each layer
+  struct Cell {
+    int layer;
+    double x, y, energy;
+  };
+  std::vector<Cell> cells;
+  std::vector<double> eLayer(layers_, 0), xLayer(layers_, 0), yLayer(layers_, 0);
+  double eTotal(0);
+  for (auto const &hit : *hits) {
+    if (hit.time() > tcut_)
+      continue;
+    HGCSiliconDetId id(hit.id());
+    int lay = id.layer() - hgcons_->firstLayer();
+    if (lay < 0 || lay >= layers_)
+      continue;
+    auto xy = hgcons_->locateCell(id.layer(), id.waferU(), id.waferV(), id.cellU(), id.cellV(), false, true);
+    double x = (id.zside() < 0) ? -xy.first : xy.first;
+    cells.emplace_back(Cell{lay, x, xy.second, hit.energy()});
+    eLayer[lay] += hit.energy();
+    xLayer[lay] += hit.energy() * x;
+    yLayer[lay] += hit.energy() * xy.second;
+    eTotal += hit.energy();
+  }
+  if (eTotal <= 0)
+    return;
+
+  double depth(0);
+  for (int lay = 0; lay < layers_; ++lay) {
+    longitudinal_->Fill(lay + hgcons_->firstLayer(), eLayer[lay] / eInc);
+    depth += eLayer[lay] * (lay + hgcons_->firstLayer());
+    if (eLayer[lay] > 0) {
+      xLayer[lay] /= eLayer[lay];
+      yLayer[lay] /= eLayer[lay];
+    }
+  }
+
+  // the transverse distances are taken from the barycentre of each layer, which
+  // follows the shower axis also for the electrons bent by the field
+  double r2(0);
+  for (auto const &cell : cells) {
+    double r = std::hypot(cell.x - xLayer[cell.layer], cell.y - yLayer[cell.layer]);
+    lateral_->Fill(r, cell.energy / eTotal);
+    r2 += cell.energy * r * r;
+  }
+
+  response_->Fill(eTotal / eInc);
+  nHits_->Fill(cells.size());
+  depth_->Fill(depth / eTotal);
+  width_->Fill(std::sqrt(r2 / eTotal));
+}
+
+//define this as a plug-in
+DEFINE_FWK_MODULE(HGCalShowerProfile);
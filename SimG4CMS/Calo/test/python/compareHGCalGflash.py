@@ -0,0 +1,66 @@
+#!/usr/bin/env python
+###############################################################################
+# Compares the HGCal shower profiles of two runs of runHGCalGflash_cfg.py
+# (full simulation and shower parametrization): visible energy, depth and
+# width of the showers, energy fraction per layer and transverse profile
+#
+#   python compareHGCalGflash.py hgcalGflash0.root hgcalGflash1.root [tolerance]
+#
+# A quantity is flagged when the parametrization differs from the full
+# simulation by more than the relative tolerance (default 0.05)
+###############################################################################
+from __future__ import print_function
+import sys
+import ROOT
+
+if len(sys.argv) not in (3, 4):
+    print("usage: compareHGCalGflash.py reference.root parametrized.root [tolerance]")
+    sys.exit(1)
+tolerance = float(sys.argv[3]) if len(sys.argv) == 4 else 0.05
+
+files = [ROOT.TFile.Open(name) for name in sys.argv[1:3]]
+get = lambda name: [f.Get("hgcalShowerProfile/%s" % name) for f in files]
+bad = 0
+
+def compare(label, ref, new):
+    global bad
+    diff = (new - ref) / ref if ref != 0 else 0.
+    flag = ""
+    if abs(diff) > tolerance:
+        flag = " <--"
+        bad += 1
+    print("%-22s %12.5g %12.5g %8.3f%s" % (label, ref, new, diff, flag))
+
+print("%-22s %12s %12s %8s" % ("quantity", "full", "param", "rel.diff"))
+for name in ["Response", "Depth", "Width", "NHits"]:
+    h = get(name)
+    compare(name + " mean", h[0].GetMean(), h[1].GetMean())
+    compare(name + " RMS", h[0].GetRMS(), h[1].GetRMS())
+
+# longitudinal profile: mean energy fraction per layer
+h = get("Longitudinal")
+for i in range(1, h[0].GetNbinsX() + 1):
+    if h[0].GetBinContent(i) > 0.01 * h[0].GetMaximum():
+        compare("layer %d" % int(h[0].GetBinCenter(i)), h[0].GetBinContent(i), h[1].GetBinContent(i))
+
+# transverse profile: radii containing 50, 90 and 95% of the energy
+h = get("Lateral")
+quantiles = [0.5, 0.9, 0.95]
+for q in quantiles:
+    r = []
+    for hist in h:
+        probs = ROOT.std.vector('double')([q])
+        radius = ROOT.std.vector('double')([0.])
+        hist.GetQuantiles(1, radius.data(), probs.data())
+        r.append(radius[0])
+    compare("R%d%% (mm)" % int(100 * q), r[0], r[1])
+
+# the visible energy is proportional to SamplingFraction * EnergyScale, the
+# depth and width of the showers depend on EffectiveZ
+h = get("Response")
+if h[1].GetMean() > 0:
+    print("EnergyScale matching the full simulation: %.4g times the one of %s"
+          % (h[0].GetMean() / h[1].GetMean(), sys.argv[2]))
+
+print("%d quantities differ by more than %g" % (bad, tolerance))
+sys.exit(1 if bad else 0)
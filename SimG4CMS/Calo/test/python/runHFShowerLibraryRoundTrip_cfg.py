@@ -0,0 +1,34 @@
+###############################################################################
+# Reads all the records of the HF shower library of g4SimHits from the ROOT
+# file and from the file converted by HFShowerLibraryConverter, and checks
+# that they have the same photons (see testHFShowerLibraryRoundTrip.sh)
+#
+#   cmsRun runHFShowerLibraryRoundTrip_cfg.py converted=hfShowerLibrary.bin
+#
+# The converted file is looked for in CMSSW_SEARCH_PATH
+###############################################################################
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing()
+options.register ("converted", "hfShowerLibrary.bin", VarParsing.multiplicity.singleton, VarParsing.varType.string)
+options.parseArguments()
+
+process = cms.Process("HFShowerLibraryRoundTrip")
+process.load('Geometry.CMSCommonData.cmsExtendedGeometry2018XML_cfi')
+process.load('SimG4Core.Application.g4SimHits_cfi')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.MessageLogger.categories.append('HFShower')
+
+process.source = cms.Source("EmptySource")
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(1)
+)
+
+process.hfShowerLibraryRoundTrip = cms.EDAnalyzer("HFShowerLibraryRoundTrip",
+    HFShower = process.g4SimHits.HFShower,
+    HFShowerLibrary = process.g4SimHits.HFShowerLibrary,
+    ConvertedFileName = cms.FileInPath(options.converted)
+)
+
+process.p1 = cms.Path(process.hfShowerLibraryRoundTrip)
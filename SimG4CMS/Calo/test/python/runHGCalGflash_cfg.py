@@ -0,0 +1,113 @@
+###############################################################################
+# Validation of the shower parametrization of HGCalSD: the same single
+# particle sample is simulated with full Geant4 showers and with GFlash in
+# CE-E, and the longitudinal and transverse shower profiles are histogrammed
+# by HGCalShowerProfile
+#
+#   cmsRun runHGCalGflash_cfg.py parametrize=0
+#   cmsRun runHGCalGflash_cfg.py parametrize=1
+#   python compareHGCalGflash.py hgcalGflash0.root hgcalGflash1.root
+#
+# The effective constants of the HGCalGflash PSet are tuned by repeating the
+# second job with other values, e.g.
+#
+#   cmsRun runHGCalGflash_cfg.py parametrize=1 energyScale=1.1 effectiveZ=55 tag=_z55
+#   python compareHGCalGflash.py hgcalGflash0.root hgcalGflash1_z55.root
+#
+# The CPU time of g4SimHits is in the Timing summary of the two jobs
+###############################################################################
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing()
+options.register ("parametrize", 1,    VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.register ("particle",    11,   VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.register ("energy",      50.0, VarParsing.multiplicity.singleton, VarParsing.varType.float)
+options.register ("events",      1000, VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.register ("energyScale", 0.0,  VarParsing.multiplicity.singleton, VarParsing.varType.float,
+                  "EnergyScale of HGCalGflash (0: default)")
+options.register ("effectiveZ",  0.0,  VarParsing.multiplicity.singleton, VarParsing.varType.float,
+                  "EffectiveZ of HGCalGflash (0: default)")
+options.register ("tag",         "",   VarParsing.multiplicity.singleton, VarParsing.varType.string,
+                  "Suffix of the output file")
+options.parseArguments()
+
+process = cms.Process("HGCalGflash")
+process.load("SimGeneral.HepPDTESSource.pythiapdt_cfi")
+process.load("IOMC.EventVertexGenerators.VtxSmearedGauss_cfi")
+process.load("Geometry.HGCalCommonData.testHGCV10XML_cfi")
+process.load("Geometry.HGCalCommonData.hgcalParametersInitialization_cfi")
+process.load("Geometry.HGCalCommonData.hgcalNumberingInitialization_cfi")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load('Configuration.StandardSequences.Generator_cff')
+process.load('Configuration.StandardSequences.SimIdeal_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.autoCond import autoCond
+process.GlobalTag.globaltag = autoCond['phase2_realistic']
+
+if hasattr(process,'MessageLogger'):
+    process.MessageLogger.categories.append('HGCSim')
+
+process.load("IOMC.RandomEngine.IOMC_cff")
+process.RandomNumberGeneratorService.generator.initialSeed = 456789
+process.RandomNumberGeneratorService.g4SimHits.initialSeed = 9876
+process.RandomNumberGeneratorService.VtxSmeared.initialSeed = 123456789
+
+process.Timing = cms.Service("Timing")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.events)
+)
+
+process.source = cms.Source("EmptySource",
+    firstRun        = cms.untracked.uint32(1),
+    firstEvent      = cms.untracked.uint32(1)
+)
+
+process.generator = cms.EDProducer("FlatRandomEGunProducer",
+    PGunParameters = cms.PSet(
+        PartID = cms.vint32(options.particle),
+        MinEta = cms.double(1.69),
+        MaxEta = cms.double(2.32),
+        MinPhi = cms.double(-3.1415926),
+        MaxPhi = cms.double(3.1415926),
+        MinE   = cms.double(options.energy),
+        MaxE   = cms.double(options.energy)
+    ),
+    Verbosity       = cms.untracked.int32(0),
+    AddAntiParticle = cms.bool(False)
+)
+
+process.hgcalShowerProfile = cms.EDAnalyzer("HGCalShowerProfile",
+    DetectorName  = cms.string("HGCalEESensitive"),
+    SourceLabel   = cms.InputTag("generatorSmeared"),
+    HitCollection = cms.InputTag("g4SimHits", "HGCHitsEE"),
+    MaxEnergy     = cms.double(2.0 * options.energy),
+    MaxRadius     = cms.double(100.0),
+    TimeCut       = cms.double(100.0)
+)
+
+process.TFileService = cms.Service("TFileService",
+    fileName = cms.string('hgcalGflash%d%s.root' % (options.parametrize, options.tag))
+)
+
+process.generation_step = cms.Path(process.pgen)
+process.simulation_step = cms.Path(process.psim)
+process.analysis_step   = cms.Path(process.hgcalShowerProfile)
+
+process.g4SimHits.Physics.type = 'SimG4Core/Physics/FTFP_BERT_EMM'
+process.g4SimHits.HGCSD.UseParametrize = bool(options.parametrize)
+if options.energyScale > 0:
+    process.g4SimHits.HGCalGflash.EnergyScale = options.energyScale
+if options.effectiveZ > 0:
+    process.g4SimHits.HGCalGflash.EffectiveZ = options.effectiveZ
+
+process.schedule = cms.Schedule(process.generation_step,
+                                process.simulation_step,
+                                process.analysis_step
+                                )
+
+# filter all path with the production filter sequence
+for path in process.paths:
+        getattr(process,path)._seq = process.generator * getattr(process,path)._seq
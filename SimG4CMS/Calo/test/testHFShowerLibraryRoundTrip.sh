@@ -0,0 +1,18 @@
+#!/bin/bash
+
+function die { echo $1: status $2 ;  exit $2; }
+
+# converts the HF shower library of g4SimHits and reads it back through HFShowerLibrary
+library=SimG4CMS/Calo/data/HFShowerLibrary_oldpmt_noatt_eta4_16en_v3.root
+input=""
+for dir in $(echo $CMSSW_SEARCH_PATH | tr : '\n') ;  do
+  if [ -f ${dir}/${library} ] ; then
+    input=${dir}/${library}
+    break
+  fi
+done
+[ -n "${input}" ] || die "${library} not found in CMSSW_SEARCH_PATH" 1
+
+HFShowerLibraryConverter ${input} hfShowerLibrary.bin || die 'Failure converting the HF shower library' $?
+CMSSW_SEARCH_PATH=$(pwd):${CMSSW_SEARCH_PATH} cmsRun ${LOCAL_TEST_DIR}/python/runHFShowerLibraryRoundTrip_cfg.py converted=hfShowerLibrary.bin || die 'Failure reading back the converted HF shower library' $?
+rm -f hfShowerLibrary.bin
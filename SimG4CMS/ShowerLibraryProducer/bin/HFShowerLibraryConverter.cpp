@@ -0,0 +1,132 @@
+//
+// Package:        ShowerLibraryProducer
+// Program:        HFShowerLibraryConverter
+//
+// Converts an HF shower library ROOT file into the flat binary format of
+// HFShowerLibraryFile, which the HFShowerLibrary maps into memory when its
+// FileName points to a converted library. The branch names are given as in
+// the HFShowerLibrary PSet, with the defaults of g4SimHits_cfi.
+//
+/////////////////////////////////////////////////////////////////////
+//
+#include "FWCore/Utilities/interface/Exception.h"
+#include "SimDataFormats/CaloHit/interface/HFShowerPhoton.h"
+#include "SimDataFormats/CaloHit/interface/HFShowerLibraryEventInfo.h"
+#include "SimG4CMS/Calo/interface/HFShowerLibraryFile.h"
+
+#include "TROOT.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+void Usage();
+
+int main(int argc, char *argv[]) {
+  if (argc < 3)
+    Usage();
+  std::map<std::string, std::string> names = {{"TreeEMID", "emParticles"},
+                                              {"TreeHadID", "hadParticles"},
+                                              {"BranchEvt", ""},
+                                              {"BranchPre", ""},
+                                              {"BranchPost", ""}};
+  for (int i = 3; i < argc; ++i) {
+    std::string arg(argv[i]);
+    auto eq = arg.find('=');
+    if (eq == std::string::npos || names.find(arg.substr(0, eq)) == names.end())
+      Usage();
+    names[arg.substr(0, eq)] = arg.substr(eq + 1);
+  }
+
+  TFile *hf = TFile::Open(argv[1]);
+  if (hf == nullptr || !hf->IsOpen())
+    throw cms::Exception("Unknown", "HFShowerLibraryConverter") << "Opening of " << argv[1] << " fails\n";
+
+  const bool newForm = names["BranchEvt"].empty();
+  TTree *event = (TTree *)hf->Get(newForm ? "HFSimHits" : "Events");
+  if (event == nullptr)
+    throw cms::Exception("Unknown", "HFShowerLibraryConverter") << "Events tree absent\n";
+
+  HFShowerLibraryFile::Header header;
+  std::vector<double> pmom;
+  if (newForm) {
+    // hardwired as in HFShowerLibrary::loadEventInfo
+    header.nMomBin = 16;
+    header.evtPerBin = 5000;
+    header.totEvents = header.nMomBin * header.evtPerBin;
+    header.libVers = 1.1;
+    header.listVersion = 3.6;
+    pmom = {2, 3, 5, 7, 10, 15, 20, 30, 50, 75, 100, 150, 250, 350, 500, 1000};
+  } else {
+    std::string info = names["BranchEvt"] + names["BranchPost"];
+    TBranch *evtInfo = event->GetBranch(info.c_str());
+    if (evtInfo == nullptr)
+      throw cms::Exception("Unknown", "HFShowerLibraryConverter") << "Event information absent\n";
+    std::vector<HFShowerLibraryEventInfo> eventInfoCollection;
+    evtInfo->SetAddress(&eventInfoCollection);
+    evtInfo->GetEntry(0);
+    header.totEvents = eventInfoCollection[0].totalEvents();
+    header.nMomBin = eventInfoCollection[0].numberOfBins();
+    header.evtPerBin = eventInfoCollection[0].eventsPerBin();
+    header.libVers = eventInfoCollection[0].showerLibraryVersion();
+    header.listVersion = eventInfoCollection[0].physListVersion();
+    pmom = eventInfoCollection[0].energyBins();
+  }
+
+  std::string nameBr = names["BranchPre"] + names["TreeEMID"] + names["BranchPost"];
+  TBranch *emBranch = event->GetBranch(nameBr.c_str());
+  nameBr = names["BranchPre"] + names["TreeHadID"] + names["BranchPost"];
+  TBranch *hadBranch = event->GetBranch(nameBr.c_str());
+  if (emBranch == nullptr || hadBranch == nullptr)
+    throw cms::Exception("Unknown", "HFShowerLibraryConverter") << "Photon branches absent\n";
+  const bool v3version = (emBranch->GetClassName() == std::string("vector<float>"));
+
+  std::cout << "HFShowerLibraryConverter: Library " << header.libVers << " ListVersion " << header.listVersion
+            << " Events Total " << header.totEvents << " and " << header.evtPerBin << " per bin in " << header.nMomBin
+            << " bins" << std::endl;
+
+  // the records are read as in HFShowerLibrary::getRecord
+  HFShowerPhotonCollection photon;
+  HFShowerPhotonCollection *photo = new HFShowerPhotonCollection;
+  std::vector<float> t;
+  std::vector<float> *tp = &t;
+  auto fillRecord = [&](int type, int record, std::vector<HFShowerLibraryFile::Photon> &photons) {
+    TBranch *branch = (type > 0) ? hadBranch : emBranch;
+    const int entry = (type > 0 && newForm) ? record - 1 + header.totEvents : record - 1;
+    if (newForm && v3version) {
+      t.clear();
+      branch->SetAddress(&tp);
+      branch->GetEntry(entry);
+      unsigned int tSize = t.size() / 5;
+      for (unsigned int i = 0; i < tSize; i++)
+        photons.push_back({t[i], t[1 * tSize + i], t[2 * tSize + i], t[3 * tSize + i], t[4 * tSize + i]});
+    } else {
+      HFShowerPhotonCollection *photons0 = newForm ? photo : &photon;
+      photons0->clear();
+      if (newForm)
+        branch->SetAddress(&photo);
+      else
+        branch->SetAddress(&photon);
+      branch->GetEntry(entry);
+      for (const auto &ph : *photons0)
+        photons.push_back({ph.x(), ph.y(), ph.z(), ph.lambda(), ph.t()});
+    }
+  };
+  HFShowerLibraryFile::write(argv[2], header, pmom, fillRecord);
+
+  std::cout << "HFShowerLibraryConverter: wrote " << argv[2] << std::endl;
+  delete photo;
+  hf->Close();
+  return 0;
+}
+
+void Usage() {
+  std::cout << "Usage: HFShowerLibraryConverter input_file output_file [TreeEMID=...] [TreeHadID=...] [BranchEvt=...]"
+            << " [BranchPre=...] [BranchPost=...]" << std::endl;
+  exit(1);
+}
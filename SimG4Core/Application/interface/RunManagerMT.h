@@ -88,6 +88,10 @@ public:
 private:
   void terminateRun();
   void DumpMagneticField(const G4Field*) const;
+  // thin wrapper over SetPhysicsTableRetrieved and StorePhysicsTable with a
+  // directory per Geant4 version, physics configuration, materials and cuts
+  void retrieveCachedPhysicsTables();
+  void storeCachedPhysicsTables();
 
   G4MTRunManagerKernel* m_kernel;
 
@@ -106,6 +110,10 @@ private:
   const std::string m_PhysicsTablesDir;
   bool m_StorePhysicsTables;
   bool m_RestorePhysicsTables;
+  bool m_CachePhysicsTables;
+  bool m_StoreCachedPhysicsTables;
+  std::string m_CachedTablesDir;
+  int m_CachedTablesLock;
   bool m_check;
   edm::ParameterSet m_pField;
   edm::ParameterSet m_pPhysics;
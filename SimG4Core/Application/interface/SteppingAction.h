@@ -68,6 +68,7 @@ private:
   bool initialized;
   bool killBeamPipe;
   bool hasWatcher;
+  bool hasWoodcock;
 };
 
 inline bool SteppingAction::isInsideDeadRegion(const G4Region* reg) const {
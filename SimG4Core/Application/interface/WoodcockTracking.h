@@ -0,0 +1,112 @@
+#ifndef SimG4Core_Application_WoodcockTracking_H
+#define SimG4Core_Application_WoodcockTracking_H
+
+// Woodcock (delta) tracking of neutral particles inside the G4Regions
+// given in the configuration.
+//
+// Inside a region the track is moved in one step from its position to
+// the next real interaction or to the exit of the region envelope (the
+// root logical volume of the region), whichever comes first. The flight
+// distances are sampled with the majorant cross section of all the
+// materials of the envelope, and a candidate point is accepted as a
+// real interaction with the probability sigma(point)/majorant, so that
+// no step is limited by the boundaries of the volumes inside the
+// envelope. The interaction itself is done in the next step by the
+// physics process chosen at the accepted point.
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "globals.hh"
+#include "G4VDiscreteProcess.hh"
+#include "G4ParticleChange.hh"
+#include "G4Navigator.hh"
+
+#include <unordered_map>
+#include <vector>
+
+class G4Step;
+class G4Track;
+class G4Region;
+class G4LogicalVolume;
+class G4MaterialCutsCouple;
+class G4ParticleDefinition;
+class G4VEmProcess;
+class G4HadronicProcess;
+
+class WoodcockTracking : public G4VDiscreteProcess {
+public:
+  // process sub type, also used by SteppingAction to recognise the
+  // secondaries of the interactions done through this process
+  static constexpr int subType = 499;
+
+  explicit WoodcockTracking(const edm::ParameterSet &,
+                            const G4ParticleDefinition *,
+                            const std::vector<const G4Region *> &);
+
+  ~WoodcockTracking() override;
+
+  G4bool IsApplicable(const G4ParticleDefinition &) override;
+
+  void BuildPhysicsTable(const G4ParticleDefinition &) override;
+
+  void StartTracking(G4Track *) override;
+
+  G4double PostStepGetPhysicalInteractionLength(const G4Track &track,
+                                                G4double previousStepSize,
+                                                G4ForceCondition *condition) override;
+
+  G4VParticleChange *PostStepDoIt(const G4Track &, const G4Step &) override;
+
+protected:
+  G4double GetMeanFreePath(const G4Track &, G4double, G4ForceCondition *) override;
+
+private:
+  // discrete process of the particle taking part in the walk
+  struct Channel {
+    G4VProcess *process;
+    G4VEmProcess *emProcess;
+    G4HadronicProcess *hadProcess;
+  };
+
+  // majorant cross section per energy bin of the materials of an envelope
+  struct Envelope {
+    std::vector<G4double> majorant;
+  };
+
+  void initialise();
+  const Envelope &envelope(const G4LogicalVolume *);
+  G4double crossSection(const Channel &, G4double ekin, const G4MaterialCutsCouple *) const;
+  G4int energyBin(G4double ekin) const;
+
+  const G4ParticleDefinition *particle_;
+  std::vector<const G4Region *> regions_;
+  std::vector<Channel> channels_;
+  std::unordered_map<const G4LogicalVolume *, Envelope> envelopes_;
+
+  G4ParticleChange fParticleChange;
+  G4Navigator navigator_;
+  std::vector<G4double> sigma_;
+
+  G4double minEnergy_;
+  G4double maxEnergy_;
+  G4double logMinEnergy_;
+  G4double binsPerLog_;
+  G4double majorantFactor_;
+  G4double tolerance_;
+  G4int nBins_;
+
+  // result of the walk of the current step
+  G4ThreeVector endPoint_;
+  G4double stepLength_;
+  G4VProcess *interaction_;
+  G4VProcess *pending_;
+  G4bool initialised_;
+
+  // statistics of the walks
+  unsigned long nWalks_;
+  unsigned long nCandidates_;
+  unsigned long nInteractions_;
+  unsigned long nViolations_;
+};
+
+#endif
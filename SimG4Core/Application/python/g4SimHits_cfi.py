@@ -52,6 +52,9 @@ g4SimHits = cms.EDProducer("OscarMTProducer",
     PhysicsTablesDirectory = cms.string('PhysicsTables'),
     StorePhysicsTables = cms.bool(False),
     RestorePhysicsTables = cms.bool(False),
+    # Store/RestorePhysicsTables, per Geant4 version, physics, materials and cuts:
+    # PhysicsTablesDirectory must then be an absolute directory shared by the jobs of the node
+    CachePhysicsTables = cms.bool(False),
     CheckOverlap = cms.untracked.bool(False),
     G4CheckOverlap = cms.PSet(
         Tolerance = cms.untracked.double(0.0),
@@ -168,6 +171,15 @@ g4SimHits = cms.EDProducer("OscarMTProducer",
         EnergyRMSE      = cms.vdouble(0.0,0.0),
         MinStepLimit              = cms.double(1.0),
         ModifyTransportation      = cms.bool(False),
+        ## Woodcock tracking in these regions, none if empty. Not validated yet:
+        ## test/runWoodcockValidation_cfg.py has not been run against the standard
+        ## tracking, so keep it empty in production
+        WoodcockRegions           = cms.vstring(),
+        WoodcockGamma             = cms.bool(True),
+        WoodcockNeutron           = cms.bool(False),
+        WoodcockGammaMinEnergy    = cms.double(0.2),  ## (MeV)
+        WoodcockNeutronMinEnergy  = cms.double(20.0), ## (MeV) above the HP data
+        WoodcockMajorantFactor    = cms.double(1.05),
         ThresholdWarningEnergy    = cms.untracked.double(100.0),
         ThresholdImportantEnergy  = cms.untracked.double(250.0),
         ThresholdTrials           = cms.untracked.int32(10)
@@ -404,6 +416,15 @@ g4SimHits = cms.EDProducer("OscarMTProducer",
         WatcherOn       = cms.untracked.bool(True),
         FillHisto       = cms.untracked.bool(True)
     ),
+    HGCalGflash = cms.PSet(
+        BField           = cms.double(3.8),
+        EffectiveZ       = cms.double(60.0),
+        RadiationLength  = cms.double(1.23),  # cm, effective for the CE-E sampling structure
+        MoliereRadius    = cms.double(2.8),   # cm
+        CriticalEnergy   = cms.double(10.0),  # MeV
+        SamplingFraction = cms.double(0.0070),
+        EnergyScale      = cms.double(1.0),   # not tuned yet: see SimG4CMS/Calo/test/python/runHGCalGflash_cfg.py
+    ),
     CastorSD = cms.PSet(
         useShowerLibrary               = cms.bool(True),
         minEnergyInGeVforUsingSLibrary = cms.double(1.0),
@@ -449,6 +470,9 @@ g4SimHits = cms.EDProducer("OscarMTProducer",
         WaferSize        = cms.untracked.double(123.7),
         MouseBite        = cms.untracked.double(2.5),
         CheckID          = cms.untracked.bool(True),
+        UseParametrize   = cms.bool(False), # GFlash showers for e+-/gamma in CE-E
+        EminParametrize  = cms.double(5.0), # GeV
+        ContainmentParametrize = cms.double(20.0), # X0 left in CE-E
     ),
     HGCScintSD = cms.PSet(
         Verbosity        = cms.untracked.int32(0),
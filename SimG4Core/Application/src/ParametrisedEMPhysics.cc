@@ -9,6 +9,7 @@
 #include "SimG4Core/Application/interface/GFlashEMShowerModel.h"
 #include "SimG4Core/Application/interface/GFlashHadronShowerModel.h"
 #include "SimG4Core/Application/interface/ElectronLimiter.h"
+#include "SimG4Core/Application/interface/WoodcockTracking.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include "G4FastSimulationManagerProcess.hh"
@@ -21,6 +22,8 @@
 #include "G4IonConstructor.hh"
 #include "G4RegionStore.hh"
 #include "G4Electron.hh"
+#include "G4Gamma.hh"
+#include "G4Neutron.hh"
 #include "G4Positron.hh"
 #include "G4MuonMinus.hh"
 #include "G4MuonPlus.hh"
@@ -286,6 +289,31 @@ void ParametrisedEMPhysics::ConstructProcess() {
       ph->RegisterProcess(plim, G4PionMinus::PionMinus());
     }
   }
+  // Woodcock tracking of neutral particles
+  std::vector<std::string> wnames = theParSet.getParameter<std::vector<std::string> >("WoodcockRegions");
+  if (!wnames.empty()) {
+    std::vector<const G4Region*> wreg;
+    G4RegionStore* store = G4RegionStore::GetInstance();
+    for (auto const& wname : wnames) {
+      const G4Region* r = store->GetRegion(wname, false);
+      if (r) {
+        wreg.emplace_back(r);
+      } else {
+        edm::LogWarning("SimG4CoreApplication") << "ParametrisedEMPhysics::ConstructProcess: " << wname
+                                                << " is not defined, no Woodcock tracking there";
+      }
+    }
+    if (!wreg.empty()) {
+      if (theParSet.getParameter<bool>("WoodcockGamma")) {
+        G4Gamma::Gamma()->GetProcessManager()->AddDiscreteProcess(
+            new WoodcockTracking(theParSet, G4Gamma::Gamma(), wreg));
+      }
+      if (theParSet.getParameter<bool>("WoodcockNeutron")) {
+        G4Neutron::Neutron()->GetProcessManager()->AddDiscreteProcess(
+            new WoodcockTracking(theParSet, G4Neutron::Neutron(), wreg));
+      }
+    }
+  }
   // enable fluorescence
   bool fluo = theParSet.getParameter<bool>("FlagFluo");
   if (fluo && !G4LossTableManager::Instance()->AtomDeexcitation()) {
@@ -55,6 +55,11 @@
 
 #include "G4GDMLParser.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Material.hh"
+#include "G4ProductionCuts.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4Version.hh"
 
 #include "DDG4/Geant4Mapping.h"
 
@@ -62,8 +67,62 @@
 #include <sstream>
 #include <fstream>
 #include <memory>
+#include <cstdio>
+#include <iomanip>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Digest.h"
+
+namespace {
+  // written last in a directory of cached physics tables
+  const std::string kCachedTablesComplete = "complete";
+
+  // digest of the materials and of the production cuts of the regions,
+  // from which the material-cuts couples of the tables are made
+  std::string materialsAndCutsDigest() {
+    std::ostringstream os;
+    os << std::setprecision(9);
+    for (auto const* material : *G4Material::GetMaterialTable()) {
+      os << material->GetName() << ' ' << material->GetDensity();
+      for (size_t i = 0; i < material->GetNumberOfElements(); ++i) {
+        os << ' ' << material->GetElement(i)->GetName() << ' ' << material->GetFractionVector()[i];
+      }
+      os << '\n';
+    }
+    for (auto const* region : *G4RegionStore::GetInstance()) {
+      os << region->GetName();
+      if (region->GetProductionCuts() != nullptr) {
+        for (double cut : region->GetProductionCuts()->GetProductionCuts()) {
+          os << ' ' << cut;
+        }
+      }
+      auto volume = region->GetRootLogicalVolumeIterator();
+      for (size_t i = 0; i < region->GetNumberOfRootVolumes(); ++i, ++volume) {
+        os << ' ' << (*volume)->GetName() << ' ' << (*volume)->GetMaterial()->GetName();
+      }
+      os << '\n';
+    }
+    return cms::Digest(os.str()).digest().toString();
+  }
+
+  // mkdir -p: creates the missing directories of the path, false if it
+  // is not a directory in the end
+  bool makeDirectories(const std::string& path) {
+    for (size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+      mkdir(path.substr(0, pos).c_str(), 0755);
+    }
+    mkdir(path.c_str(), 0755);
+    struct stat status;
+    return stat(path.c_str(), &status) == 0 && S_ISDIR(status.st_mode);
+  }
+}  // namespace
 
 RunManagerMT::RunManagerMT(edm::ParameterSet const& p)
     : m_managerInitialized(false),
@@ -72,12 +131,20 @@ RunManagerMT::RunManagerMT(edm::ParameterSet const& p)
       m_PhysicsTablesDir(p.getParameter<std::string>("PhysicsTablesDirectory")),
       m_StorePhysicsTables(p.getParameter<bool>("StorePhysicsTables")),
       m_RestorePhysicsTables(p.getParameter<bool>("RestorePhysicsTables")),
+      m_CachePhysicsTables(p.getParameter<bool>("CachePhysicsTables")),
+      m_StoreCachedPhysicsTables(false),
+      m_CachedTablesLock(-1),
       m_pField(p.getParameter<edm::ParameterSet>("MagneticField")),
       m_pPhysics(p.getParameter<edm::ParameterSet>("Physics")),
       m_pRunAction(p.getParameter<edm::ParameterSet>("RunAction")),
       m_g4overlap(p.getParameter<edm::ParameterSet>("G4CheckOverlap")),
       m_G4Commands(p.getParameter<std::vector<std::string> >("G4Commands")),
       m_p(p) {
+  if (m_CachePhysicsTables && (m_PhysicsTablesDir.empty() || m_PhysicsTablesDir[0] != '/')) {
+    throw edm::Exception(edm::errors::Configuration)
+        << "CachePhysicsTables requires an absolute PhysicsTablesDirectory shared by the jobs of the node, not \""
+        << m_PhysicsTablesDir << "\"";
+  }
   m_currentRun = nullptr;
   m_UIsession.reset(new CustomUIsession());
   m_physicsList.reset(nullptr);
@@ -180,6 +247,11 @@ void RunManagerMT::initG4(const DDCompactView* pDD,
     m_prodCuts->update();
   }
 
+  // the cache is keyed on the cuts of the regions, known from here
+  if (m_CachePhysicsTables && !m_RestorePhysicsTables) {
+    retrieveCachedPhysicsTables();
+  }
+
   m_kernel->SetPhysics(phys);
 
   // Geant4 UI commands before initialisation of physics
@@ -217,6 +289,9 @@ void RunManagerMT::initG4(const DDCompactView* pDD,
       G4UImanager::GetUIpointer()->ApplyCommand(cmd);
     m_physicsList->StorePhysicsTable(m_PhysicsTablesDir);
   }
+  if (m_StoreCachedPhysicsTables) {
+    storeCachedPhysicsTables();
+  }
 
   initializeUserActions();
 
@@ -252,6 +327,75 @@ void RunManagerMT::initG4(const DDCompactView* pDD,
   m_userRunAction->BeginOfRunAction(m_currentRun);
 }
 
+void RunManagerMT::retrieveCachedPhysicsTables() {
+  // The tables depend on the Geant4 version, on the physics configuration and
+  // on the materials and cuts of the geometry: each one has its own sub-directory
+  std::ostringstream dir;
+  dir << m_PhysicsTablesDir << "/" << G4VERSION_NUMBER << "_" << m_pPhysics.id() << "_" << materialsAndCutsDigest();
+  m_CachedTablesDir = dir.str();
+  const std::string complete = m_CachedTablesDir + "/" + kCachedTablesComplete;
+  if (access(complete.c_str(), R_OK) == 0) {
+    // Geant4 still checks the material-cuts couples of the stored tables, and builds them if they do not match
+    m_physicsList->SetPhysicsTableRetrieved(m_CachedTablesDir);
+    edm::LogVerbatim("SimG4CoreApplication") << "RunManagerMT: physics tables are retrieved from " << m_CachedTablesDir;
+    return;
+  }
+  // The process holding the lock stores the tables, the other ones build their
+  // own tables in the meantime instead of waiting for it. The lock is released
+  // by the system if the process dies, so that it cannot be left stale.
+  if (!makeDirectories(m_PhysicsTablesDir)) {
+    edm::LogWarning("SimG4CoreApplication") << "RunManagerMT: cannot create the directory " << m_PhysicsTablesDir
+                                            << " of the cached physics tables, they are built";
+    return;
+  }
+  m_CachedTablesLock = open((m_CachedTablesDir + ".lock").c_str(), O_CREAT | O_WRONLY, 0644);
+  if (m_CachedTablesLock < 0) {
+    edm::LogWarning("SimG4CoreApplication") << "RunManagerMT: cannot create the lock " << m_CachedTablesDir
+                                            << ".lock (" << std::strerror(errno) << "), the physics tables are built"
+                                            << " and not stored";
+    return;
+  }
+  if (flock(m_CachedTablesLock, LOCK_EX | LOCK_NB) == 0) {
+    if (access(complete.c_str(), R_OK) == 0) {
+      // stored by another process since the first check
+      close(m_CachedTablesLock);
+      m_CachedTablesLock = -1;
+      m_physicsList->SetPhysicsTableRetrieved(m_CachedTablesDir);
+      edm::LogVerbatim("SimG4CoreApplication")
+          << "RunManagerMT: physics tables are retrieved from " << m_CachedTablesDir;
+      return;
+    }
+    m_StoreCachedPhysicsTables = true;
+  } else {
+    close(m_CachedTablesLock);
+    m_CachedTablesLock = -1;
+    edm::LogVerbatim("SimG4CoreApplication")
+        << "RunManagerMT: physics tables are not available yet in " << m_CachedTablesDir << ", they are built";
+  }
+}
+
+void RunManagerMT::storeCachedPhysicsTables() {
+  // the tables are written aside, and the complete directory is renamed in one go,
+  // so that no process ever retrieves a partially written table
+  const std::string tmpDir = m_CachedTablesDir + ".tmp" + std::to_string(getpid());
+  if (mkdir(tmpDir.c_str(), 0755) != 0) {
+    edm::LogWarning("SimG4CoreApplication") << "RunManagerMT: cannot create the directory " << tmpDir << " ("
+                                            << std::strerror(errno) << "), the physics tables are not stored";
+  } else {
+    m_physicsList->StorePhysicsTable(tmpDir);
+    std::ofstream(tmpDir + "/" + kCachedTablesComplete) << m_pPhysics.getParameter<std::string>("type") << std::endl;
+    if (std::rename(tmpDir.c_str(), m_CachedTablesDir.c_str()) == 0) {
+      edm::LogVerbatim("SimG4CoreApplication") << "RunManagerMT: physics tables are stored in " << m_CachedTablesDir;
+    } else {
+      edm::LogWarning("SimG4CoreApplication")
+          << "RunManagerMT: cannot move the physics tables from " << tmpDir << " to " << m_CachedTablesDir;
+    }
+  }
+  close(m_CachedTablesLock);
+  m_CachedTablesLock = -1;
+  m_StoreCachedPhysicsTables = false;
+}
+
 void RunManagerMT::initializeUserActions() {
   m_runInterface.reset(new SimRunInterface(this, true));
   m_userRunAction = new RunAction(m_pRunAction, m_runInterface.get(), true);
@@ -1,11 +1,16 @@
 
 #include "SimG4Core/Application/interface/SteppingAction.h"
 #include "SimG4Core/Application/interface/EventAction.h"
+#include "SimG4Core/Application/interface/WoodcockTracking.h"
 #include "SimG4Core/Notification/interface/CMSSteppingVerbose.h"
 
+#include "G4Gamma.hh"
 #include "G4LogicalVolumeStore.hh"
+#include "G4Neutron.hh"
 #include "G4ParticleTable.hh"
 #include "G4PhysicalVolumeStore.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessVector.hh"
 #include "G4RegionStore.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
@@ -23,7 +28,8 @@ SteppingAction::SteppingAction(EventAction* e, const edm::ParameterSet& p, const
       nWarnings(0),
       initialized(false),
       killBeamPipe(false),
-      hasWatcher(hasW) {
+      hasWatcher(hasW),
+      hasWoodcock(false) {
   theCriticalEnergyForVacuum = (p.getParameter<double>("CriticalEnergyForVacuum") * CLHEP::MeV);
   if (0.0 < theCriticalEnergyForVacuum) {
     killBeamPipe = true;
@@ -87,6 +93,19 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep) {
     initialized = initPointer();
   }
 
+  // the secondaries of an interaction done through the Woodcock tracking
+  // are given back to the physics process of the interaction
+  if (hasWoodcock && 0 < aStep->GetNumberOfSecondariesInCurrentStep()) {
+    const G4VProcess* proc = aStep->GetPostStepPoint()->GetProcessDefinedStep();
+    for (auto const& sec : *(aStep->GetSecondaryInCurrentStep())) {
+      const G4VProcess* creator = sec->GetCreatorProcess();
+      if (creator && creator->GetProcessType() == fGeneral &&
+          creator->GetProcessSubType() == WoodcockTracking::subType) {
+        const_cast<G4Track*>(sec)->SetCreatorProcess(proc);
+      }
+    }
+  }
+
   //if(hasWatcher) { m_g4StepSignal(aStep); }
   m_g4StepSignal(aStep);
 
@@ -235,6 +254,19 @@ bool SteppingAction::initPointer() {
     }
   }
 
+  const G4ParticleDefinition* neutrals[2] = {G4Gamma::Gamma(), G4Neutron::Neutron()};
+  for (auto const& part : neutrals) {
+    G4ProcessVector* pv = part->GetProcessManager()->GetProcessList();
+    for (G4int i = 0; i < pv->entries(); ++i) {
+      if ((*pv)[i]->GetProcessType() == fGeneral && (*pv)[i]->GetProcessSubType() == WoodcockTracking::subType) {
+        hasWoodcock = true;
+      }
+    }
+  }
+  if (hasWoodcock) {
+    edm::LogVerbatim("SimG4CoreApplication") << "SteppingAction: Woodcock tracking is active";
+  }
+
   const G4RegionStore* rs = G4RegionStore::GetInstance();
   if (numberTimes > 0) {
     maxTimeRegions.resize(numberTimes, nullptr);
@@ -0,0 +1,342 @@
+//
+// Woodcock (delta) tracking of neutral particles inside selected regions
+//
+#include "SimG4Core/Application/interface/WoodcockTracking.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+
+#include "G4ParticleDefinition.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessVector.hh"
+#include "G4VEmProcess.hh"
+#include "G4HadronicProcess.hh"
+#include "G4HadronicProcessStore.hh"
+#include "G4GeometryTolerance.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4Region.hh"
+#include "G4Material.hh"
+#include "G4MaterialCutsCouple.hh"
+#include "G4NavigationHistory.hh"
+#include "G4TouchableHistory.hh"
+#include "G4TransportationManager.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4Threading.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Exp.hh"
+#include "G4Log.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+  // energy grid of the majorant tables
+  constexpr G4double maxTableEnergy = 100 * CLHEP::TeV;
+  constexpr G4double binsPerDecade = 20;
+  // the cross sections are sampled at the edges and inside each bin
+  constexpr G4int samplesPerBin = 4;
+  constexpr unsigned long maxWarnings = 10;
+}  // namespace
+
+WoodcockTracking::WoodcockTracking(const edm::ParameterSet &p,
+                                   const G4ParticleDefinition *part,
+                                   const std::vector<const G4Region *> &regions)
+    : G4VDiscreteProcess("WoodcockTracking", fGeneral),
+      particle_(part),
+      regions_(regions),
+      maxEnergy_(maxTableEnergy),
+      stepLength_(0.0),
+      interaction_(nullptr),
+      pending_(nullptr),
+      initialised_(false),
+      nWalks_(0),
+      nCandidates_(0),
+      nInteractions_(0),
+      nViolations_(0) {
+  SetProcessSubType(subType);
+  pParticleChange = &fParticleChange;
+
+  G4double emin = (part->GetPDGEncoding() == 22) ? p.getParameter<double>("WoodcockGammaMinEnergy")
+                                                 : p.getParameter<double>("WoodcockNeutronMinEnergy");
+  minEnergy_ = std::max(emin * CLHEP::MeV, CLHEP::keV);
+  majorantFactor_ = p.getParameter<double>("WoodcockMajorantFactor");
+  tolerance_ = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
+
+  logMinEnergy_ = G4Log(minEnergy_);
+  binsPerLog_ = binsPerDecade / G4Log(10.);
+  nBins_ = G4int((G4Log(maxEnergy_) - logMinEnergy_) * binsPerLog_) + 1;
+}
+
+WoodcockTracking::~WoodcockTracking() {
+  if (0 < nWalks_) {
+    edm::LogVerbatim("SimG4CoreApplication")
+        << "WoodcockTracking for " << particle_->GetParticleName() << ": " << nWalks_ << " walks, " << nCandidates_
+        << " candidate points, " << nInteractions_ << " interactions, " << nViolations_
+        << " points above the majorant";
+  }
+}
+
+G4bool WoodcockTracking::IsApplicable(const G4ParticleDefinition &part) { return (&part == particle_); }
+
+void WoodcockTracking::BuildPhysicsTable(const G4ParticleDefinition &) {
+  // the channels and the majorants are made at the first track, when the
+  // tables of all the processes of the particle are there
+  envelopes_.clear();
+  initialised_ = false;
+
+  if (G4Threading::IsMasterThread()) {
+    std::string names;
+    for (auto const &reg : regions_) {
+      names += " " + reg->GetName();
+    }
+    edm::LogVerbatim("SimG4CoreApplication")
+        << "WoodcockTracking::BuildPhysicsTable for " << particle_->GetParticleName()
+        << " Emin(MeV)= " << minEnergy_ / CLHEP::MeV << " majorant factor= " << majorantFactor_ << " in regions:"
+        << names;
+  }
+}
+
+void WoodcockTracking::StartTracking(G4Track *) {
+  pending_ = nullptr;
+  if (!initialised_) {
+    initialise();
+  }
+}
+
+void WoodcockTracking::initialise() {
+  channels_.clear();
+  std::string names, ignored;
+  G4ProcessManager *pm = particle_->GetProcessManager();
+  G4ProcessVector *pv = pm->GetPostStepProcessVector(typeDoIt);
+  for (G4int i = 0; i < pv->entries(); ++i) {
+    G4VProcess *proc = (*pv)[i];
+    if (proc == this || proc->GetProcessType() == fTransportation || !pm->GetProcessActivation(proc)) {
+      continue;
+    }
+    G4VEmProcess *em = (proc->GetProcessType() == fElectromagnetic) ? dynamic_cast<G4VEmProcess *>(proc) : nullptr;
+    G4HadronicProcess *had = (proc->GetProcessType() == fHadronic) ? dynamic_cast<G4HadronicProcess *>(proc) : nullptr;
+    if (em || had) {
+      channels_.push_back({proc, em, had});
+      names += " " + proc->GetProcessName();
+    } else {
+      ignored += " " + proc->GetProcessName();
+    }
+  }
+  sigma_.resize(channels_.size());
+  navigator_.SetWorldVolume(
+      G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking()->GetWorldVolume());
+  initialised_ = true;
+
+  edm::LogVerbatim("SimG4CoreApplication") << "WoodcockTracking for " << particle_->GetParticleName()
+                                           << " samples the interactions of:" << names;
+  if (!ignored.empty()) {
+    edm::LogVerbatim("SimG4CoreApplication") << "WoodcockTracking for " << particle_->GetParticleName()
+                                             << " does not sample:" << ignored;
+  }
+}
+
+const WoodcockTracking::Envelope &WoodcockTracking::envelope(const G4LogicalVolume *lv) {
+  auto itr = envelopes_.find(lv);
+  if (itr != envelopes_.end()) {
+    return itr->second;
+  }
+
+  // materials of all the volumes inside the envelope, whatever their region
+  std::vector<const G4MaterialCutsCouple *> couples;
+  std::vector<const G4LogicalVolume *> volumes(1, lv);
+  std::unordered_set<const G4LogicalVolume *> visited;
+  while (!volumes.empty()) {
+    const G4LogicalVolume *vol = volumes.back();
+    volumes.pop_back();
+    if (!visited.insert(vol).second) {
+      continue;
+    }
+    const G4MaterialCutsCouple *couple = vol->GetMaterialCutsCouple();
+    if (couple && std::find(couples.begin(), couples.end(), couple) == couples.end()) {
+      couples.push_back(couple);
+    }
+    G4int nd = vol->GetNoDaughters();
+    for (G4int i = 0; i < nd; ++i) {
+      volumes.push_back(vol->GetDaughter(i)->GetLogicalVolume());
+    }
+  }
+
+  Envelope &env = envelopes_[lv];
+  env.majorant.resize(nBins_, 0.0);
+  for (G4int bin = 0; bin < nBins_; ++bin) {
+    G4double sigmaMax = 0.0;
+    for (G4int k = 0; k <= samplesPerBin; ++k) {
+      G4double ekin = G4Exp(logMinEnergy_ + (bin + G4double(k) / samplesPerBin) / binsPerLog_);
+      for (auto const &couple : couples) {
+        G4double sigma = 0.0;
+        for (auto const &ch : channels_) {
+          sigma += crossSection(ch, ekin, couple);
+        }
+        sigmaMax = std::max(sigmaMax, sigma);
+      }
+    }
+    env.majorant[bin] = majorantFactor_ * sigmaMax;
+  }
+
+  edm::LogVerbatim("SimG4CoreApplication")
+      << "WoodcockTracking: majorant for " << particle_->GetParticleName() << " in " << lv->GetName() << " ("
+      << lv->GetRegion()->GetName() << ") from " << couples.size() << " materials of " << visited.size()
+      << " volumes";
+  return env;
+}
+
+G4double WoodcockTracking::crossSection(const Channel &ch, G4double ekin, const G4MaterialCutsCouple *couple) const {
+  if (ch.emProcess) {
+    return ch.emProcess->GetLambda(ekin, couple);
+  }
+  return G4HadronicProcessStore::Instance()->GetCrossSectionPerVolume(
+      particle_, ekin, ch.process, couple->GetMaterial());
+}
+
+G4int WoodcockTracking::energyBin(G4double ekin) const {
+  G4int bin = G4int((G4Log(ekin) - logMinEnergy_) * binsPerLog_);
+  return std::min(std::max(bin, 0), nBins_ - 1);
+}
+
+G4double WoodcockTracking::PostStepGetPhysicalInteractionLength(const G4Track &track,
+                                                                G4double,
+                                                                G4ForceCondition *condition) {
+  *condition = NotForced;
+
+  // the interaction sampled in the previous step is done now
+  if (pending_) {
+    return 0.0;
+  }
+
+  G4double ekin = track.GetKineticEnergy();
+  if (channels_.empty() || ekin < minEnergy_ || ekin >= maxEnergy_) {
+    return DBL_MAX;
+  }
+  const G4VTouchable *touch = track.GetTouchable();
+  const G4Region *reg = touch->GetVolume()->GetLogicalVolume()->GetRegion();
+  if (std::find(regions_.begin(), regions_.end(), reg) == regions_.end()) {
+    return DBL_MAX;
+  }
+
+  // the envelope is the root logical volume of the region of the track
+  G4int depth = 0;
+  const G4int historyDepth = touch->GetHistoryDepth();
+  while (depth < historyDepth && !touch->GetVolume(depth)->GetLogicalVolume()->IsRootRegion()) {
+    ++depth;
+  }
+  const G4LogicalVolume *lv = touch->GetVolume(depth)->GetLogicalVolume();
+  const G4AffineTransform &toLocal = touch->GetHistory()->GetTransform(historyDepth - depth);
+  const G4ThreeVector &position = track.GetPosition();
+  const G4ThreeVector &direction = track.GetMomentumDirection();
+  G4double exitLength =
+      lv->GetSolid()->DistanceToOut(toLocal.TransformPoint(position), toLocal.TransformAxis(direction));
+  if (exitLength <= tolerance_) {
+    return DBL_MAX;
+  }
+
+  G4double majorant = envelope(lv).majorant[energyBin(ekin)];
+  if (majorant <= 0.0) {
+    return DBL_MAX;
+  }
+
+  ++nWalks_;
+  interaction_ = nullptr;
+  G4double length = 0.0;
+  G4bool relative = false;
+  for (;;) {
+    length -= G4Log(G4UniformRand()) / majorant;
+    if (length >= exitLength) {
+      length = exitLength;
+      break;
+    }
+
+    // real or virtual interaction at the candidate point
+    ++nCandidates_;
+    const G4VPhysicalVolume *pv =
+        navigator_.LocateGlobalPointAndSetup(position + length * direction, &direction, relative, false);
+    relative = true;
+    if (!pv) {
+      length = exitLength;
+      break;
+    }
+    const G4MaterialCutsCouple *couple = pv->GetLogicalVolume()->GetMaterialCutsCouple();
+    G4double sigma = 0.0;
+    for (size_t i = 0; i < channels_.size(); ++i) {
+      sigma_[i] = crossSection(channels_[i], ekin, couple);
+      sigma += sigma_[i];
+    }
+    if (sigma > majorant) {
+      ++nViolations_;
+      if (nViolations_ <= maxWarnings) {
+        edm::LogWarning("SimG4CoreApplication")
+            << "WoodcockTracking: cross section " << sigma * CLHEP::mm << "/mm of " << particle_->GetParticleName()
+            << " E(MeV)= " << ekin / CLHEP::MeV << " in " << couple->GetMaterial()->GetName()
+            << " is above the majorant " << majorant * CLHEP::mm << "/mm of " << lv->GetName();
+      }
+    }
+    if (G4UniformRand() * majorant < sigma) {
+      G4double x = G4UniformRand() * sigma;
+      size_t i = 0;
+      for (; i + 1 < channels_.size(); ++i) {
+        x -= sigma_[i];
+        if (x < 0.0) {
+          break;
+        }
+      }
+      interaction_ = channels_[i].process;
+      ++nInteractions_;
+      break;
+    }
+  }
+
+  endPoint_ = position + length * direction;
+  stepLength_ = length;
+  *condition = ExclusivelyForced;
+  return length;
+}
+
+G4VParticleChange *WoodcockTracking::PostStepDoIt(const G4Track &track, const G4Step &step) {
+  if (pending_) {
+    // the step is attributed to the physics process, the secondaries are
+    // given back to it by SteppingAction
+    G4VProcess *proc = pending_;
+    pending_ = nullptr;
+    step.GetPostStepPoint()->SetProcessDefinedStep(proc);
+    return proc->PostStepDoIt(track, step);
+  }
+
+  // move the track to the end of the walk; the step is exclusively forced,
+  // so the track is located here as Transportation would do
+  fParticleChange.Initialize(track);
+  fParticleChange.ProposeTrueStepLength(stepLength_);
+  fParticleChange.ProposePosition(endPoint_);
+  G4double dt = stepLength_ / track.GetVelocity();
+  fParticleChange.ProposeLocalTime(track.GetLocalTime() + dt);
+  fParticleChange.ProposeProperTime(track.GetProperTime() +
+                                    dt * track.GetDynamicParticle()->GetMass() / track.GetTotalEnergy());
+
+  G4Navigator *navigator = G4TransportationManager::GetTransportationManager()->GetNavigatorForTracking();
+  G4VPhysicalVolume *pv = navigator->LocateGlobalPointAndSetup(endPoint_, &track.GetMomentumDirection(), false, false);
+  G4StepPoint *postStep = step.GetPostStepPoint();
+  postStep->SetTouchableHandle(G4TouchableHandle(navigator->CreateTouchableHistory()));
+  if (pv) {
+    G4LogicalVolume *lv = pv->GetLogicalVolume();
+    postStep->SetMaterial(lv->GetMaterial());
+    postStep->SetMaterialCutsCouple(lv->GetMaterialCutsCouple());
+    postStep->SetSensitiveDetector(lv->GetSensitiveDetector());
+  } else {
+    fParticleChange.ProposeTrackStatus(fStopAndKill);
+  }
+
+  // no interaction of the channels happened on the way, the numbers of
+  // interaction lengths left are sampled again from the new point
+  for (auto const &ch : channels_) {
+    ch.process->StartTracking(const_cast<G4Track *>(&track));
+  }
+  pending_ = interaction_;
+  return &fParticleChange;
+}
+
+G4double WoodcockTracking::GetMeanFreePath(const G4Track &, G4double, G4ForceCondition *) { return DBL_MAX; }
@@ -0,0 +1,95 @@
+###############################################################################
+# Validation of the Woodcock tracking of gammas and neutrons in the
+# calorimeters: the same single particle sample is simulated with and
+# without Woodcock tracking and the energy deposits in CaloSD are
+# histogrammed by CaloSimHitStudy
+#
+#   cmsRun runWoodcockValidation_cfg.py woodcock=0
+#   cmsRun runWoodcockValidation_cfg.py woodcock=1
+#   compareHistogramsKS.py woodcock0.root woodcock1.root CaloSimHitStudy
+#
+# The CPU time of g4SimHits is in the Timing summary of the two jobs
+###############################################################################
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing()
+options.register ("woodcock", 1,     VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.register ("neutron",  0,     VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.register ("particle", 22,    VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.register ("energy",   50.0,  VarParsing.multiplicity.singleton, VarParsing.varType.float)
+options.register ("events",   1000,  VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.parseArguments()
+
+process = cms.Process("WoodcockValidation")
+process.load("SimG4CMS.Calo.pythiapdt_cfi")
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load("IOMC.EventVertexGenerators.VtxSmearedGauss_cfi")
+process.load("Geometry.CMSCommonData.cmsIdealGeometryXML_cfi")
+process.load("Geometry.TrackerNumberingBuilder.trackerNumberingGeometry_cfi")
+process.load("Geometry.HcalCommonData.hcalParameters_cfi")
+process.load("Geometry.HcalCommonData.hcalDDDSimConstants_cfi")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load('Configuration.StandardSequences.Generator_cff')
+process.load('Configuration.StandardSequences.SimIdeal_cff')
+process.load("SimG4CMS.Calo.CaloSimHitStudy_cfi")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.autoCond import autoCond
+process.GlobalTag.globaltag = autoCond['run2_mc']
+
+if 'MessageLogger' in process.__dict__:
+    process.MessageLogger.categories.append('SimG4CoreApplication')
+
+process.load("IOMC.RandomEngine.IOMC_cff")
+process.RandomNumberGeneratorService.generator.initialSeed = 456789
+process.RandomNumberGeneratorService.g4SimHits.initialSeed = 9876
+process.RandomNumberGeneratorService.VtxSmeared.initialSeed = 123456789
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.events)
+)
+
+process.source = cms.Source("EmptySource",
+    firstRun        = cms.untracked.uint32(1),
+    firstEvent      = cms.untracked.uint32(1)
+)
+
+process.generator = cms.EDProducer("FlatRandomEGunProducer",
+    PGunParameters = cms.PSet(
+        PartID = cms.vint32(options.particle),
+        MinEta = cms.double(-3.0),
+        MaxEta = cms.double(3.0),
+        MinPhi = cms.double(-3.14159265359),
+        MaxPhi = cms.double(3.14159265359),
+        MinE   = cms.double(options.energy),
+        MaxE   = cms.double(options.energy)
+    ),
+    Verbosity       = cms.untracked.int32(0),
+    AddAntiParticle = cms.bool(False)
+)
+
+process.Timing = cms.Service("Timing")
+
+process.TFileService = cms.Service("TFileService",
+    fileName = cms.string('woodcock%d.root' % options.woodcock)
+)
+
+process.generation_step = cms.Path(process.pgen)
+process.simulation_step = cms.Path(process.psim)
+process.analysis_step   = cms.Path(process.CaloSimHitStudy)
+
+process.CaloSimHitStudy.MaxEnergy = 2.0 * options.energy
+process.CaloSimHitStudy.SourceLabel = "generatorSmeared"
+
+if options.woodcock:
+    process.g4SimHits.Physics.WoodcockRegions = ['EcalRegion', 'HcalRegion', 'HGcalRegion']
+    process.g4SimHits.Physics.WoodcockNeutron = bool(options.neutron)
+
+process.schedule = cms.Schedule(process.generation_step,
+                                process.simulation_step,
+                                process.analysis_step
+                                )
+
+# filter all path with the production filter sequence
+for path in process.paths:
+        getattr(process,path)._seq = process.generator * getattr(process,path)._seq
@@ -131,6 +131,7 @@ private:
   void accumulate(const PileUpEventPrincipal &event, const edm::EventSetup &setup, edm::StreamID const &) override;
   void finalizeEvent(edm::Event &event, const edm::EventSetup &setup) override;
   void beginLuminosityBlock(edm::LuminosityBlock const &lumi, edm::EventSetup const &setup) override;
+  bool threadSafePileUpAccumulation() const override { return true; }
 
   /** @brief Both forms of accumulate() delegate to this templated method. */
   template <class T>
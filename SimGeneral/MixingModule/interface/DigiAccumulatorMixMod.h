@@ -45,6 +45,12 @@ public:
   virtual ~DigiAccumulatorMixMod();
 
   // ---------- const member functions ---------------------
+  // True if accumulate() for pileup events uses neither the random number engine of the
+  // module nor data shared with the other accumulators: on prefetched pileup events the
+  // MixingModule then runs it in a parallel task, filling the buffers of this accumulator only.
+  // The prefetched events only hold the products consumed through the ConsumesCollector
+  // given to the accumulators: reading another pileup product throws a LogicError.
+  virtual bool threadSafePileUpAccumulation() const { return false; }
 
   // ---------- static member functions --------------------
 
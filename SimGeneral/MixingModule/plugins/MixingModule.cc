@@ -35,6 +35,8 @@
 #include "SimGeneral/MixingModule/interface/PileUpEventPrincipal.h"
 #include "DataFormats/Common/interface/ValueMap.h"
 
+#include "tbb/task_group.h"
+
 namespace edm {
 
   // Constructor
@@ -43,7 +45,15 @@ namespace edm {
         inputTagPlayback_(),
         mixProdStep2_(ps_mix.getParameter<bool>("mixProdStep2")),
         mixProdStep1_(ps_mix.getParameter<bool>("mixProdStep1")),
-        digiAccumulators_() {
+        digiAccumulators_(),
+        concurrentAccumulation_(false) {
+    for (auto const& source : inputSources_) {
+      if (source && source->sharedEventCache()) {
+        // the adjusters shift the times and vertices of the pileup products in place
+        throw cms::Exception("Configuration") << "The MixingModule modifies the pileup events, so that their products "
+                                                 "cannot be shared by the streams: please remove sharedCacheEvents.";
+      }
+    }
     if (!mixProdStep1_ && !mixProdStep2_)
       LogInfo("MixingModule") << " The MixingModule was run in the Standard mode.";
     if (mixProdStep1_)
@@ -263,6 +273,19 @@ namespace edm {
     edm::ConsumesCollector iC(consumesCollector());
     // Create and configure digitizers
     createDigiAccumulators(ps_mix, iC);
+
+    // The pileup events read ahead only get the products consumed by the
+    // module and its accumulators: the others can no longer be read once the
+    // source has moved on to the next events
+    std::vector<edm::InputTag> consumedTags;
+    for (auto const& info : consumesInfo()) {
+      if (info.branchType() == InEvent)
+        consumedTags.emplace_back(info.label(), info.instance(), info.process());
+    }
+    for (auto const& source : inputSources_) {
+      if (source && source->prefetch())
+        source->setPrefetchedProducts(consumedTags);
+    }
   }
 
   void MixingModule::createDigiAccumulators(const edm::ParameterSet& mixingPSet, edm::ConsumesCollector& iC) {
@@ -280,6 +303,13 @@ namespace edm {
         digiAccumulators_.push_back(accumulator.release());
       }
     }
+    for (auto const& accumulator : digiAccumulators_) {
+      if (accumulator->threadSafePileUpAccumulation()) {
+        threadSafeAccumulators_.push_back(accumulator);
+      } else {
+        serialAccumulators_.push_back(accumulator);
+      }
+    }
   }
 
   void MixingModule::reload(const edm::EventSetup& setup) {
@@ -525,6 +555,8 @@ namespace edm {
           // non-minbias pileup only gets one event for now. Fix later if desired.
           int numberOfEvents = (readSrcIdx == 0 ? PileupList[bunchIdx - minBunch_] : 1);
           sizes.push_back(numberOfEvents);
+          // the products of the events read ahead are already in memory
+          concurrentAccumulation_ = source->prefetch();
           inputSources_[readSrcIdx]->readPileUp(e.id(),
                                                 recordEventID,
                                                 std::bind(&MixingModule::pileAllWorkers,
@@ -538,6 +570,7 @@ namespace edm {
                                                           e.streamID()),
                                                 numberOfEvents,
                                                 e.streamID());
+          concurrentAccumulation_ = false;
         } else if (oldFormatPlayback) {
           std::vector<edm::EventID> const& playEventID = oldFormatPlaybackInfo_H->getStartEventId(readSrcIdx, bunchIdx);
           size_t numberOfEvents = playEventID.size();
@@ -677,6 +710,18 @@ namespace edm {
   void MixingModule::accumulateEvent(PileUpEventPrincipal const& event,
                                      edm::EventSetup const& setup,
                                      edm::StreamID const& streamID) {
+    if (concurrentAccumulation_ && !threadSafeAccumulators_.empty()) {
+      tbb::task_group group;
+      for (auto const& accumulator : threadSafeAccumulators_) {
+        group.run([accumulator, &event, &setup, &streamID]() { accumulator->accumulate(event, setup, streamID); });
+      }
+      // the others keep their order, and with it the sequence of random numbers
+      for (auto const& accumulator : serialAccumulators_) {
+        accumulator->accumulate(event, setup, streamID);
+      }
+      group.wait();
+      return;
+    }
     for (Accumulators::const_iterator accItr = digiAccumulators_.begin(), accEnd = digiAccumulators_.end();
          accItr != accEnd;
          ++accItr) {
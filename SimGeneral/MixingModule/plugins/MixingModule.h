@@ -110,6 +110,11 @@ namespace edm {
 
     // Digi-producing algorithms
     Accumulators digiAccumulators_;
+    // split of digiAccumulators_ for the pileup events read ahead by PileUp:
+    // the thread-safe ones run in parallel tasks next to the others
+    Accumulators threadSafeAccumulators_;
+    Accumulators serialAccumulators_;
+    bool concurrentAccumulation_;
   };
 }  // namespace edm
 
@@ -52,6 +52,20 @@ SiPixelSimBlock = cms.PSet(
     PrintClusters = cms.bool(False),
     PrintTemplates = cms.bool(False),
     DoPixelAging = cms.bool(False),
+    # Charge sharing of the hits crossing the sensor taken from templates
+    # precomputed with the drift and diffusion model, instead of drifting
+    # and integrating each 10um segment: no charge fluctuation along the
+    # track, not used with DoPixelAging nor near the big pixels. Phase 1
+    # digitizer only, the Phase 2 one has no templates
+    UseChargeSharingTemplates = cms.bool(False),
+    ChargeSharingTemplates = cms.PSet(
+        cotAlphaMax = cms.double(1.5),  # cot(alpha) + tan(Lorentz angle)
+        nCotAlpha = cms.int32(31),
+        cotBetaMax = cms.double(6.0),
+        nCotBeta = cms.int32(49),
+        nPosition = cms.int32(4),       # bins of the charge centroid in a pixel, in x and y
+        tanLorentzAngleStep = cms.double(0.02)
+    ),
     ReadoutNoiseInElec = cms.double(350.0),
     deltaProductionCut = cms.double(0.03),
     RoutList = cms.vstring(
@@ -19,6 +19,11 @@ SiStripSimBlock = cms.PSet(
     GevPerElectron          = cms.double(3.61e-09),
     ChargeDistributionRMS   = cms.double(6.5e-10),
     noDiffusion             = cms.bool(False),
+    #if True divide, drift and integrate the charge of all the SimHits of a module at once
+    #(expected to give the same digis faster, to be validated with
+    #SimTracker/SiStripDigitizer/test/compareStripDigis.py before it is switched on)
+    #if False each SimHit is digitized on its own
+    VectorizedDigitization  = cms.bool(False),
     #---SiTrivialInduceChargeOnStrips
     #switch to use different coupling constants set
     #if True RunII cross talk will be used
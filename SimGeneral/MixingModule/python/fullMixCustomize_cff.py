@@ -62,3 +62,14 @@ def setCrossingFrameOn(process):
     )
 
     return(process)
+
+# Reads the pileup events nEvents ahead of their use in a parallel task, and
+# runs the thread-safe digitizers concurrently on them. The same pileup events
+# are mixed as without it, see SimGeneral/MixingModule/test/testPileUpPrefetch.sh
+def setPileUpPrefetchOn(process, nEvents=8):
+
+    for source in ['input', 'cosmics', 'beamhalo_plus', 'beamhalo_minus']:
+        if hasattr(process.mix, source):
+            getattr(process.mix, source).prefetchEvents = cms.untracked.uint32(nEvents)
+
+    return(process)
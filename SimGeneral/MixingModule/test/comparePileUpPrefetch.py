@@ -0,0 +1,49 @@
+#!/usr/bin/env python
+###############################################################################
+# Checks that the outputs of testPileUpPrefetch_cfg.py are the same event by
+# event: the pileup events mixed in each bunch crossing, and the tracking
+# particles and vertices made from them
+#
+#   python comparePileUpPrefetch.py reference.root other.root [...]
+###############################################################################
+from __future__ import print_function
+import sys
+
+import ROOT
+from DataFormats.FWLite import Events, Handle
+
+def summarize(fileName):
+    mixing = Handle("PileupMixingContent")
+    particles = Handle("std::vector<TrackingParticle>")
+    vertices = Handle("std::vector<TrackingVertex>")
+    summary = {}
+    for event in Events(fileName):
+        aux = event.eventAuxiliary()
+        event.getByLabel("mix", mixing)
+        event.getByLabel("mix", "MergedTrackTruth", particles)
+        event.getByLabel("mix", "MergedTrackTruth", vertices)
+        pileup = [(id.run(), id.luminosityBlock(), id.event()) for id in mixing.product().getMix_eventInfo()]
+        tps = [(tp.eventId().bunchCrossing(), tp.eventId().event(), tp.pdgId(), round(tp.pt(), 6))
+               for tp in particles.product()]
+        summary[(aux.run(), aux.luminosityBlock(), aux.event())] = (list(mixing.product().getMix_Ninteractions()),
+                                                                    pileup, tps, vertices.product().size())
+    return summary
+
+if len(sys.argv) < 3:
+    print("usage: comparePileUpPrefetch.py reference.root other.root [...]")
+    sys.exit(1)
+
+reference = summarize(sys.argv[1])
+bad = 0
+for fileName in sys.argv[2:]:
+    other = summarize(fileName)
+    if sorted(other.keys()) != sorted(reference.keys()):
+        print("%s: not the same events as %s" % (fileName, sys.argv[1]))
+        bad += 1
+        continue
+    for key in sorted(reference.keys()):
+        if other[key] != reference[key]:
+            print("%s: event %d:%d:%d differs from %s" % (fileName, key[0], key[1], key[2], sys.argv[1]))
+            bad += 1
+print("%d differences in %d events" % (bad, len(reference)))
+sys.exit(1 if bad else 0)
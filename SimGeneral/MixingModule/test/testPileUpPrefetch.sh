@@ -0,0 +1,15 @@
+#!/bin/sh
+
+# Mixes the same events without and with the pileup events read ahead, and with
+# 1 and 4 threads, and checks that the outputs are the same. The signal and the
+# pileup events are the minimum bias events of a small GEN-SIM step.
+
+function die { echo $1: status $2 ;  exit $2; }
+
+cmsDriver.py MinBias_13TeV_pythia8_TuneCUETP8M1_cfi -s GEN,SIM -n 50 --era Run2_2018 --conditions auto:phase1_2018_realistic --beamspot Realistic25ns13TeVEarly2018Collision --geometry DB:Extended --datatier GEN-SIM --eventcontent RAWSIM --fileout file:pileUpPrefetchGenSim.root --python_filename pileUpPrefetchGenSim_cfg.py || die "cmsDriver GEN,SIM" $?
+
+cmsRun ${LOCAL_TEST_DIR}/testPileUpPrefetch_cfg.py inputFiles=file:pileUpPrefetchGenSim.root prefetch=0 threads=1 outputFile=pileUpPrefetch0.root || die "cmsRun prefetch=0 threads=1" $?
+cmsRun ${LOCAL_TEST_DIR}/testPileUpPrefetch_cfg.py inputFiles=file:pileUpPrefetchGenSim.root prefetch=8 threads=1 outputFile=pileUpPrefetch8_1.root || die "cmsRun prefetch=8 threads=1" $?
+cmsRun ${LOCAL_TEST_DIR}/testPileUpPrefetch_cfg.py inputFiles=file:pileUpPrefetchGenSim.root prefetch=8 threads=4 outputFile=pileUpPrefetch8_4.root || die "cmsRun prefetch=8 threads=4" $?
+
+python ${LOCAL_TEST_DIR}/comparePileUpPrefetch.py pileUpPrefetch0.root pileUpPrefetch8_1.root pileUpPrefetch8_4.root || die "comparePileUpPrefetch.py" $?
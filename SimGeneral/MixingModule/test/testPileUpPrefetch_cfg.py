@@ -0,0 +1,69 @@
+###############################################################################
+# Mixes a GEN-SIM sample with pileup read from the same files, with the
+# tracking truth and pileup vertex accumulators, and keeps the products of
+# the mix module. Run by testPileUpPrefetch.sh with and without reading the
+# pileup events ahead and with several threads: one stream is used, since
+# each stream reads its pileup events from its own position in the files
+#
+#   cmsRun testPileUpPrefetch_cfg.py inputFiles=file:gensim.root prefetch=8 threads=4 outputFile=mix.root
+###############################################################################
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.register('prefetch', 0, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "Number of pileup events read ahead (0: none)")
+options.register('threads', 1, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "Number of threads")
+options.register('pileup', 20.0, VarParsing.multiplicity.singleton, VarParsing.varType.float,
+                 "Average number of pileup events per bunch crossing")
+options.setDefault('maxEvents', 20)
+options.setDefault('outputFile', 'pileUpPrefetch.root')
+options.parseArguments()
+
+if len(options.inputFiles) == 0:
+    raise RuntimeError("inputFiles: GEN-SIM events are needed, e.g. those made by testPileUpPrefetch.sh")
+
+process = cms.Process("MIX")
+process.load("Configuration.StandardSequences.Services_cff")
+process.load("FWCore.MessageService.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport.reportEvery = 10
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(options.threads),
+    numberOfStreams = cms.untracked.uint32(1)
+)
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+from SimGeneral.MixingModule.mix_POISSON_average_cfi import mix
+from SimGeneral.MixingModule.pileupVtxDigitizer_cfi import pileupVtxDigitizer
+from SimGeneral.MixingModule.trackingTruthProducer_cfi import trackingParticles
+process.mix = mix.clone(
+    digitizers = cms.PSet(
+        puVtx = cms.PSet(pileupVtxDigitizer),
+        mergedtruth = cms.PSet(trackingParticles)
+    )
+)
+process.mix.input.nbPileupEvents.averageNumber = options.pileup
+process.mix.input.fileNames = cms.untracked.vstring(options.inputFiles)
+if options.prefetch > 0:
+    from SimGeneral.MixingModule.fullMixCustomize_cff import setPileUpPrefetchOn
+    setPileUpPrefetchOn(process, options.prefetch)
+
+# the CPU time of the mix module is in the summary
+process.Timing = cms.Service("Timing",
+    summaryOnly = cms.untracked.bool(True)
+)
+
+process.out = cms.OutputModule("PoolOutputModule",
+    fileName = cms.untracked.string(options.outputFile),
+    outputCommands = cms.untracked.vstring('drop *', 'keep *_mix_*_MIX')
+)
+
+process.p = cms.Path(process.mix)
+process.e = cms.EndPath(process.out)
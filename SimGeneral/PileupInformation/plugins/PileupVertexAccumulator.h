@@ -49,6 +49,7 @@ namespace cms {
     void accumulate(edm::Event const& e, edm::EventSetup const& c) override;
     void accumulate(PileUpEventPrincipal const& e, edm::EventSetup const& c, edm::StreamID const&) override;
     void finalizeEvent(edm::Event& e, edm::EventSetup const& c) override;
+    bool threadSafePileUpAccumulation() const override { return true; }
 
     virtual void beginJob() {}
 
@@ -26,6 +26,13 @@ mixData = cms.EDProducer("PreMixingModule",
         seed = cms.int32(1234567),
         type = cms.string('fixed'),
         sequential = cms.untracked.bool(False), # set to true for sequential reading of pileup
+        # With sharedCacheEvents > 0, the premixed events of sharedCacheSignalEvents consecutive signal events are
+        # drawn from a pool of sharedCacheEvents consecutive entries, sharedCachePoolsPerFile pools following each
+        # other in a file, and the streams share their products. The choice of the events is reproducible, whatever
+        # the number of streams, but differs from the one with sharedCacheEvents = 0.
+        sharedCacheEvents = cms.untracked.uint32(0),
+        sharedCacheSignalEvents = cms.untracked.uint32(10),
+        sharedCachePoolsPerFile = cms.untracked.uint32(100),
         fileNames = cms.untracked.vstring('file:DMPreProcess_RAW2DIGI.root'),
         consecutiveRejectionsLimit = cms.untracked.uint32(100) # should be sufficiently large to allow enough tails
     ),
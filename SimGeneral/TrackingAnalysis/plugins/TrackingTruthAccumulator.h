@@ -97,6 +97,7 @@ private:
   void accumulate(const edm::Event &event, const edm::EventSetup &setup) override;
   void accumulate(const PileUpEventPrincipal &event, const edm::EventSetup &setup, edm::StreamID const &) override;
   void finalizeEvent(edm::Event &event, const edm::EventSetup &setup) override;
+  bool threadSafePileUpAccumulation() const override { return true; }
 
   /** @brief Both forms of accumulate() delegate to this templated method. */
   template <class T>
@@ -0,0 +1,206 @@
+#include "SiPixelChargeSharingTemplate.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // same subdivision of the track as in SiPixelDigitizerAlgorithm::primary_ionization
+  constexpr float kSegmentLength = 0.0010;  // 10 microns in cm
+  // smaller fractions are dropped from the windows
+  constexpr double kMinFraction = 1.e-4;
+
+  // fraction of a gaussian cloud centred at x collected in [lb, ub]
+  inline double integral(double lb, double ub, double x, double sigma) {
+    return 0.5 * (std::erf((ub - x) / (M_SQRT2 * sigma)) - std::erf((lb - x) / (M_SQRT2 * sigma)));
+  }
+}  // namespace
+
+SiPixelChargeSharingTemplate::SiPixelChargeSharingTemplate(const Binning& binning,
+                                                           float pitchX,
+                                                           float pitchY,
+                                                           float thickness,
+                                                           float tanLorentzAngleX,
+                                                           float tanLorentzAngleY,
+                                                           float sigma0,
+                                                           float dist300,
+                                                           float clusterWidth)
+    : binning_(binning),
+      pitchX_(pitchX),
+      pitchY_(pitchY),
+      thickness_(thickness),
+      tanLorentzAngleX_(tanLorentzAngleX),
+      tanLorentzAngleY_(tanLorentzAngleY),
+      sigma0_(sigma0),
+      dist300_(dist300),
+      clusterWidth_(clusterWidth),
+      bins_(binning.nCotAlpha * binning.nCotBeta * binning.nPosition * binning.nPosition) {
+  const float stepAlpha = 2.f * binning_.cotAlphaMax / (binning_.nCotAlpha - 1);
+  const float stepBeta = 2.f * binning_.cotBetaMax / (binning_.nCotBeta - 1);
+  std::vector<double> grid;
+  auto bin = bins_.begin();
+  for (int ia = 0; ia < binning_.nCotAlpha; ++ia) {
+    for (int ib = 0; ib < binning_.nCotBeta; ++ib) {
+      for (int px = 0; px < binning_.nPosition; ++px) {
+        for (int py = 0; py < binning_.nPosition; ++py, ++bin) {
+          fill(*bin,
+               -binning_.cotAlphaMax + ia * stepAlpha,
+               -binning_.cotBetaMax + ib * stepBeta,
+               (px + 0.5f) / binning_.nPosition * pitchX_,
+               (py + 0.5f) / binning_.nPosition * pitchY_,
+               grid);
+        }
+      }
+    }
+  }
+  fractions_.shrink_to_fit();
+}
+
+void SiPixelChargeSharingTemplate::fill(
+    Bin& bin, float cotAlpha, float cotBeta, float centroidX, float centroidY, std::vector<double>& grid) {
+  // same drift as SiPixelDigitizerAlgorithm::drift, with the electrons drifting to -z
+  const float driftScale =
+      std::sqrt(1.f + tanLorentzAngleX_ * tanLorentzAngleX_ + tanLorentzAngleY_ * tanLorentzAngleY_);
+  const float projectionX = std::sqrt(1.f + tanLorentzAngleX_ * tanLorentzAngleX_);
+  const float projectionY = std::sqrt(1.f + tanLorentzAngleY_ * tanLorentzAngleY_);
+  const float halfThickness = 0.5f * thickness_;
+
+  const float length = thickness_ * std::sqrt(1.f + cotAlpha * cotAlpha + cotBeta * cotBeta);
+  const int nSegments = std::max(int(length / kSegmentLength), 1);
+
+  // pixels reached by the cloud of any segment
+  const float sigmaMax = std::sqrt(thickness_ * driftScale / dist300_) * sigma0_;
+  const float spreadX = std::abs(cotAlpha) * halfThickness + clusterWidth_ * sigmaMax * projectionX;
+  const float spreadY = std::abs(cotBeta) * halfThickness + clusterWidth_ * sigmaMax * projectionY;
+  const int gx0 = int(std::floor((centroidX - spreadX) / pitchX_));
+  const int gy0 = int(std::floor((centroidY - spreadY) / pitchY_));
+  const int nx = int(std::floor((centroidX + spreadX) / pitchX_)) - gx0 + 1;
+  const int ny = int(std::floor((centroidY + spreadY) / pitchY_)) - gy0 + 1;
+  grid.assign(nx * ny, 0.);
+
+  std::vector<double> fx(nx), fy(ny);
+  for (int i = 0; i < nSegments; ++i) {
+    const float z = -halfThickness + (i + 0.5f) / nSegments * thickness_;
+    const float x = centroidX + z * cotAlpha;
+    const float y = centroidY + z * cotBeta;
+    const float sigma = std::sqrt((halfThickness + z) * driftScale / dist300_) * sigma0_;
+    const float sigmaX = sigma * projectionX;
+    const float sigmaY = sigma * projectionY;
+
+    const int ixLow = std::max(int(std::floor((x - clusterWidth_ * sigmaX) / pitchX_)), gx0);
+    const int ixHigh = std::min(int(std::floor((x + clusterWidth_ * sigmaX) / pitchX_)), gx0 + nx - 1);
+    const int iyLow = std::max(int(std::floor((y - clusterWidth_ * sigmaY) / pitchY_)), gy0);
+    const int iyHigh = std::min(int(std::floor((y + clusterWidth_ * sigmaY) / pitchY_)), gy0 + ny - 1);
+    for (int ix = ixLow; ix <= ixHigh; ++ix) {
+      fx[ix - gx0] = sigmaX > 0. ? integral(ix * pitchX_, (ix + 1) * pitchX_, x, sigmaX) : 1.;
+    }
+    for (int iy = iyLow; iy <= iyHigh; ++iy) {
+      fy[iy - gy0] = sigmaY > 0. ? integral(iy * pitchY_, (iy + 1) * pitchY_, y, sigmaY) : 1.;
+    }
+    for (int ix = ixLow; ix <= ixHigh; ++ix) {
+      for (int iy = iyLow; iy <= iyHigh; ++iy) {
+        grid[(ix - gx0) * ny + (iy - gy0)] += fx[ix - gx0] * fy[iy - gy0] / nSegments;
+      }
+    }
+  }
+
+  // keep the smallest window holding the significant fractions
+  int xMin = nx, xMax = -1, yMin = ny, yMax = -1;
+  for (int ix = 0; ix < nx; ++ix) {
+    for (int iy = 0; iy < ny; ++iy) {
+      if (grid[ix * ny + iy] >= kMinFraction) {
+        xMin = std::min(xMin, ix);
+        xMax = std::max(xMax, ix);
+        yMin = std::min(yMin, iy);
+        yMax = std::max(yMax, iy);
+      }
+    }
+  }
+  bin.offset = fractions_.size();
+  bin.x0 = gx0 + xMin;
+  bin.y0 = gy0 + yMin;
+  bin.nx = std::max(xMax - xMin + 1, 0);
+  bin.ny = std::max(yMax - yMin + 1, 0);
+  for (int ix = xMin; ix <= xMax; ++ix) {
+    for (int iy = yMin; iy <= yMax; ++iy) {
+      fractions_.push_back(grid[ix * ny + iy]);
+    }
+  }
+}
+
+bool SiPixelChargeSharingTemplate::window(
+    float cotAlpha, float cotBeta, float positionX, float positionY, Window& w) const {
+  const float ta = (cotAlpha + binning_.cotAlphaMax) / (2.f * binning_.cotAlphaMax) * (binning_.nCotAlpha - 1);
+  const float tb = (cotBeta + binning_.cotBetaMax) / (2.f * binning_.cotBetaMax) * (binning_.nCotBeta - 1);
+  if (!(ta >= 0.f && ta <= binning_.nCotAlpha - 1 && tb >= 0.f && tb <= binning_.nCotBeta - 1))
+    return false;
+  const int ia = std::min(int(ta), binning_.nCotAlpha - 2);
+  const int ib = std::min(int(tb), binning_.nCotBeta - 2);
+
+  // Between the centres of the position bins. Beyond the first and last
+  // centres, the neighbouring bin is the last or first one of the next pixel,
+  // whose window is shifted by one pixel.
+  const int nPosition = binning_.nPosition;
+  const float tx = positionX * nPosition - 0.5f;
+  const float ty = positionY * nPosition - 0.5f;
+  const int px = int(std::floor(tx));
+  const int py = int(std::floor(ty));
+
+  struct Corner {
+    const Bin* bin;
+    int dx;
+    int dy;
+    float weight;
+  };
+  Corner corners[16];
+  int nCorners = 0;
+  int xLow = 0, xHigh = 0, yLow = 0, yHigh = 0;
+  for (int ja = 0; ja < 2; ++ja) {
+    const float wa = ja ? ta - ia : 1.f - (ta - ia);
+    for (int jb = 0; jb < 2; ++jb) {
+      const float wb = jb ? tb - ib : 1.f - (tb - ib);
+      for (int jx = 0; jx < 2; ++jx) {
+        const float wx = jx ? tx - px : 1.f - (tx - px);
+        const int dx = px + jx < 0 ? -1 : (px + jx >= nPosition ? 1 : 0);
+        const int binX = px + jx - dx * nPosition;
+        for (int jy = 0; jy < 2; ++jy) {
+          const float wy = jy ? ty - py : 1.f - (ty - py);
+          const int dy = py + jy < 0 ? -1 : (py + jy >= nPosition ? 1 : 0);
+          const int binY = py + jy - dy * nPosition;
+          const float weight = wa * wb * wx * wy;
+          const Bin& bin = bins_[(((ia + ja) * binning_.nCotBeta + ib + jb) * nPosition + binX) * nPosition + binY];
+          if (weight <= 0.f || bin.nx == 0 || bin.ny == 0)
+            continue;
+          if (nCorners == 0) {
+            xLow = bin.x0 + dx;
+            xHigh = bin.x0 + dx + bin.nx;
+            yLow = bin.y0 + dy;
+            yHigh = bin.y0 + dy + bin.ny;
+          } else {
+            xLow = std::min(xLow, bin.x0 + dx);
+            xHigh = std::max(xHigh, bin.x0 + dx + bin.nx);
+            yLow = std::min(yLow, bin.y0 + dy);
+            yHigh = std::max(yHigh, bin.y0 + dy + bin.ny);
+          }
+          corners[nCorners++] = Corner{&bin, dx, dy, weight};
+        }
+      }
+    }
+  }
+
+  w.x0 = xLow;
+  w.y0 = yLow;
+  w.nx = xHigh - xLow;
+  w.ny = yHigh - yLow;
+  w.fraction.assign(w.nx * w.ny, 0.f);
+  for (int ic = 0; ic < nCorners; ++ic) {
+    const Bin& bin = *corners[ic].bin;
+    const float* fraction = fractions_.data() + bin.offset;
+    for (int ix = 0; ix < bin.nx; ++ix) {
+      float* row = w.fraction.data() + (bin.x0 + corners[ic].dx - xLow + ix) * w.ny + (bin.y0 + corners[ic].dy - yLow);
+      for (int iy = 0; iy < bin.ny; ++iy) {
+        row[iy] += corners[ic].weight * fraction[ix * bin.ny + iy];
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,82 @@
+#ifndef SiPixelChargeSharingTemplate_h
+#define SiPixelChargeSharingTemplate_h
+
+/** \class SiPixelChargeSharingTemplate
+ *
+ * Fraction of the charge of a track segment crossing the whole sensor
+ * which is collected by each pixel around it, precomputed with the drift
+ * and diffusion model of SiPixelDigitizerAlgorithm on a grid of
+ *  - the track angles on the collection plane, Lorentz drift included
+ *    (cot(alpha) + tan(theta_L,x), cot(beta) + tan(theta_L,y));
+ *  - the position inside its pixel of the charge collected from the
+ *    middle of the sensor.
+ * The fractions of a hit are interpolated linearly between the angle nodes
+ * and the centres of the position bins.
+ * The pixels are assumed to have a uniform pitch.
+ *
+ ************************************************************/
+
+#include <cstddef>
+#include <vector>
+
+class SiPixelChargeSharingTemplate {
+public:
+  struct Binning {
+    float cotAlphaMax;
+    float cotBetaMax;
+    int nCotAlpha;
+    int nCotBeta;
+    int nPosition;
+  };
+
+  // pixels [x0, x0 + nx) x [y0, y0 + ny) relative to the pixel of the charge
+  // centroid; fraction[ix * ny + iy]
+  struct Window {
+    int x0;
+    int y0;
+    int nx;
+    int ny;
+    std::vector<float> fraction;
+  };
+
+  SiPixelChargeSharingTemplate(const Binning& binning,
+                               float pitchX,
+                               float pitchY,
+                               float thickness,
+                               float tanLorentzAngleX,
+                               float tanLorentzAngleY,
+                               float sigma0,
+                               float dist300,
+                               float clusterWidth);
+
+  // fills the interpolated fractions; false if the angles are outside of the table
+  bool window(float cotAlpha, float cotBeta, float positionX, float positionY, Window& w) const;
+
+  size_t size() const { return fractions_.size(); }
+
+private:
+  struct Bin {
+    int x0;
+    int y0;
+    int nx;
+    int ny;
+    size_t offset;
+  };
+
+  void fill(Bin& bin, float cotAlpha, float cotBeta, float centroidX, float centroidY, std::vector<double>& grid);
+
+  const Binning binning_;
+  const float pitchX_;
+  const float pitchY_;
+  const float thickness_;
+  const float tanLorentzAngleX_;
+  const float tanLorentzAngleY_;
+  const float sigma0_;
+  const float dist300_;
+  const float clusterWidth_;
+
+  std::vector<Bin> bins_;
+  std::vector<float> fractions_;
+};
+
+#endif
@@ -40,6 +40,8 @@
 // February, 2011: Time improvement in DriftDirection()  (J. Bashir Butt)
 // June, 2011: Bug Fix for pixels on ROC edges in module_killing_DB() (J. Bashir Butt)
 // February, 2018: Implement cluster charge reweighting (P. Schuetze, with code from A. Hazi)
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
 
@@ -332,6 +334,9 @@ SiPixelDigitizerAlgorithm::SiPixelDigitizerAlgorithm(const edm::ParameterSet& co
       UseReweighting(conf.getParameter<bool>("UseReweighting")),
       PrintClusters(conf.getParameter<bool>("PrintClusters")),
       PrintTemplates(conf.getParameter<bool>("PrintTemplates")),
+      UseChargeSharingTemplates(conf.exists("UseChargeSharingTemplates")
+                                    ? conf.getParameter<bool>("UseChargeSharingTemplates") && !AddPixelAging
+                                    : false),
 
       // delta cutoff in MeV, has to be same as in OSCAR(0.030/cmsim=1.0 MeV
       //tMax(0.030), // In MeV.
@@ -354,6 +359,25 @@ SiPixelDigitizerAlgorithm::SiPixelDigitizerAlgorithm(const edm::ParameterSet& co
                              << "threshold in electron BPix Layer2 = " << theThresholdInE_BPix_L2 << " "
                              << theElectronPerADC << " " << theAdcFullScale << " The delta cut-off is set to " << tMax
                              << " pix-inefficiency " << AddPixelInefficiency;
+
+  if (UseChargeSharingTemplates) {
+    const edm::ParameterSet& pset = conf.getParameter<edm::ParameterSet>("ChargeSharingTemplates");
+    chargeSharingBinning_.cotAlphaMax = pset.getParameter<double>("cotAlphaMax");
+    chargeSharingBinning_.cotBetaMax = pset.getParameter<double>("cotBetaMax");
+    chargeSharingBinning_.nCotAlpha = pset.getParameter<int>("nCotAlpha");
+    chargeSharingBinning_.nCotBeta = pset.getParameter<int>("nCotBeta");
+    chargeSharingBinning_.nPosition = pset.getParameter<int>("nPosition");
+    chargeSharingLorentzStep_ = pset.getParameter<double>("tanLorentzAngleStep");
+    if (chargeSharingBinning_.cotAlphaMax <= 0. || chargeSharingBinning_.cotBetaMax <= 0. ||
+        chargeSharingBinning_.nCotAlpha < 2 || chargeSharingBinning_.nCotBeta < 2 ||
+        chargeSharingBinning_.nPosition < 1 || chargeSharingLorentzStep_ <= 0.) {
+      throw cms::Exception("Configuration") << "SiPixelDigitizerAlgorithm: invalid ChargeSharingTemplates binning";
+    }
+  } else if (AddPixelAging && conf.exists("UseChargeSharingTemplates") &&
+             conf.getParameter<bool>("UseChargeSharingTemplates")) {
+    LogWarning("PixelDigitizer") << "The charge sharing templates are not used with the pixel aging, "
+                                 << "which depends on the depth of each deposit";
+  }
 }
 
 std::map<int, SiPixelDigitizerAlgorithm::CalParameters, std::less<int> > SiPixelDigitizerAlgorithm::initCal() const {
@@ -790,6 +814,15 @@ void SiPixelDigitizerAlgorithm::accumulateSimHits(std::vector<PSimHit>::const_it
 
   uint32_t detId = pixdet->geographicalId().rawId();
   size_t simHitGlobalIndex = inputBeginGlobalIndex;  // This needs to stored to create the digi-sim link later
+
+  const SiPixelChargeSharingTemplate* chargeSharing = nullptr;
+  LocalVector driftDir;
+  if (UseChargeSharingTemplates) {
+    driftDir = DriftDirection(pixdet, bfield, detId);
+    if (driftDir.z() != 0.) {
+      chargeSharing = &chargeSharingTemplate(pixdet, driftDir);
+    }
+  }
   for (std::vector<PSimHit>::const_iterator ssbegin = inputBegin; ssbegin != inputEnd; ++ssbegin, ++simHitGlobalIndex) {
     // skip hits not in this detector.
     if ((*ssbegin).detUnitId() != detId) {
@@ -810,6 +843,11 @@ void SiPixelDigitizerAlgorithm::accumulateSimHits(std::vector<PSimHit>::const_it
     // Check the TOF cut
     if (((*ssbegin).tof() - pixdet->surface().toGlobal((*ssbegin).localPosition()).mag() / 30.) >= theTofLowerCut &&
         ((*ssbegin).tof() - pixdet->surface().toGlobal((*ssbegin).localPosition()).mag() / 30.) <= theTofUpperCut) {
+      // segments crossing the sensor go through the charge sharing templates if enabled
+      if (chargeSharing != nullptr &&
+          induce_signal_template(inputBegin, *ssbegin, simHitGlobalIndex, tofBin, pixdet, driftDir, *chargeSharing)) {
+        continue;
+      }
       primary_ionization(*ssbegin, ionization_points, engine);  // fills _ionization_points
       drift(*ssbegin,
             pixdet,
@@ -827,6 +865,10 @@ void SiPixelDigitizerAlgorithm::accumulateSimHits(std::vector<PSimHit>::const_it
                     collection_points);  // 1st 3 args needed only for SimHit<-->Digi link
     }                                    //  end if
   }                                      // end for
+
+  if (chargeSharing != nullptr) {
+    flush_dense_signal(pixdet, tofBin);
+  }
 }
 
 //============================================================================
@@ -1507,6 +1549,177 @@ void SiPixelDigitizerAlgorithm::induce_signal(std::vector<PSimHit>::const_iterat
 
 }  // end induce_signal
 
+//*************************************************************************
+// Charge sharing template for the pixel size, thickness and Lorentz drift of the module
+const SiPixelChargeSharingTemplate& SiPixelDigitizerAlgorithm::chargeSharingTemplate(const PixelGeomDetUnit* pixdet,
+                                                                                     const LocalVector& driftDir) {
+  const PixelTopology& topol = pixdet->specificTopology();
+  float moduleThickness = pixdet->specificSurface().bounds().thickness();
+  float tanLorentzX = driftDir.x();
+  float tanLorentzY = alpha2Order ? driftDir.y() : 0.f;  // as in drift()
+
+  // The Lorentz drift only enters the diffusion through the table, the shift
+  // of the charge is exact, so that a coarse step is enough
+  ChargeSharingKey key(topol.pitch().first,
+                       topol.pitch().second,
+                       moduleThickness,
+                       int(std::lround(tanLorentzX / chargeSharingLorentzStep_)),
+                       int(std::lround(tanLorentzY / chargeSharingLorentzStep_)));
+  auto& chargeSharing = chargeSharingTemplates_[key];
+  if (!chargeSharing) {
+    chargeSharing = std::make_unique<const SiPixelChargeSharingTemplate>(chargeSharingBinning_,
+                                                                         topol.pitch().first,
+                                                                         topol.pitch().second,
+                                                                         moduleThickness,
+                                                                         std::get<3>(key) * chargeSharingLorentzStep_,
+                                                                         std::get<4>(key) * chargeSharingLorentzStep_,
+                                                                         Sigma0,
+                                                                         Dist300,
+                                                                         ClusterWidth);
+    LogInfo("PixelDigitizer") << "Charge sharing template built for pitch " << topol.pitch().first << " x "
+                              << topol.pitch().second << ", thickness " << moduleThickness << ", Lorentz drift "
+                              << std::get<3>(key) * chargeSharingLorentzStep_ << " "
+                              << std::get<4>(key) * chargeSharingLorentzStep_ << ": " << chargeSharing->size()
+                              << " fractions";
+  }
+  return *chargeSharing;
+}
+
+//*************************************************************************
+// Induce the signal of a hit crossing the whole sensor from the charge
+// sharing template, in place of primary_ionization, drift and induce_signal.
+// The charge is added to the dense signal of the module; returns false if the
+// hit is not covered by the template, or if its charge reaches a big pixel,
+// whose size the template does not know.
+bool SiPixelDigitizerAlgorithm::induce_signal_template(std::vector<PSimHit>::const_iterator inputBegin,
+                                                       const PSimHit& hit,
+                                                       const size_t hitIndex,
+                                                       const unsigned int tofBin,
+                                                       const PixelGeomDetUnit* pixdet,
+                                                       const LocalVector& driftDir,
+                                                       const SiPixelChargeSharingTemplate& chargeSharing) {
+  const PixelTopology* topol = &pixdet->specificTopology();
+  float moduleThickness = pixdet->specificSurface().bounds().thickness();
+
+  LocalVector direction = hit.exitPoint() - hit.entryPoint();
+  if (std::abs(direction.z()) < 0.99f * moduleThickness)
+    return false;
+
+  float tanLorentzX = driftDir.x();
+  float tanLorentzY = alpha2Order ? driftDir.y() : 0.f;
+  float cotAlpha = direction.x() / direction.z();
+  float cotBeta = direction.y() / direction.z();
+
+  // Charge from the middle plane of the sensor, drifted over half of the thickness
+  Local3DPoint middle = hit.entryPoint() + 0.5f * direction;
+  float centroidX = middle.x() - middle.z() * cotAlpha + 0.5f * moduleThickness * tanLorentzX;
+  float centroidY = middle.y() - middle.z() * cotBeta + 0.5f * moduleThickness * tanLorentzY;
+  MeasurementPoint mp = topol->measurementPosition(LocalPoint(centroidX, centroidY));
+  int ixCentroid = int(floor(mp.x()));
+  int iyCentroid = int(floor(mp.y()));
+
+  SiPixelChargeSharingTemplate::Window& window = chargeSharingWindow_;
+  if (!chargeSharing.window(
+          cotAlpha + tanLorentzX, cotBeta + tanLorentzY, mp.x() - ixCentroid, mp.y() - iyCentroid, window))
+    return false;
+
+  // THE CHARGE OUTSIDE THE ACTIVE PIXEL AREA IS LOST, as in induce_signal
+  int numColumns = topol->ncolumns();
+  int numRows = topol->nrows();
+  int ixLow = std::max(ixCentroid + window.x0, 0);
+  int ixHigh = std::min(ixCentroid + window.x0 + window.nx, numRows);
+  int iyLow = std::max(iyCentroid + window.y0, 0);
+  int iyHigh = std::min(iyCentroid + window.y0 + window.ny, numColumns);
+  for (int ix = ixLow; ix < ixHigh; ++ix) {
+    if (topol->isItBigPixelInX(ix))
+      return false;
+  }
+  for (int iy = iyLow; iy < iyHigh; ++iy) {
+    if (topol->isItBigPixelInY(iy))
+      return false;
+  }
+  float Charge = hit.energyLoss() / GeVperElectron;
+
+  if (UseReweighting) {
+    std::map<int, float, std::less<int> > hit_signal;
+    for (int ix = ixLow; ix < ixHigh; ++ix) {
+      for (int iy = iyLow; iy < iyHigh; ++iy) {
+        float ChargeFraction =
+            Charge * window.fraction[(ix - ixCentroid - window.x0) * window.ny + (iy - iyCentroid - window.y0)];
+        if (ChargeFraction > 0.)
+          hit_signal[PixelDigi::pixelToChannel(ix, iy)] += ChargeFraction;
+      }
+    }
+    uint32_t detID = pixdet->geographicalId().rawId();
+    // If it's not the primary particle, use the first hit in the collection as SimHit, as in induce_signal
+    if (hitSignalReweight(hit.processType() == 0 ? hit : (*inputBegin),
+                          hit_signal,
+                          hitIndex,
+                          tofBin,
+                          topol,
+                          detID,
+                          _signal[detID],
+                          hit.processType()))
+      return true;
+  }
+
+  denseSignal_.resize(std::max(denseSignal_.size(), size_t(numRows) * numColumns), 0.f);
+  for (int ix = ixLow; ix < ixHigh; ++ix) {
+    for (int iy = iyLow; iy < iyHigh; ++iy) {
+      float ChargeFraction =
+          Charge * window.fraction[(ix - ixCentroid - window.x0) * window.ny + (iy - iyCentroid - window.y0)];
+      if (ChargeFraction > 0.) {
+        int pixel = ix * numColumns + iy;
+        if (denseSignal_[pixel] == 0.f)
+          denseTouched_.push_back(pixel);
+        denseSignal_[pixel] += ChargeFraction;
+        if (makeDigiSimLinks_)
+          denseContributions_.push_back(DenseContribution{pixel, ChargeFraction, &hit, hitIndex});
+      }
+    }
+  }
+  return true;
+}
+
+//*************************************************************************
+// Move the dense signal of the module accumulated from the templates into
+// its signal map, one map access per pixel
+void SiPixelDigitizerAlgorithm::flush_dense_signal(const PixelGeomDetUnit* pixdet, const unsigned int tofBin) {
+  if (denseTouched_.empty())
+    return;
+
+  int numColumns = pixdet->specificTopology().ncolumns();
+  signal_map_type& theSignal = _signal[pixdet->geographicalId().rawId()];
+  if (makeDigiSimLinks_) {
+    // keep the order of the hits in each pixel
+    std::stable_sort(denseContributions_.begin(),
+                     denseContributions_.end(),
+                     [](const DenseContribution& a, const DenseContribution& b) { return a.pixel < b.pixel; });
+    Amplitude* amplitude = nullptr;
+    int lastPixel = -1;
+    for (auto const& contribution : denseContributions_) {
+      if (contribution.pixel != lastPixel) {
+        lastPixel = contribution.pixel;
+        amplitude = &theSignal[PixelDigi::pixelToChannel(lastPixel / numColumns, lastPixel % numColumns)];
+      }
+      *amplitude +=
+          Amplitude(contribution.amplitude, contribution.hit, contribution.hitIndex, tofBin, contribution.amplitude);
+    }
+    denseContributions_.clear();
+  } else {
+    std::sort(denseTouched_.begin(), denseTouched_.end());
+    for (int pixel : denseTouched_) {
+      theSignal[PixelDigi::pixelToChannel(pixel / numColumns, pixel % numColumns)] +=
+          Amplitude(denseSignal_[pixel], denseSignal_[pixel]);
+    }
+  }
+
+  for (int pixel : denseTouched_) {
+    denseSignal_[pixel] = 0.f;
+  }
+  denseTouched_.clear();
+}
+
 /***********************************************************************/
 
 // Build pixels, check threshold, add misscalibration, ...
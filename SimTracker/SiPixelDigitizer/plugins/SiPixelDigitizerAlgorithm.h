@@ -3,6 +3,7 @@
 
 #include <map>
 #include <memory>
+#include <tuple>
 #include <vector>
 #include <iostream>
 #include "DataFormats/GeometrySurface/interface/GloballyPositioned.h"
@@ -20,6 +21,7 @@
 #include "DataFormats/SiPixelDetId/interface/PixelFEDChannel.h"
 #include "CalibTracker/Records/interface/SiPixelFEDChannelContainerESProducerRcd.h"
 #include "boost/multi_array.hpp"
+#include "SiPixelChargeSharingTemplate.h"
 
 typedef boost::multi_array<float, 2> array_2d;
 
@@ -321,6 +323,26 @@ private:
   const SiPixel2DTemplateDBObject* dbobject_den;
   const SiPixel2DTemplateDBObject* dbobject_num;
 
+  // Charge sharing templates, built on first use for each pitch, thickness
+  // and Lorentz drift (in units of chargeSharingLorentzStep_)
+  typedef std::tuple<float, float, float, int, int> ChargeSharingKey;
+  SiPixelChargeSharingTemplate::Binning chargeSharingBinning_;
+  float chargeSharingLorentzStep_;
+  std::map<ChargeSharingKey, std::unique_ptr<const SiPixelChargeSharingTemplate> > chargeSharingTemplates_;
+  SiPixelChargeSharingTemplate::Window chargeSharingWindow_;
+
+  // Signal of the module being accumulated with the charge sharing templates,
+  // indexed by row * ncolumns + column, and the contribution of each hit to it
+  struct DenseContribution {
+    int pixel;
+    float amplitude;
+    const PSimHit* hit;
+    size_t hitIndex;
+  };
+  std::vector<float> denseSignal_;
+  std::vector<int> denseTouched_;
+  std::vector<DenseContribution> denseContributions_;
+
 private:
   // Variables
   //external parameters
@@ -395,6 +417,7 @@ private:
   const bool UseReweighting;
   const bool PrintClusters;
   const bool PrintTemplates;
+  const bool UseChargeSharingTemplates;  // precomputed charge sharing for the hits crossing the sensor
 
   // The PDTable
   //HepPDTable *particleTable;
@@ -430,6 +453,16 @@ private:
                      const unsigned int tofBin,
                      const PixelGeomDetUnit* pixdet,
                      const std::vector<SignalPoint>& collection_points);
+  const SiPixelChargeSharingTemplate& chargeSharingTemplate(const PixelGeomDetUnit* pixdet,
+                                                            const LocalVector& driftDir);
+  bool induce_signal_template(std::vector<PSimHit>::const_iterator inputBegin,
+                              const PSimHit& hit,
+                              const size_t hitIndex,
+                              const unsigned int tofBin,
+                              const PixelGeomDetUnit* pixdet,
+                              const LocalVector& driftDir,
+                              const SiPixelChargeSharingTemplate& chargeSharing);
+  void flush_dense_signal(const PixelGeomDetUnit* pixdet, const unsigned int tofBin);
   void fluctuateEloss(int particleId,
                       float momentum,
                       float eloss,
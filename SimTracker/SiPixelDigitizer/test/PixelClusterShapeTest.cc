@@ -0,0 +1,145 @@
+// -*- C++ -*-
+//
+// Package:    SiPixelDigitizer
+// Class:      PixelClusterShapeTest
+//
+/**\class PixelClusterShapeTest PixelClusterShapeTest.cc
+
+ Description: Cluster shape distributions (charge, size in x and y,
+ number of clusters) in the barrel and forward pixels, to compare the
+ digitization options (see runChargeSharingValidation_cfg.py). Also the
+ position of the clusters inside their pixel, and their residual to the
+ nearest simhit of the module.
+
+*/
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/ESGetToken.h"
+
+#include "DataFormats/Common/interface/DetSetVectorNew.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/DetId/interface/DetId.h"
+#include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+#include "DataFormats/SiPixelDetId/interface/PixelSubdetector.h"
+#include "SimDataFormats/TrackingHit/interface/PSimHitContainer.h"
+#include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
+#include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetUnit.h"
+
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+
+#include <TH1F.h>
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+class PixelClusterShapeTest : public edm::one::EDAnalyzer<edm::one::SharedResources> {
+public:
+  explicit PixelClusterShapeTest(const edm::ParameterSet&);
+
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+
+private:
+  edm::EDGetTokenT<edmNew::DetSetVector<SiPixelCluster>> tPixelCluster_;
+  std::vector<edm::EDGetTokenT<edm::PSimHitContainer>> tPixelSimHits_;
+  edm::ESGetToken<TrackerGeometry, TrackerDigiGeometryRecord> tGeom_;
+
+  // 0 = barrel, 1 = forward
+  TH1F* hclusPerEvent_[2];
+  TH1F* hcharge_[2];
+  TH1F* hsize_[2];
+  TH1F* hsizeX_[2];
+  TH1F* hsizeY_[2];
+  TH1F* hpositionX_[2];
+  TH1F* hpositionY_[2];
+  TH1F* hresidualX_[2];
+  TH1F* hresidualY_[2];
+};
+
+PixelClusterShapeTest::PixelClusterShapeTest(const edm::ParameterSet& iConfig)
+    : tPixelCluster_(consumes<edmNew::DetSetVector<SiPixelCluster>>(iConfig.getParameter<edm::InputTag>("src"))),
+      tGeom_(esConsumes<TrackerGeometry, TrackerDigiGeometryRecord>()) {
+  for (auto const& tag : iConfig.getParameter<std::vector<edm::InputTag>>("simHits")) {
+    tPixelSimHits_.push_back(consumes<edm::PSimHitContainer>(tag));
+  }
+  usesResource("TFileService");
+  edm::Service<TFileService> fs;
+  const char* parts[2] = {"BPix", "FPix"};
+  for (int i = 0; i < 2; ++i) {
+    hclusPerEvent_[i] =
+        fs->make<TH1F>(Form("hclusPerEvent%s", parts[i]), Form("%s clusters per event", parts[i]), 200, 0., 20000.);
+    hcharge_[i] = fs->make<TH1F>(Form("hcharge%s", parts[i]), Form("%s cluster charge (ke)", parts[i]), 200, 0., 200.);
+    hsize_[i] = fs->make<TH1F>(Form("hsize%s", parts[i]), Form("%s cluster size (pixels)", parts[i]), 100, -0.5, 99.5);
+    hsizeX_[i] = fs->make<TH1F>(Form("hsizeX%s", parts[i]), Form("%s cluster size in x", parts[i]), 20, -0.5, 19.5);
+    hsizeY_[i] = fs->make<TH1F>(Form("hsizeY%s", parts[i]), Form("%s cluster size in y", parts[i]), 40, -0.5, 39.5);
+    hpositionX_[i] = fs->make<TH1F>(
+        Form("hpositionX%s", parts[i]), Form("%s position in the pixel in x, size in x > 1", parts[i]), 50, 0., 1.);
+    hpositionY_[i] = fs->make<TH1F>(
+        Form("hpositionY%s", parts[i]), Form("%s position in the pixel in y, size in y > 1", parts[i]), 50, 0., 1.);
+    hresidualX_[i] =
+        fs->make<TH1F>(Form("hresidualX%s", parts[i]), Form("%s residual in x (um)", parts[i]), 200, -100., 100.);
+    hresidualY_[i] =
+        fs->make<TH1F>(Form("hresidualY%s", parts[i]), Form("%s residual in y (um)", parts[i]), 200, -200., 200.);
+  }
+}
+
+void PixelClusterShapeTest::analyze(const edm::Event& iEvent, const edm::EventSetup& iSetup) {
+  edm::Handle<edmNew::DetSetVector<SiPixelCluster>> clusters;
+  iEvent.getByToken(tPixelCluster_, clusters);
+  const TrackerGeometry& geom = iSetup.getData(tGeom_);
+
+  std::map<unsigned int, std::vector<const PSimHit*>> simHits;
+  for (auto const& token : tPixelSimHits_) {
+    for (auto const& hit : iEvent.get(token)) {
+      simHits[hit.detUnitId()].push_back(&hit);
+    }
+  }
+
+  int nclus[2] = {0, 0};
+  for (auto const& detSet : *clusters) {
+    DetId detId(detSet.detId());
+    int part = detId.subdetId() == PixelSubdetector::PixelBarrel ? 0 : 1;
+    const PixelGeomDetUnit* pixdet = dynamic_cast<const PixelGeomDetUnit*>(geom.idToDetUnit(detId));
+    auto const& hits = simHits[detId.rawId()];
+    for (auto const& cluster : detSet) {
+      ++nclus[part];
+      hcharge_[part]->Fill(cluster.charge() / 1000.);
+      hsize_[part]->Fill(cluster.size());
+      hsizeX_[part]->Fill(cluster.sizeX());
+      hsizeY_[part]->Fill(cluster.sizeY());
+      // a single pixel is always at its centre
+      if (cluster.sizeX() > 1)
+        hpositionX_[part]->Fill(cluster.x() - std::floor(cluster.x()));
+      if (cluster.sizeY() > 1)
+        hpositionY_[part]->Fill(cluster.y() - std::floor(cluster.y()));
+
+      if (pixdet == nullptr || hits.empty())
+        continue;
+      // residual including the Lorentz shift, which is the same for all the options
+      LocalPoint position = pixdet->specificTopology().localPosition(MeasurementPoint(cluster.x(), cluster.y()));
+      const PSimHit* nearest = nullptr;
+      float distance = 0.f;
+      for (auto const* hit : hits) {
+        float d = (hit->localPosition() - position).perp2();
+        if (nearest == nullptr || d < distance) {
+          nearest = hit;
+          distance = d;
+        }
+      }
+      hresidualX_[part]->Fill((position.x() - nearest->localPosition().x()) * 1.e4);
+      hresidualY_[part]->Fill((position.y() - nearest->localPosition().y()) * 1.e4);
+    }
+  }
+  for (int i = 0; i < 2; ++i) {
+    hclusPerEvent_[i]->Fill(nclus[i]);
+  }
+}
+
+DEFINE_FWK_MODULE(PixelClusterShapeTest);
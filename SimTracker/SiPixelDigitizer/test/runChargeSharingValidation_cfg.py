@@ -0,0 +1,69 @@
+###############################################################################
+# Validation of the charge sharing templates of the pixel digitizer: the
+# same GEN-SIM sample is digitized with the full drift and induction of
+# each 10um segment and with the templates, the digis are clustered and
+# the cluster shapes, positions in the pixel and residuals to the simhits
+# histogrammed by PixelClusterShapeTest
+#
+#   cmsRun runChargeSharingValidation_cfg.py inputFiles=file:step1.root templates=0
+#   cmsRun runChargeSharingValidation_cfg.py inputFiles=file:step1.root templates=1
+#   compareHistogramsKS.py clusterShapes0.root clusterShapes1.root PixelClusterShapeTest
+#
+# The CPU time of the mix module is in the Timing summary of the two jobs
+###############################################################################
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+from Configuration.Eras.Era_Run2_2018_cff import Run2_2018
+
+options = VarParsing('analysis')
+options.register ("templates", 1, VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.parseArguments()
+
+process = cms.Process("ChargeSharingValidation", Run2_2018)
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('SimGeneral.MixingModule.mixNoPU_cfi')
+process.load('SimGeneral.MixingModule.aliases_cfi')
+process.load('RecoLocalTracker.SiPixelClusterizer.SiPixelClusterizer_cfi')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2018_realistic', '')
+
+if 'MessageLogger' in process.__dict__:
+    process.MessageLogger.categories.append('PixelDigitizer')
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.Timing = cms.Service("Timing")
+
+process.TFileService = cms.Service("TFileService",
+    fileName = cms.string('clusterShapes%d.root' % options.templates)
+)
+
+# digitize the pixels only
+process.mix.digitizers = cms.PSet(
+    pixel = process.mix.digitizers.pixel
+)
+process.mix.digitizers.pixel.UseChargeSharingTemplates = bool(options.templates)
+
+process.siPixelClusters.src = 'simSiPixelDigis'
+
+process.PixelClusterShapeTest = cms.EDAnalyzer("PixelClusterShapeTest",
+    src = cms.InputTag("siPixelClusters"),
+    simHits = cms.VInputTag(
+        cms.InputTag("g4SimHits", "TrackerHitsPixelBarrelLowTof"),
+        cms.InputTag("g4SimHits", "TrackerHitsPixelBarrelHighTof"),
+        cms.InputTag("g4SimHits", "TrackerHitsPixelEndcapLowTof"),
+        cms.InputTag("g4SimHits", "TrackerHitsPixelEndcapHighTof")
+    )
+)
+
+process.p = cms.Path(process.mix * process.siPixelClusters * process.PixelClusterShapeTest)
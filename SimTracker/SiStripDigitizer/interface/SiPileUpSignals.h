@@ -15,10 +15,13 @@ class SiPileUpSignals {
 public:
   // type used to describe the amplitude on a strip
   typedef float Amplitude;
-  // associates to each strip a vector of amplitudes.
-  // That allows later to comput the fraction of the contribution of each simhit to the ADC value
-  typedef std::map<int, Amplitude> SignalMapType;
-  typedef std::map<uint32_t, SignalMapType> signalMaps;
+  // amplitudes of the strips [first, first + amplitudes.size()) of a module, which
+  // hold all the strips with signal: the range grows with each add()
+  struct SignalType {
+    size_t first = 0;
+    std::vector<Amplitude> amplitudes;
+  };
+  typedef std::map<uint32_t, SignalType> signalMaps;
 
   SiPileUpSignals() { reset(); }
 
@@ -31,7 +34,7 @@ public:
 
   void reset() { resetSignals(); }
 
-  const SignalMapType* getSignal(uint32_t detID) const {
+  const SignalType* getSignal(uint32_t detID) const {
     auto where = signal_.find(detID);
     if (where == signal_.end()) {
       return nullptr;
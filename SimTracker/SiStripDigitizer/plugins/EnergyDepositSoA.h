@@ -0,0 +1,65 @@
+#ifndef _TRACKER_EnergyDepositSoA_H
+#define _TRACKER_EnergyDepositSoA_H
+
+#include <vector>
+
+/**
+ * The energy deposits of all the SimHits of a module, in structure-of-arrays form,
+ * so that each step of the digitization runs over the whole module at once:
+ * - the charge divider fills the position in the bulk and the energy;
+ * - the drifter moves x and y to the surface and computes sigma from the diffusion;
+ * - the induction computes the position and spread in strip units, the strips
+ *   reached by each deposit and the integral of its charge over each of them.
+ * The deposits of the hit i are [hitBegin[i], hitBegin[i + 1]).
+ * The buffers keep their capacity, so clear() the collection and reuse it from module to module.
+ */
+class EnergyDepositSoA {
+public:
+  EnergyDepositSoA() { clear(); }
+
+  void clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    energy.clear();
+    sigma.clear();
+    hitBegin.assign(1, 0);
+  }
+
+  // add a deposit to the current hit
+  void push_back(float e, float px, float py, float pz) {
+    energy.push_back(e);
+    x.push_back(px);
+    y.push_back(py);
+    z.push_back(pz);
+  }
+
+  // close the current hit (which may have no deposit)
+  void endHit() { hitBegin.push_back(size()); }
+
+  unsigned int size() const { return energy.size(); }
+  unsigned int nHits() const { return hitBegin.size() - 1; }
+  unsigned int begin(unsigned int hit) const { return hitBegin[hit]; }
+  unsigned int end(unsigned int hit) const { return hitBegin[hit + 1]; }
+
+  // position (in the bulk, then on the surface), energy and diffusion
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> z;
+  std::vector<float> energy;
+  std::vector<float> sigma;
+
+  // in strip units: the strips [fromStrip, fromStrip + nStrip) collect the charge
+  // of the deposit, their integrals are value[valueBegin, valueBegin + nStrip)
+  std::vector<float> chargePosition;
+  std::vector<float> chargeSpread;
+  std::vector<float> amplitude;
+  std::vector<int> fromStrip;
+  std::vector<int> nStrip;
+  std::vector<int> valueBegin;
+  std::vector<float> value;
+
+  std::vector<unsigned int> hitBegin;
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include "DataFormats/GeometryVector/interface/LocalVector.h"
 #include "SignalPoint.h"
 #include "EnergyDepositUnit.h"
+#include "EnergyDepositSoA.h"
 
 #include <vector>
 /**
@@ -16,6 +17,8 @@ public:
 
   virtual ~SiChargeCollectionDrifter() {}
   virtual collection_type drift(const ionization_type&, const LocalVector&, double, double) = 0;
+  // same, in place for all the deposits of a module
+  virtual void drift(EnergyDepositSoA&, const LocalVector&, double, double) = 0;
 };
 
 #endif
@@ -2,6 +2,7 @@
 #define Tracker_SiChargeDivider_H
 
 #include "EnergyDepositUnit.h"
+#include "EnergyDepositSoA.h"
 #include "SimDataFormats/TrackingHit/interface/PSimHit.h"
 #include "Geometry/TrackerGeometryBuilder/interface/StripGeomDetUnit.h"
 
@@ -22,6 +23,13 @@ public:
   virtual ~SiChargeDivider() {}
   virtual ionization_type divide(
       const PSimHit*, const LocalVector&, double, const StripGeomDetUnit& det, CLHEP::HepRandomEngine* engine) = 0;
+  // same, appending the deposits of the hit to those of the module
+  virtual void divide(const PSimHit*,
+                      const LocalVector&,
+                      double,
+                      const StripGeomDetUnit& det,
+                      EnergyDepositSoA& deposits,
+                      CLHEP::HepRandomEngine* engine) = 0;
   virtual void setParticleDataTable(const ParticleDataTable* pdt) = 0;
 };
 
@@ -53,3 +53,31 @@ void SiHitDigitizer::processHit(const PSimHit* hit,
       lastChannelWithSignal,
       tTopo);
 }
+
+void SiHitDigitizer::processHits(const std::vector<const PSimHit*>& hits,
+                                 const StripGeomDetUnit& det,
+                                 GlobalVector bfield,
+                                 float langle,
+                                 CLHEP::HepRandomEngine* engine) {
+  // Compute the drift direction for this det
+  double moduleThickness = det.specificSurface().bounds().thickness();  // active detector thicness
+  double timeNormalisation = (moduleThickness * moduleThickness) / (2. * depletionVoltage * chargeMobility);
+  LocalVector driftDir = DriftDirection(&det, bfield, langle);
+
+  theDeposits.clear();
+  for (auto hit : hits) {
+    theSiChargeDivider->divide(hit, driftDir, moduleThickness, det, theDeposits, engine);
+  }
+  theSiChargeCollectionDrifter->drift(theDeposits, driftDir, moduleThickness, timeNormalisation);
+  theSiInduceChargeOnStrips->integrate(theDeposits, det);
+}
+
+void SiHitDigitizer::induceHit(unsigned int hit,
+                               const StripGeomDetUnit& det,
+                               std::vector<float>& locAmpl,
+                               size_t& firstChannelWithSignal,
+                               size_t& lastChannelWithSignal,
+                               const TrackerTopology* tTopo) {
+  theSiInduceChargeOnStrips->induce(
+      theDeposits, hit, det, locAmpl, firstChannelWithSignal, lastChannelWithSignal, tTopo);
+}
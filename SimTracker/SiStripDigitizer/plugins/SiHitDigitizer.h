@@ -52,12 +52,25 @@ public:
                   const TrackerTopology* tTopo,
                   CLHEP::HepRandomEngine*);
 
+  // Same as processHit, for all the SimHits of a module: the charge of the hits is divided
+  // (in the order of the hits), drifted and integrated over the strips all at once...
+  void processHits(const std::vector<const PSimHit*>&,
+                   const StripGeomDetUnit&,
+                   GlobalVector,
+                   float,
+                   CLHEP::HepRandomEngine*);
+
+  // ...then induced on the strips hit by hit (i-th hit given to processHits)
+  void induceHit(unsigned int, const StripGeomDetUnit&, std::vector<float>&, size_t&, size_t&, const TrackerTopology*);
+
 private:
   const double depletionVoltage;
   const double chargeMobility;
   std::unique_ptr<SiChargeDivider> theSiChargeDivider;
   std::unique_ptr<SiChargeCollectionDrifter> theSiChargeCollectionDrifter;
   std::unique_ptr<const SiInduceChargeOnStrips> theSiInduceChargeOnStrips;
+  // energy deposits of the module given to processHits
+  EnergyDepositSoA theDeposits;
 
   typedef GloballyPositioned<double> Frame;
 
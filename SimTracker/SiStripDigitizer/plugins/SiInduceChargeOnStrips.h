@@ -23,5 +23,15 @@ public:
                       size_t &,
                       size_t &,
                       const TrackerTopology *tTopo) const = 0;
+  // same for the drifted deposits of a module: integrate() computes the charge of all of
+  // them on the strips at once, then induce() adds that of each hit to the amplitudes
+  virtual void integrate(EnergyDepositSoA &, const StripGeomDetUnit &) const = 0;
+  virtual void induce(const EnergyDepositSoA &,
+                      unsigned int hit,
+                      const StripGeomDetUnit &,
+                      std::vector<float> &,
+                      size_t &,
+                      size_t &,
+                      const TrackerTopology *tTopo) const = 0;
 };
 #endif
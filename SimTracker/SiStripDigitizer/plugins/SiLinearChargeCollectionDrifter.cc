@@ -20,25 +20,50 @@ SiChargeCollectionDrifter::collection_type SiLinearChargeCollectionDrifter::drif
   return _temp;
 }
 
-SignalPoint SiLinearChargeCollectionDrifter::drift(const EnergyDepositUnit& edu,
-                                                   const LocalVector& drift,
-                                                   double moduleThickness,
-                                                   double timeNormalisation) {
+inline double SiLinearChargeCollectionDrifter::driftTime(double depth,
+                                                         double moduleThickness,
+                                                         double timeNormalisation) const {
   // computes the fraction of the module the charge has to drift through,
   // ensuring it is bounded in [0,1]
-  double depth = (moduleThickness / 2. - edu.z());
   double thicknessFraction = depth / moduleThickness;
   thicknessFraction = thicknessFraction > 0. ? thicknessFraction : 0.;
   thicknessFraction = thicknessFraction < 1. ? thicknessFraction : 1.;
 
   // computes the drift time in the sensor
-  double driftTime = -timeNormalisation * vdt::fast_log(1. - 2 * depletionVoltage * thicknessFraction /
-                                                                 (depletionVoltage + appliedVoltage)) +
-                     chargeDistributionRMS;
+  return -timeNormalisation *
+             vdt::fast_log(1. - 2 * depletionVoltage * thicknessFraction / (depletionVoltage + appliedVoltage)) +
+         chargeDistributionRMS;
+}
+
+void SiLinearChargeCollectionDrifter::drift(EnergyDepositSoA& deposits,
+                                            const LocalVector& driftDir,
+                                            double moduleThickness,
+                                            double timeNormalisation) {
+  const unsigned int n = deposits.size();
+  deposits.sigma.resize(n);
+  float* __restrict__ x = deposits.x.data();
+  float* __restrict__ y = deposits.y.data();
+  const float* __restrict__ z = deposits.z.data();
+  float* __restrict__ sigma = deposits.sigma.data();
+  const double driftX = driftDir.x();
+  const double driftY = driftDir.y();
+  const double driftZ = driftDir.z();
+  for (unsigned int i = 0; i < n; ++i) {
+    double depth = (moduleThickness / 2. - z[i]);
+    sigma[i] = sqrt(2. * diffusionConstant * driftTime(depth, moduleThickness, timeNormalisation));
+    x[i] = x[i] + depth * driftX / driftZ;
+    y[i] = y[i] + depth * driftY / driftZ;
+  }
+}
 
+SignalPoint SiLinearChargeCollectionDrifter::drift(const EnergyDepositUnit& edu,
+                                                   const LocalVector& drift,
+                                                   double moduleThickness,
+                                                   double timeNormalisation) {
+  double depth = (moduleThickness / 2. - edu.z());
   // returns the signal: an energy on the surface, with a size due to diffusion.
   return SignalPoint(edu.x() + depth * drift.x() / drift.z(),
                      edu.y() + depth * drift.y() / drift.z(),
-                     sqrt(2. * diffusionConstant * driftTime),
+                     sqrt(2. * diffusionConstant * driftTime(depth, moduleThickness, timeNormalisation)),
                      edu.energy());
 }
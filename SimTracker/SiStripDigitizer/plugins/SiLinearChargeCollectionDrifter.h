@@ -16,9 +16,11 @@ public:
                                                    const LocalVector&,
                                                    double,
                                                    double) override;
+  void drift(EnergyDepositSoA&, const LocalVector&, double, double) override;
 
 private:
   SignalPoint drift(const EnergyDepositUnit&, const LocalVector&, double, double);
+  double driftTime(double depth, double moduleThickness, double timeNormalisation) const;
 
 private:
   const double diffusionConstant;
@@ -73,12 +73,32 @@ SiChargeDivider::ionization_type SiLinearChargeDivider::divide(const PSimHit* hi
                                                                double moduleThickness,
                                                                const StripGeomDetUnit& det,
                                                                CLHEP::HepRandomEngine* engine) {
+  EnergyDepositSoA deposits;
+  divide(hit, driftdir, moduleThickness, det, deposits, engine);
+
+  // Prepare output
+  ionization_type _ionization_points;
+  _ionization_points.reserve(deposits.size());
+  for (unsigned int i = 0; i != deposits.size(); ++i) {
+    _ionization_points.emplace_back(deposits.energy[i], deposits.x[i], deposits.y[i], deposits.z[i]);
+  }
+  return _ionization_points;
+}
+
+void SiLinearChargeDivider::divide(const PSimHit* hit,
+                                   const LocalVector& driftdir,
+                                   double moduleThickness,
+                                   const StripGeomDetUnit& det,
+                                   EnergyDepositSoA& deposits,
+                                   CLHEP::HepRandomEngine* engine) {
   // signal after pulse shape correction
   float const decSignal = TimeResponse(hit, det);
 
   // if out of time go home!
-  if (0 == decSignal)
-    return ionization_type();
+  if (0 == decSignal) {
+    deposits.endHit();
+    return;
+  }
 
   // Get the nass if the particle, in MeV.
   // Protect from particles with Mass = 0, assuming then the pion mass
@@ -106,15 +126,12 @@ SiChargeDivider::ionization_type SiLinearChargeDivider::divide(const PSimHit* hi
   // Eloss in GeV
   float eLoss = hit->energyLoss();
 
-  // Prepare output
-  ionization_type _ionization_points;
-  _ionization_points.resize(NumberOfSegmentation);
-
   // Fluctuate charge in track subsegments
   LocalVector direction = hit->exitPoint() - hit->entryPoint();
   if (NumberOfSegmentation <= 1) {
     // here I need a random... not 0.5
-    _ionization_points[0] = EnergyDepositUnit(eLoss * decSignal / eLoss, hit->entryPoint() + 0.5f * direction);
+    const Local3DPoint position = hit->entryPoint() + 0.5f * direction;
+    deposits.push_back(eLoss * decSignal / eLoss, position.x(), position.y(), position.z());
   } else {
     float eLossVector[NumberOfSegmentation];
     if (fluctuateCharge) {
@@ -122,21 +139,19 @@ SiChargeDivider::ionization_type SiLinearChargeDivider::divide(const PSimHit* hi
       // Save the energy of each segment
       for (int i = 0; i != NumberOfSegmentation; i++) {
         // take energy value from vector eLossVector,
-        _ionization_points[i] =
-            EnergyDepositUnit(eLossVector[i] * decSignal / eLoss,
-                              hit->entryPoint() + float((i + 0.5) / NumberOfSegmentation) * direction);
+        const Local3DPoint position = hit->entryPoint() + float((i + 0.5) / NumberOfSegmentation) * direction;
+        deposits.push_back(eLossVector[i] * decSignal / eLoss, position.x(), position.y(), position.z());
       }
     } else {
       // Save the energy of each segment
       for (int i = 0; i != NumberOfSegmentation; i++) {
         // take energy value from eLoss average over n.segments.
-        _ionization_points[i] =
-            EnergyDepositUnit(decSignal / float(NumberOfSegmentation),
-                              hit->entryPoint() + float((i + 0.5) / NumberOfSegmentation) * direction);
+        const Local3DPoint position = hit->entryPoint() + float((i + 0.5) / NumberOfSegmentation) * direction;
+        deposits.push_back(decSignal / float(NumberOfSegmentation), position.x(), position.y(), position.z());
       }
     }
   }
-  return _ionization_points;
+  deposits.endHit();
 }
 
 void SiLinearChargeDivider::fluctuateEloss(double particleMass,
@@ -35,6 +35,13 @@ public:
   // main method: divide the charge (from the PSimHit) into several energy deposits in the bulk
   SiChargeDivider::ionization_type divide(
       const PSimHit*, const LocalVector&, double, const StripGeomDetUnit& det, CLHEP::HepRandomEngine*) override;
+  // same, appending the deposits to those of the module
+  void divide(const PSimHit*,
+              const LocalVector&,
+              double,
+              const StripGeomDetUnit& det,
+              EnergyDepositSoA&,
+              CLHEP::HepRandomEngine*) override;
 
   // set the ParticleDataTable (used to fluctuate the charge properly)
   void setParticleDataTable(const ParticleDataTable* pdt) override { theParticleDataTable = pdt; }
@@ -1,20 +1,29 @@
 #include "SimTracker/SiStripDigitizer/interface/SiPileUpSignals.h"
 #include "SimDataFormats/TrackingHit/interface/PSimHit.h"
 
+#include <algorithm>
+
 void SiPileUpSignals::resetSignals() { signal_.clear(); }
 
 void SiPileUpSignals::add(uint32_t detID,
                           const std::vector<float>& locAmpl,
                           const size_t& firstChannelWithSignal,
                           const size_t& lastChannelWithSignal) {
-  SignalMapType& theSignal = signal_[detID];
+  if (firstChannelWithSignal >= lastChannelWithSignal)
+    return;
+  SignalType& theSignal = signal_[detID];
+  if (theSignal.amplitudes.empty())
+    theSignal.first = firstChannelWithSignal;
+  // extend the range of strips to the new ones
+  const size_t first = std::min(theSignal.first, firstChannelWithSignal);
+  const size_t last = std::max(theSignal.first + theSignal.amplitudes.size(), lastChannelWithSignal);
+  if (first < theSignal.first) {
+    theSignal.amplitudes.insert(theSignal.amplitudes.begin(), theSignal.first - first, 0.);
+    theSignal.first = first;
+  }
+  theSignal.amplitudes.resize(last - first, 0.);
+
   for (size_t iChannel = firstChannelWithSignal; iChannel < lastChannelWithSignal; ++iChannel) {
-    if (locAmpl[iChannel] != 0.0) {
-      if (theSignal.find(iChannel) == theSignal.end()) {
-        theSignal.insert(std::make_pair(iChannel, locAmpl[iChannel]));
-      } else {
-        theSignal[iChannel] += locAmpl[iChannel];
-      }
-    }
+    theSignal.amplitudes[iChannel - first] += locAmpl[iChannel];
   }
 }
@@ -61,6 +61,7 @@ SiStripDigitizerAlgorithm::SiStripDigitizerAlgorithm(const edm::ParameterSet& co
       inefficiency(conf.getParameter<double>("Inefficiency")),
       pedOffset((unsigned int)conf.getParameter<double>("PedestalsOffset")),
       PreMixing_(conf.getParameter<bool>("PreMixingMode")),
+      vectorizedDigitization_(conf.getParameter<bool>("VectorizedDigitization")),
       theSiHitDigitizer(new SiHitDigitizer(conf)),
       theSiPileUpSignals(new SiPileUpSignals()),
       theSiNoiseAdder(new SiGaussianTailNoiseAdder(theThreshold)),
@@ -165,7 +166,8 @@ void SiStripDigitizerAlgorithm::accumulateSimHits(std::vector<PSimHit>::const_it
 
   float langle = (lorentzAngleHandle.isValid()) ? lorentzAngleHandle->getLorentzAngle(detID) : 0.;
 
-  std::vector<float> locAmpl(numStrips, 0.);
+  std::vector<float>& locAmpl = localAmplitudes_;
+  locAmpl.resize(numStrips, 0.);
 
   // Loop over hits
 
@@ -173,11 +175,13 @@ void SiStripDigitizerAlgorithm::accumulateSimHits(std::vector<PSimHit>::const_it
   // First: loop on the SimHits
   if (CLHEP::RandFlat::shoot(engine) > inefficiency) {
     AssociationInfoForChannel* pDetIDAssociationInfo;  // I only need this if makeDigiSimLinks_ is true...
-    if (makeDigiSimLinks_)
+    if (makeDigiSimLinks_) {
       pDetIDAssociationInfo = &(associationInfoForDetId_[detId]);  // ...so only search the map if that is the case
-    std::vector<float>
-        previousLocalAmplitude;  // Only used if makeDigiSimLinks_ is true. Needed to work out the change in amplitude.
+      previousLocalAmplitudes_.resize(numStrips, 0.);  // Needed to work out the change in amplitude.
+    }
 
+    moduleHits_.clear();
+    moduleHitGlobalIndices_.clear();
     size_t simHitGlobalIndex = inputBeginGlobalIndex;  // This needs to stored to create the digi-sim link later
     for (std::vector<PSimHit>::const_iterator simHitIter = inputBegin; simHitIter != inputEnd;
          ++simHitIter, ++simHitGlobalIndex) {
@@ -189,49 +193,74 @@ void SiStripDigitizerAlgorithm::accumulateSimHits(std::vector<PSimHit>::const_it
       if (std::fabs(simHitIter->tof() - cosmicShift -
                     det->surface().toGlobal(simHitIter->localPosition()).mag() / 30.) < tofCut &&
           simHitIter->energyLoss() > 0) {
-        if (makeDigiSimLinks_)
-          previousLocalAmplitude = locAmpl;  // Not needed except to make the sim link association.
-        size_t localFirstChannel = numStrips;
-        size_t localLastChannel = 0;
-        // process the hit
+        moduleHits_.push_back(&*simHitIter);
+        moduleHitGlobalIndices_.push_back(simHitGlobalIndex);
+      }
+    }
+
+    // divide and drift the charge of all the hits at once
+    if (vectorizedDigitization_)
+      theSiHitDigitizer->processHits(moduleHits_, *det, bfield, langle, engine);
+
+    for (unsigned int iHit = 0; iHit != moduleHits_.size(); ++iHit) {
+      const PSimHit* simHit = moduleHits_[iHit];
+      size_t localFirstChannel = numStrips;
+      size_t localLastChannel = 0;
+      // process the hit
+      if (vectorizedDigitization_)
+        theSiHitDigitizer->induceHit(iHit, *det, locAmpl, localFirstChannel, localLastChannel, tTopo);
+      else
         theSiHitDigitizer->processHit(
-            &*simHitIter, *det, bfield, langle, locAmpl, localFirstChannel, localLastChannel, tTopo, engine);
-
-        if (thisFirstChannelWithSignal > localFirstChannel)
-          thisFirstChannelWithSignal = localFirstChannel;
-        if (thisLastChannelWithSignal < localLastChannel)
-          thisLastChannelWithSignal = localLastChannel;
-
-        if (makeDigiSimLinks_) {  // No need to do any of this if truth association was turned off in the configuration
-          for (size_t stripIndex = 0; stripIndex < locAmpl.size(); ++stripIndex) {
-            // Work out the amplitude from this SimHit from the difference of what it was before and what it is now
-            float signalFromThisSimHit = locAmpl[stripIndex] - previousLocalAmplitude[stripIndex];
-            if (signalFromThisSimHit != 0) {  // If this SimHit had any contribution I need to record it.
-              auto& associationVector = (*pDetIDAssociationInfo)[stripIndex];
-              bool addNewEntry = true;
-              // Make sure the hit isn't in already. I've seen this a few times, it always seems to happen in pairs so I think
-              // it's something to do with the stereo strips.
-              for (auto& associationInfo : associationVector) {
-                if (associationInfo.trackID == simHitIter->trackId() &&
-                    associationInfo.eventID == simHitIter->eventId()) {
-                  // The hit is already in, so add this second contribution and move on
-                  associationInfo.contributionToADC += signalFromThisSimHit;
-                  addNewEntry = false;
-                  break;
-                }
-              }  // end of loop over associationVector
-              // If the hit wasn't already in create a new association info structure.
-              if (addNewEntry)
-                associationVector.push_back(AssociationInfo{
-                    simHitIter->trackId(), simHitIter->eventId(), signalFromThisSimHit, simHitGlobalIndex, tofBin});
-            }  // end of "if( signalFromThisSimHit!=0 )"
-          }    // end of loop over locAmpl strips
-        }      // end of "if( makeDigiSimLinks_ )"
-      }        // end of TOF check
-    }          // end for
+            simHit, *det, bfield, langle, locAmpl, localFirstChannel, localLastChannel, tTopo, engine);
+
+      if (thisFirstChannelWithSignal > localFirstChannel)
+        thisFirstChannelWithSignal = localFirstChannel;
+      if (thisLastChannelWithSignal < localLastChannel)
+        thisLastChannelWithSignal = localLastChannel;
+
+      if (makeDigiSimLinks_) {  // No need to do any of this if truth association was turned off in the configuration
+        // the strips out of [localFirstChannel, localLastChannel) did not change
+        for (size_t stripIndex = localFirstChannel; stripIndex < localLastChannel; ++stripIndex) {
+          // Work out the amplitude from this SimHit from the difference of what it was before and what it is now
+          float signalFromThisSimHit = locAmpl[stripIndex] - previousLocalAmplitudes_[stripIndex];
+          previousLocalAmplitudes_[stripIndex] = locAmpl[stripIndex];
+          if (signalFromThisSimHit != 0) {  // If this SimHit had any contribution I need to record it.
+            auto& associationVector = (*pDetIDAssociationInfo)[stripIndex];
+            bool addNewEntry = true;
+            // Make sure the hit isn't in already. I've seen this a few times, it always seems to happen in pairs so I think
+            // it's something to do with the stereo strips.
+            for (auto& associationInfo : associationVector) {
+              if (associationInfo.trackID == simHit->trackId() && associationInfo.eventID == simHit->eventId()) {
+                // The hit is already in, so add this second contribution and move on
+                associationInfo.contributionToADC += signalFromThisSimHit;
+                addNewEntry = false;
+                break;
+              }
+            }  // end of loop over associationVector
+            // If the hit wasn't already in create a new association info structure.
+            if (addNewEntry)
+              associationVector.push_back(AssociationInfo{simHit->trackId(),
+                                                          simHit->eventId(),
+                                                          signalFromThisSimHit,
+                                                          moduleHitGlobalIndices_[iHit],
+                                                          tofBin});
+          }  // end of "if( signalFromThisSimHit!=0 )"
+        }    // end of loop over locAmpl strips
+      }      // end of "if( makeDigiSimLinks_ )"
+    }        // end for
   }
   theSiPileUpSignals->add(detID, locAmpl, thisFirstChannelWithSignal, thisLastChannelWithSignal);
 
+  // leave the buffers empty for the next module
+  for (size_t iChannel = thisFirstChannelWithSignal; iChannel < thisLastChannelWithSignal; ++iChannel) {
+    locAmpl[iChannel] = 0.;
+  }
+  if (makeDigiSimLinks_) {
+    for (size_t iChannel = thisFirstChannelWithSignal; iChannel < thisLastChannelWithSignal; ++iChannel) {
+      previousLocalAmplitudes_[iChannel] = 0.;
+    }
+  }
+
   if (firstChannelsWithSignal[detID] > thisFirstChannelWithSignal)
     firstChannelsWithSignal[detID] = thisFirstChannelWithSignal;
   if (lastChannelsWithSignal[detID] < thisLastChannelWithSignal)
@@ -288,13 +317,11 @@ void SiStripDigitizerAlgorithm::digitize(edm::DetSet<SiStripDigi>& outdigi,
   unsigned int detID = det->geographicalId().rawId();
   int numStrips = (det->specificTopology()).nstrips();
 
-  const SiPileUpSignals::SignalMapType* theSignal(theSiPileUpSignals->getSignal(detID));
+  const SiPileUpSignals::SignalType* theSignal(theSiPileUpSignals->getSignal(detID));
 
   std::vector<float> detAmpl(numStrips, 0.);
   if (theSignal) {
-    for (const auto& amp : *theSignal) {
-      detAmpl[amp.first] = amp.second;
-    }
+    std::copy(theSignal->amplitudes.begin(), theSignal->amplitudes.end(), detAmpl.begin() + theSignal->first);
   }
 
   //removing signal from the dead (and HIP effected) strips
@@ -54,7 +54,7 @@ class SiStripDigitizerAlgorithm {
 public:
   typedef SiDigitalConverter::DigitalVecType DigitalVecType;
   typedef SiDigitalConverter::DigitalRawVecType DigitalRawVecType;
-  typedef SiPileUpSignals::SignalMapType SignalMapType;
+  typedef SiPileUpSignals::SignalType SignalType;
   typedef std::map<int, float, std::less<int>> hit_map_type;
   typedef float Amplitude;
 
@@ -125,6 +125,7 @@ private:
   const double inefficiency;
   const double pedOffset;
   const bool PreMixing_;
+  const bool vectorizedDigitization_;
 
   const ParticleDataTable* pdt;
   const ParticleData* particle;
@@ -146,6 +147,13 @@ private:
   std::map<unsigned int, size_t> firstChannelsWithSignal;
   std::map<unsigned int, size_t> lastChannelsWithSignal;
 
+  // buffers of accumulateSimHits, reused from module to module: the strip amplitudes
+  // are all zeros between two calls
+  std::vector<const PSimHit*> moduleHits_;
+  std::vector<size_t> moduleHitGlobalIndices_;
+  std::vector<float> localAmplitudes_;
+  std::vector<float> previousLocalAmplitudes_;
+
   // ESHandles
   edm::ESHandle<SiStripLorentzAngle> lorentzAngleHandle;
 
@@ -284,6 +284,148 @@ void SiTrivialInduceChargeOnStrips::induceVector(const SiChargeCollectionDrifter
   }  // end loop ip
 }
 
+void SiTrivialInduceChargeOnStrips::integrate(EnergyDepositSoA& deposits, const StripGeomDetUnit& det) const {
+  // same computation as induceVector, for all the deposits of the module at once
+  const StripTopology& topology = dynamic_cast<const StripTopology&>(det.specificTopology());
+  const int Nstrips = topology.nstrips();
+  const int N = deposits.size();
+
+  deposits.chargePosition.resize(N);
+  deposits.chargeSpread.resize(N);
+  deposits.amplitude.resize(N);
+  deposits.fromStrip.resize(N);
+  deposits.nStrip.resize(N);
+  deposits.valueBegin.resize(N);
+  float* __restrict__ chargePosition = deposits.chargePosition.data();
+  float* __restrict__ chargeSpread = deposits.chargeSpread.data();
+  float* __restrict__ amplitude = deposits.amplitude.data();
+  int* __restrict__ fromStrip = deposits.fromStrip.data();
+  int* __restrict__ nStrip = deposits.nStrip.data();
+  int* __restrict__ valueBegin = deposits.valueBegin.data();
+
+  // load not vectorize
+  //In strip coordinates:
+  for (int i = 0; i != N; ++i) {
+    if (0 == deposits.energy[i])
+      count.zero();
+    const LocalPoint position(deposits.x[i], deposits.y[i]);
+    chargePosition[i] = topology.strip(position);
+    chargeSpread[i] = deposits.sigma[i] / topology.localPitch(position);
+    amplitude[i] = 0.5f * deposits.energy[i] / geVperElectron;
+  }
+
+  // this vectorize
+  // as in induceVector: topology.strip() is within [0, Nstrips], so nStrip is never negative
+  for (int i = 0; i != N; ++i) {
+    fromStrip[i] = std::max(0, int(std::floor(chargePosition[i] - Nsigma * chargeSpread[i])));
+    nStrip[i] = std::min(Nstrips, int(std::ceil(chargePosition[i] + Nsigma * chargeSpread[i]))) - fromStrip[i];
+  }
+  int tot = 0;
+  for (int i = 0; i != N; ++i) {
+    assert(nStrip[i] >= 0);
+    valueBegin[i] = tot;
+    tot += nStrip[i] + 1;  // add last strip
+  }
+  count.val(tot);
+  deposits.value.resize(tot);
+  float* __restrict__ value = deposits.value.data();
+
+  // assign relative position (lower bound of strip) in value;
+  for (int i = 0; i != N; ++i) {
+    auto delta = 1.f / (std::sqrt(2.f) * chargeSpread[i]);
+    auto pos = delta * (float(fromStrip[i]) - chargePosition[i]);
+    for (int j = 0; j <= nStrip[i]; ++j)  /// include last strip
+      value[valueBegin[i] + j] = pos + float(j) * delta;
+  }
+
+  // main loop fully vectorized
+  for (int k = 0; k != tot; ++k)
+    value[k] = approx_erf(value[k]);
+
+  // saturate 0 & NStrips strip to 0 and 1???
+  for (int i = 0; i != N; ++i) {
+    if (0 == fromStrip[i])
+      value[valueBegin[i]] = 0;
+    if (Nstrips == fromStrip[i] + nStrip[i])
+      value[valueBegin[i] + nStrip[i]] = 1.f;
+  }
+
+  // compute integral over strip (lower bound becomes the value)
+  for (int k = 0; k < tot - 1; ++k)
+    value[k] -= value[k + 1];  // this is negative!
+}
+
+void SiTrivialInduceChargeOnStrips::induce(const EnergyDepositSoA& deposits,
+                                           unsigned int hit,
+                                           const StripGeomDetUnit& det,
+                                           std::vector<float>& localAmplitudes,
+                                           size_t& recordMinAffectedStrip,
+                                           size_t& recordMaxAffectedStrip,
+                                           const TrackerTopology* tTopo) const {
+  auto const& coupling = signalCoupling[typeOf(det, tTopo)];
+  const StripTopology& topology = dynamic_cast<const StripTopology&>(det.specificTopology());
+  const int Nstrips = topology.nstrips();
+
+  if (Nstrips == 0)
+    return;
+
+  const int NP = deposits.end(hit) - deposits.begin(hit);
+  if (0 == NP)
+    return;
+
+  const float* amplitude = deposits.amplitude.data();
+  const int* fromStrip = deposits.fromStrip.data();
+  const int* nStrip = deposits.nStrip.data();
+  const int* valueBegin = deposits.valueBegin.data();
+  const float* value = deposits.value.data();
+
+  // same splitting of the hit and same order of the sums as in induceVector,
+  // on the strips reached by the deposits only
+  constexpr int MaxN = 512;
+  for (int ip = deposits.begin(hit); ip < int(deposits.end(hit)); ip += MaxN) {
+    auto last = std::min(int(deposits.end(hit)), ip + MaxN);
+
+    count.dep(last - ip);
+    int lowStrip = Nstrips, highStrip = 0;
+    for (int i = ip; i != last; ++i) {
+      if (nStrip[i] > 0) {
+        lowStrip = std::min(lowStrip, fromStrip[i]);
+        highStrip = std::max(highStrip, fromStrip[i] + nStrip[i]);
+      }
+    }
+    if (lowStrip >= highStrip)
+      continue;
+
+    float charge[highStrip - lowStrip];
+    for (int i = 0; i != highStrip - lowStrip; ++i)
+      charge[i] = 0;
+    for (int i = ip; i != last; ++i) {
+      for (int j = 0; j < nStrip[i]; ++j)
+        charge[fromStrip[i] + j - lowStrip] -= amplitude[i] * value[valueBegin[i] + j];
+    }
+
+    /// do crosstalk... (can be done better, most probably not worth)
+    int minA = recordMinAffectedStrip, maxA = recordMaxAffectedStrip;
+    int sc = coupling.size();
+    for (int i = lowStrip; i != highStrip; ++i) {
+      int strip = i;
+      if (0 == charge[i - lowStrip])
+        continue;
+      auto affectedFromStrip = std::max(0, strip - sc + 1);
+      auto affectedUntilStrip = std::min(Nstrips, strip + sc);
+      for (auto affectedStrip = affectedFromStrip; affectedStrip < affectedUntilStrip; ++affectedStrip)
+        localAmplitudes[affectedStrip] += charge[i - lowStrip] * coupling[std::abs(affectedStrip - strip)];
+
+      if (affectedFromStrip < minA)
+        minA = affectedFromStrip;
+      if (affectedUntilStrip > maxA)
+        maxA = affectedUntilStrip;
+    }
+    recordMinAffectedStrip = minA;
+    recordMaxAffectedStrip = maxA;
+  }  // end loop ip
+}
+
 void SiTrivialInduceChargeOnStrips::induceOriginal(const SiChargeCollectionDrifter::collection_type& collection_points,
                                                    const StripGeomDetUnit& det,
                                                    std::vector<float>& localAmplitudes,
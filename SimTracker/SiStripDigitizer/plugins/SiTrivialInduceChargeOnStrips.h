@@ -16,6 +16,14 @@ public:
               size_t& recordMinAffectedStrip,
               size_t& recordMaxAffectedStrip,
               const TrackerTopology* tTopo) const override;
+  void integrate(EnergyDepositSoA& deposits, const StripGeomDetUnit& det) const override;
+  void induce(const EnergyDepositSoA& deposits,
+              unsigned int hit,
+              const StripGeomDetUnit& det,
+              std::vector<float>& localAmplitudes,
+              size_t& recordMinAffectedStrip,
+              size_t& recordMaxAffectedStrip,
+              const TrackerTopology* tTopo) const override;
 
 private:
   void induceOriginal(const SiChargeCollectionDrifter::collection_type& collection_points,
@@ -0,0 +1,44 @@
+#!/usr/bin/env python
+###############################################################################
+# Checks that two runs of runStripDigitizerBenchmark_cfg.py (hit by hit and
+# with the vectorized digitization) produced the same strip digis and
+# digi-sim links, event by event and module by module
+#
+#   python compareStripDigis.py stripDigis0.root stripDigis1.root
+###############################################################################
+from __future__ import print_function
+import sys
+from DataFormats.FWLite import Events, Handle
+
+if len(sys.argv) != 3:
+    print("usage: compareStripDigis.py reference.root vectorized.root")
+    sys.exit(1)
+
+def content(event, handle, label, convert):
+    event.getByLabel(label, handle)
+    if not handle.isValid():
+        return None
+    return dict((detSet.detId(), [convert(x) for x in detSet.data]) for detSet in handle.product())
+
+digiHandles = [Handle("edm::DetSetVector<SiStripDigi>") for f in sys.argv[1:]]
+linkHandles = [Handle("edm::DetSetVector<StripDigiSimLink>") for f in sys.argv[1:]]
+digi = lambda d: (d.strip(), d.adc())
+link = lambda l: (l.channel(), l.SimTrackId(), l.eventId().rawId(), l.CFposition(), l.TofBin(), l.fraction())
+
+events = [Events(name) for name in sys.argv[1:]]
+nEvents = 0
+bad = 0
+for ev0, ev1 in zip(events[0], events[1]):
+    nEvents += 1
+    for name, handles, label, convert in [("digis", digiHandles, ("mix", "ZeroSuppressed"), digi),
+                                          ("links", linkHandles, "mix", link)]:
+        products = [content(ev, h, label, convert) for ev, h in zip([ev0, ev1], handles)]
+        if products[0] != products[1]:
+            bad += 1
+            aux = ev0.eventAuxiliary()
+            dets = [d for d in set(products[0] or {}) | set(products[1] or {})
+                    if (products[0] or {}).get(d) != (products[1] or {}).get(d)]
+            print("run %d event %d: %s differ in %d modules" % (aux.run(), aux.event(), name, len(dets)))
+
+print("%d events compared, %d products differ" % (nEvents, bad))
+sys.exit(1 if bad else 0)
@@ -0,0 +1,64 @@
+###############################################################################
+# Throughput of the strip digitizer: the same GEN-SIM sample is digitized
+# hit by hit and with all the hits of a module at once
+# (VectorizedDigitization), the digis are written out to check that they
+# are identical
+#
+#   cmsRun runStripDigitizerBenchmark_cfg.py inputFiles=file:step1.root vectorized=0
+#   cmsRun runStripDigitizerBenchmark_cfg.py inputFiles=file:step1.root vectorized=1
+#   python compareStripDigis.py stripDigis0.root stripDigis1.root
+#
+# The CPU time per event of the mix module is in the Timing summary of the
+# two jobs; run them with the same number of threads and events
+###############################################################################
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+from Configuration.Eras.Era_Run2_2018_cff import Run2_2018
+
+options = VarParsing('analysis')
+options.register ("vectorized", 1, VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.register ("links", 1, VarParsing.multiplicity.singleton, VarParsing.varType.int)
+options.parseArguments()
+
+process = cms.Process("StripDigitizerBenchmark", Run2_2018)
+process.load('Configuration.StandardSequences.Services_cff')
+process.load('FWCore.MessageService.MessageLogger_cfi')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('SimGeneral.MixingModule.mixNoPU_cfi')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2018_realistic', '')
+
+process.MessageLogger.cerr.FwkReport.reportEvery = 100
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.Timing = cms.Service("Timing",
+    summaryOnly = cms.untracked.bool(True)
+)
+
+# digitize the strips only
+process.mix.digitizers = cms.PSet(
+    strip = process.mix.digitizers.strip
+)
+process.mix.digitizers.strip.VectorizedDigitization = bool(options.vectorized)
+process.mix.digitizers.strip.makeDigiSimLinks = bool(options.links)
+
+process.out = cms.OutputModule("PoolOutputModule",
+    fileName = cms.untracked.string('stripDigis%d.root' % options.vectorized),
+    outputCommands = cms.untracked.vstring(
+        'drop *',
+        'keep *_mix_ZeroSuppressed_*',
+        'keep StripDigiSimLinkedmDetSetVector_mix_*_*'
+    )
+)
+
+process.p = cms.Path(process.mix)
+process.e = cms.EndPath(process.out)
@@ -12,6 +12,9 @@
  *  which are close to one another. The actual calculation
  *  of the distance between components is done by a specific
  *  (polymorphic) class, given at construction time.
+ *  For the Kullback-Leibler distance, the distances are computed
+ *  on a flat copy of the components (see KullbackLeiblerDistanceSoA),
+ *  refilled once per merging pass.
  */
 
 template <unsigned int N>
@@ -43,6 +46,7 @@ private:
 
   int theMaxNumberOfComponents;
   DeepCopyPointerByClone<DistanceBetweenComponents<N> > theDistance;
+  bool theDistanceIsKullbackLeibler;
 };
 
 #include "TrackingTools/GsfTools/interface/CloseComponentsMerger.icc"
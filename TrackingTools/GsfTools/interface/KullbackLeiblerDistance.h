@@ -3,6 +3,9 @@
 
 #include "TrackingTools/GsfTools/interface/DistanceBetweenComponents.h"
 
+#include <memory>
+#include <vector>
+
 /** Calculation of Kullback-Leibler distance between two Gaussian components.
  */
 
@@ -16,6 +19,40 @@ public:
   KullbackLeiblerDistance<N>* clone() const override { return new KullbackLeiblerDistance<N>(*this); }
 };
 
+/** Kullback-Leibler distances between the components of a mixture, computed on a flat
+ *  (structure-of-arrays) copy of their means, covariance and weight matrices.
+ *  The weight matrices are taken from the components, which invert their covariance on the
+ *  first access and cache it, as for KullbackLeiblerDistance.
+ *  The distances of one component to all the active others are computed in a single loop over
+ *  the components: the merging stays O(n^2), only the per-pair cost is reduced. The formula is
+ *  the one of KullbackLeiblerDistanceDetails::compute but the terms are summed in a different
+ *  order, so the results agree within rounding and are not bitwise identical.
+ */
+
+template <unsigned int N>
+class KullbackLeiblerDistanceSoA {
+public:
+  using SingleStatePtr = std::shared_ptr<SingleGaussianState<N>>;
+  /// number of independent elements of a symmetric NxN matrix
+  static constexpr unsigned int kSize = N * (N + 1) / 2;
+
+  void fill(const std::vector<SingleStatePtr>& states);
+
+  unsigned int size() const { return theSize; }
+
+  /** Distances of component i to the components j with active[j] set, in the order given at
+   *  filling time; the entries of the inactive components are left untouched. Each computed entry
+   *  is equal, within rounding, to KullbackLeiblerDistance<N>()(state i, state j).
+   */
+  void distances(unsigned int i, const bool* active, double* distances) const;
+
+private:
+  unsigned int theSize = 0;
+  std::vector<double> theMeans;          // N arrays of size()
+  std::vector<double> theCovariances;    // kSize arrays of size(), packed as in MatRepSym
+  std::vector<double> theWeightMatrices;  // kSize arrays of size(), packed as in MatRepSym
+};
+
 #include "TrackingTools/GsfTools/interface/KullbackLeiblerDistance.icc"
 
 #endif  // KullbackLeiblerDistance_H
@@ -0,0 +1,65 @@
+#include "TrackingTools/GsfTools/interface/KullbackLeiblerDistance.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+typedef SingleGaussianState<5> GS;
+typedef GS::Vector Vector;
+typedef GS::Matrix Matrix;
+
+// a positive definite covariance matrix with some correlations
+Matrix buildCovariance(double scale) {
+  Matrix cov;
+  for (unsigned int i = 0; i < 5; ++i) {
+    cov(i, i) = scale * (1. + i);
+    for (unsigned int j = 0; j < i; ++j)
+      cov(i, j) = 0.1 * scale * (1. + i + j) / (1. + i * j);
+  }
+  return cov;
+}
+
+int main() {
+  KullbackLeiblerDistance<5> distance;
+
+  std::vector<std::shared_ptr<GS>> states;
+  for (int i = 0; i < 13; ++i) {
+    double x = 0.1 * i;
+    states.push_back(std::make_shared<GS>(
+        Vector(1. + x, -x, 0.5 * x * x, 2. - x, 0.3), buildCovariance(1. + 0.2 * i), 1. / (1. + i)));
+  }
+
+  KullbackLeiblerDistanceSoA<5> soa;
+  soa.fill(states);
+  assert(soa.size() == states.size());
+
+  // one component in three is inactive, as after some merging steps in CloseComponentsMerger
+  const double untouched = -1.;
+  std::unique_ptr<bool[]> active(new bool[states.size()]);
+  for (unsigned int j = 0; j < states.size(); ++j)
+    active[j] = (j % 3 != 1);
+
+  std::vector<double> distances(states.size());
+  for (unsigned int i = 0; i < states.size(); ++i) {
+    std::fill(distances.begin(), distances.end(), untouched);
+    soa.distances(i, active.get(), distances.data());
+    for (unsigned int j = 0; j < states.size(); ++j) {
+      if (!active[j]) {
+        assert(distances[j] == untouched);
+        continue;
+      }
+      double ref = distance(*states[i], *states[j]);
+      if (std::abs(distances[j] - ref) > 1.e-9 * std::max(1., std::abs(ref))) {
+        std::cout << "mismatch for " << i << ' ' << j << ": " << distances[j] << " vs " << ref << std::endl;
+        return 1;
+      }
+    }
+    assert(!active[i] || distances[i] == 0);
+  }
+
+  std::cout << "KullbackLeiblerDistanceSoA agrees with KullbackLeiblerDistance" << std::endl;
+  return 0;
+}
@@ -0,0 +1,55 @@
+#! /usr/bin/env python
+###############################################################################
+# Compares the 1D histograms of a directory of two ROOT files, e.g. the
+# TFileService outputs of the same validation job run with and without a
+# new simulation feature: prints the mean of each histogram in both files
+# and their Kolmogorov-Smirnov probability, and exits with 1 if any of
+# them is below the threshold
+#
+#   compareHistogramsKS.py reference.root new.root CaloSimHitStudy
+###############################################################################
+from __future__ import print_function
+import optparse
+import sys
+
+import ROOT
+
+def compareDirectory(refDir, newDir, minProb):
+    """
+    Compares the histograms of refDir found in newDir, returns the number
+    of them with a KS probability below minProb
+    """
+    bad = 0
+    print("%-20s %12s %12s %10s" % ("hist", "mean(ref)", "mean(new)", "KS prob"))
+    for key in refDir.GetListOfKeys():
+        ref = key.ReadObj()
+        if not ref.InheritsFrom("TH1") or ref.InheritsFrom("TH2") or ref.InheritsFrom("TProfile"):
+            continue
+        new = newDir.Get(key.GetName())
+        if not new or ref.GetEntries() == 0 or new.GetEntries() == 0:
+            continue
+        prob = ref.KolmogorovTest(new)
+        flag = ""
+        if prob < minProb:
+            flag = " <--"
+            bad += 1
+        print("%-20s %12.5g %12.5g %10.4f%s" % (key.GetName(), ref.GetMean(), new.GetMean(), prob, flag))
+    return bad
+
+if __name__ == "__main__":
+    parser = optparse.OptionParser("usage: %prog [options] reference.root new.root directory")
+    parser.add_option('--minProb', dest='minProb', type='float', default=0.01,
+                      help='KS probability below which two histograms differ (default 0.01)')
+    options, args = parser.parse_args()
+    if len(args) != 3:
+        parser.print_help()
+        sys.exit(1)
+
+    files = [ROOT.TFile.Open(name) for name in args[:2]]
+    dirs = [f.Get(args[2]) if f else None for f in files]
+    if not dirs[0] or not dirs[1]:
+        print("directory %s not found in %s and %s" % (args[2], args[0], args[1]))
+        sys.exit(1)
+    bad = compareDirectory(dirs[0], dirs[1], options.minProb)
+    print("%d distributions differ at the %g level" % (bad, options.minProb))
+    sys.exit(1 if bad else 0)